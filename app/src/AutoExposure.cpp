@@ -0,0 +1,258 @@
+#include "AutoExposure.h"
+
+#include <algorithm>
+#include <cmath>
+#include <QString>
+
+#include "CameraProperty.h"
+#include "ICamera.hpp"
+#include "logwidget.hpp"
+
+namespace lzx
+{
+    AutoExposure::AutoExposure(const Config &config)
+        : m_config(config)
+    {
+    }
+
+    void AutoExposure::setConfig(const Config &config)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_config = config;
+    }
+
+    AutoExposure::Config AutoExposure::config() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_config;
+    }
+
+    AutoExposure::Measurement AutoExposure::measure(const HistogramEngine::Result &result, const Config &config)
+    {
+        Measurement measurement;
+        if (result.empty())
+            return measurement;
+
+        const double samples = static_cast<double>(result.samples);
+        const int whiteLevel = std::min(std::max(1, static_cast<int>(std::ceil(config.saturationLevel * result.maxValue))), result.maxValue);
+        const int blackLevel = static_cast<int>(config.blackLevel * result.maxValue);
+
+        uint64_t saturated = 0;
+        for (int value = whiteLevel; value <= result.maxValue; value++)
+            saturated += result.counts[value];
+        uint64_t black = 0;
+        for (int value = 0; value <= blackLevel; value++)
+            black += result.counts[value];
+
+        measurement.saturated = saturated / samples;
+        measurement.black = black / samples;
+
+        // 目标为 0 时按一个像素算，避免除零
+        const double saturationTarget = std::max(config.saturationTarget, 1.0 / samples);
+        const double blackTarget = std::max(config.blackTarget, 1.0 / samples);
+
+        // 白端：饱和超标时分位值卡在满量程，只能按超标倍数估计；否则按分位值到饱和线的距离，曝光与灰度成正比
+        double whiteError;
+        if (measurement.saturated > saturationTarget)
+        {
+            whiteError = -std::log2(measurement.saturated / saturationTarget);
+        }
+        else
+        {
+            int white = std::max(result.percentile(1.0 - saturationTarget), 1);
+            whiteError = std::log2(static_cast<double>(whiteLevel) / white);
+        }
+
+        // 黑端只在两端冲突时起作用：白端有余量时加曝光本身就会减少死黑
+        double blackError = measurement.black > blackTarget ? std::log2(measurement.black / blackTarget) : 0.0;
+
+        measurement.errorStops = (whiteError < 0.0 && blackError > 0.0) ? (whiteError + blackError) / 2 : whiteError;
+        return measurement;
+    }
+
+    bool AutoExposure::update(const HistogramEngine::Result &result, const FrameMetadata &metadata,
+                              double currentUs, double minUs, double maxUs, double &exposureUs)
+    {
+        if (result.empty())
+            return false;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // 还没按新参数拍出来的帧；相机确认超时也会切换编号，等这么久仍是旧编号说明采集线程写入失败，不再等待
+        if (metadata.parameterEpoch < m_awaitEpoch)
+        {
+            ++m_stats.settling;
+            if (++m_settleFrames <= ParameterEpoch::MaxSettleFrames * 2)
+                return false;
+
+            ++m_stats.failed;
+            m_awaitEpoch = 0;
+        }
+
+        ++m_stats.frames;
+        Measurement measurement = measure(result, m_config);
+        m_stats.last = measurement;
+
+        // 饱和很多时按面积估计的误差远大于实际需要的档数，限幅后再进控制律，避免比例项来回过冲
+        const double error = std::min(std::max(measurement.errorStops, -m_config.maxStepStops), m_config.maxStepStops);
+        if (std::fabs(error) < m_config.deadbandStops)
+        {
+            m_previousError = 0.0;
+            return false;
+        }
+
+        if (m_lastWriteNs != 0 && FrameMetadata::now() - m_lastWriteNs < static_cast<int64_t>(m_config.minIntervalMs * 1e6))
+        {
+            ++m_stats.throttled;
+            return false;
+        }
+
+        // 帧信息里的曝光是相机按步长取整后实际生效的值
+        double current = metadata.exposureUs > 0.0 ? metadata.exposureUs : currentUs;
+        if (current <= 0.0)
+            return false;
+
+        double step = m_config.kp * (error - m_previousError) + m_config.ki * error;
+        step = std::min(std::max(step, -m_config.maxStepStops), m_config.maxStepStops);
+        m_previousError = error;
+
+        if (m_config.maxExposureUs > 0.0)
+            maxUs = maxUs > 0.0 ? std::min(maxUs, m_config.maxExposureUs) : m_config.maxExposureUs;
+        double target = current * std::exp2(step);
+        if (maxUs > 0.0)
+            target = std::min(target, maxUs);
+        target = std::max(target, std::max(minUs, 1.0));
+
+        // 已经顶到范围边界
+        if (std::fabs(std::log2(target / current)) < 0.01)
+            return false;
+
+        exposureUs = target;
+        return true;
+    }
+
+    void AutoExposure::committed(uint64_t epoch, int64_t nowNs)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (epoch == 0)
+        {
+            ++m_stats.failed;
+            return;
+        }
+
+        ++m_stats.writes;
+        m_awaitEpoch = epoch;
+        m_settleFrames = 0;
+        m_lastWriteNs = nowNs;
+    }
+
+    AutoExposure::Statistics AutoExposure::statistics() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    void AutoExposure::reset()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_awaitEpoch = 0;
+        m_settleFrames = 0;
+        m_previousError = 0.0;
+        m_lastWriteNs = 0;
+        m_stats = Statistics();
+    }
+
+    AutoExposureController::AutoExposureController(ICamera *camera, const AutoExposure::Config &config)
+        : m_camera(camera),
+          m_law(config)
+    {
+    }
+
+    AutoExposureController::~AutoExposureController()
+    {
+        stop();
+    }
+
+    bool AutoExposureController::start()
+    {
+        if (m_running)
+            return true;
+
+        FrameBus *bus = m_camera ? m_camera->frameBus() : nullptr;
+        if (!bus)
+        {
+            Log::error("AutoExposure: camera has no frame bus");
+            return false;
+        }
+
+        PropertyInfo exposure = m_camera->properties().info(PropertyId::ExposureTime);
+        if (!exposure.available || !exposure.writable)
+        {
+            Log::error("AutoExposure: exposure time is not writable on " + QString::fromStdString(m_camera->label()));
+            return false;
+        }
+
+        m_law.reset();
+        m_subscription = bus->subscribe("auto exposure");
+        m_running = true;
+        m_thread = std::make_unique<std::thread>(&AutoExposureController::controlFunction, this);
+
+        Log::info(QString("AutoExposure started on %1").arg(QString::fromStdString(m_camera->label())));
+        return true;
+    }
+
+    void AutoExposureController::stop()
+    {
+        if (!m_running)
+            return;
+
+        m_running = false;
+        m_thread->join();
+        m_thread.reset();
+        m_subscription.reset();
+
+        AutoExposure::Statistics stats = m_law.statistics();
+        Log::info(QString("AutoExposure stopped: %1 frames, %2 settling, %3 throttled, %4 writes, %5 failed, last error %6 stops")
+                      .arg(stats.frames)
+                      .arg(stats.settling)
+                      .arg(stats.throttled)
+                      .arg(stats.writes)
+                      .arg(stats.failed)
+                      .arg(stats.last.errorStops, 0, 'f', 2));
+    }
+
+    void AutoExposureController::controlFunction()
+    {
+        HistogramEngine engine;
+        HistogramEngine::Result result;
+
+        while (m_running)
+        {
+            Frame frame = m_subscription->acquire();
+            if (frame.empty())
+            {
+                std::this_thread::sleep_for(PollInterval);
+                continue;
+            }
+
+            // 饱和/死黑比例不需要每个像素，大画幅按步长抽样
+            FrameView view = frame.view();
+            double points = static_cast<double>(view.width()) * view.height();
+            int factor = std::max(1, static_cast<int>(std::ceil(std::sqrt(points / MaxSamples))));
+
+            FrameMetadata metadata = frame.metadata();
+            bool computed = engine.compute(view.decimate(factor), result);
+            frame.reset();
+            if (!computed)
+                continue;
+
+            PropertyInfo exposure = m_camera->properties().info(PropertyId::ExposureTime);
+            double target = 0.0;
+            if (!m_law.update(result, metadata, exposure.value, exposure.min, exposure.max, target))
+                continue;
+
+            uint64_t epoch = m_camera->apply(ParameterTransaction().setExposure(target));
+            m_law.committed(epoch, FrameMetadata::now());
+        }
+    }
+}
@@ -0,0 +1,124 @@
+#ifndef AUTO_EXPOSURE_H
+#define AUTO_EXPOSURE_H
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <cstdint>
+
+#include "Frame.h"
+#include "FrameBus.h"
+#include "HistogramEngine.h"
+
+namespace lzx
+{
+    class ICamera;
+
+    // 自动曝光的控制律：误差以“档”（曝光的 log2）计，
+    // 白端让 (1 - saturationTarget) 分位落在饱和线上（尽量曝光、饱和像素不超过目标比例），
+    // 饱和超标时按超标倍数减曝光；两端都超标（场景动态范围超过传感器）时取两端误差的折中。
+    // 用速度形式的 PI：Δu = kp·(e - e_prev) + ki·e，u 为 log2 曝光，单次调整限幅，没有积分饱和问题。
+    // 提交后编号小于返回值的帧是按旧参数拍的（见 ParameterEpoch），不参与计算，相机的生效延迟不会被当成误差。
+    class AutoExposure
+    {
+    public:
+        struct Config
+        {
+            double saturationTarget = 0.005; // 允许饱和的像素比例
+            double blackTarget = 0.01;       // 允许死黑的像素比例
+            double saturationLevel = 0.98;   // 不低于满量程的这个比例算饱和
+            double blackLevel = 0.02;        // 不高于满量程的这个比例算死黑
+            double kp = 0.2;                 // 比例增益
+            double ki = 0.5;                 // 积分增益
+            double maxStepStops = 1.0;       // 单次调整上限（档）
+            double deadbandStops = 0.05;     // 误差小于此值时不写相机
+            double minIntervalMs = 100.0;    // 两次写入的最小间隔
+            double maxExposureUs = 0.0;      // 曝光上限（最低帧率对应的帧间隔），0 表示只受相机范围限制
+        };
+
+        struct Measurement
+        {
+            double saturated = 0.0;  // 饱和像素比例
+            double black = 0.0;      // 死黑像素比例
+            double errorStops = 0.0; // 正数表示需要加曝光
+        };
+
+        struct Statistics
+        {
+            uint64_t frames = 0;    // 参与计算的帧
+            uint64_t settling = 0;  // 等待新参数生效、跳过的帧
+            uint64_t throttled = 0; // 需要调整但距上次写入太近的帧
+            uint64_t writes = 0;    // 提交到相机的次数
+            uint64_t failed = 0;    // 相机拒绝的提交（包括采集线程写入失败、一直没有生效的）
+            Measurement last;
+        };
+
+        explicit AutoExposure(const Config &config);
+
+        void setConfig(const Config &config);
+        Config config() const;
+
+        // 直方图上的饱和/死黑比例和误差
+        static Measurement measure(const HistogramEngine::Result &result, const Config &config);
+
+        // 加入一帧的直方图；需要写入时返回 true，exposureUs 为目标曝光。
+        // currentUs 为当前曝光（帧信息没有曝光时使用），minUs/maxUs 为相机的曝光范围
+        bool update(const HistogramEngine::Result &result, const FrameMetadata &metadata,
+                    double currentUs, double minUs, double maxUs, double &exposureUs);
+
+        // 提交后调用，epoch 为 ICamera::apply 的返回值，0 表示提交失败
+        void committed(uint64_t epoch, int64_t nowNs);
+
+        Statistics statistics() const;
+
+        // 重新开始（换相机、重新取流）
+        void reset();
+
+    private:
+        mutable std::mutex m_mutex;
+        Config m_config;
+
+        uint64_t m_awaitEpoch = 0; // 编号小于它的帧是过渡帧
+        int m_settleFrames = 0;    // 等待生效已经跳过的帧
+        double m_previousError = 0.0;
+        int64_t m_lastWriteNs = 0;
+        Statistics m_stats;
+    };
+
+    // 自动曝光线程：在相机的帧总线上以 Latest 模式订阅，抽样计算直方图，按 AutoExposure 的结果通过 ICamera::apply 写曝光。
+    // 只依赖 ICamera 的帧总线、参数表和 apply，海康、PlayerOne 和合成相机都可以用，没有界面时也能调参。
+    class AutoExposureController
+    {
+    public:
+        // 相机必须比控制器活得久
+        AutoExposureController(ICamera *camera, const AutoExposure::Config &config);
+        ~AutoExposureController();
+
+        // 相机取流后调用；相机没有帧总线或不能设置曝光时返回 false
+        bool start();
+        void stop();
+        bool running() const { return m_running; }
+
+        void setConfig(const AutoExposure::Config &config) { m_law.setConfig(config); }
+        AutoExposure::Statistics statistics() const { return m_law.statistics(); }
+
+    private:
+        AutoExposureController(const AutoExposureController &) = delete;
+        AutoExposureController &operator=(const AutoExposureController &) = delete;
+
+        static constexpr size_t MaxSamples = 1 << 18; // 直方图最多统计这么多采样点，大画幅按步长抽样
+        static constexpr auto PollInterval = std::chrono::milliseconds(2);
+
+        void controlFunction();
+
+        ICamera *m_camera;
+        AutoExposure m_law;
+        std::unique_ptr<FrameBus::Subscription> m_subscription;
+        std::atomic<bool> m_running{false};
+        std::unique_ptr<std::thread> m_thread;
+    };
+}
+
+#endif
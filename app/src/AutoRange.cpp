@@ -0,0 +1,82 @@
+#include "AutoRange.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace lzx
+{
+    AutoRange::AutoRange(const Config &config)
+        : m_config(config)
+    {
+    }
+
+    void AutoRange::setConfig(const Config &config)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_config = config;
+        m_hasState = false;
+    }
+
+    bool AutoRange::update(const HistogramEngine::Result &result, int64_t timestampNs)
+    {
+        if (result.empty())
+            return false;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_stats.updates;
+
+        double low = result.percentile(std::min(m_config.lowPercentile, m_config.highPercentile));
+        double high = result.percentile(std::max(m_config.lowPercentile, m_config.highPercentile));
+        high = std::max(high, low + 1.0); // 平坦的画面上两个百分位可能相同
+
+        // 位深变化（换相机、换像素格式）时直接切换
+        if (!m_hasState || result.maxValue != m_range.maxValue)
+        {
+            m_smoothLow = low;
+            m_smoothHigh = high;
+            m_lastNs = timestampNs;
+            m_range = {low, high, result.maxValue};
+            m_hasState = true;
+            ++m_stats.changes;
+            return true;
+        }
+
+        // 按两次更新的时间间隔折算平滑系数，直方图的计算频率不影响收敛速度
+        double alpha = 1.0;
+        if (m_config.timeConstantMs > 0.0)
+        {
+            double dtMs = std::max(0.0, static_cast<double>(timestampNs - m_lastNs) / 1e6);
+            alpha = 1.0 - std::exp(-dtMs / m_config.timeConstantMs);
+        }
+        m_lastNs = timestampNs;
+        m_smoothLow += alpha * (low - m_smoothLow);
+        m_smoothHigh += alpha * (high - m_smoothHigh);
+
+        double threshold = std::max(1.0, m_config.hysteresis * result.maxValue);
+        if (std::fabs(m_smoothLow - m_range.low) < threshold && std::fabs(m_smoothHigh - m_range.high) < threshold)
+            return false;
+
+        m_range.low = std::round(m_smoothLow);
+        m_range.high = std::max(std::round(m_smoothHigh), m_range.low + 1.0);
+        ++m_stats.changes;
+        return true;
+    }
+
+    AutoRange::Range AutoRange::range() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_range;
+    }
+
+    AutoRange::Statistics AutoRange::statistics() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    void AutoRange::reset()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_hasState = false;
+    }
+}
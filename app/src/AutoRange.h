@@ -0,0 +1,67 @@
+#ifndef AUTO_RANGE_H
+#define AUTO_RANGE_H
+
+#include <mutex>
+#include <cstdint>
+
+#include "HistogramEngine.h"
+
+namespace lzx
+{
+    // 自动显示范围：黑白点取精确直方图的低/高百分位，
+    // 先按时间常数做指数平滑，平滑后的值偏离当前范围超过滞回阈值时才切换，
+    // 场景缓慢变化或噪声抖动时 LUT 不闪烁、也不用每帧重新生成。
+    // update() 在直方图线程上调用，range() 可以在任意线程调用。
+    class AutoRange
+    {
+    public:
+        struct Config
+        {
+            double lowPercentile = 0.001;  // 黑点，0~1
+            double highPercentile = 0.999; // 白点，0~1
+            double timeConstantMs = 300.0; // 平滑的时间常数，0 表示不平滑
+            double hysteresis = 0.01;      // 切换阈值，满量程的比例
+        };
+
+        struct Range
+        {
+            double low = 0.0;
+            double high = 0.0;
+            int maxValue = 0; // 满量程
+        };
+
+        struct Statistics
+        {
+            uint64_t updates = 0; // 参与计算的直方图数
+            uint64_t changes = 0; // 范围切换（需要重新生成 LUT）的次数
+        };
+
+        explicit AutoRange(const Config &config);
+
+        void setConfig(const Config &config);
+
+        // 加入一帧的直方图，timestampNs 为主机单调时钟；范围切换时返回 true
+        bool update(const HistogramEngine::Result &result, int64_t timestampNs);
+
+        // 当前生效的范围，还没有直方图时 maxValue 为 0
+        Range range() const;
+
+        Statistics statistics() const;
+
+        // 下一帧直接取当前百分位，不平滑
+        void reset();
+
+    private:
+        mutable std::mutex m_mutex;
+        Config m_config;
+
+        bool m_hasState = false;
+        double m_smoothLow = 0.0;
+        double m_smoothHigh = 0.0;
+        int64_t m_lastNs = 0;
+        Range m_range;
+        Statistics m_stats;
+    };
+}
+
+#endif
@@ -0,0 +1,493 @@
+#include "Benchmarks.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <thread>
+#include <QString>
+
+#include "Frame.h"
+#include "FrameCodec.h"
+#include "FrameRing.h"
+#include "HistogramEngine.h"
+#include "ThreadPool.h"
+#include "logwidget.hpp"
+
+namespace lzx
+{
+    namespace
+    {
+        double secondsSince(std::chrono::steady_clock::time_point start)
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        // 原来 FrameRenderer 里的直方图：100 个 bin，逐像素判断位深并做浮点除法
+        std::vector<int> legacyHistogram(const FrameView &frame, int sampling, int bins)
+        {
+            int maxPossibleValue = (1 << std::min(std::max(frame.bitDepth(), 8), 16)) - 1;
+            std::vector<int> histogram(bins, 0);
+
+            FrameView sampled = frame.decimate(sampling);
+            int step = sampled.pixelStep() * sampled.channels();
+            float binWidth = static_cast<float>(maxPossibleValue + 1) / bins;
+
+            for (int y = 0; y < sampled.height(); y++)
+            {
+                const unsigned char *row8 = sampled.row(y);
+                const unsigned short *row16 = sampled.row<unsigned short>(y);
+                for (int x = 0; x < sampled.width(); x++)
+                {
+                    int pixelValue = (sampled.bitDepth() <= 8) ? row8[x * step] : row16[x * step];
+                    int binIndex = static_cast<int>(pixelValue / binWidth);
+                    if (binIndex >= bins)
+                        binIndex = bins - 1;
+                    histogram[binIndex]++;
+                }
+            }
+            return histogram;
+        }
+    }
+
+    std::vector<unsigned char> Benchmarks::makeHdrFrame(int width, int height, int bitDepth, int sensorBits, uint32_t seed)
+    {
+        const int bytesPerPixel = bitDepth > 8 ? 2 : 1;
+        const int shift = bitDepth - sensorBits;
+        const double fullScale = (1 << sensorBits) - 1;
+
+        std::mt19937 generator(seed);
+        std::normal_distribution<double> readNoise(0.0, 3.0);       // 读出噪声（DN）
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+        // 亮斑：位置、半径和峰值随机，峰值最高到满量程 3 倍（饱和）
+        struct Spot
+        {
+            double x, y, sigma, peak;
+        };
+        std::vector<Spot> spots(6);
+        for (auto &spot : spots)
+        {
+            spot.x = uniform(generator) * width;
+            spot.y = uniform(generator) * height;
+            spot.sigma = (0.01 + 0.04 * uniform(generator)) * std::min(width, height);
+            spot.peak = (0.1 + 2.9 * uniform(generator)) * fullScale;
+        }
+
+        const double background = fullScale * 0.02;
+        std::vector<unsigned char> frame(static_cast<size_t>(width) * height * bytesPerPixel);
+        for (int y = 0; y < height; y++)
+        {
+            for (int x = 0; x < width; x++)
+            {
+                double signal = background;
+                for (const auto &spot : spots)
+                {
+                    double dx = x - spot.x, dy = y - spot.y;
+                    double d2 = (dx * dx + dy * dy) / (2 * spot.sigma * spot.sigma);
+                    if (d2 < 20)
+                        signal += spot.peak * std::exp(-d2);
+                }
+
+                // 散粒噪声近似为高斯
+                double value = signal + readNoise(generator) + std::sqrt(signal) * readNoise(generator) / 3.0;
+                uint32_t dn = static_cast<uint32_t>(std::min(std::max(value, 0.0), fullScale)) << shift;
+
+                size_t index = static_cast<size_t>(y) * width + x;
+                if (bytesPerPixel == 2)
+                    reinterpret_cast<uint16_t *>(frame.data())[index] = static_cast<uint16_t>(dn);
+                else
+                    frame[index] = static_cast<uint8_t>(dn);
+            }
+        }
+        return frame;
+    }
+
+    Benchmarks::CodecResult Benchmarks::codec(int width, int height, int bitDepth, int sensorBits, size_t threads, int iterations)
+    {
+        CodecResult result;
+        result.width = width;
+        result.height = height;
+        result.bitDepth = bitDepth;
+        result.sensorBits = sensorBits;
+
+        std::vector<unsigned char> frame = makeHdrFrame(width, height, bitDepth, sensorBits);
+        FrameView view(frame.data(), width, height, 1, bitDepth);
+
+        std::unique_ptr<ThreadPool> pool;
+        if (threads > 0)
+            pool = std::make_unique<ThreadPool>(threads);
+        result.threads = threads + 1;
+
+        FrameCodec codec(pool.get());
+        std::vector<unsigned char> encoded(FrameCodec::maxEncodedBytes(width, height, 1, bitDepth));
+        std::vector<unsigned char> decoded(frame.size());
+
+        // 预热一次，同时检查无损
+        size_t encodedBytes = codec.encode(view, encoded.data());
+        if (!codec.decode(encoded.data(), encodedBytes, decoded.data(), width, height, 1, bitDepth) || decoded != frame)
+        {
+            Log::error("Codec benchmark: round trip mismatch");
+            return result;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+            codec.encode(view, encoded.data());
+        double encodeSeconds = secondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+            codec.decode(encoded.data(), encodedBytes, decoded.data(), width, height, 1, bitDepth);
+        double decodeSeconds = secondsSince(start);
+
+        double megabytes = frame.size() * static_cast<double>(iterations) / 1048576.0;
+        result.ratio = static_cast<double>(frame.size()) / encodedBytes;
+        result.encodeMBps = megabytes / encodeSeconds;
+        result.decodeMBps = megabytes / decodeSeconds;
+        return result;
+    }
+
+    Benchmarks::UnpackResult Benchmarks::unpack(PixelFormat format, int width, int height, int iterations)
+    {
+        UnpackResult result;
+        result.format = format;
+        result.width = width;
+        result.height = height;
+
+        // 源数据取 HDR 测试帧按格式打包后的结果，内容不影响解包速度
+        const int bitDepth = PixelConvert::bitDepth(format);
+        std::vector<unsigned char> frame = makeHdrFrame(width, height, bitDepth, bitDepth);
+        const uint16_t *pixels = reinterpret_cast<const uint16_t *>(frame.data());
+        const int lowBits = bitDepth - 8;
+        std::vector<unsigned char> packed(PixelConvert::rowBytes(format, width) * height);
+        for (size_t i = 0; i + 1 < static_cast<size_t>(width) * height; i += 2)
+        {
+            unsigned char *group = packed.data() + i / 2 * 3;
+            group[0] = static_cast<unsigned char>(pixels[i] >> lowBits);
+            group[1] = static_cast<unsigned char>((pixels[i] & ((1 << lowBits) - 1)) | (pixels[i + 1] & ((1 << lowBits) - 1)) << 4);
+            group[2] = static_cast<unsigned char>(pixels[i + 1] >> lowBits);
+        }
+
+        Frame output(width, height, 1, bitDepth);
+        if (!PixelConvert::toFrame(packed.data(), packed.size(), format, output) ||
+            memcmp(output.data(), frame.data(), frame.size()) != 0)
+        {
+            Log::error("Unpack benchmark: result mismatch");
+            return result;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+            PixelConvert::toFrame(packed.data(), packed.size(), format, output);
+        double seconds = secondsSince(start);
+
+        result.framesPerSecond = iterations / seconds;
+        result.megapixelsPerSecond = result.framesPerSecond * width * height / 1e6;
+        return result;
+    }
+
+    Benchmarks::DemosaicResult Benchmarks::demosaic(Demosaic::Method method, int width, int height, size_t threads, int iterations)
+    {
+        DemosaicResult result;
+        result.method = method;
+        result.width = width;
+        result.height = height;
+
+        // 测试帧直接当作 RGGB 原始数据，内容不影响速度
+        std::vector<unsigned char> raw = makeHdrFrame(width, height, 16, 12);
+        FrameView view(raw.data(), width, height, 1, 16);
+        Frame output(width, height, 3, 16);
+
+        std::unique_ptr<ThreadPool> pool;
+        if (threads > 0)
+            pool = std::make_unique<ThreadPool>(threads);
+        result.threads = threads + 1;
+        Demosaic demosaic(pool.get());
+
+        if (!demosaic.process(view, Demosaic::Pattern::RGGB, method, output))
+        {
+            Log::error("Demosaic benchmark: process failed");
+            return result;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+            demosaic.process(view, Demosaic::Pattern::RGGB, method, output);
+        double seconds = secondsSince(start);
+
+        result.framesPerSecond = iterations / seconds;
+        result.megapixelsPerSecond = result.framesPerSecond * width * height / 1e6;
+        return result;
+    }
+
+    std::vector<Benchmarks::ConvertResult> Benchmarks::convert(PixelConvert::SimdLevel level, int width, int height, int iterations)
+    {
+        std::vector<ConvertResult> results;
+        const PixelConvert::SimdLevel previous = PixelConvert::simdLevel();
+        if (!PixelConvert::setSimdLevel(level))
+            return results;
+
+        const size_t pixels = static_cast<size_t>(width) * height;
+        std::vector<unsigned char> frame = makeHdrFrame(width, height, 16, 12);
+        const uint16_t *mono16 = reinterpret_cast<const uint16_t *>(frame.data());
+        // 彩色源数据内容不影响速度，直接复用测试帧的字节
+        std::vector<unsigned char> source(pixels * 4);
+        for (size_t i = 0; i < source.size(); i++)
+            source[i] = frame[i % frame.size()];
+        std::vector<unsigned char> output(pixels * 4);
+        std::vector<uint8_t> lut(4096);
+        for (size_t i = 0; i < lut.size(); i++)
+            lut[i] = static_cast<uint8_t>(i >> 4);
+        uint8_t *dst = output.data();
+        uint16_t *dst16 = reinterpret_cast<uint16_t *>(output.data());
+
+        auto measure = [&](const char *name, auto &&kernel)
+        {
+            kernel();
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < iterations; i++)
+                kernel();
+            double seconds = secondsSince(start);
+            results.push_back({name, iterations * pixels / seconds / 1e6});
+        };
+
+        measure("packMono12Packed", [&]
+                { PixelConvert::packMono12Packed(mono16, dst, pixels); });
+        measure("mono8ToMono16", [&]
+                { PixelConvert::mono8ToMono16(source.data(), dst16, pixels); });
+        measure("mono16ToMono8", [&]
+                { PixelConvert::mono16ToMono8(mono16, dst, pixels, 4); });
+        measure("mono16ToMono8 (LUT)", [&]
+                { PixelConvert::mono16ToMono8(mono16, dst, pixels, lut.data(), lut.size()); });
+        measure("mono8ToRgba", [&]
+                { PixelConvert::mono8ToRgba(source.data(), dst, pixels); });
+        measure("rgbToRgba", [&]
+                { PixelConvert::rgbToRgba(source.data(), dst, pixels); });
+        measure("rgbaToRgb", [&]
+                { PixelConvert::rgbaToRgb(source.data(), dst, pixels); });
+        measure("rgbToBgr", [&]
+                { PixelConvert::rgbToBgr(source.data(), dst, pixels); });
+        measure("rgbaToBgra", [&]
+                { PixelConvert::rgbaToBgra(source.data(), dst, pixels); });
+        measure("mirror (16 bit)", [&]
+                {
+                    for (int y = 0; y < height; y++)
+                        PixelConvert::mirror(frame.data() + y * width * 2, dst + y * width * 2, width, 2); });
+
+        PixelConvert::setSimdLevel(previous);
+        return results;
+    }
+
+    Benchmarks::HistogramResult Benchmarks::histogram(int sampling, int width, int height, int bitDepth, int sensorBits, size_t threads, int iterations)
+    {
+        HistogramResult result;
+        result.sampling = sampling;
+        result.bitDepth = bitDepth;
+
+        std::vector<unsigned char> frame = makeHdrFrame(width, height, bitDepth, sensorBits);
+        FrameView view(frame.data(), width, height, 1, bitDepth);
+        FrameView sampled = view.decimate(sampling);
+
+        std::unique_ptr<ThreadPool> pool;
+        if (threads > 0)
+            pool = std::make_unique<ThreadPool>(threads);
+        result.threads = threads + 1;
+        HistogramEngine engine(pool.get());
+
+        // 预热一次，同时核对合并成 100 个 bin 后与原实现一致
+        HistogramEngine::Result exact;
+        engine.compute(sampled, exact);
+        if (exact.rebin(100) != legacyHistogram(view, sampling, 100))
+        {
+            Log::error("Histogram benchmark: result mismatch");
+            return result;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+            legacyHistogram(view, sampling, 100);
+        result.legacyMs = secondsSince(start) * 1000.0 / iterations;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+            engine.compute(sampled, exact);
+        result.engineMs = secondsSince(start) * 1000.0 / iterations;
+        return result;
+    }
+
+    Benchmarks::RingResult Benchmarks::ringOverflow(size_t depth, int frames)
+    {
+        RingResult result;
+        FrameRing ring("benchmark", depth, FrameRing::OverflowPolicy::DropOldest);
+        result.depth = ring.depth();
+
+        // 消费者时快时慢，既有队列满的时候，也经常和生产者争同一个单元
+        std::atomic<bool> done{false};
+        std::thread consumer([&]()
+                             {
+            Frame frame;
+            uint32_t n = 0;
+            while (true)
+            {
+                if (ring.tryPop(frame))
+                {
+                    result.delivered++;
+                    if ((++n & 63) == 0)
+                        std::this_thread::yield();
+                }
+                else if (done.load(std::memory_order_acquire))
+                {
+                    // 生产者结束后取完剩下的帧
+                    while (ring.tryPop(frame))
+                        result.delivered++;
+                    break;
+                }
+            } });
+
+        auto start = std::chrono::steady_clock::now();
+        uint64_t dropped = 0;
+        for (int i = 0; i < frames; i++)
+        {
+            ring.push(Frame());
+            uint64_t now = ring.statistics().droppedOldest;
+            result.maxDropsPerPush = std::max(result.maxDropsPerPush, now - dropped);
+            dropped = now;
+        }
+        result.pushesPerSecond = frames / secondsSince(start);
+
+        done.store(true, std::memory_order_release);
+        consumer.join();
+
+        FrameRing::Statistics stats = ring.statistics();
+        result.pushed = stats.pushed;
+        result.dropped = stats.droppedOldest;
+        result.consistent = result.pushed == static_cast<uint64_t>(frames) &&
+                            result.delivered + result.dropped == result.pushed &&
+                            result.maxDropsPerPush <= 1;
+        if (!result.consistent)
+        {
+            Log::error(QString("Ring benchmark: %1 pushed, %2 delivered, %3 dropped, up to %4 dropped by one push")
+                           .arg(result.pushed)
+                           .arg(result.delivered)
+                           .arg(result.dropped)
+                           .arg(result.maxDropsPerPush));
+        }
+        return result;
+    }
+
+    void Benchmarks::runAll()
+    {
+        unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+        Log::info(QString("Benchmarks: %1 hardware threads, codec %2").arg(hardware).arg(FrameCodec::simdName()));
+
+        struct Case
+        {
+            int bitDepth;
+            int sensorBits;
+        };
+        // 单线程，以及用满所有核
+        std::vector<size_t> workerCounts = {0};
+        if (hardware > 1)
+            workerCounts.push_back(hardware - 1);
+
+        for (const Case &c : {Case{16, 12}, Case{16, 16}, Case{8, 8}})
+        {
+            for (size_t workers : workerCounts)
+            {
+                CodecResult r = codec(1920, 1080, c.bitDepth, c.sensorBits, workers);
+                Log::info(QString("Codec %1x%2 %3 bit (%4 bit sensor), %5 threads: ratio %6, encode %7 MB/s, decode %8 MB/s")
+                              .arg(r.width)
+                              .arg(r.height)
+                              .arg(r.bitDepth)
+                              .arg(r.sensorBits)
+                              .arg(r.threads)
+                              .arg(r.ratio, 0, 'f', 2)
+                              .arg(r.encodeMBps, 0, 'f', 0)
+                              .arg(r.decodeMBps, 0, 'f', 0));
+            }
+        }
+
+        // 先确认当前实现与标量参考一致，不一致时 selfTest 已退回标量
+        PixelConvert::selfTest();
+
+        // 海康相机默认 ROI 1024x768，另测 1080p 作参考
+        Log::info(QString("Unpack kernels: %1").arg(PixelConvert::simdName()));
+        for (PixelFormat format : {PixelFormat::Mono10Packed, PixelFormat::Mono12Packed})
+        {
+            for (auto size : {std::pair<int, int>(1024, 768), std::pair<int, int>(1920, 1080)})
+            {
+                UnpackResult r = unpack(format, size.first, size.second);
+                Log::info(QString("Unpack %1 %2x%3: %4 Mpixel/s, %5 frames/s")
+                              .arg(PixelConvert::name(r.format))
+                              .arg(r.width)
+                              .arg(r.height)
+                              .arg(r.megapixelsPerSecond, 0, 'f', 0)
+                              .arg(r.framesPerSecond, 0, 'f', 0));
+            }
+        }
+
+        Log::info(QString("Demosaic kernels: %1").arg(Demosaic::simdName()));
+        for (Demosaic::Method method : {Demosaic::Method::Bilinear, Demosaic::Method::EdgeAware})
+        {
+            for (size_t workers : workerCounts)
+            {
+                DemosaicResult r = demosaic(method, 1920, 1080, workers);
+                Log::info(QString("Demosaic %1 %2x%3, %4 threads: %5 Mpixel/s, %6 frames/s")
+                              .arg(Demosaic::name(r.method))
+                              .arg(r.width)
+                              .arg(r.height)
+                              .arg(r.threads)
+                              .arg(r.megapixelsPerSecond, 0, 'f', 0)
+                              .arg(r.framesPerSecond, 0, 'f', 0));
+            }
+        }
+
+        // 直方图：原实现只有单线程
+        Log::info(QString("Histogram kernels: %1").arg(HistogramEngine::simdName()));
+        for (const Case &c : {Case{16, 12}, Case{16, 16}, Case{8, 8}})
+        {
+            for (int sampling : {1, 4, 16})
+            {
+                for (size_t workers : workerCounts)
+                {
+                    HistogramResult r = histogram(sampling, 1920, 1080, c.bitDepth, c.sensorBits, workers);
+                    Log::info(QString("Histogram 1920x1080 %1 bit (%2 bit sensor), sampling %3, %4 threads: legacy %5 ms, engine %6 ms")
+                                  .arg(r.bitDepth)
+                                  .arg(c.sensorBits)
+                                  .arg(r.sampling)
+                                  .arg(r.threads)
+                                  .arg(r.legacyMs, 0, 'f', 3)
+                                  .arg(r.engineMs, 0, 'f', 3));
+                }
+            }
+        }
+
+        for (size_t depth : {8, 64})
+        {
+            RingResult r = ringOverflow(depth);
+            Log::info(QString("Ring DropOldest depth %1: %2 pushes/s, %3 delivered, %4 dropped, %5")
+                          .arg(r.depth)
+                          .arg(r.pushesPerSecond, 0, 'f', 0)
+                          .arg(r.delivered)
+                          .arg(r.dropped)
+                          .arg(r.consistent ? "counts consistent" : "COUNTS INCONSISTENT"));
+        }
+
+        // 各实现逐个对比，CPU 不支持的跳过
+        using Level = PixelConvert::SimdLevel;
+        for (Level level : {Level::Scalar, Level::SSE2, Level::AVX2, Level::NEON})
+        {
+            for (const ConvertResult &r : convert(level, 1920, 1080))
+            {
+                Log::info(QString("Convert %1 %2: %3 Mpixel/s")
+                              .arg(PixelConvert::name(level))
+                              .arg(r.name)
+                              .arg(r.megapixelsPerSecond, 0, 'f', 0));
+            }
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "Demosaic.h"
+#include "PixelConvert.h"
+
+namespace lzx
+{
+    // 性能基准：在有代表性的合成 HDR 帧上测量各处理环节的吞吐，结果写入日志，
+    // 用于对比不同机器和不同实现，readme 里的数字由这里得到
+    class Benchmarks
+    {
+    public:
+        // 单色 HDR 测试帧（紧密排列）：暗背景 + 读出噪声 + 若干高斯亮斑，最亮处饱和。
+        // sensorBits 为传感器有效位数，数据左对齐到 bitDepth（如 12 位传感器输出 RAW16）
+        static std::vector<unsigned char> makeHdrFrame(int width, int height, int bitDepth, int sensorBits, uint32_t seed = 1);
+
+        struct CodecResult
+        {
+            int width = 0;
+            int height = 0;
+            int bitDepth = 0;
+            int sensorBits = 0;
+            size_t threads = 0;     // 参与编码的线程数（含调用线程）
+            double ratio = 0.0;     // 原始字节数 / 编码后字节数
+            double encodeMBps = 0.0; // 按原始字节数计
+            double decodeMBps = 0.0;
+        };
+
+        // threads 为工作线程数（调用线程之外），0 表示只用调用线程
+        static CodecResult codec(int width, int height, int bitDepth, int sensorBits, size_t threads, int iterations = 20);
+
+        struct UnpackResult
+        {
+            PixelFormat format = PixelFormat::Mono12Packed;
+            int width = 0;
+            int height = 0;
+            double megapixelsPerSecond = 0.0;
+            double framesPerSecond = 0.0; // 单线程每秒能解包的整帧数
+        };
+
+        // 打包格式解包成 16 位帧的吞吐（单线程）
+        static UnpackResult unpack(PixelFormat format, int width, int height, int iterations = 200);
+
+        struct DemosaicResult
+        {
+            Demosaic::Method method = Demosaic::Method::Bilinear;
+            int width = 0;
+            int height = 0;
+            size_t threads = 0; // 含调用线程
+            double megapixelsPerSecond = 0.0;
+            double framesPerSecond = 0.0;
+        };
+
+        // 16 位 Bayer 帧插值成 RGB 的吞吐，threads 为工作线程数（调用线程之外）
+        static DemosaicResult demosaic(Demosaic::Method method, int width, int height, size_t threads, int iterations = 20);
+
+        struct ConvertResult
+        {
+            const char *name = "";
+            double megapixelsPerSecond = 0.0;
+        };
+
+        // 各像素转换内核在指定实现下的吞吐（单线程），CPU 不支持该实现时返回空
+        static std::vector<ConvertResult> convert(PixelConvert::SimdLevel level, int width, int height, int iterations = 100);
+
+        struct HistogramResult
+        {
+            int sampling = 1; // 行列抽样步长
+            int bitDepth = 0;
+            size_t threads = 0;   // 含调用线程
+            double legacyMs = 0.0; // 原来在界面线程上的逐像素浮点除法实现，每帧耗时
+            double engineMs = 0.0; // HistogramEngine 每帧耗时（含合并和统计）
+        };
+
+        // 单色测试帧的直方图耗时，threads 为工作线程数（调用线程之外）
+        static HistogramResult histogram(int sampling, int width, int height, int bitDepth, int sensorBits, size_t threads, int iterations = 50);
+
+        struct RingResult
+        {
+            size_t depth = 0;
+            uint64_t pushed = 0;          // 生产者入队的帧数
+            uint64_t delivered = 0;       // 消费者取走的帧数
+            uint64_t dropped = 0;         // DropOldest 挤掉的帧数
+            uint64_t maxDropsPerPush = 0; // 单次入队挤掉的最多帧数，应不超过 1
+            double pushesPerSecond = 0.0;
+            bool consistent = false;      // 取走 + 挤掉 = 入队，且单次入队最多挤掉一帧
+        };
+
+        // DropOldest 队列在消费者并发出队、频繁溢出时的吞吐，同时核对丢帧计数
+        static RingResult ringOverflow(size_t depth, int frames = 200000);
+
+        // 运行全部基准，耗时数秒，不要在界面线程调用
+        static void runAll();
+    };
+}
+
+#endif
@@ -0,0 +1,145 @@
+#include "CameraCommandQueue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <QString>
+
+#include "logwidget.hpp"
+
+namespace lzx
+{
+    CameraCommandQueue::CameraCommandQueue(const std::string &name)
+        : m_name(name)
+    {
+        m_thread = std::thread(&CameraCommandQueue::commandFunction, this);
+    }
+
+    CameraCommandQueue::~CameraCommandQueue()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        m_thread.join();
+
+        if (m_stats.executed > 0)
+        {
+            Log::info(QString("Camera commands [%1]: executed %2 coalesced %3 failed %4 max %5 ms")
+                          .arg(QString::fromStdString(m_name))
+                          .arg(m_stats.executed)
+                          .arg(m_stats.coalesced)
+                          .arg(m_stats.failed)
+                          .arg(m_stats.maxDurationMs, 0, 'f', 1));
+        }
+    }
+
+    std::shared_future<bool> CameraCommandQueue::submit(const std::string &name, std::function<bool()> work, Callback done)
+    {
+        return enqueue(name, false, std::move(work), std::move(done));
+    }
+
+    std::shared_future<bool> CameraCommandQueue::submitCoalesced(const std::string &key, std::function<bool()> work, Callback done)
+    {
+        return enqueue(key, true, std::move(work), std::move(done));
+    }
+
+    std::shared_future<bool> CameraCommandQueue::enqueue(const std::string &name, bool coalescable, std::function<bool()> work, Callback done)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (coalescable)
+        {
+            // 只替换还在排队的命令，保持它在队列中的位置，前后其他命令的顺序不变
+            auto it = std::find_if(m_commands.begin(), m_commands.end(), [&name](const std::shared_ptr<Command> &command)
+                                   { return command->coalescable && command->name == name; });
+            if (it != m_commands.end())
+            {
+                (*it)->work = std::move(work);
+                (*it)->done = std::move(done);
+                ++m_stats.coalesced;
+                return (*it)->future;
+            }
+        }
+
+        auto command = std::make_shared<Command>();
+        command->name = name;
+        command->coalescable = coalescable;
+        command->work = std::move(work);
+        command->done = std::move(done);
+        command->future = command->promise.get_future().share();
+        m_commands.push_back(command);
+
+        m_wake.notify_one();
+        return command->future;
+    }
+
+    void CameraCommandQueue::drain()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [this]()
+                    { return m_commands.empty() && !m_busy; });
+    }
+
+    size_t CameraCommandQueue::pending() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_commands.size() + (m_busy ? 1 : 0);
+    }
+
+    CameraCommandQueue::Statistics CameraCommandQueue::statistics() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    void CameraCommandQueue::commandFunction()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_wake.wait(lock, [this]()
+                        { return m_stop || !m_commands.empty(); });
+
+            // 退出前执行完剩余的命令，关闭相机之类的命令不能丢
+            if (m_commands.empty())
+            {
+                break;
+            }
+
+            std::shared_ptr<Command> command = m_commands.front();
+            m_commands.pop_front();
+            m_busy = true;
+            lock.unlock();
+
+            auto start = std::chrono::steady_clock::now();
+            bool ok = command->work();
+            double durationMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            if (durationMs > SlowCommandMs)
+            {
+                Log::warn(QString("Camera command [%1] %2 took %3 ms")
+                              .arg(QString::fromStdString(m_name))
+                              .arg(QString::fromStdString(command->name))
+                              .arg(durationMs, 0, 'f', 0));
+            }
+
+            command->promise.set_value(ok);
+            if (command->done)
+            {
+                command->done(ok);
+            }
+
+            lock.lock();
+            m_busy = false;
+            ++m_stats.executed;
+            if (!ok)
+                ++m_stats.failed;
+            m_stats.maxDurationMs = std::max(m_stats.maxDurationMs, durationMs);
+            if (m_commands.empty())
+            {
+                m_idle.notify_all();
+            }
+        }
+    }
+}
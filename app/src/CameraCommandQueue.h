@@ -0,0 +1,80 @@
+#ifndef CAMERA_COMMAND_QUEUE_H
+#define CAMERA_COMMAND_QUEUE_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <cstdint>
+
+namespace lzx
+{
+    // 相机命令线程：打开/关闭、开始/停止取流、写参数等会阻塞在 SDK 里的调用按提交顺序在这个线程上执行，
+    // 界面线程提交后立即返回。每个命令返回一个 future，也可以附带完成回调（在命令线程上调用，
+    // 需要更新界面时由回调自己转回界面线程）。
+    // submitCoalesced 用于滑块之类的连续修改：同一个 key 的命令还没开始执行时只替换它的内容，
+    // 不重复排队，调用方拿到的是同一个 future。
+    class CameraCommandQueue
+    {
+    public:
+        using Callback = std::function<void(bool ok)>;
+
+        struct Statistics
+        {
+            uint64_t executed = 0;
+            uint64_t coalesced = 0; // 被后一次同 key 提交替换掉的命令
+            uint64_t failed = 0;    // 返回 false 的命令
+            double maxDurationMs = 0.0;
+        };
+
+        static constexpr double SlowCommandMs = 200.0; // 超过这个耗时的命令输出警告
+
+        explicit CameraCommandQueue(const std::string &name);
+
+        // 析构时执行完已提交的命令再退出
+        ~CameraCommandQueue();
+
+        std::shared_future<bool> submit(const std::string &name, std::function<bool()> work, Callback done = nullptr);
+        std::shared_future<bool> submitCoalesced(const std::string &key, std::function<bool()> work, Callback done = nullptr);
+
+        // 等待已提交的命令全部执行完（不能在命令线程上调用）
+        void drain();
+
+        size_t pending() const;
+        Statistics statistics() const;
+
+    private:
+        CameraCommandQueue(const CameraCommandQueue &) = delete;
+        CameraCommandQueue &operator=(const CameraCommandQueue &) = delete;
+
+        struct Command
+        {
+            std::string name;
+            bool coalescable = false;
+            std::function<bool()> work;
+            Callback done;
+            std::promise<bool> promise;
+            std::shared_future<bool> future;
+        };
+
+        std::shared_future<bool> enqueue(const std::string &name, bool coalescable, std::function<bool()> work, Callback done);
+        void commandFunction();
+
+        std::string m_name;
+        std::thread m_thread;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake; // 新命令或退出
+        std::condition_variable m_idle; // 队列清空且没有命令在执行
+        std::deque<std::shared_ptr<Command>> m_commands;
+        bool m_busy = false;
+        bool m_stop = false;
+        Statistics m_stats;
+    };
+}
+
+#endif
@@ -21,6 +21,7 @@ CameraControllerBar::~CameraControllerBar()
     disconnect(m_streamButton, nullptr, this, nullptr);
     disconnect(m_captureButton, nullptr, this, nullptr);
     disconnect(m_recordingButton, nullptr, this, nullptr);
+    disconnect(m_autoExposureButton, nullptr, this, nullptr);
     disconnect(m_exposureSpinBox, nullptr, this, nullptr);
     disconnect(m_gainSpinBox, nullptr, this, nullptr);
 
@@ -45,6 +46,7 @@ CameraControllerBar::~CameraControllerBar()
     m_captureButton = nullptr;
     m_recordingButton = nullptr;
     m_lutButton = nullptr;
+    m_autoExposureButton = nullptr;
     m_exposureSpinBox = nullptr;
     m_gainSpinBox = nullptr;
     m_fpsLabel = nullptr;
@@ -67,6 +69,8 @@ void CameraControllerBar::setupUI()
     m_captureButton = createButton(":/icons8_unsplash.svg", tr("Capture frame"));
     m_recordingButton = createButton(":/icons8_not_record.svg", tr("Start/Stop recording"));
     m_lutButton = createButton(":/icons8_histogram.svg", tr("Open LUT editor"));
+    m_autoExposureButton = createButton(":/icons8_camera_automation.svg", tr("Auto exposure"));
+    m_autoExposureButton->setCheckable(true);
 
     m_exposureSpinBox = new QSpinBox(this);
     m_exposureSpinBox->setPrefix("Exp: ");
@@ -96,6 +100,7 @@ void CameraControllerBar::setupUI()
     m_layout->addWidget(m_captureButton);
     m_layout->addWidget(m_recordingButton);
     m_layout->addWidget(m_lutButton);
+    m_layout->addWidget(m_autoExposureButton);
     m_layout->addWidget(m_exposureSpinBox);
     m_layout->addWidget(m_gainSpinBox);
     m_layout->addWidget(m_fpsLabel);
@@ -105,6 +110,7 @@ void CameraControllerBar::setupUI()
     m_captureButton->setEnabled(false);
     m_recordingButton->setEnabled(false);
     m_lutButton->setEnabled(false);
+    m_autoExposureButton->setEnabled(false);
     m_exposureSpinBox->setEnabled(false);
     m_gainSpinBox->setEnabled(false);
 
@@ -126,7 +132,14 @@ QPushButton *CameraControllerBar::createButton(const QString &iconPath, const QS
 
 void CameraControllerBar::onRecordClicked()
 {
-    m_isRecording = !m_isRecording;
+    setRecording(!m_isRecording);
+
+    emit recordingClicked(m_isRecording);
+}
+
+void CameraControllerBar::setRecording(bool recording)
+{
+    m_isRecording = recording;
 
     if (m_isRecording)
     {
@@ -136,8 +149,6 @@ void CameraControllerBar::onRecordClicked()
     {
         m_recordingButton->setIcon(QIcon(":/icons8_not_record.svg"));
     }
-
-    emit recordingClicked(m_isRecording);
 }
 
 void CameraControllerBar::createConnections()
@@ -155,6 +166,13 @@ void CameraControllerBar::createConnections()
     connect(m_exposureSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
             this, &CameraControllerBar::exposureChanged);
 
+    // 自动曝光期间曝光框只显示控制器写入的值
+    connect(m_autoExposureButton, &QPushButton::toggled, this, [this](bool checked)
+            {
+                m_isAutoExposure = checked;
+                m_exposureSpinBox->setEnabled(m_isConnected && !m_isAutoExposure);
+                emit autoExposureToggled(checked); });
+
     connect(m_gainSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
             this, &CameraControllerBar::gainChanged);
 
@@ -176,6 +194,12 @@ void CameraControllerBar::createConnections()
     // 对 m_lutPopupWindow的 lutChanged 信号进转发
     connect(m_lutPopupWindow, &LutPopupWindow::lutChanged, this, [this](double min, double max, double gamma)
             { emit lutChanged(min, max, gamma); });
+    connect(m_lutPopupWindow, &LutPopupWindow::autoRangeToggled, this, &CameraControllerBar::autoRangeToggled);
+}
+
+void CameraControllerBar::onAutoRangeChanged(double min, double max)
+{
+    m_lutPopupWindow->setDisplayRange(min, max);
 }
 
 void CameraControllerBar::onFPSUpdated(double fps)
@@ -203,7 +227,8 @@ void CameraControllerBar::onCameraStatusChanged(QString status, QString value)
         m_captureButton->setEnabled(m_isConnected);
         m_recordingButton->setEnabled(m_isConnected);
         m_lutButton->setEnabled(m_isConnected);
-        m_exposureSpinBox->setEnabled(m_isConnected);
+        m_autoExposureButton->setEnabled(m_isConnected);
+        m_exposureSpinBox->setEnabled(m_isConnected && !m_isAutoExposure);
         m_gainSpinBox->setEnabled(m_isConnected);
     }
 
@@ -237,9 +262,9 @@ void CameraControllerBar::onCameraStatusChanged(QString status, QString value)
     }
 }
 
-void CameraControllerBar::onHistogramUpdated(const std::vector<int> &histogram, int maxValue)
+void CameraControllerBar::setHistogramChannel(std::shared_ptr<lzx::HistogramChannel> channel)
 {
-    m_lutPopupWindow->updateHistogram(histogram, maxValue);
+    m_lutPopupWindow->setHistogramChannel(std::move(channel));
 }
 
 void CameraControllerBar::paintEvent(QPaintEvent *event)
@@ -289,11 +314,17 @@ LutPopupWindow::LutPopupWindow(QWidget *parent)
     // 对 m_mappingWidget的 lutChanged 信号进转发
     connect(m_mappingWidget, &GrayMappingWidget::lutChanged, this, [this](double min, double max, double gamma)
             { emit lutChanged(min, max, gamma); });
+    connect(m_mappingWidget, &GrayMappingWidget::autoRangeToggled, this, &LutPopupWindow::autoRangeToggled);
+}
+
+void LutPopupWindow::setHistogramChannel(std::shared_ptr<lzx::HistogramChannel> channel)
+{
+    m_mappingWidget->setHistogramChannel(std::move(channel));
 }
 
-void LutPopupWindow::updateHistogram(const std::vector<int> &histogram, int maxValue)
+void LutPopupWindow::setDisplayRange(double min, double max)
 {
-    m_mappingWidget->setHistogram(histogram, maxValue);
+    m_mappingWidget->setDisplayRange(min, max);
 }
 
 void LutPopupWindow::mousePressEvent(QMouseEvent *event)
@@ -7,6 +7,7 @@
 #include <QHBoxLayout>
 #include <QSpinBox>
 #include "GrayMappingWidget.h"
+#include "HistogramChannel.h"
 
 // LUT编辑器弹窗
 class LutPopupWindow : public QWidget
@@ -15,11 +16,13 @@ class LutPopupWindow : public QWidget
 public:
     explicit LutPopupWindow(QWidget *parent = nullptr);
 
-    void updateHistogram(const std::vector<int> &histogram, int maxValue);
+    void setHistogramChannel(std::shared_ptr<lzx::HistogramChannel> channel);
+    void setDisplayRange(double min, double max);
 
 signals:
     void visibilityChanged(bool visible);
     void lutChanged(double min, double max, double gamma);
+    void autoRangeToggled(bool enabled);
 
 protected:
     void mousePressEvent(QMouseEvent *event) override;
@@ -48,10 +51,14 @@ public:
     explicit CameraControllerBar(QWidget *parent = nullptr);
     ~CameraControllerBar();
 
+    // 灰度映射弹窗显示期间从这里拉取直方图
+    void setHistogramChannel(std::shared_ptr<lzx::HistogramChannel> channel);
+
 public slots:
     void onCameraStatusChanged(QString status, QString value);
-    void onHistogramUpdated(const std::vector<int> &histogram, int maxValue);
     void onFPSUpdated(double fps);
+    void onAutoRangeChanged(double min, double max);
+    void setRecording(bool recording); // 只更新按钮状态，不发出 recordingClicked（录制启动失败时复位）
 
 signals:
     void connectClicked(bool connect);
@@ -62,6 +69,8 @@ signals:
     void gainChanged(int value);
     void requestHistogram(bool enable);
     void lutChanged(double min, double max, double gamma);
+    void autoRangeToggled(bool enabled);
+    void autoExposureToggled(bool enabled);
 
 protected:
     void paintEvent(QPaintEvent *event) override;
@@ -73,6 +82,7 @@ private:
     QPushButton *m_captureButton;
     QPushButton *m_recordingButton;
     QPushButton *m_lutButton;
+    QPushButton *m_autoExposureButton;
     QSpinBox *m_exposureSpinBox;
     QSpinBox *m_gainSpinBox;
 
@@ -95,6 +105,7 @@ private:
     bool m_isConnected = false;
     bool m_isStreaming = false;
     bool m_isRecording = false;
+    bool m_isAutoExposure = false;
 };
 
 #endif // CAMERACONTROLLERBAR_H
\ No newline at end of file
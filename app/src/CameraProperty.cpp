@@ -0,0 +1,258 @@
+#include "CameraProperty.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace lzx
+{
+    const char *PropertyRegistry::name(PropertyId id)
+    {
+        switch (id)
+        {
+        case PropertyId::ExposureTime:
+            return "ExposureTime";
+        case PropertyId::Gain:
+            return "Gain";
+        case PropertyId::OffsetX:
+            return "OffsetX";
+        case PropertyId::OffsetY:
+            return "OffsetY";
+        case PropertyId::Width:
+            return "Width";
+        case PropertyId::Height:
+            return "Height";
+        default:
+            return "Unknown";
+        }
+    }
+
+    bool PropertyRegistry::parse(const std::string &text, PropertyId &id)
+    {
+        if (text == "exposure")
+        {
+            id = PropertyId::ExposureTime;
+            return true;
+        }
+        if (text == "gain")
+        {
+            id = PropertyId::Gain;
+            return true;
+        }
+
+        for (size_t i = 0; i < Count; ++i)
+        {
+            if (text == name(static_cast<PropertyId>(i)))
+            {
+                id = static_cast<PropertyId>(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void PropertyRegistry::clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_properties.fill(PropertyInfo());
+    }
+
+    void PropertyRegistry::define(PropertyId id, double min, double max, double increment, double value, bool writable)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        PropertyInfo &info = m_properties[index(id)];
+        info.available = true;
+        info.writable = writable;
+        info.min = min;
+        info.max = max;
+        info.increment = increment;
+        info.defaultValue = value;
+        info.value = value;
+    }
+
+    void PropertyRegistry::setRange(PropertyId id, double min, double max)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_properties[index(id)].min = min;
+        m_properties[index(id)].max = max;
+    }
+
+    void PropertyRegistry::update(PropertyId id, double value)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_properties[index(id)].value = value;
+    }
+
+    PropertyInfo PropertyRegistry::info(PropertyId id) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_properties[index(id)];
+    }
+
+    double PropertyRegistry::clamp(PropertyId id, double value) const
+    {
+        PropertyInfo property = info(id);
+        if (!property.available)
+            return value;
+
+        value = std::min(std::max(value, property.min), property.max);
+        if (property.increment > 0.0)
+        {
+            // 从最小值起按步长对齐，向下取整不会超过最大值
+            value = property.min + std::floor((value - property.min) / property.increment + 1e-9) * property.increment;
+        }
+        return value;
+    }
+
+    ParameterTransaction &ParameterTransaction::set(PropertyId id, double value)
+    {
+        for (auto &change : m_changes)
+        {
+            if (change.first == id)
+            {
+                change.second = value;
+                return *this;
+            }
+        }
+        m_changes.emplace_back(id, value);
+        return *this;
+    }
+
+    ParameterTransaction &ParameterTransaction::setRoi(int x, int y, int width, int height)
+    {
+        set(PropertyId::OffsetX, x);
+        set(PropertyId::OffsetY, y);
+        set(PropertyId::Width, width);
+        return set(PropertyId::Height, height);
+    }
+
+    void ParameterTransaction::merge(const ParameterTransaction &other)
+    {
+        for (const auto &change : other.m_changes)
+        {
+            set(change.first, change.second);
+        }
+    }
+
+    bool ParameterTransaction::has(PropertyId id) const
+    {
+        return std::any_of(m_changes.begin(), m_changes.end(), [id](const std::pair<PropertyId, double> &change)
+                           { return change.first == id; });
+    }
+
+    double ParameterTransaction::value(PropertyId id, double fallback) const
+    {
+        for (const auto &change : m_changes)
+        {
+            if (change.first == id)
+                return change.second;
+        }
+        return fallback;
+    }
+
+    bool ParameterTransaction::changesGeometry() const
+    {
+        return has(PropertyId::OffsetX) || has(PropertyId::OffsetY) || has(PropertyId::Width) || has(PropertyId::Height);
+    }
+
+    uint64_t ParameterEpoch::allocate()
+    {
+        return m_next.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    void ParameterEpoch::applied(uint64_t epoch, const ParameterTransaction &target, int64_t appliedNs, double previousExposureUs)
+    {
+        if (epoch <= m_current.load(std::memory_order_relaxed))
+            return;
+
+        // 上一组还没确认时，正在曝光的帧可能按其中任何一组参数拍摄
+        if (!m_pending)
+        {
+            m_previousExposureUs = previousExposureUs;
+            m_settleExposureUs = 0.0;
+        }
+        m_settleExposureUs = std::max({m_settleExposureUs, previousExposureUs, target.value(PropertyId::ExposureTime)});
+
+        m_pending = true;
+        m_pendingEpoch = epoch;
+        m_target = target;
+        m_appliedNs = appliedNs;
+        m_settleFrames = 0;
+    }
+
+    bool ParameterEpoch::confirmed(const FrameMetadata &metadata, int width, int height) const
+    {
+        if (m_target.has(PropertyId::Width) && width != static_cast<int>(m_target.value(PropertyId::Width)))
+            return false;
+        if (m_target.has(PropertyId::Height) && height != static_cast<int>(m_target.value(PropertyId::Height)))
+            return false;
+
+        // 没有帧信息（曝光为 0）时也只能按时间判断；缩短曝光时按旧曝光算，否则旧设置下拍的最后一帧会被当成新参数
+        if (m_confirm == Confirm::Timing || metadata.exposureUs <= 0.0)
+        {
+            int64_t exposureNs = static_cast<int64_t>(std::max(m_settleExposureUs, metadata.exposureUs) * 1000.0);
+            return metadata.hostTimestampNs - exposureNs >= m_appliedNs;
+        }
+
+        // 相机按步长取整，允许少量误差
+        if (m_target.has(PropertyId::ExposureTime))
+        {
+            double target = m_target.value(PropertyId::ExposureTime);
+            if (std::fabs(metadata.exposureUs - target) > std::max(2.0, target * 0.005))
+                return false;
+        }
+        if (m_target.has(PropertyId::Gain) && std::fabs(metadata.gain - m_target.value(PropertyId::Gain)) > 0.05)
+            return false;
+        return true;
+    }
+
+    uint64_t ParameterEpoch::tag(FrameMetadata &metadata, int width, int height)
+    {
+        if (m_pending)
+        {
+            ++m_settleFrames;
+            if (confirmed(metadata, width, height) || m_settleFrames > MaxSettleFrames)
+            {
+                m_current.store(m_pendingEpoch, std::memory_order_release);
+                m_pending = false;
+            }
+            else if (m_confirm == Confirm::Timing && m_previousExposureUs > 0.0)
+            {
+                metadata.exposureUs = m_previousExposureUs;
+            }
+        }
+        return m_current.load(std::memory_order_relaxed);
+    }
+
+    void ParameterEpoch::reset()
+    {
+        m_pending = false;
+        m_current.store(m_next.load(std::memory_order_relaxed), std::memory_order_release);
+    }
+
+    void ParameterQueue::push(uint64_t epoch, const ParameterTransaction &transaction)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_pending.merge(transaction);
+        m_epoch = std::max(m_epoch, epoch);
+        m_hasPending = true;
+    }
+
+    bool ParameterQueue::take(ParameterTransaction &transaction, uint64_t &epoch)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_hasPending)
+            return false;
+
+        transaction = std::move(m_pending);
+        epoch = m_epoch;
+        m_pending = ParameterTransaction();
+        m_hasPending = false;
+        return true;
+    }
+
+    bool ParameterQueue::empty() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return !m_hasPending;
+    }
+}
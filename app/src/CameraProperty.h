@@ -0,0 +1,164 @@
+#ifndef CAMERA_PROPERTY_H
+#define CAMERA_PROPERTY_H
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <cstdint>
+
+#include "Frame.h"
+
+namespace lzx
+{
+    // 相机参数的类型化句柄，取代按字符串比较分发
+    enum class PropertyId
+    {
+        ExposureTime, // us
+        Gain,
+        OffsetX,
+        OffsetY,
+        Width,
+        Height,
+        Count
+    };
+
+    struct PropertyInfo
+    {
+        bool available = false; // 相机支持这个参数
+        bool writable = false;
+        double min = 0.0;
+        double max = 0.0;
+        double increment = 0.0; // 0 表示连续
+        double defaultValue = 0.0;
+        double value = 0.0; // 最近一次读到或写入成功的值
+    };
+
+    // 参数表：相机打开时查询一次范围、步长和默认值，之后读取参数、检查范围都不再调用 SDK
+    // 采集线程应用参数后更新当前值，界面线程读取，内部加锁
+    class PropertyRegistry
+    {
+    public:
+        static constexpr size_t Count = static_cast<size_t>(PropertyId::Count);
+
+        static const char *name(PropertyId id);
+
+        // 识别参数名，兼容界面上的小写别名（exposure / gain）
+        static bool parse(const std::string &text, PropertyId &id);
+
+        void clear();
+        void define(PropertyId id, double min, double max, double increment, double value, bool writable = true);
+        void setRange(PropertyId id, double min, double max);
+        void update(PropertyId id, double value);
+
+        PropertyInfo info(PropertyId id) const;
+        bool available(PropertyId id) const { return info(id).available; }
+        double value(PropertyId id) const { return info(id).value; }
+
+        // 限制到范围内并对齐到步长；参数不可用时原样返回
+        double clamp(PropertyId id, double value) const;
+
+    private:
+        static size_t index(PropertyId id) { return static_cast<size_t>(id); }
+
+        std::array<PropertyInfo, Count> m_properties;
+        mutable std::mutex m_mutex;
+    };
+
+    // 一组一起生效的参数修改，同一参数多次设置时以最后一次为准
+    class ParameterTransaction
+    {
+    public:
+        ParameterTransaction &set(PropertyId id, double value);
+        ParameterTransaction &setExposure(double exposureUs) { return set(PropertyId::ExposureTime, exposureUs); }
+        ParameterTransaction &setGain(double gain) { return set(PropertyId::Gain, gain); }
+        ParameterTransaction &setRoi(int x, int y, int width, int height);
+
+        // 后一组覆盖前一组中相同的参数
+        void merge(const ParameterTransaction &other);
+
+        bool has(PropertyId id) const;
+        double value(PropertyId id, double fallback = 0.0) const;
+        bool empty() const { return m_changes.empty(); }
+
+        // 修改 ROI 时相机需要先停止取流
+        bool changesGeometry() const;
+
+        const std::vector<std::pair<PropertyId, double>> &changes() const { return m_changes; }
+
+    private:
+        std::vector<std::pair<PropertyId, double>> m_changes;
+    };
+
+    // 参数组编号：每次提交分配新编号，等到确认新参数已生效的第一帧才切换，过渡期间的帧仍带旧编号，
+    // 处理端比较 FrameMetadata::parameterEpoch 就能丢掉过渡帧。
+    // 提交后还没生效时又提交了新的一组，中间那组不会出现在任何帧上。
+    class ParameterEpoch
+    {
+    public:
+        enum class Confirm
+        {
+            Reported, // 帧信息带实际生效的曝光和增益（海康），与目标一致即确认，帧信息为空时退回按时间判断
+            Timing    // 只能按时间判断（PlayerOne）：新旧曝光中较长的一个也晚于应用完成才开始的帧才算新参数
+        };
+
+        static constexpr int MaxSettleFrames = 8; // 超过这么多帧仍未确认时直接切换，避免永远停在旧编号
+
+        explicit ParameterEpoch(Confirm confirm) : m_confirm(confirm) {}
+
+        // 分配一个新编号（提交时调用，可以在任意线程）
+        uint64_t allocate();
+
+        // 采集线程成功应用一组参数后调用（写入失败时不调用，帧保持旧编号）；
+        // target 为实际写入相机的值，previousExposureUs 为写入前生效的曝光，0 表示未知
+        void applied(uint64_t epoch, const ParameterTransaction &target, int64_t appliedNs, double previousExposureUs = 0.0);
+
+        // 采集线程给每一帧打编号，返回这一帧的参数组编号；
+        // Timing 模式下还没确认的帧把曝光改回写入前的值（帧信息里的曝光是采集线程填的当前设置）
+        uint64_t tag(FrameMetadata &metadata, int width, int height);
+
+        // 最近一帧的参数组编号
+        uint64_t current() const { return m_current.load(std::memory_order_acquire); }
+
+        // 取流开始时调用：之前提交的参数都已生效
+        void reset();
+
+    private:
+        bool confirmed(const FrameMetadata &metadata, int width, int height) const;
+
+        Confirm m_confirm;
+        std::atomic<uint64_t> m_next{0};
+        std::atomic<uint64_t> m_current{0};
+
+        // 仅采集线程访问
+        bool m_pending = false;
+        uint64_t m_pendingEpoch = 0;
+        ParameterTransaction m_target;
+        int64_t m_appliedNs = 0;
+        int m_settleFrames = 0;
+        double m_previousExposureUs = 0.0; // 最后确认的一组参数的曝光，过渡帧按它标注
+        double m_settleExposureUs = 0.0;   // 过渡期间可能在曝光的最长时间
+    };
+
+    // 提交给采集线程的参数队列：采集线程在两帧之间取出，多组合并成一组一次应用
+    class ParameterQueue
+    {
+    public:
+        void push(uint64_t epoch, const ParameterTransaction &transaction);
+
+        // 取出所有待应用的修改，epoch 为其中最新的编号
+        bool take(ParameterTransaction &transaction, uint64_t &epoch);
+
+        bool empty() const;
+
+    private:
+        mutable std::mutex m_mutex;
+        ParameterTransaction m_pending;
+        uint64_t m_epoch = 0;
+        bool m_hasPending = false;
+    };
+}
+
+#endif
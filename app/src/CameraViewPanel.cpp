@@ -3,8 +3,10 @@
 
 #include "DummyTestCamera.h"
 #include "PlayerOne.hpp"
+#include "ReplayCamera.h"
 #include "USBCamera.hpp"
 
+#include "Global.hpp"
 #include "Settings.hpp"
 
 #include "logwidget.hpp"
@@ -17,7 +19,9 @@ CameraViewPanel::CameraViewPanel(QString desc, QWidget *parent, bool isReference
       m_controlBar(nullptr),
       m_camera(nullptr),
       m_isStreaming(false),
-      m_isReference(isReference)
+      m_isReference(isReference),
+      m_rawRecorder(std::make_unique<lzx::RawRecorder>()),
+      m_commands(std::make_unique<lzx::CameraCommandQueue>(desc.toStdString()))
 {
     setupUI();
     createConnections();
@@ -33,10 +37,26 @@ CameraViewPanel::CameraViewPanel(QString desc, QWidget *parent, bool isReference
     else if (m_desc == "PlayerOne")
     {
         m_camera = new PlayerOne();
+        m_camera->set("Demosaic", Settings::getInstance().getDemosaicMethod().toStdString());
     }
     else if (m_desc == "MVS")
     {
         m_camera = new USBCamera("Hikvision");
+        m_camera->set("PixelFormat", Settings::getInstance().getHikPixelFormat().toStdString());
+    }
+    else if (m_desc == "Replay")
+    {
+        // 作为参考相机时发布到全局总线，Mask 窗口和配对从这里取帧
+        Settings &settings = Settings::getInstance();
+        auto replay = new lzx::ReplayCamera(settings.getReplayFile().toStdString(),
+                                            settings.getReplayWidth(),
+                                            settings.getReplayHeight(),
+                                            settings.getReplayBitDepth(),
+                                            m_isReference ? GlobalResourceManager::getInstance().frameBus.get() : nullptr);
+        replay->set("Pacing", settings.getReplayPacing().toStdString());
+        replay->set("FrameRate", settings.getReplayFrameRate());
+        replay->set("Loop", settings.isReplayLoop());
+        m_camera = replay;
     }
 
     // 设置状态回调
@@ -55,22 +75,35 @@ CameraViewPanel::CameraViewPanel(QString desc, QWidget *parent, bool isReference
 
 CameraViewPanel::~CameraViewPanel()
 {
-    if (m_camera)
-    {
-        m_camera->stop();
-        m_camera->close();
-    }
+    shutdownCamera();
+
+    // 命令线程的回调会投递到本对象，先让线程退出
+    m_commands.reset();
 }
 
 void CameraViewPanel::setCamera(lzx::ICamera *camera)
 {
+    shutdownCamera();
+
+    m_camera = camera;
+}
+
+void CameraViewPanel::shutdownCamera()
+{
+    m_rawRecorder->stop();
+    m_pairing.reset();
+    m_autoExposure.reset();
+
     if (m_camera)
     {
-        m_camera->stop();
-        m_camera->close();
+        lzx::ICamera *camera = m_camera;
+        m_commands->submit("stop", [camera]()
+                           { return camera->stop(); });
+        m_commands->submit("close", [camera]()
+                           { return camera->close(); });
+        m_commands->drain();
     }
-
-    m_camera = camera;
+    m_isStreaming = false;
 }
 
 void CameraViewPanel::onConnectClicked(bool connect)
@@ -78,13 +111,17 @@ void CameraViewPanel::onConnectClicked(bool connect)
     if (!m_camera)
         return;
 
+    // 打开相机可能要枚举设备、读写大量参数，放到命令线程；结果通过状态回调通知控制栏
+    lzx::ICamera *camera = m_camera;
     if (connect)
     {
-        m_camera->open();
+        m_commands->submit("open", [camera]()
+                           { return camera->open(); });
     }
     else
     {
-        m_camera->close();
+        m_commands->submit("close", [camera]()
+                           { return camera->close(); });
     }
 }
 
@@ -93,18 +130,38 @@ void CameraViewPanel::onStreamClicked(bool stream)
     if (!m_camera)
         return;
 
+    lzx::ICamera *camera = m_camera;
     if (m_isStreaming)
     {
-        m_camera->stop();
+        m_isStreaming = false;
+        m_pairing.reset();
+        m_autoExposure.reset(); // 停止取流前退出控制线程，不再向相机提交曝光
         m_frameRenderer->onEnableUpdate(false);
+        m_commands->submit("stop", [camera]()
+                           { return camera->stop(); });
     }
     else
     {
-        m_camera->start();
-        m_frameRenderer->onEnableUpdate(true);
+        // 先按成功处理，取流真正开始后再打开刷新和配对；期间再次点击的停止命令排在开始之后
+        m_isStreaming = true;
+        m_commands->submit("start", [camera]()
+                           { return camera->start(); },
+                           [this](bool ok)
+                           {
+                               QMetaObject::invokeMethod(this, [this, ok]()
+                                                         {
+                                   if (!m_isStreaming)
+                                       return;
+                                   if (!ok)
+                                   {
+                                       m_isStreaming = false;
+                                       return;
+                                   }
+                                   m_frameRenderer->onEnableUpdate(true);
+                                   startPairing();
+                                   startAutoExposure(); }, Qt::QueuedConnection);
+                           });
     }
-
-    m_isStreaming = !m_isStreaming;
 }
 
 void CameraViewPanel::onCaptureClicked()
@@ -125,30 +182,102 @@ void CameraViewPanel::onCaptureClicked()
 
 void CameraViewPanel::onRecordClicked(bool record)
 {
+    // 相机有帧总线时录制原始帧（.hdrraw，保留原始位深、按相机帧率），否则录制显示画面（.mp4）
+    lzx::FrameBus *bus = m_camera ? m_camera->frameBus() : nullptr;
+
     if (record)
     {
         QString filename = m_camera->label().c_str();
-        filename += "-" + QDateTime::currentDateTime().toString("yyyy-MM-dd_hh-mm-ss") + ".mp4";
+        filename += "-" + QDateTime::currentDateTime().toString("yyyy-MM-dd_hh-mm-ss") + (bus ? ".hdrraw" : ".mp4");
 
         filename = Settings::getInstance().getDefaultSavePath() + "/" + filename;
 
-        m_frameRenderer->startRecording(filename);
+        if (bus)
+        {
+            m_rawRecorder->setCodec(Settings::getInstance().isRawCompression() ? lzx::raw::CodecDeltaPack : lzx::raw::CodecNone);
+            if (!m_rawRecorder->start(bus, filename.toStdString(), m_camera->label()))
+            {
+                // 路径不可写等情况下按钮复位，再次点击重新开始，而不是去停止没有启动的 MP4 录制
+                Log::error("Start raw recording failed: " + filename);
+                m_controlBar->setRecording(false);
+            }
+        }
+        else
+        {
+            m_frameRenderer->startRecording(filename);
+        }
     }
     else
     {
-        m_frameRenderer->stopRecording();
+        if (m_rawRecorder->recording())
+        {
+            m_rawRecorder->stop();
+        }
+        else
+        {
+            m_frameRenderer->stopRecording();
+        }
     }
 }
 
 void CameraViewPanel::onExposureChanged(int value)
 {
-    m_camera->set("exposure", value);
+    if (!m_camera)
+        return;
+
+    // 拖动滑块时只保留最新的值，命令线程忙时不会积压
+    lzx::ICamera *camera = m_camera;
+    m_commands->submitCoalesced("exposure", [camera, value]()
+                                { return camera->set("exposure", value); });
 }
 
 void CameraViewPanel::onGainChanged(int value)
 {
+    if (!m_camera)
+        return;
+
     Log::info(QString("Gain changed: %1").arg(value));
-    m_camera->set("gain", value);
+    lzx::ICamera *camera = m_camera;
+    m_commands->submitCoalesced("gain", [camera, value]()
+                                { return camera->set("gain", value); });
+}
+
+void CameraViewPanel::onAutoExposureToggled(bool enabled)
+{
+    m_autoExposureEnabled = enabled;
+    if (!enabled)
+    {
+        m_autoExposure.reset();
+        return;
+    }
+
+    // 已经在取流时立即启动，否则等取流开始
+    if (m_isStreaming && m_camera && m_camera->streaming())
+    {
+        startAutoExposure();
+    }
+}
+
+void CameraViewPanel::startAutoExposure()
+{
+    if (!m_autoExposureEnabled || !m_camera || m_autoExposure)
+        return;
+
+    Settings &settings = Settings::getInstance();
+    lzx::AutoExposure::Config config;
+    config.saturationTarget = settings.getAutoExposureSaturationPercent() / 100.0;
+    config.blackTarget = settings.getAutoExposureBlackPercent() / 100.0;
+    config.minIntervalMs = settings.getAutoExposureIntervalMs();
+    if (settings.getAutoExposureMinFrameRate() > 0.0)
+    {
+        config.maxExposureUs = 1e6 / settings.getAutoExposureMinFrameRate();
+    }
+
+    m_autoExposure = std::make_unique<lzx::AutoExposureController>(m_camera, config);
+    if (!m_autoExposure->start())
+    {
+        m_autoExposure.reset();
+    }
 }
 
 void CameraViewPanel::setupUI()
@@ -182,14 +311,15 @@ void CameraViewPanel::createConnections()
             this, &CameraViewPanel::onExposureChanged);
     connect(m_controlBar, &CameraControllerBar::gainChanged,
             this, &CameraViewPanel::onGainChanged);
+    connect(m_controlBar, &CameraControllerBar::autoExposureToggled,
+            this, &CameraViewPanel::onAutoExposureToggled);
 
     // 连接直方图请求信号
     connect(m_controlBar, &CameraControllerBar::requestHistogram,
             m_frameRenderer, &FrameRenderer::setHistogramEnabled);
 
-    // 将 FrameRenderer 的直方图数据信号连接到 CameraControllerBar
-    connect(m_frameRenderer, &FrameRenderer::histogramCalculated,
-            m_controlBar, &CameraControllerBar::onHistogramUpdated);
+    // 直方图不再每帧发信号，灰度映射弹窗按自己的刷新率从通道拉取
+    m_controlBar->setHistogramChannel(m_frameRenderer->histogramChannel());
 
     // 将 FrameRenderer 的FPS信号连接到 CameraControllerBar
     connect(m_frameRenderer, &FrameRenderer::fpsUpdated,
@@ -198,9 +328,37 @@ void CameraViewPanel::createConnections()
     /// 将ControlBar的lutChanged信号连接到FrameRenderer
     connect(m_controlBar, &CameraControllerBar::lutChanged,
             m_frameRenderer, &FrameRenderer::onLutChanged);
+
+    // 自动范围：开关从灰度映射控件发到 FrameRenderer，切换后的黑白点再发回控件显示
+    connect(m_controlBar, &CameraControllerBar::autoRangeToggled,
+            m_frameRenderer, &FrameRenderer::setAutoRangeEnabled);
+    connect(m_frameRenderer, &FrameRenderer::autoRangeChanged,
+            m_controlBar, &CameraControllerBar::onAutoRangeChanged);
 }
 
 void CameraViewPanel::handleCameraState(const std::string &state, const std::string &value)
 {
     m_controlBar->onCameraStatusChanged(QString::fromStdString(state), QString::fromStdString(value));
-}
\ No newline at end of file
+}
+
+void CameraViewPanel::startPairing()
+{
+    // 成像相机取流时与全局总线上的参考帧配对，查询 Mask 窗口的送显记录
+    lzx::FrameBus *bus = m_camera ? m_camera->frameBus() : nullptr;
+    if (m_isReference || !bus || !Settings::getInstance().isFramePairing())
+    {
+        return;
+    }
+
+    Settings &settings = Settings::getInstance();
+    lzx::FramePairing::Config config;
+    config.toleranceNs = static_cast<int64_t>(settings.getPairingToleranceUs() * 1000.0);
+    config.imagingOffsetNs = static_cast<int64_t>(settings.getPairingOffsetUs() * 1000.0);
+
+    auto &resources = GlobalResourceManager::getInstance();
+    m_pairing = std::make_unique<lzx::FramePairing>(resources.frameBus.get(), bus, resources.maskTimeline.get(), config);
+    if (!m_pairing->start())
+    {
+        m_pairing.reset();
+    }
+}
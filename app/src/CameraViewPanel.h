@@ -2,11 +2,16 @@
 
 #include <QWidget>
 #include <QString>
+#include <memory>
 #include "ICamera.hpp"
+#include "CameraCommandQueue.h"
 #include "framerenderer.hpp"
 #include "CameraControllerBar.h"
 #include "TripleBuffer.h"
 #include "Frame.h"
+#include "RawRecorder.h"
+#include "FramePairing.h"
+#include "AutoExposure.h"
 
 class QVBoxLayout;
 
@@ -27,11 +32,15 @@ private slots:
     void onRecordClicked(bool record);
     void onExposureChanged(int value);
     void onGainChanged(int value);
+    void onAutoExposureToggled(bool enabled);
 
 private:
     void setupUI();
     void createConnections();
     void handleCameraState(const std::string &state, const std::string &value);
+    void startPairing();
+    void startAutoExposure(); // 取流开始且打开了自动曝光时启动控制线程
+    void shutdownCamera(); // 停止并关闭当前相机，等命令线程执行完
 
 private:
     QString m_desc;
@@ -41,4 +50,9 @@ private:
     lzx::ICamera *m_camera;
     bool m_isStreaming;
     bool m_isReference;
+    std::unique_ptr<lzx::RawRecorder> m_rawRecorder; // 相机有帧总线时录制原始帧
+    std::unique_ptr<lzx::FramePairing> m_pairing;    // 成像相机与参考相机的帧配对，取流期间运行
+    std::unique_ptr<lzx::AutoExposureController> m_autoExposure; // 自动曝光，取流期间运行
+    bool m_autoExposureEnabled = false;
+    std::unique_ptr<lzx::CameraCommandQueue> m_commands; // 相机的 SDK 调用都在这个线程上按顺序执行，不阻塞界面和渲染
 };
\ No newline at end of file
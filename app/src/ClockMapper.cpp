@@ -0,0 +1,155 @@
+#include "ClockMapper.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace lzx
+{
+    ClockMapper::ClockMapper(size_t window)
+        : m_window(std::max<size_t>(window, 2))
+    {
+    }
+
+    double ClockMapper::predict(int64_t deviceNs) const
+    {
+        return m_intercept + m_slope * static_cast<double>(deviceNs - m_deviceAnchor);
+    }
+
+    void ClockMapper::addSample(int64_t deviceNs, int64_t hostNs)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_hasCandidate)
+        {
+            double residual = static_cast<double>(hostNs - m_hostAnchor) - predict(deviceNs);
+            if (deviceNs <= m_candidate.first || std::fabs(residual) > static_cast<double>(JumpNs))
+            {
+                m_samples.clear();
+                m_hasCandidate = false;
+                m_jitterNs = 0.0;
+                ++m_resets;
+            }
+            else
+            {
+                // 包络之下的样本说明包络还没收敛，不计入抖动
+                m_jitterNs += (std::max(residual, 0.0) - m_jitterNs) / 64.0;
+            }
+        }
+
+        if (!m_hasCandidate)
+        {
+            m_candidate = {deviceNs, hostNs};
+            m_bucketStart = deviceNs;
+            m_hasCandidate = true;
+        }
+        else if (deviceNs - m_bucketStart < BucketNs)
+        {
+            if (hostNs - deviceNs < m_candidate.second - m_candidate.first)
+            {
+                m_candidate = {deviceNs, hostNs};
+            }
+        }
+        else
+        {
+            m_samples.push_back(m_candidate);
+            if (m_samples.size() > m_window)
+            {
+                m_samples.pop_front();
+            }
+            m_candidate = {deviceNs, hostNs};
+            m_bucketStart = deviceNs;
+        }
+
+        refit();
+    }
+
+    void ClockMapper::refit()
+    {
+        // 拟合点：已结束的时间桶加上当前桶的候选
+        const size_t n = m_samples.size() + 1;
+        auto point = [this](size_t i) -> const std::pair<int64_t, int64_t> &
+        {
+            return i < m_samples.size() ? m_samples[i] : m_candidate;
+        };
+
+        // 以第一个点为原点，差值在 double 中保持亚纳秒精度
+        m_deviceAnchor = point(0).first;
+        m_hostAnchor = point(0).second;
+
+        double span = static_cast<double>(m_candidate.first - m_deviceAnchor);
+
+        m_slope = 1.0;
+        if (n >= 3 && span >= static_cast<double>(MinFitSpanNs))
+        {
+            double meanX = 0.0, meanY = 0.0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                meanX += static_cast<double>(point(i).first - m_deviceAnchor);
+                meanY += static_cast<double>(point(i).second - m_hostAnchor);
+            }
+            meanX /= n;
+            meanY /= n;
+
+            double sxx = 0.0, sxy = 0.0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                double dx = static_cast<double>(point(i).first - m_deviceAnchor) - meanX;
+                double dy = static_cast<double>(point(i).second - m_hostAnchor) - meanY;
+                sxx += dx * dx;
+                sxy += dx * dy;
+            }
+
+            double slope = sxy / sxx;
+            if (std::fabs(slope - 1.0) * 1e6 <= MaxDriftPpm)
+            {
+                m_slope = slope;
+            }
+        }
+
+        // 截距取拟合点的下包络
+        double lowest = 0.0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            double residual = static_cast<double>(point(i).second - m_hostAnchor) - m_slope * static_cast<double>(point(i).first - m_deviceAnchor);
+            lowest = i == 0 ? residual : std::min(lowest, residual);
+        }
+        m_intercept = lowest;
+    }
+
+    int64_t ClockMapper::toHost(int64_t deviceNs) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_hasCandidate)
+        {
+            return 0;
+        }
+        return m_hostAnchor + std::llround(predict(deviceNs));
+    }
+
+    ClockMapper::Estimate ClockMapper::estimate() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        Estimate estimate;
+        estimate.valid = m_hasCandidate;
+        estimate.resets = m_resets;
+        if (estimate.valid)
+        {
+            estimate.samples = m_samples.size() + 1;
+            estimate.driftPpm = (1.0 / m_slope - 1.0) * 1e6;
+            estimate.jitterUs = m_jitterNs / 1000.0;
+            estimate.spanSeconds = static_cast<double>(m_candidate.first - m_deviceAnchor) / 1e9;
+        }
+        return estimate;
+    }
+
+    void ClockMapper::reset()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_samples.clear();
+        m_hasCandidate = false;
+        m_slope = 1.0;
+        m_intercept = 0.0;
+        m_jitterNs = 0.0;
+    }
+}
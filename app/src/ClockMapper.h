@@ -0,0 +1,70 @@
+#ifndef CLOCK_MAPPER_H
+#define CLOCK_MAPPER_H
+
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace lzx
+{
+    // 把相机时钟映射到主机单调时钟
+    // 每帧加入一对（设备时间戳，主机时间）。主机时间 = 真实时刻 + 非负的传输/调度延迟，
+    // 所以每 BucketNs 的设备时间里只保留延迟最小的一个样本（下包络），在最近 window 个这样的样本上拟合
+    // host = a + b * device：斜率 b 用最小二乘估计（跨度不足 MinFitSpanNs 时取 1，即只估计偏移），
+    // b 偏离 1 的程度即两个时钟的相对漂移；截距 a 取下包络，映射后的时间不带 USB 传输和线程调度的抖动。
+    // 设备时间倒退或与预测相差超过 JumpNs（相机重启、时间戳清零）时丢弃旧样本重新估计。
+    // 由采集线程写入，estimate() 可以在任意线程调用。
+    class ClockMapper
+    {
+    public:
+        static constexpr int64_t BucketNs = 100000000LL;      // 100ms
+        static constexpr int64_t MinFitSpanNs = 2000000000LL; // 2s
+        static constexpr int64_t JumpNs = 1000000000LL;       // 1s
+        static constexpr double MaxDriftPpm = 1000.0;         // 超出时认为拟合不可信，斜率取 1
+
+        struct Estimate
+        {
+            bool valid = false;       // 至少有一个样本
+            double driftPpm = 0.0;    // 设备时钟相对主机时钟的漂移，正值表示设备时钟偏快
+            double jitterUs = 0.0;    // 样本在下包络之上的平均距离，即传输抖动
+            double spanSeconds = 0.0; // 拟合窗口覆盖的设备时间
+            size_t samples = 0;       // 拟合用的包络样本数
+            uint64_t resets = 0;      // 因时钟跳变重新估计的次数
+        };
+
+        // window: 包络样本数，默认约 25s
+        explicit ClockMapper(size_t window = 256);
+
+        void addSample(int64_t deviceNs, int64_t hostNs);
+
+        // 设备时间对应的主机时间（ns），还没有样本时返回 0
+        int64_t toHost(int64_t deviceNs) const;
+
+        Estimate estimate() const;
+        void reset();
+
+    private:
+        void refit();
+        double predict(int64_t deviceNs) const; // 相对 m_hostAnchor 的预测值
+
+        size_t m_window;
+        std::deque<std::pair<int64_t, int64_t>> m_samples; // 已结束的时间桶的包络样本 (device, host)
+        std::pair<int64_t, int64_t> m_candidate{0, 0};     // 当前时间桶内延迟最小的样本
+        int64_t m_bucketStart = 0;
+        bool m_hasCandidate = false;
+
+        // 拟合结果：host = m_hostAnchor + m_intercept + m_slope * (device - m_deviceAnchor)
+        int64_t m_deviceAnchor = 0;
+        int64_t m_hostAnchor = 0;
+        double m_slope = 1.0;
+        double m_intercept = 0.0;
+        double m_jitterNs = 0.0; // 样本到包络距离的指数平均
+        uint64_t m_resets = 0;
+
+        mutable std::mutex m_mutex;
+    };
+}
+
+#endif
@@ -0,0 +1,557 @@
+#include "Demosaic.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+
+#include "ThreadPool.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DEMOSAIC_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace lzx
+{
+    namespace
+    {
+        struct PatternInfo
+        {
+            Demosaic::Pattern pattern;
+            const char *name;
+            int redX; // 红色像素在 2x2 内的位置
+            int redY;
+        };
+
+        const PatternInfo kPatterns[] = {
+            {Demosaic::Pattern::RGGB, "RGGB", 0, 0},
+            {Demosaic::Pattern::BGGR, "BGGR", 1, 1},
+            {Demosaic::Pattern::GRBG, "GRBG", 1, 0},
+            {Demosaic::Pattern::GBRG, "GBRG", 0, 1},
+        };
+
+        const PatternInfo &info(Demosaic::Pattern pattern)
+        {
+            for (const auto &entry : kPatterns)
+            {
+                if (entry.pattern == pattern)
+                    return entry;
+            }
+            return kPatterns[0];
+        }
+
+        // 以下标量函数与 SSE2 版本逐条对应（_mm_avg_epu16 的舍入、饱和加减），两者结果逐位相同。
+        // 每一行只有一种非绿颜色（红行为 R，蓝行为 B），称为本行色，另一种称为异行色
+        inline uint16_t avg(uint16_t a, uint16_t b)
+        {
+            return static_cast<uint16_t>((a + b + 1) >> 1);
+        }
+
+        inline uint16_t avg4(uint16_t a, uint16_t b, uint16_t c, uint16_t d)
+        {
+            return avg(avg(a, b), avg(c, d));
+        }
+
+        inline uint16_t subSat(uint16_t a, uint16_t b)
+        {
+            return static_cast<uint16_t>(a > b ? a - b : 0);
+        }
+
+        inline uint16_t addSat(uint16_t a, uint16_t b)
+        {
+            return static_cast<uint16_t>(std::min(a + b, 0xFFFF));
+        }
+
+        inline uint16_t absDiff(uint16_t a, uint16_t b)
+        {
+            return static_cast<uint16_t>(a > b ? a - b : b - a);
+        }
+
+        // base + plus - minus，截断到 [0, 65535]
+        inline uint16_t addDiff(uint16_t base, uint16_t plus, uint16_t minus)
+        {
+            return subSat(addSat(base, subSat(plus, minus)), subSat(minus, plus));
+        }
+
+        // p 指向当前像素，s 为行距（元素数）
+        void bilinearPixel(const uint16_t *p, ptrdiff_t s, bool chromaSite, uint16_t &own, uint16_t &green, uint16_t &other)
+        {
+            uint16_t h = avg(p[-1], p[1]);
+            uint16_t v = avg(p[-s], p[s]);
+            if (chromaSite)
+            {
+                own = p[0];
+                green = avg(h, v);
+                other = avg4(p[-s - 1], p[-s + 1], p[s - 1], p[s + 1]);
+            }
+            else
+            {
+                own = h;
+                green = p[0];
+                other = v;
+            }
+        }
+
+        // Hamilton-Adams：梯度 = 绿色差/2 + 本色二阶差/2，沿梯度小的方向取绿色均值并用本色二阶差修正
+        uint16_t greenPixel(const uint16_t *p, ptrdiff_t s, bool chromaSite, uint16_t maxValue)
+        {
+            const uint16_t c = p[0];
+            if (!chromaSite)
+                return c;
+
+            uint16_t midH = avg(p[-2], p[2]);
+            uint16_t midV = avg(p[-2 * s], p[2 * s]);
+            uint16_t gradH = addSat(absDiff(p[-1], p[1]) >> 1, absDiff(c, midH));
+            uint16_t gradV = addSat(absDiff(p[-s], p[s]) >> 1, absDiff(c, midV));
+            uint16_t greenH = addDiff(avg(p[-1], p[1]), subSat(c, midH) >> 1, subSat(midH, c) >> 1);
+            uint16_t greenV = addDiff(avg(p[-s], p[s]), subSat(c, midV) >> 1, subSat(midV, c) >> 1);
+
+            uint16_t g = gradH < gradV ? greenH : gradV < gradH ? greenV
+                                                                : avg(greenH, greenV);
+            return std::min(g, maxValue);
+        }
+
+        // 绿色平面已知，本行色和异行色按色差（颜色 - 绿色）的双线性插值加回绿色
+        void chromaPixel(const uint16_t *p, ptrdiff_t s, const uint16_t *g, ptrdiff_t gs, bool chromaSite,
+                         uint16_t maxValue, uint16_t &own, uint16_t &other)
+        {
+            if (chromaSite)
+            {
+                own = p[0];
+                other = addDiff(g[0], avg4(p[-s - 1], p[-s + 1], p[s - 1], p[s + 1]),
+                                avg4(g[-gs - 1], g[-gs + 1], g[gs - 1], g[gs + 1]));
+            }
+            else
+            {
+                own = addDiff(g[0], avg(p[-1], p[1]), avg(g[-1], g[1]));
+                other = addDiff(g[0], avg(p[-s], p[s]), avg(g[-gs], g[gs]));
+            }
+            own = std::min(own, maxValue);
+            other = std::min(other, maxValue);
+        }
+
+        // 行内核：处理 [x0, x1)，调用方保证邻域都在图内
+        void bilinearRowScalar(const uint16_t *row, ptrdiff_t s, int x0, int x1, int chromaParity,
+                               uint16_t *own, uint16_t *green, uint16_t *other)
+        {
+            for (int x = x0; x < x1; x++)
+                bilinearPixel(row + x, s, (x & 1) == chromaParity, own[x], green[x], other[x]);
+        }
+
+        void greenRowScalar(const uint16_t *row, ptrdiff_t s, int x0, int x1, int chromaParity, uint16_t maxValue, uint16_t *green)
+        {
+            for (int x = x0; x < x1; x++)
+                green[x] = greenPixel(row + x, s, (x & 1) == chromaParity, maxValue);
+        }
+
+        void chromaRowScalar(const uint16_t *row, ptrdiff_t s, const uint16_t *greenRow, ptrdiff_t gs, int x0, int x1,
+                             int chromaParity, uint16_t maxValue, uint16_t *own, uint16_t *other)
+        {
+            for (int x = x0; x < x1; x++)
+                chromaPixel(row + x, s, greenRow + x, gs, (x & 1) == chromaParity, maxValue, own[x], other[x]);
+        }
+
+        void interleaveScalar(const uint16_t *r, const uint16_t *g, const uint16_t *b, uint16_t *dst, int x0, int x1)
+        {
+            for (int x = x0; x < x1; x++)
+            {
+                dst[x * 3 + 0] = r[x];
+                dst[x * 3 + 1] = g[x];
+                dst[x * 3 + 2] = b[x];
+            }
+        }
+
+#ifdef DEMOSAIC_SSE2
+        inline __m128i load(const uint16_t *p)
+        {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        }
+
+        inline void store(uint16_t *p, __m128i v)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(p), v);
+        }
+
+        inline __m128i absDiff(__m128i a, __m128i b)
+        {
+            return _mm_or_si128(_mm_subs_epu16(a, b), _mm_subs_epu16(b, a));
+        }
+
+        inline __m128i addDiff(__m128i base, __m128i plus, __m128i minus)
+        {
+            return _mm_subs_epu16(_mm_adds_epu16(base, _mm_subs_epu16(plus, minus)), _mm_subs_epu16(minus, plus));
+        }
+
+        inline __m128i select(__m128i mask, __m128i a, __m128i b)
+        {
+            return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+        }
+
+        // 无符号 a < b：b - a 饱和减法不为 0
+        inline __m128i lessThan(__m128i a, __m128i b)
+        {
+            return _mm_xor_si128(_mm_cmpeq_epi16(_mm_subs_epu16(b, a), _mm_setzero_si128()), _mm_set1_epi16(-1));
+        }
+
+        inline __m128i minU16(__m128i v, __m128i maxValue)
+        {
+            return _mm_sub_epi16(v, _mm_subs_epu16(v, maxValue));
+        }
+
+        // 一次 8 个像素，x 每次加 8，奇偶相位不变，本行色所在的通道用掩码区分
+        inline __m128i chromaMask(int x0, int chromaParity)
+        {
+            return (x0 & 1) == chromaParity ? _mm_setr_epi16(-1, 0, -1, 0, -1, 0, -1, 0)
+                                            : _mm_setr_epi16(0, -1, 0, -1, 0, -1, 0, -1);
+        }
+
+        void bilinearRow(const uint16_t *row, ptrdiff_t s, int x0, int x1, int chromaParity,
+                         uint16_t *own, uint16_t *green, uint16_t *other)
+        {
+            const __m128i mask = chromaMask(x0, chromaParity);
+            int x = x0;
+            for (; x + 8 <= x1; x += 8)
+            {
+                const uint16_t *p = row + x;
+                __m128i c = load(p);
+                __m128i h = _mm_avg_epu16(load(p - 1), load(p + 1));
+                __m128i v = _mm_avg_epu16(load(p - s), load(p + s));
+                __m128i diagonal = _mm_avg_epu16(_mm_avg_epu16(load(p - s - 1), load(p - s + 1)),
+                                                 _mm_avg_epu16(load(p + s - 1), load(p + s + 1)));
+                store(own + x, select(mask, c, h));
+                store(green + x, select(mask, _mm_avg_epu16(h, v), c));
+                store(other + x, select(mask, diagonal, v));
+            }
+            bilinearRowScalar(row, s, x, x1, chromaParity, own, green, other);
+        }
+
+        void greenRow(const uint16_t *row, ptrdiff_t s, int x0, int x1, int chromaParity, uint16_t maxValue, uint16_t *green)
+        {
+            const __m128i mask = chromaMask(x0, chromaParity);
+            const __m128i maxVector = _mm_set1_epi16(static_cast<short>(maxValue));
+            int x = x0;
+            for (; x + 8 <= x1; x += 8)
+            {
+                const uint16_t *p = row + x;
+                __m128i c = load(p);
+                __m128i left = load(p - 1), right = load(p + 1);
+                __m128i up = load(p - s), down = load(p + s);
+                __m128i midH = _mm_avg_epu16(load(p - 2), load(p + 2));
+                __m128i midV = _mm_avg_epu16(load(p - 2 * s), load(p + 2 * s));
+
+                __m128i gradH = _mm_adds_epu16(_mm_srli_epi16(absDiff(left, right), 1), absDiff(c, midH));
+                __m128i gradV = _mm_adds_epu16(_mm_srli_epi16(absDiff(up, down), 1), absDiff(c, midV));
+                __m128i greenH = addDiff(_mm_avg_epu16(left, right), _mm_srli_epi16(_mm_subs_epu16(c, midH), 1),
+                                         _mm_srli_epi16(_mm_subs_epu16(midH, c), 1));
+                __m128i greenV = addDiff(_mm_avg_epu16(up, down), _mm_srli_epi16(_mm_subs_epu16(c, midV), 1),
+                                         _mm_srli_epi16(_mm_subs_epu16(midV, c), 1));
+
+                __m128i g = select(lessThan(gradH, gradV), greenH,
+                                   select(lessThan(gradV, gradH), greenV, _mm_avg_epu16(greenH, greenV)));
+                store(green + x, select(mask, minU16(g, maxVector), c));
+            }
+            greenRowScalar(row, s, x, x1, chromaParity, maxValue, green);
+        }
+
+        void chromaRow(const uint16_t *row, ptrdiff_t s, const uint16_t *greenRowPtr, ptrdiff_t gs, int x0, int x1,
+                       int chromaParity, uint16_t maxValue, uint16_t *own, uint16_t *other)
+        {
+            const __m128i mask = chromaMask(x0, chromaParity);
+            const __m128i maxVector = _mm_set1_epi16(static_cast<short>(maxValue));
+            int x = x0;
+            for (; x + 8 <= x1; x += 8)
+            {
+                const uint16_t *p = row + x;
+                const uint16_t *g = greenRowPtr + x;
+                __m128i c = load(p);
+                __m128i g0 = load(g);
+
+                __m128i pDiagonal = _mm_avg_epu16(_mm_avg_epu16(load(p - s - 1), load(p - s + 1)),
+                                                  _mm_avg_epu16(load(p + s - 1), load(p + s + 1)));
+                __m128i gDiagonal = _mm_avg_epu16(_mm_avg_epu16(load(g - gs - 1), load(g - gs + 1)),
+                                                  _mm_avg_epu16(load(g + gs - 1), load(g + gs + 1)));
+                __m128i fromDiagonal = addDiff(g0, pDiagonal, gDiagonal);
+                __m128i fromH = addDiff(g0, _mm_avg_epu16(load(p - 1), load(p + 1)), _mm_avg_epu16(load(g - 1), load(g + 1)));
+                __m128i fromV = addDiff(g0, _mm_avg_epu16(load(p - s), load(p + s)), _mm_avg_epu16(load(g - gs), load(g + gs)));
+
+                store(own + x, minU16(select(mask, c, fromH), maxVector));
+                store(other + x, minU16(select(mask, fromDiagonal, fromV), maxVector));
+            }
+            chromaRowScalar(row, s, greenRowPtr, gs, x, x1, chromaParity, maxValue, own, other);
+        }
+
+        // 三个平面交错成 RGB：每两个像素拼成 R G B 0 R G B 0，去掉空位后是 12 字节
+        void interleave(const uint16_t *r, const uint16_t *g, const uint16_t *b, uint16_t *dst, int x0, int x1)
+        {
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i low6 = _mm_setr_epi16(-1, -1, -1, 0, 0, 0, 0, 0);
+            const __m128i high6 = _mm_setr_epi16(0, 0, 0, -1, -1, -1, 0, 0);
+            int x = x0;
+            for (; x + 8 <= x1; x += 8)
+            {
+                __m128i red = load(r + x), green = load(g + x), blue = load(b + x);
+                __m128i rgLow = _mm_unpacklo_epi16(red, green);
+                __m128i rgHigh = _mm_unpackhi_epi16(red, green);
+                __m128i bLow = _mm_unpacklo_epi16(blue, zero);
+                __m128i bHigh = _mm_unpackhi_epi16(blue, zero);
+                __m128i pairs[4] = {_mm_unpacklo_epi32(rgLow, bLow), _mm_unpackhi_epi32(rgLow, bLow),
+                                    _mm_unpacklo_epi32(rgHigh, bHigh), _mm_unpackhi_epi32(rgHigh, bHigh)};
+
+                uint16_t *out = dst + x * 3;
+                for (int i = 0; i < 4; i++)
+                {
+                    __m128i packed = _mm_or_si128(_mm_and_si128(pairs[i], low6), _mm_and_si128(_mm_srli_si128(pairs[i], 2), high6));
+                    if (i < 3)
+                    {
+                        // 多写的 4 字节随后被下一组覆盖
+                        store(out + i * 6, packed);
+                    }
+                    else
+                    {
+                        _mm_storel_epi64(reinterpret_cast<__m128i *>(out + i * 6), packed);
+                        uint32_t last = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(packed, 8)));
+                        memcpy(out + i * 6 + 4, &last, 4);
+                    }
+                }
+            }
+            interleaveScalar(r, g, b, dst, x, x1);
+        }
+#else
+        void bilinearRow(const uint16_t *row, ptrdiff_t s, int x0, int x1, int chromaParity,
+                         uint16_t *own, uint16_t *green, uint16_t *other)
+        {
+            bilinearRowScalar(row, s, x0, x1, chromaParity, own, green, other);
+        }
+
+        void greenRow(const uint16_t *row, ptrdiff_t s, int x0, int x1, int chromaParity, uint16_t maxValue, uint16_t *green)
+        {
+            greenRowScalar(row, s, x0, x1, chromaParity, maxValue, green);
+        }
+
+        void chromaRow(const uint16_t *row, ptrdiff_t s, const uint16_t *greenRowPtr, ptrdiff_t gs, int x0, int x1,
+                       int chromaParity, uint16_t maxValue, uint16_t *own, uint16_t *other)
+        {
+            chromaRowScalar(row, s, greenRowPtr, gs, x0, x1, chromaParity, maxValue, own, other);
+        }
+
+        void interleave(const uint16_t *r, const uint16_t *g, const uint16_t *b, uint16_t *dst, int x0, int x1)
+        {
+            interleaveScalar(r, g, b, dst, x0, x1);
+        }
+#endif
+
+        // 边界像素：按镜像取 5x5 邻域（-1 → 1，w → w-2），不改变 Bayer 相位
+        constexpr int WindowSize = 5;
+
+        inline int reflect(int v, int n)
+        {
+            if (v < 0)
+                return -v;
+            if (v >= n)
+                return 2 * (n - 1) - v;
+            return v;
+        }
+
+        const uint16_t *gather(const uint16_t *base, ptrdiff_t stride, int width, int height, int x, int y, uint16_t *window)
+        {
+            for (int dy = -2; dy <= 2; dy++)
+            {
+                const uint16_t *row = base + reflect(y + dy, height) * stride;
+                for (int dx = -2; dx <= 2; dx++)
+                    window[(dy + 2) * WindowSize + dx + 2] = row[reflect(x + dx, width)];
+            }
+            return window + 2 * WindowSize + 2;
+        }
+
+        // 一行中邻域完整的内部区间 [margin, width - margin) 交给行内核，两端逐像素取镜像邻域
+        template <typename Interior, typename Border>
+        void forRow(int width, int margin, bool interiorRow, Interior interior, Border border)
+        {
+            if (!interiorRow || width <= 2 * margin)
+            {
+                for (int x = 0; x < width; x++)
+                    border(x);
+                return;
+            }
+            for (int x = 0; x < margin; x++)
+                border(x);
+            interior(margin, width - margin);
+            for (int x = width - margin; x < width; x++)
+                border(x);
+        }
+    }
+
+    Demosaic::Demosaic(ThreadPool *pool)
+        : m_pool(pool)
+    {
+    }
+
+    const char *Demosaic::name(Pattern pattern)
+    {
+        return info(pattern).name;
+    }
+
+    bool Demosaic::parse(const std::string &text, Pattern &pattern)
+    {
+        for (const auto &entry : kPatterns)
+        {
+            if (text == entry.name)
+            {
+                pattern = entry.pattern;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const char *Demosaic::name(Method method)
+    {
+        return method == Method::EdgeAware ? "edge" : "bilinear";
+    }
+
+    bool Demosaic::parse(const std::string &text, Method &method)
+    {
+        if (text == "bilinear")
+            method = Method::Bilinear;
+        else if (text == "edge")
+            method = Method::EdgeAware;
+        else
+            return false;
+        return true;
+    }
+
+    bool Demosaic::process(const FrameView &src, Pattern pattern, Method method, Frame &dst)
+    {
+        const int width = src.width();
+        const int height = src.height();
+        if (src.empty() || src.channels() != 1 || src.bitDepth() <= 8 || !src.isRowContiguous() || src.stride() % 2 != 0 ||
+            width < 4 || height < 4)
+            return false;
+        if (dst.empty() || dst.width() != width || dst.height() != height || dst.channels() != 3 ||
+            dst.bitDepth() != src.bitDepth() || dst.stride() % 2 != 0)
+            return false;
+
+        const PatternInfo &layout = info(pattern);
+        const uint16_t maxValue = static_cast<uint16_t>((1 << std::min(src.bitDepth(), 16)) - 1);
+        const uint16_t *base = src.row<uint16_t>(0);
+        const ptrdiff_t s = static_cast<ptrdiff_t>(src.stride() / 2);
+        const size_t tileCount = (height + TileRows - 1) / TileRows;
+
+        // 本行色为红还是蓝，以及它在行内的奇偶位置
+        auto rowLayout = [&](int y, bool &redRow, int &chromaParity)
+        {
+            redRow = (y & 1) == layout.redY;
+            chromaParity = redRow ? layout.redX : layout.redX ^ 1;
+        };
+
+        auto runTiles = [&](const std::function<void(size_t)> &task)
+        {
+            if (m_pool)
+                m_pool->parallelFor(tileCount, task);
+            else
+                for (size_t tile = 0; tile < tileCount; tile++)
+                    task(tile);
+        };
+
+        if (method == Method::EdgeAware)
+        {
+            m_green.resize(static_cast<size_t>(width) * height);
+            uint16_t *greenPlane = m_green.data();
+
+            // 第一遍：整幅绿色平面
+            runTiles([&](size_t tile)
+                     {
+                         uint16_t window[WindowSize * WindowSize];
+                         int y0 = static_cast<int>(tile) * TileRows;
+                         int y1 = std::min(y0 + TileRows, height);
+                         for (int y = y0; y < y1; y++)
+                         {
+                             bool redRow;
+                             int chromaParity;
+                             rowLayout(y, redRow, chromaParity);
+                             const uint16_t *row = base + y * s;
+                             uint16_t *green = greenPlane + static_cast<size_t>(y) * width;
+                             forRow(
+                                 width, 2, y >= 2 && y < height - 2,
+                                 [&](int x0, int x1)
+                                 { greenRow(row, s, x0, x1, chromaParity, maxValue, green); },
+                                 [&](int x)
+                                 {
+                                     const uint16_t *p = gather(base, s, width, height, x, y, window);
+                                     green[x] = greenPixel(p, WindowSize, (x & 1) == chromaParity, maxValue);
+                                 });
+                         } });
+
+            // 第二遍：色差插值红蓝，交错写出
+            runTiles([&](size_t tile)
+                     {
+                         std::vector<uint16_t> ownPlane(width), otherPlane(width);
+                         uint16_t *own = ownPlane.data();
+                         uint16_t *other = otherPlane.data();
+                         uint16_t window[WindowSize * WindowSize], greenWindow[WindowSize * WindowSize];
+                         int y0 = static_cast<int>(tile) * TileRows;
+                         int y1 = std::min(y0 + TileRows, height);
+                         for (int y = y0; y < y1; y++)
+                         {
+                             bool redRow;
+                             int chromaParity;
+                             rowLayout(y, redRow, chromaParity);
+                             const uint16_t *row = base + y * s;
+                             const uint16_t *green = greenPlane + static_cast<size_t>(y) * width;
+                             forRow(
+                                 width, 1, y >= 1 && y < height - 1,
+                                 [&](int x0, int x1)
+                                 { chromaRow(row, s, green, width, x0, x1, chromaParity, maxValue, own, other); },
+                                 [&](int x)
+                                 {
+                                     const uint16_t *p = gather(base, s, width, height, x, y, window);
+                                     const uint16_t *g = gather(greenPlane, width, width, height, x, y, greenWindow);
+                                     chromaPixel(p, WindowSize, g, WindowSize, (x & 1) == chromaParity, maxValue, own[x], other[x]);
+                                 });
+
+                             uint16_t *out = reinterpret_cast<uint16_t *>(dst.buffer() + y * dst.stride());
+                             interleave(redRow ? own : other, green, redRow ? other : own, out, 0, width);
+                         } });
+            return true;
+        }
+
+        runTiles([&](size_t tile)
+                 {
+                     std::vector<uint16_t> planes(static_cast<size_t>(width) * 3);
+                     uint16_t *own = planes.data();
+                     uint16_t *green = own + width;
+                     uint16_t *other = green + width;
+                     uint16_t window[WindowSize * WindowSize];
+                     int y0 = static_cast<int>(tile) * TileRows;
+                     int y1 = std::min(y0 + TileRows, height);
+                     for (int y = y0; y < y1; y++)
+                     {
+                         bool redRow;
+                         int chromaParity;
+                         rowLayout(y, redRow, chromaParity);
+                         const uint16_t *row = base + y * s;
+                         forRow(
+                             width, 1, y >= 1 && y < height - 1,
+                             [&](int x0, int x1)
+                             { bilinearRow(row, s, x0, x1, chromaParity, own, green, other); },
+                             [&](int x)
+                             {
+                                 const uint16_t *p = gather(base, s, width, height, x, y, window);
+                                 bilinearPixel(p, WindowSize, (x & 1) == chromaParity, own[x], green[x], other[x]);
+                             });
+
+                         uint16_t *out = reinterpret_cast<uint16_t *>(dst.buffer() + y * dst.stride());
+                         interleave(redRow ? own : other, green, redRow ? other : own, out, 0, width);
+                     } });
+        return true;
+    }
+
+    const char *Demosaic::simdName()
+    {
+#ifdef DEMOSAIC_SSE2
+        return "SSE2";
+#else
+        return "scalar";
+#endif
+    }
+}
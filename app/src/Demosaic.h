@@ -0,0 +1,62 @@
+#ifndef DEMOSAIC_H
+#define DEMOSAIC_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "Frame.h"
+#include "FrameView.h"
+
+namespace lzx
+{
+    class ThreadPool;
+
+    // 彩色传感器的 Bayer 插值：16 位单通道 RAW 输入，16 位 RGB（三通道交错）输出。
+    //   Bilinear：缺失的颜色取相邻同色像素的平均
+    //   EdgeAware：先沿梯度较小的方向插值绿色（Hamilton-Adams），再对色差 R-G、B-G 做双线性插值，
+    //              边缘处的伪彩和拉链效应明显少于 Bilinear，耗时约两倍
+    // 帧按 TileRows 行切成图块在线程池上并行，行内用 SSE2 一次处理 8 个像素；
+    // 边界按镜像取邻域（不改变 Bayer 相位），所有实现的舍入方式一致，SIMD 与标量结果逐位相同。
+    class Demosaic
+    {
+    public:
+        static constexpr int TileRows = 64;
+
+        // 左上角 2x2 的排列
+        enum class Pattern
+        {
+            RGGB,
+            BGGR,
+            GRBG,
+            GBRG
+        };
+
+        enum class Method
+        {
+            Bilinear,
+            EdgeAware
+        };
+
+        explicit Demosaic(ThreadPool *pool = nullptr);
+
+        static const char *name(Pattern pattern);
+        static bool parse(const std::string &text, Pattern &pattern);
+        static const char *name(Method method);
+        static bool parse(const std::string &text, Method &method);
+
+        // src 为单通道、位深大于 8 的 RAW 视图（宽高至少 4），dst 为同尺寸、同位深的三通道帧；
+        // 参数不符时返回 false
+        bool process(const FrameView &src, Pattern pattern, Method method, Frame &dst);
+
+        // 内层循环使用的指令集
+        static const char *simdName();
+
+    private:
+        ThreadPool *m_pool;
+        std::vector<uint16_t> m_green; // EdgeAware 第一遍得到的整幅绿色平面
+    };
+}
+
+#endif
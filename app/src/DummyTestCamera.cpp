@@ -1,20 +1,37 @@
 #include "DummyTestCamera.h"
+#include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <cmath>
+#include <random>
+#include <sstream>
+#include <type_traits>
 #include <QString>
 
 #include "logwidget.hpp"
 
 namespace lzx
 {
+    // 帧池容量：总线槽位和订阅者各持有的帧，加上采集线程正在写入的帧；
+    // 挂接录像、帧配对队列后按 FrameBus::retainedFrames() 加上余量扩容
+    static constexpr size_t kFramePoolCapacity = 8;
+    static constexpr size_t kFramePoolHeadroom = 2;
+
+    static size_t framePoolCapacity(const FrameBus &bus)
+    {
+        return std::max(kFramePoolCapacity, bus.retainedFrames() + kFramePoolHeadroom);
+    }
+
     DummyTestCamera::DummyTestCamera(int bitDepth)
         : m_isOpened(false),
-          m_isStreaming(false),
           m_width(640),
           m_height(480),
           m_channels(1),
-          m_bitDepth(bitDepth)
+          m_bitDepth(bitDepth),
+          m_stride(0),
+          m_frameBus(std::make_unique<FrameBus>())
     {
+        m_subscription = m_frameBus->subscribe("test view");
         generateTestPattern();
     }
 
@@ -35,6 +52,9 @@ namespace lzx
 
         m_isOpened = true;
 
+        propertyRegistry.clear();
+        propertyRegistry.define(PropertyId::ExposureTime, 10, 1000000, 1, m_exposureUs);
+
         notifyStateChanged("open", "true");
 
         return true;
@@ -58,10 +78,27 @@ namespace lzx
     bool DummyTestCamera::start()
     {
         Log::info("camera start");
-        if (!m_isOpened)
+        if (!m_isOpened || m_isStreaming)
             return false;
 
+        // 和真实相机一样，大画幅时帧池尝试使用大页内存
+        size_t frameBytes = FramePool::frameBytes(m_width, m_height, m_channels, m_bitDepth, m_stride);
+        m_framePool = FramePool::create(framePoolCapacity(*m_frameBus), frameBytes,
+                                        frameBytes >= FramePool::HugePageThreshold);
+        m_produced = 0;
+        m_late = 0;
+        m_measuredFrameRate = 0.0;
+
+        // 停止期间提交的参数直接生效
+        ParameterTransaction pending;
+        uint64_t pendingEpoch = 0;
+        if (m_parameterQueue.take(pending, pendingEpoch))
+            applyParameters(pending, pendingEpoch);
+        m_parameterEpoch.reset();
+
         m_isStreaming = true;
+        m_thread = std::make_unique<std::thread>(&DummyTestCamera::produceFunction, this);
+
         notifyStateChanged("stream", "true");
         return true;
     }
@@ -73,6 +110,32 @@ namespace lzx
             return true;
 
         m_isStreaming = false;
+        m_thread->join();
+        m_thread.reset();
+
+        Log::info(QString("DummyTest produced %1 frames, %2 fps measured, late %3")
+                      .arg(m_produced.load())
+                      .arg(m_measuredFrameRate.load(), 0, 'f', 1)
+                      .arg(m_late.load()));
+
+        auto stats = m_framePool->statistics();
+        Log::info(QString("DummyTest frame pool: acquired %1 exhausted %2 oversized %3 high water %4/%5 huge pages %6")
+                      .arg(stats.acquired)
+                      .arg(stats.exhausted)
+                      .arg(stats.oversized)
+                      .arg(stats.highWater)
+                      .arg(stats.capacity)
+                      .arg(stats.hugePageBuffers));
+
+        for (const auto &busStats : m_frameBus->statistics())
+        {
+            Log::info(QString("DummyTest frame bus [%1]: delivered %2 skipped %3 dropped %4")
+                          .arg(QString::fromStdString(busStats.name))
+                          .arg(busStats.delivered)
+                          .arg(busStats.skipped)
+                          .arg(busStats.dropped));
+        }
+
         notifyStateChanged("stream", "false");
         return true;
     }
@@ -85,178 +148,316 @@ namespace lzx
 
         return true;
     }
-    bool DummyTestCamera::getFrame(unsigned char *buffer, int &width, int &height, int &channels, int &bitDepth)
+
+    Frame DummyTestCamera::acquireLatestFrame()
+    {
+        return m_subscription->acquire();
+    }
+
+    void DummyTestCamera::produceFunction()
     {
-        if (!m_isOpened || !m_isStreaming || buffer == nullptr)
+        using Clock = std::chrono::steady_clock;
+
+        Clock::time_point due = Clock::now();
+        Clock::time_point rateWindowStart = due;
+        uint64_t rateWindowFrames = 0;
+        uint64_t frameIndex = 0;
+        uint32_t rng = 0x9E3779B9u;
+
+        // 已从队列取出、还在等待生效的参数
+        ParameterTransaction delayed;
+        uint64_t delayedEpoch = 0;
+        uint64_t delayedUntil = 0;
+        bool hasDelayed = false;
+
+        while (m_isStreaming)
         {
-            Log::error(QString("camera getFrame failed: opened %1 streaming %2 buffer %3")
-                           .arg(m_isOpened)
-                           .arg(m_isStreaming)
-                           .arg(buffer != nullptr));
-            return false;
-        }
+            // 按帧率定时，0 表示不限速
+            double frameRate = m_frameRate.load(std::memory_order_relaxed);
+            if (frameRate > 0)
+            {
+                auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / frameRate));
+                due += period;
 
-        width = m_width;
-        height = m_height;
-        channels = m_channels;
-        bitDepth = m_bitDepth;
+                Clock::time_point now = Clock::now();
+                if (now > due + period)
+                {
+                    // 生成跟不上设定帧率，重新对时而不是连续补帧
+                    m_late.fetch_add(1, std::memory_order_relaxed);
+                    due = now;
+                }
+                else
+                {
+                    // 系统定时器精度有限，长睡眠提前1ms醒来，剩下的时间让出时间片轮询
+                    if (due - now > std::chrono::milliseconds(2))
+                        std::this_thread::sleep_until(due - std::chrono::milliseconds(1));
+                    while (Clock::now() < due && m_isStreaming)
+                        std::this_thread::yield();
+                }
+            }
 
-        // 创建临时缓冲区
-        std::vector<unsigned char> tempBuffer = m_testPattern;
+            ParameterTransaction pending;
+            uint64_t pendingEpoch = 0;
+            if (m_parameterQueue.take(pending, pendingEpoch))
+            {
+                if (!hasDelayed)
+                    delayedUntil = frameIndex + m_settleFrames.load(std::memory_order_relaxed);
+                delayed.merge(pending);
+                delayedEpoch = pendingEpoch;
+                hasDelayed = true;
+            }
+            if (hasDelayed && frameIndex >= delayedUntil)
+            {
+                applyParameters(delayed, delayedEpoch);
+                delayed = ParameterTransaction();
+                hasDelayed = false;
+            }
 
-        // 根据位深度获取最大值
-        uint16_t maxValue = (1 << m_bitDepth) - 1;
+            // 取流期间挂接了新队列（开始录像、帧配对），帧池容量不够时重建
+            size_t poolCapacity = framePoolCapacity(*m_frameBus);
+            if (m_framePool->capacity() < poolCapacity)
+            {
+                size_t bufferSize = m_framePool->bufferSize();
+                m_framePool = FramePool::create(poolCapacity, bufferSize, bufferSize >= FramePool::HugePageThreshold);
+            }
 
-        // 在临时缓冲区中绘制动态图案
-        static int frameCount = 0;
-        frameCount++;
+            Frame frame = m_framePool->acquire(m_width, m_height, m_channels, m_bitDepth, m_stride);
+
+            int64_t grabNs = FrameMetadata::now();
+            if (m_bitDepth > 8)
+                renderFrame(reinterpret_cast<uint16_t *>(frame.buffer()), frameIndex, rng);
+            else
+                renderFrame(frame.buffer(), frameIndex, rng);
+
+            frame.setSequenceNumber(Frame::nextSequenceNumber());
+            FrameMetadata &meta = frame.metadata();
+            meta.hostTimestampNs = grabNs;
+            meta.stageNs[FrameMetadata::Grab] = grabNs;
+            meta.exposureUs = m_exposureUs.load(std::memory_order_relaxed);
+            meta.deviceFrameCounter = frameIndex;
+            meta.parameterEpoch = m_parameterEpoch.tag(meta, m_width, m_height);
+            meta.mark(FrameMetadata::Enqueue);
+
+            m_frameBus->publish(std::move(frame));
+            m_produced.fetch_add(1, std::memory_order_relaxed);
+            frameIndex++;
+
+            // 每秒统计一次实际帧率
+            rateWindowFrames++;
+            Clock::time_point now = Clock::now();
+            if (now - rateWindowStart >= std::chrono::seconds(1))
+            {
+                double seconds = std::chrono::duration<double>(now - rateWindowStart).count();
+                m_measuredFrameRate.store(rateWindowFrames / seconds, std::memory_order_relaxed);
+                rateWindowStart = now;
+                rateWindowFrames = 0;
+            }
+        }
 
-        // 创建一个移动的圆形图案
-        int centerX = m_width / 2 + static_cast<int>(100 * sin(frameCount * 0.01));
-        int centerY = m_height / 2 + static_cast<int>(100 * cos(frameCount * 0.01));
-        int radius = 20;
+        if (hasDelayed)
+            applyParameters(delayed, delayedEpoch);
+    }
 
-        if (m_bitDepth == 8)
+    void DummyTestCamera::applyParameters(const ParameterTransaction &transaction, uint64_t epoch)
+    {
+        if (transaction.has(PropertyId::ExposureTime))
         {
-            // 8位图像处理
-            uint8_t *pattern = reinterpret_cast<uint8_t *>(tempBuffer.data());
+            double exposureUs = transaction.value(PropertyId::ExposureTime);
+            m_exposureUs = exposureUs;
+            propertyRegistry.update(PropertyId::ExposureTime, exposureUs);
+        }
+        m_parameterEpoch.applied(epoch, transaction, FrameMetadata::now());
+    }
+
+    uint64_t DummyTestCamera::apply(const ParameterTransaction &transaction)
+    {
+        if (transaction.empty())
+            return m_parameterEpoch.current();
+
+        if (!transaction.has(PropertyId::ExposureTime))
+            return 0;
+
+        ParameterTransaction target;
+        target.setExposure(propertyRegistry.clamp(PropertyId::ExposureTime, transaction.value(PropertyId::ExposureTime)));
+        uint64_t epoch = m_parameterEpoch.allocate();
+
+        if (m_isStreaming)
+            m_parameterQueue.push(epoch, target);
+        else
+            applyParameters(target, epoch);
+
+        notifyStateChanged("exposure", std::to_string(int(target.value(PropertyId::ExposureTime))));
+        return epoch;
+    }
 
-            // 绘制一个实心圆
-            for (int y = -radius; y <= radius; y++)
+    template <typename T>
+    void DummyTestCamera::renderFrame(T *dst, uint64_t frameIndex, uint32_t &rng)
+    {
+        const int pattern = m_pattern.load(std::memory_order_relaxed);
+        const int maxValue = (1 << m_bitDepth) - 1;
+        const size_t rowPixels = m_stride / sizeof(T);
+        const T *background = reinterpret_cast<const T *>(m_background.data());
+        const double brightness = m_exposureUs.load(std::memory_order_relaxed) / ReferenceExposureUs;
+        const int scale = static_cast<int>(std::min(brightness, 128.0) * 256.0 + 0.5); // 8 位定点
+
+        // 背景：没有噪声时整块拷贝，有噪声时每行从噪声表随机偏移处取一段叠加
+        // 8位用 int16 累加，编译器可以按 8 像素一组向量化
+        // 曝光不等于参考曝光时整幅按曝光缩放（噪声不随曝光变化），供自动曝光调试，压力测试仍走快速路径
+        if (scale != 256)
+        {
+            const int width = m_width;
+            const bool noise = (pattern & Noise) != 0;
+            for (int y = 0; y < m_height; ++y)
             {
-                for (int x = -radius; x <= radius; x++)
+                rng ^= rng << 13;
+                rng ^= rng >> 17;
+                rng ^= rng << 5;
+                const int16_t *noiseRow = m_noiseTable.data() + rng % NoiseTableMargin;
+                const T *src = background + y * rowPixels;
+                T *row = dst + y * rowPixels;
+                for (int x = 0; x < width; ++x)
                 {
-                    if (x * x + y * y <= radius * radius)
-                    {
-                        int drawX = centerX + x;
-                        int drawY = centerY + y;
-
-                        // 确保绘制位置在图像范围内
-                        if (drawX >= 0 && drawX < m_width && drawY >= 0 && drawY < m_height)
-                        {
-                            // 创建渐变效果
-                            float distance = sqrt(x * x + y * y) / radius;
-                            uint8_t value = static_cast<uint8_t>(maxValue * (1.0f - distance));
-                            pattern[drawX + drawY * m_width] = value * (sin(frameCount * 0.1) + 1.0f) * 0.5f;
-                        }
-                    }
+                    int value = ((src[x] * scale) >> 8) + (noise ? noiseRow[x] : 0);
+                    row[x] = static_cast<T>(std::min(std::max(value, 0), maxValue));
+                }
+            }
+        }
+        else if (pattern & Noise)
+        {
+            using Acc = typename std::conditional<sizeof(T) == 1, int16_t, int32_t>::type;
+            const int width = m_width; // 8位写入可能与成员别名，先取到局部变量才能向量化
+            for (int y = 0; y < m_height; ++y)
+            {
+                rng ^= rng << 13;
+                rng ^= rng >> 17;
+                rng ^= rng << 5;
+                const int16_t *noise = m_noiseTable.data() + rng % NoiseTableMargin;
+                const T *src = background + y * rowPixels;
+                T *row = dst + y * rowPixels;
+                for (int x = 0; x < width; ++x)
+                {
+                    Acc value = static_cast<Acc>(src[x] + noise[x]);
+                    row[x] = static_cast<T>(std::min<Acc>(std::max<Acc>(value, 0), static_cast<Acc>(maxValue)));
                 }
             }
         }
         else
         {
-            // 16位图像处理
-            uint16_t *pattern = reinterpret_cast<uint16_t *>(tempBuffer.data());
+            memcpy(dst, background, m_stride * m_height);
+        }
+
+        const double t = frameIndex * 0.02;
+
+        // 移动光斑：亮度随曝光缩放，超过满量程时饱和
+        if (pattern & Blobs)
+        {
+            const int r = m_blobRadius;
+            const int size = 2 * r + 1;
+            const int blobCount = m_blobCount.load(std::memory_order_relaxed);
 
-            // 绘制一个实心圆
-            for (int y = -radius; y <= radius; y++)
+            for (int i = 0; i < blobCount; ++i)
             {
-                for (int x = -radius; x <= radius; x++)
+                int centerX = m_width / 2 + static_cast<int>((m_width / 2 - r) * sin(t * (1.0 + i * 0.37) + i));
+                int centerY = m_height / 2 + static_cast<int>((m_height / 2 - r) * cos(t * (1.3 + i * 0.21) + i * 2));
+                float peak = static_cast<float>(maxValue * brightness * (0.75 + 0.25 * sin(t * 5 + i)));
+
+                int x0 = std::max(centerX - r, 0), x1 = std::min(centerX + r, m_width - 1);
+                int y0 = std::max(centerY - r, 0), y1 = std::min(centerY + r, m_height - 1);
+                for (int y = y0; y <= y1; ++y)
                 {
-                    if (x * x + y * y <= radius * radius)
+                    const float *sprite = m_blobSprite.data() + (y - centerY + r) * size;
+                    T *row = dst + y * rowPixels;
+                    for (int x = x0; x <= x1; ++x)
                     {
-                        int drawX = centerX + x;
-                        int drawY = centerY + y;
-
-                        // 确保绘制位置在图像范围内
-                        if (drawX >= 0 && drawX < m_width && drawY >= 0 && drawY < m_height)
-                        {
-                            // 创建渐变效果
-                            float distance = sqrt(x * x + y * y) / radius;
-                            uint16_t value = static_cast<uint16_t>(maxValue * (1.0f - distance));
-                            pattern[drawX + drawY * m_width] = value * (sin(frameCount * 0.1) + 1.0f) * 0.5f;
-                        }
+                        int value = std::min(static_cast<int>(sprite[x - centerX + r] * peak), maxValue);
+                        if (value > row[x])
+                            row[x] = static_cast<T>(value);
                     }
                 }
             }
         }
 
-        // 将临时缓冲区复制到输出缓冲区
-        std::memcpy(buffer, tempBuffer.data(), tempBuffer.size());
-        return true;
+        // 饱和高光：三个方块轮流闪烁，用于检查过曝显示和自动范围
+        if (pattern & Highlights)
+        {
+            const int size = std::max(4, m_height / 40);
+            for (int i = 0; i < 3; ++i)
+            {
+                if (((frameIndex >> 5) + i) % 2)
+                    continue;
+
+                int x0 = m_width * (i + 1) / 4 - size / 2;
+                int y0 = m_height / 4 - size / 2;
+                for (int y = std::max(y0, 0); y < std::min(y0 + size, m_height); ++y)
+                {
+                    T *row = dst + y * rowPixels;
+                    std::fill(row + std::max(x0, 0), row + std::min(x0 + size, m_width), static_cast<T>(maxValue));
+                }
+            }
+        }
     }
 
     void DummyTestCamera::generateTestPattern()
     {
-        // 根据位深度分配内存
-        int bytesPerPixel = m_bitDepth / 8;
-        m_testPattern.resize(m_width * m_height * m_channels * bytesPerPixel);
+        // 行首按缓存行对齐，和海康相机的帧布局一致
+        m_stride = Frame::alignedStride(m_width, m_channels, m_bitDepth);
+        m_background.assign(m_stride * m_height, 0);
 
         // 根据位深度获取最大值
-        uint16_t maxValue = (1 << m_bitDepth) - 1; // 8位最大值255或16位最大值65535
+        int maxValue = (1 << m_bitDepth) - 1;
+        int centerX = m_width / 2;
+        int centerY = m_height / 2;
+        int lineWidth = 2;
 
-        if (m_bitDepth == 8)
+        for (int y = 0; y < m_height; ++y)
         {
-            // 8位图像处理
-            uint8_t *pattern = reinterpret_cast<uint8_t *>(m_testPattern.data());
-
-            for (int y = 0; y < m_height; ++y)
+            for (int x = 0; x < m_width; ++x)
             {
-                for (int x = 0; x < m_width; ++x)
-                {
-                    int index = y * m_width + x;
-
-                    // 创建渐变效果
-                    float gradientX = static_cast<float>(x) / m_width;
-                    float gradientY = static_cast<float>(y) / m_height;
-                    float gradient = (gradientX + gradientY) / 2.0f;
+                // 创建渐变效果
+                float gradientX = static_cast<float>(x) / m_width;
+                float gradientY = static_cast<float>(y) / m_height;
+                int value = static_cast<int>((gradientX + gradientY) / 2.0f * maxValue);
 
-                    // 将渐变值映射到8位范围
-                    pattern[index] = static_cast<uint8_t>(gradient * maxValue);
-
-                    // 在图像中心绘制十字
-                    int centerX = m_width / 2;
-                    int centerY = m_height / 2;
-                    int lineWidth = 2;
-
-                    if ((abs(x - centerX) < lineWidth) || (abs(y - centerY) < lineWidth))
-                    {
-                        pattern[index] = maxValue; // 白色十字
-                    }
+                // 在图像中心绘制十字
+                if ((abs(x - centerX) < lineWidth) || (abs(y - centerY) < lineWidth))
+                {
+                    value = maxValue; // 白色十字
+                }
 
-                    // 添加网格线
-                    if ((x % 64 == 0) || (y % 64 == 0))
-                    {
-                        pattern[index] = maxValue / 2; // 灰色网格
-                    }
+                // 添加网格线
+                if ((x % 64 == 0) || (y % 64 == 0))
+                {
+                    value = maxValue / 2; // 灰色网格
                 }
+
+                if (m_bitDepth > 8)
+                    reinterpret_cast<uint16_t *>(m_background.data() + y * m_stride)[x] = static_cast<uint16_t>(value);
+                else
+                    m_background[y * m_stride + x] = static_cast<uint8_t>(value);
             }
         }
-        else
+
+        // 噪声表：约满量程 1.5% 的均匀噪声
+        int amplitude = std::max(1, maxValue / 64);
+        std::mt19937 generator(12345);
+        std::uniform_int_distribution<int> distribution(-amplitude, amplitude);
+        m_noiseTable.resize(m_width + NoiseTableMargin);
+        for (auto &value : m_noiseTable)
         {
-            // 16位图像处理
-            uint16_t *pattern = reinterpret_cast<uint16_t *>(m_testPattern.data());
+            value = static_cast<int16_t>(distribution(generator));
+        }
 
-            for (int y = 0; y < m_height; ++y)
+        // 光斑：中心最亮、边缘为0的圆形渐变，半径随画幅缩放
+        m_blobRadius = std::max(8, std::min(m_width, m_height) / 24);
+        int size = 2 * m_blobRadius + 1;
+        m_blobSprite.assign(size * size, 0.0f);
+        for (int y = -m_blobRadius; y <= m_blobRadius; y++)
+        {
+            for (int x = -m_blobRadius; x <= m_blobRadius; x++)
             {
-                for (int x = 0; x < m_width; ++x)
-                {
-                    int index = y * m_width + x;
-
-                    // 创建渐变效果
-                    float gradientX = static_cast<float>(x) / m_width;
-                    float gradientY = static_cast<float>(y) / m_height;
-                    float gradient = (gradientX + gradientY) / 2.0f;
-
-                    // 将渐变值映射到16位范围
-                    pattern[index] = static_cast<uint16_t>(gradient * maxValue);
-
-                    // 在图像中心绘制十字
-                    int centerX = m_width / 2;
-                    int centerY = m_height / 2;
-                    int lineWidth = 2;
-
-                    if ((abs(x - centerX) < lineWidth) || (abs(y - centerY) < lineWidth))
-                    {
-                        pattern[index] = maxValue; // 白色十字
-                    }
-
-                    // 添加网格线
-                    if ((x % 64 == 0) || (y % 64 == 0))
-                    {
-                        pattern[index] = maxValue / 2; // 灰色网格
-                    }
-                }
+                float distance = sqrtf(static_cast<float>(x * x + y * y)) / m_blobRadius;
+                if (distance <= 1.0f)
+                    m_blobSprite[(y + m_blobRadius) * size + x + m_blobRadius] = 1.0f - distance;
             }
         }
     }
@@ -266,16 +467,85 @@ namespace lzx
         QString msg = "set " + QString::fromStdString(name) + " " + QString::number(value);
         Log::info(msg);
 
-        if (name == "width")
+        if (name == "width" || name == "height" || name == "BitDepth")
         {
-            m_width = value;
+            // 尺寸和位深决定帧池和预生成的图案，只能在停止时修改
+            if (m_isStreaming)
+            {
+                Log::error("DummyTest: stop streaming before changing " + QString::fromStdString(name));
+                return false;
+            }
+
+            if (name == "width" && value > 0)
+                m_width = value;
+            else if (name == "height" && value > 0)
+                m_height = value;
+            else if (name == "BitDepth" && value >= 8 && value <= 16)
+                m_bitDepth = value;
+            else
+                return false;
+
             generateTestPattern();
             return true;
         }
-        else if (name == "height")
+        else if (name == "BlobCount")
         {
-            m_height = value;
-            generateTestPattern();
+            m_blobCount = std::min(std::max(value, 0), MaxBlobs);
+            return true;
+        }
+        else if (name == "exposure" && value > 0)
+        {
+            return apply(ParameterTransaction().setExposure(value)) != 0;
+        }
+        else if (name == "SettleFrames")
+        {
+            m_settleFrames = std::max(value, 0);
+            return true;
+        }
+        else if (name == "fps")
+        {
+            m_frameRate = std::max(value, 0);
+            return true;
+        }
+        return false;
+    }
+
+    bool DummyTestCamera::set(const std::string &name, double value)
+    {
+        if (name == "FrameRate" && value >= 0)
+        {
+            m_frameRate = value;
+            return true;
+        }
+        else if (name == "exposure" && value > 0)
+        {
+            return apply(ParameterTransaction().setExposure(value)) != 0;
+        }
+        return false;
+    }
+
+    bool DummyTestCamera::set(const std::string &name, const std::string &value)
+    {
+        if (name == "Pattern")
+        {
+            int pattern = 0;
+            std::stringstream stream(value);
+            std::string token;
+            while (std::getline(stream, token, '+'))
+            {
+                if (token == "blobs")
+                    pattern |= Blobs;
+                else if (token == "highlights")
+                    pattern |= Highlights;
+                else if (token == "noise")
+                    pattern |= Noise;
+                else if (!token.empty() && token != "none")
+                {
+                    Log::error("DummyTest: unknown pattern " + QString::fromStdString(token));
+                    return false;
+                }
+            }
+            m_pattern = pattern;
             return true;
         }
         return false;
@@ -294,11 +564,36 @@ namespace lzx
             value = m_height;
             return true;
         }
+        else if (name == "BitDepth")
+        {
+            value = m_bitDepth;
+            return true;
+        }
         else if (name == "fps")
         {
-            value = 30;
+            value = static_cast<int>(m_frameRate + 0.5);
+            return true;
+        }
+        return false;
+    }
+
+    bool DummyTestCamera::get(const std::string &name, double &value)
+    {
+        if (name == "FrameRate")
+        {
+            value = m_frameRate;
+            return true;
+        }
+        else if (name == "MeasuredFrameRate")
+        {
+            value = m_measuredFrameRate;
+            return true;
+        }
+        else if (name == "exposure")
+        {
+            value = m_exposureUs;
             return true;
         }
         return false;
     }
-}
\ No newline at end of file
+}
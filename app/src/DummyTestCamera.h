@@ -2,16 +2,31 @@
 #define DUMMY_TEST_CAMERA_HPP
 
 #include "ICamera.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
 #include <vector>
 
-#include "TripleBuffer.h"
 #include "Frame.h"
+#include "FrameBus.h"
+#include "FramePool.h"
 
 namespace lzx
 {
+    // 合成传感器：独立的生产线程按设定帧率生成图像，经帧池和帧总线发布，和真实相机走同一条路径，
+    // 用于在没有硬件时对显示/Mask流水线做高帧率（500fps以上）、大画幅（4K以上）的压力测试
     class DummyTestCamera : public ICamera
     {
     public:
+        // 图案组合（按位或）
+        enum Pattern
+        {
+            Blobs = 1 << 0,      // 沿李萨如轨迹移动的渐变光斑
+            Highlights = 1 << 1, // 闪烁的饱和高光块
+            Noise = 1 << 2       // 加性噪声
+        };
+
         DummyTestCamera(int bitDepth = 16);
         virtual ~DummyTestCamera();
 
@@ -23,25 +38,67 @@ namespace lzx
         virtual bool stop() override;
         virtual bool snap() override;
         virtual bool streaming() override { return m_isStreaming; }
-        virtual bool getFrame(unsigned char *buffer, int &width, int &height, int &channels, int &bitDepth) override;
+        virtual Frame acquireLatestFrame() override;
+        virtual FrameBus *frameBus() override { return m_frameBus.get(); }
+
+        // 只支持曝光；取流时由生产线程在两帧之间应用，再过 SettleFrames 帧才生效，模拟真实相机的生效延迟
+        virtual uint64_t apply(const ParameterTransaction &transaction) override;
 
         // 实现一些参数设置和获取
+        // int: width / height / BitDepth（仅停止时可改）, BlobCount, exposure (us，缩放整幅画面的亮度), SettleFrames
+        // double: FrameRate（0 表示不限速）
+        // string: Pattern，如 "blobs+highlights+noise"
         virtual bool set(const std::string &name, int value) override;
+        virtual bool set(const std::string &name, double value) override;
+        virtual bool set(const std::string &name, const std::string &value) override;
         virtual bool get(const std::string &name, int &value) override;
+        virtual bool get(const std::string &name, double &value) override;
 
     private:
+        static constexpr int MaxBlobs = 16;
+        static constexpr int NoiseTableMargin = 4096; // 噪声表比一行多出的长度，每行随机偏移取用
+        static constexpr double ReferenceExposureUs = 10000.0; // 此曝光下光斑峰值恰好到满量程
+
         bool m_isOpened;
-        bool m_isStreaming;
-        std::vector<unsigned char> m_testPattern;
+        std::atomic<bool> m_isStreaming{false};
         int m_width;
         int m_height;
         int m_channels;
         int m_bitDepth;
+        size_t m_stride;
+
+        std::atomic<double> m_frameRate{30.0};
+        std::atomic<int> m_pattern{Blobs | Highlights};
+        std::atomic<int> m_blobCount{3};
+        std::atomic<double> m_exposureUs{ReferenceExposureUs};
+        std::atomic<int> m_settleFrames{2};
+
+        ParameterEpoch m_parameterEpoch{ParameterEpoch::Confirm::Reported};
+        ParameterQueue m_parameterQueue;
+
+        // 预先生成，生产线程只读
+        std::vector<unsigned char> m_background; // 渐变+十字+网格，按 m_stride 排列
+        std::vector<int16_t> m_noiseTable;       // 噪声值
+        std::vector<float> m_blobSprite;         // 光斑的亮度分布 (2r+1)^2
+        int m_blobRadius = 0;
+
+        std::unique_ptr<std::thread> m_thread;
+        std::shared_ptr<FramePool> m_framePool;
+        std::unique_ptr<FrameBus> m_frameBus;
+        std::unique_ptr<FrameBus::Subscription> m_subscription;
+
+        // 统计
+        std::atomic<uint64_t> m_produced{0};
+        std::atomic<uint64_t> m_late{0}; // 落后计划时刻超过一帧、重新对时的次数
+        std::atomic<double> m_measuredFrameRate{0.0};
 
-        TripleBuffer<Frame> m_frameBuffer;
+        void generateTestPattern(); // 生成背景、噪声表和光斑
+        void applyParameters(const ParameterTransaction &transaction, uint64_t epoch);
+        void produceFunction();
 
-        void generateTestPattern(); // 生成测试图案
+        template <typename T>
+        void renderFrame(T *dst, uint64_t frameIndex, uint32_t &rng);
     };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -1,6 +1,123 @@
 #include "Frame.h"
+#include "FramePool.h"
+
+#include <algorithm>
+#include <new>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#include <cstdlib>
+#endif
 
 namespace lzx
 {
-    size_t Frame::s_sequenceNumber = 0;
-}
\ No newline at end of file
+    std::atomic<size_t> Frame::s_sequenceNumber{0};
+
+    FrameBuffer *FrameBuffer::create(size_t capacity)
+    {
+        return new FrameBuffer(capacity);
+    }
+
+    FrameBuffer::FrameBuffer(size_t capacity, bool hugePages)
+        : m_capacity(capacity)
+    {
+        if (hugePages)
+        {
+#ifdef _WIN32
+            // 需要“锁定内存页”权限，没有权限时 VirtualAlloc 失败，退回普通内存
+            SIZE_T largePage = GetLargePageMinimum();
+            if (largePage > 0)
+            {
+                size_t size = (capacity + largePage - 1) / largePage * largePage;
+                void *p = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE | MEM_LARGE_PAGES, PAGE_READWRITE);
+                if (p)
+                {
+                    m_data = static_cast<unsigned char *>(p);
+                    m_allocated = size;
+                    m_hugePages = true;
+                }
+            }
+#elif defined(__linux__)
+            // 透明大页：按2MB对齐分配后提示内核合并
+            const size_t largePage = 2 * 1024 * 1024;
+            size_t size = (capacity + largePage - 1) / largePage * largePage;
+            void *p = nullptr;
+            if (posix_memalign(&p, largePage, size) == 0)
+            {
+                madvise(p, size, MADV_HUGEPAGE);
+                m_data = static_cast<unsigned char *>(p);
+                m_allocated = size;
+                m_hugePages = true;
+            }
+#endif
+        }
+
+        if (!m_data)
+        {
+            m_data = static_cast<unsigned char *>(::operator new(capacity, std::align_val_t(Alignment)));
+            m_allocated = capacity;
+        }
+    }
+
+    FrameBuffer::~FrameBuffer()
+    {
+        if (m_hugePages)
+        {
+#ifdef _WIN32
+            VirtualFree(m_data, 0, MEM_RELEASE);
+#elif defined(__linux__)
+            free(m_data);
+#endif
+            return;
+        }
+
+        ::operator delete(m_data, std::align_val_t(Alignment));
+    }
+
+    void FrameBuffer::release()
+    {
+        if (m_refCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        {
+            return;
+        }
+
+        if (m_owner)
+        {
+            // 先把池的引用移出来，归还后如果这是池的最后一个引用，池会在这里析构并释放全部存储块
+            std::shared_ptr<FramePool> owner = std::move(m_owner);
+            owner->recycle(this);
+        }
+        else
+        {
+            delete this;
+        }
+    }
+
+    void Frame::fill(const std::vector<unsigned char> &color)
+    {
+        size_t pixelBytes = packedStride(1, m_channels, m_bitDepth);
+        if (empty() || color.size() != pixelBytes)
+        {
+            return;
+        }
+
+        // 第一行：写入一个像素后按已填充部分成倍 memcpy，其余各行整行拷贝第一行
+        size_t rowBytes = packedStride(m_width, m_channels, m_bitDepth);
+        unsigned char *first = m_storage->data();
+        memcpy(first, color.data(), pixelBytes);
+        for (size_t filled = pixelBytes; filled < rowBytes; filled *= 2)
+        {
+            memcpy(first + filled, first, std::min(filled, rowBytes - filled));
+        }
+
+        for (int y = 1; y < m_height; y++)
+        {
+            memcpy(m_storage->data() + y * m_stride, first, rowBytes);
+        }
+    }
+}
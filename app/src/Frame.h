@@ -2,12 +2,123 @@
 #define FRAME_H
 
 #include <vector>
+#include <atomic>
+#include <memory>
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <chrono>
+
+#include "FrameView.h"
 
 namespace lzx
 {
+    class FramePool;
+
+    // 帧数据存储块：64字节对齐，带侵入式引用计数
+    // 由 FramePool 借出的存储块在引用归零时回收到池中，否则直接释放
+    // 大尺寸传感器可以申请大页内存，减少 TLB 缺失，申请失败时退回普通内存
+    class FrameBuffer
+    {
+    public:
+        static constexpr size_t Alignment = 64;
+
+        // 分配一个不属于任何池的存储块（内容未初始化）
+        static FrameBuffer *create(size_t capacity);
+
+        unsigned char *data() { return m_data; }
+        const unsigned char *data() const { return m_data; }
+        size_t capacity() const { return m_capacity; }
+        bool hugePages() const { return m_hugePages; }
+
+        void addRef() { m_refCount.fetch_add(1, std::memory_order_relaxed); }
+        void release();
+
+    private:
+        friend class FramePool;
+
+        explicit FrameBuffer(size_t capacity, bool hugePages = false);
+        ~FrameBuffer();
+
+        FrameBuffer(const FrameBuffer &) = delete;
+        FrameBuffer &operator=(const FrameBuffer &) = delete;
+
+        std::atomic<int> m_refCount{0};
+        unsigned char *m_data = nullptr;
+        size_t m_capacity = 0;
+        size_t m_allocated = 0; // 实际分配的字节数（大页会向上取整）
+        bool m_hugePages = false;
+        std::shared_ptr<FramePool> m_owner; // 借出期间持有所属的池，保证池比存储块活得久
+    };
+
+    // 每帧附带的元数据，跟随 Frame 的值拷贝（不共享），下游各阶段在自己的副本上打时间戳
+    struct FrameMetadata
+    {
+        // 流水线各阶段
+        enum Stage
+        {
+            Grab,          // SDK 返回图像
+            Enqueue,       // 发布到帧总线
+            TextureUpload, // 上传到显示纹理
+            MaskEncode,    // DMD 编码完成
+            Present,       // 交换缓冲区，送显
+            StageCount
+        };
+
+        int64_t hostTimestampNs = 0;     // SDK 返回时的主机单调时钟（ns）
+        double exposureUs = 0.0;         // 生效的曝光时间（us）
+        double gain = 0.0;               // 生效的增益
+        uint64_t deviceFrameCounter = 0; // 相机/驱动给出的帧计数
+        uint64_t droppedGap = 0;         // 与上一帧之间丢失的帧数
+        int64_t stageNs[StageCount] = {}; // 各阶段的主机单调时钟，0 表示未经过
+        int64_t deviceTimestampNs = 0;   // 相机时钟的时间戳（ns），0 表示相机不提供
+        int64_t exposureStartNs = 0;     // 由相机时钟映射到主机时钟的曝光开始时间，0 表示没有映射
+        uint64_t parameterEpoch = 0;     // 拍摄这一帧时生效的参数组编号，见 ParameterEpoch
+
+        // 曝光中点（主机时钟，ns），没有映射时用到达时间减去曝光时间估计
+        int64_t exposureMidNs() const
+        {
+            int64_t exposureNs = static_cast<int64_t>(exposureUs * 1000.0);
+            int64_t start = exposureStartNs != 0 ? exposureStartNs : hostTimestampNs - exposureNs;
+            return start + exposureNs / 2;
+        }
+
+        static int64_t now()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now().time_since_epoch())
+                .count();
+        }
+
+        void mark(Stage stage) { stageNs[stage] = now(); }
+
+        // 两个阶段之间的耗时（ns），任一阶段未经过时返回 -1
+        int64_t elapsed(Stage from, Stage to) const
+        {
+            if (stageNs[from] == 0 || stageNs[to] == 0)
+                return -1;
+            return stageNs[to] - stageNs[from];
+        }
+    };
+
+    // 图像帧，拷贝为浅拷贝（共享同一存储块），生产者写完后视为只读
+    // 行可以带填充（stride），池化的帧行首按缓存行对齐
     class Frame
     {
     public:
+        // 紧密排列的行字节数
+        static size_t packedStride(int width, int channels, int bitDepth)
+        {
+            return static_cast<size_t>(width) * channels * (bitDepth > 8 ? 2 : 1);
+        }
+
+        // 行首按缓存行对齐的行字节数
+        static size_t alignedStride(int width, int channels, int bitDepth)
+        {
+            size_t packed = packedStride(width, channels, bitDepth);
+            return (packed + FrameBuffer::Alignment - 1) / FrameBuffer::Alignment * FrameBuffer::Alignment;
+        }
+
         // 无参 构造函数
         Frame() : m_width(0), m_height(0), m_channels(0), m_bitDepth(8)
         {
@@ -19,8 +130,15 @@ namespace lzx
               m_height(height),
               m_channels(channels),
               m_bitDepth(bitDepth),
-              m_data(width * height * channels * (bitDepth > 8 ? 2 : 1), 0)
+              m_stride(packedStride(width, channels, bitDepth)),
+              m_size(m_stride * height)
         {
+            if (m_size > 0)
+            {
+                m_storage = FrameBuffer::create(m_size);
+                m_storage->addRef();
+                memset(m_storage->data(), 0, m_size);
+            }
         }
 
         // 带参
@@ -28,79 +146,199 @@ namespace lzx
             : m_width(width),
               m_height(height),
               m_channels(channels),
-              m_bitDepth(bitDepth), m_data(data)
+              m_bitDepth(bitDepth),
+              m_stride(packedStride(width, channels, bitDepth)),
+              m_size(data.size())
         {
+            if (m_size > 0)
+            {
+                m_storage = FrameBuffer::create(m_size);
+                m_storage->addRef();
+                memcpy(m_storage->data(), data.data(), m_size);
+            }
+        }
+
+        Frame(const Frame &other)
+            : m_width(other.m_width),
+              m_height(other.m_height),
+              m_channels(other.m_channels),
+              m_bitDepth(other.m_bitDepth),
+              m_stride(other.m_stride),
+              m_storage(other.m_storage),
+              m_size(other.m_size),
+              m_sequenceNumber(other.m_sequenceNumber),
+              m_metadata(other.m_metadata)
+        {
+            if (m_storage)
+                m_storage->addRef();
         }
 
-        ~Frame() = default;
+        Frame(Frame &&other) noexcept
+            : m_width(other.m_width),
+              m_height(other.m_height),
+              m_channels(other.m_channels),
+              m_bitDepth(other.m_bitDepth),
+              m_stride(other.m_stride),
+              m_storage(other.m_storage),
+              m_size(other.m_size),
+              m_sequenceNumber(other.m_sequenceNumber),
+              m_metadata(other.m_metadata)
+        {
+            other.m_storage = nullptr;
+            other.m_size = 0;
+        }
+
+        Frame &operator=(const Frame &other)
+        {
+            if (this != &other)
+            {
+                if (other.m_storage)
+                    other.m_storage->addRef();
+                reset();
+                m_width = other.m_width;
+                m_height = other.m_height;
+                m_channels = other.m_channels;
+                m_bitDepth = other.m_bitDepth;
+                m_stride = other.m_stride;
+                m_storage = other.m_storage;
+                m_size = other.m_size;
+                m_sequenceNumber = other.m_sequenceNumber;
+                m_metadata = other.m_metadata;
+            }
+            return *this;
+        }
+
+        Frame &operator=(Frame &&other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                m_width = other.m_width;
+                m_height = other.m_height;
+                m_channels = other.m_channels;
+                m_bitDepth = other.m_bitDepth;
+                m_stride = other.m_stride;
+                m_storage = other.m_storage;
+                m_size = other.m_size;
+                m_sequenceNumber = other.m_sequenceNumber;
+                m_metadata = other.m_metadata;
+                other.m_storage = nullptr;
+                other.m_size = 0;
+            }
+            return *this;
+        }
+
+        ~Frame() { reset(); }
 
         int width() const { return m_width; }
         int height() const { return m_height; }
         int channels() const { return m_channels; }
         int bitDepth() const { return m_bitDepth; }
+        size_t stride() const { return m_stride; }
+        bool isContiguous() const { return m_stride == packedStride(m_width, m_channels, m_bitDepth); }
         size_t sn() const { return m_sequenceNumber; }
         void setSequenceNumber(size_t sn) { m_sequenceNumber = sn; }
 
-        void fill(const std::vector<unsigned char> &color)
+        FrameMetadata &metadata() { return m_metadata; }
+        const FrameMetadata &metadata() const { return m_metadata; }
+
+        // 是否持有数据
+        bool empty() const { return m_storage == nullptr; }
+
+        // 释放对存储块的引用（池化的存储块会被回收）
+        void reset()
         {
-            size_t bytesPerPixelComponent = (m_bitDepth > 8) ? 2 : 1;
-            if (color.size() != m_channels * bytesPerPixelComponent)
+            if (m_storage)
+            {
+                m_storage->release();
+                m_storage = nullptr;
+            }
+            m_size = 0;
+        }
+
+        // 所有像素填成同一个值，color 为一个像素的字节（16 位为小端）
+        void fill(const std::vector<unsigned char> &color);
+
+        // 从外部缓冲区拷贝像素，srcStride 为 0 表示源数据紧密排列
+        void fill(const unsigned char *src, size_t srcStride = 0)
+        {
+            if (empty())
+                return;
+
+            size_t rowBytes = packedStride(m_width, m_channels, m_bitDepth);
+            if (srcStride == 0)
+                srcStride = rowBytes;
+
+            if (srcStride == m_stride)
             {
+                memcpy(m_storage->data(), src, m_size);
                 return;
             }
 
-            for (int i = 0; i < m_width * m_height; i++)
+            for (int y = 0; y < m_height; y++)
             {
-                for (int j = 0; j < m_channels; j++)
-                {
-                    for (size_t b = 0; b < bytesPerPixelComponent; b++)
-                    {
-                        m_data[i * m_channels * bytesPerPixelComponent + j * bytesPerPixelComponent + b] =
-                            color[j * bytesPerPixelComponent + b];
-                    }
-                }
+                memcpy(m_storage->data() + y * m_stride, src + y * srcStride, rowBytes);
             }
         }
 
-        void fill(const unsigned char *color)
+        // 整帧的只读视图，可以继续取 roi() 或 decimate()
+        FrameView view() const
         {
-            size_t bytesPerPixel = m_channels * (m_bitDepth > 8 ? 2 : 1);
-            memcpy(m_data.data(), color, m_width * m_height * bytesPerPixel);
+            return FrameView(data(), m_width, m_height, m_channels, m_bitDepth, m_stride);
         }
 
-        const unsigned char *data() const { return m_data.data(); }
+        const unsigned char *data() const { return m_storage ? m_storage->data() : nullptr; }
 
-        static size_t sequenceNumber() { return s_sequenceNumber; }
+        // 全局帧序号，所有相机共用，从1开始
+        static size_t sequenceNumber() { return s_sequenceNumber.load(std::memory_order_relaxed); }
+        static size_t nextSequenceNumber() { return s_sequenceNumber.fetch_add(1, std::memory_order_relaxed) + 1; }
 
         // Function to get a pointer to the internal buffer, used for writing data to the buffer
         unsigned char *buffer()
         {
-            return m_data.data();
+            return m_storage ? m_storage->data() : nullptr;
         }
 
-        // Function to get the size of the internal buffer
+        // Function to get the size of the internal buffer (stride * height)
         size_t bufferSize() const
         {
-            return m_data.size();
+            return m_size;
         }
 
         // const function to get a pointer to the internal buffer, used for reading data from the buffer
         const unsigned char *buffer() const
         {
-            return m_data.data();
+            return m_storage ? m_storage->data() : nullptr;
         }
 
     private:
+        friend class FramePool;
+
+        // 接管一个已经 addRef 过的存储块（供 FramePool 使用，内容未初始化）
+        Frame(int width, int height, int channels, int bitDepth, size_t stride, FrameBuffer *storage, size_t size)
+            : m_width(width),
+              m_height(height),
+              m_channels(channels),
+              m_bitDepth(bitDepth),
+              m_stride(stride),
+              m_storage(storage),
+              m_size(size)
+        {
+        }
+
         int m_width;
         int m_height;
         int m_channels;
         int m_bitDepth;
-        std::vector<unsigned char> m_data;
+        size_t m_stride = 0; // 行间距（字节）
+        FrameBuffer *m_storage = nullptr;
+        size_t m_size = 0;
 
-        static size_t s_sequenceNumber;
+        static std::atomic<size_t> s_sequenceNumber;
 
         size_t m_sequenceNumber = 0;
+        FrameMetadata m_metadata;
     };
 }
 
-#endif
\ No newline at end of file
+#endif
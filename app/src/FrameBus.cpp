@@ -0,0 +1,204 @@
+#include "FrameBus.h"
+
+#include <algorithm>
+
+namespace lzx
+{
+    FrameBus::Subscription::Subscription(FrameBus *bus, const std::string &name, DeliveryMode mode)
+        : m_bus(bus),
+          m_name(name),
+          m_mode(mode),
+          m_cursor(bus->published())
+    {
+    }
+
+    FrameBus::Subscription::~Subscription()
+    {
+        std::lock_guard<std::mutex> lock(m_bus->m_subscribersMutex);
+        auto &subscribers = m_bus->m_subscribers;
+        subscribers.erase(std::remove(subscribers.begin(), subscribers.end(), this), subscribers.end());
+        m_bus->m_subscriberCount.store(subscribers.size(), std::memory_order_relaxed);
+    }
+
+    bool FrameBus::Subscription::hasNewFrame() const
+    {
+        return m_bus->published() > m_cursor;
+    }
+
+    Frame FrameBus::Subscription::acquire()
+    {
+        Frame frame;
+
+        while (true)
+        {
+            uint64_t latest = m_bus->published();
+            if (latest <= m_cursor)
+            {
+                return frame;
+            }
+
+            uint64_t target = (m_mode == DeliveryMode::Latest) ? latest : m_cursor + 1;
+
+            // 环形槽位中仍然可读的最早序号
+            uint64_t depth = m_bus->m_slots.size();
+            uint64_t oldest = latest >= depth ? latest - depth + 1 : 1;
+            if (target < oldest)
+            {
+                target = oldest;
+            }
+
+            if (m_bus->read(target, frame))
+            {
+                uint64_t missed = target - m_cursor - 1;
+                if (missed > 0)
+                {
+                    if (m_mode == DeliveryMode::Latest)
+                        m_skipped.fetch_add(missed, std::memory_order_relaxed);
+                    else
+                        m_dropped.fetch_add(missed, std::memory_order_relaxed);
+                }
+
+                m_cursor = target;
+                m_delivered.fetch_add(1, std::memory_order_relaxed);
+                return frame;
+            }
+
+            // 读取期间槽位被生产者覆盖，重新定位
+        }
+    }
+
+    FrameBus::SubscriberStatistics FrameBus::Subscription::statistics() const
+    {
+        SubscriberStatistics stats;
+        stats.name = m_name;
+        stats.delivered = m_delivered.load(std::memory_order_relaxed);
+        stats.skipped = m_skipped.load(std::memory_order_relaxed);
+        stats.dropped = m_dropped.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    FrameBus::FrameBus(size_t depth)
+        : m_slots(std::max<size_t>(depth, 2))
+    {
+    }
+
+    FrameBus::~FrameBus()
+    {
+    }
+
+    void FrameBus::publish(Frame frame)
+    {
+        if (m_ringCount.load(std::memory_order_acquire) > 0)
+        {
+            std::lock_guard<std::mutex> lock(m_ringsMutex);
+            for (const auto &ring : m_rings)
+            {
+                ring->push(frame);
+            }
+        }
+
+        uint64_t sequence = m_latest.load(std::memory_order_relaxed) + 1;
+        Slot &slot = m_slots[sequence % m_slots.size()];
+
+        Frame evicted;
+        slot.lock.lock();
+        evicted = std::move(slot.frame);
+        slot.frame = std::move(frame);
+        slot.sequence = sequence;
+        slot.lock.unlock();
+
+        m_latest.store(sequence, std::memory_order_release);
+
+        if (m_listenerCount.load(std::memory_order_acquire) > 0)
+        {
+            std::lock_guard<std::mutex> lock(m_listenersMutex);
+            for (const auto &listener : m_listeners)
+            {
+                listener.second();
+            }
+        }
+
+        // evicted 在锁外析构，缓冲区归还帧池
+    }
+
+    bool FrameBus::read(uint64_t sequence, Frame &frame)
+    {
+        Slot &slot = m_slots[sequence % m_slots.size()];
+
+        slot.lock.lock();
+        bool valid = slot.sequence == sequence;
+        if (valid)
+        {
+            frame = slot.frame;
+        }
+        slot.lock.unlock();
+
+        return valid;
+    }
+
+    void FrameBus::attachRing(const std::shared_ptr<FrameRing> &ring)
+    {
+        std::lock_guard<std::mutex> lock(m_ringsMutex);
+        if (std::find(m_rings.begin(), m_rings.end(), ring) == m_rings.end())
+        {
+            m_rings.push_back(ring);
+            m_ringDepth.fetch_add(ring->depth(), std::memory_order_relaxed);
+        }
+        m_ringCount.store(m_rings.size(), std::memory_order_release);
+    }
+
+    void FrameBus::detachRing(const std::shared_ptr<FrameRing> &ring)
+    {
+        std::lock_guard<std::mutex> lock(m_ringsMutex);
+        auto it = std::find(m_rings.begin(), m_rings.end(), ring);
+        if (it != m_rings.end())
+        {
+            m_ringDepth.fetch_sub(ring->depth(), std::memory_order_relaxed);
+            m_rings.erase(it);
+        }
+        m_ringCount.store(m_rings.size(), std::memory_order_release);
+    }
+
+    uint64_t FrameBus::addListener(Listener listener)
+    {
+        std::lock_guard<std::mutex> lock(m_listenersMutex);
+        uint64_t id = ++m_nextListenerId;
+        m_listeners.emplace_back(id, std::move(listener));
+        m_listenerCount.store(m_listeners.size(), std::memory_order_release);
+        return id;
+    }
+
+    void FrameBus::removeListener(uint64_t id)
+    {
+        // 发布线程在锁内调用回调，拿到锁即说明没有正在执行的回调
+        std::lock_guard<std::mutex> lock(m_listenersMutex);
+        m_listeners.erase(std::remove_if(m_listeners.begin(), m_listeners.end(),
+                                         [id](const std::pair<uint64_t, Listener> &listener)
+                                         { return listener.first == id; }),
+                          m_listeners.end());
+        m_listenerCount.store(m_listeners.size(), std::memory_order_release);
+    }
+
+    std::unique_ptr<FrameBus::Subscription> FrameBus::subscribe(const std::string &name, DeliveryMode mode)
+    {
+        std::unique_ptr<Subscription> subscription(new Subscription(this, name, mode));
+
+        std::lock_guard<std::mutex> lock(m_subscribersMutex);
+        m_subscribers.push_back(subscription.get());
+        m_subscriberCount.store(m_subscribers.size(), std::memory_order_relaxed);
+
+        return subscription;
+    }
+
+    std::vector<FrameBus::SubscriberStatistics> FrameBus::statistics() const
+    {
+        std::vector<SubscriberStatistics> result;
+
+        std::lock_guard<std::mutex> lock(m_subscribersMutex);
+        for (const Subscription *subscription : m_subscribers)
+        {
+            result.push_back(subscription->statistics());
+        }
+        return result;
+    }
+}
@@ -0,0 +1,138 @@
+#ifndef FRAME_BUS_H
+#define FRAME_BUS_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "Frame.h"
+#include "FrameRing.h"
+#include "spinlock.hpp"
+
+namespace lzx
+{
+    // 单生产者/多消费者的“最新帧”总线
+    // 生产者把帧写入一个小环形槽位，从不等待消费者；每个订阅者有自己的游标，互不抢帧。
+    // 槽位锁只在拷贝帧句柄（增加引用计数）时持有，不涉及像素拷贝。
+    // 不允许丢帧的消费者（录像）挂接 FrameRing，由发布线程直接入队，溢出按队列策略处理并计数。
+    // 显示端注册到达通知，有新帧时才重绘，不用按刷新率轮询。
+    class FrameBus
+    {
+    public:
+        enum class DeliveryMode
+        {
+            Latest, // 总是取最新帧，跳过中间帧（显示用）
+            Every   // 尽量逐帧取，被环形槽位覆盖的帧记为丢失
+        };
+
+        struct SubscriberStatistics
+        {
+            std::string name;
+            uint64_t delivered = 0; // 交付的帧数
+            uint64_t skipped = 0;   // Latest 模式下主动跳过的帧数
+            uint64_t dropped = 0;   // Every 模式下来不及读取、已被覆盖的帧数
+        };
+
+        class Subscription
+        {
+        public:
+            ~Subscription();
+
+            // 取下一帧（按订阅模式），没有新帧时返回空帧
+            Frame acquire();
+
+            // 是否有尚未读取的新帧
+            bool hasNewFrame() const;
+
+            DeliveryMode mode() const { return m_mode; }
+            SubscriberStatistics statistics() const;
+
+        private:
+            friend class FrameBus;
+
+            Subscription(FrameBus *bus, const std::string &name, DeliveryMode mode);
+
+            Subscription(const Subscription &) = delete;
+            Subscription &operator=(const Subscription &) = delete;
+
+            FrameBus *m_bus;
+            std::string m_name;
+            DeliveryMode m_mode;
+            uint64_t m_cursor; // 已读取的最后一个总线序号
+
+            std::atomic<uint64_t> m_delivered{0};
+            std::atomic<uint64_t> m_skipped{0};
+            std::atomic<uint64_t> m_dropped{0};
+        };
+
+        // depth: 环形槽位数，Every 模式的订阅者最多可以落后 depth-1 帧
+        explicit FrameBus(size_t depth = 4);
+        ~FrameBus();
+
+        // 生产者发布一帧，不会被消费者阻塞
+        void publish(Frame frame);
+
+        // 订阅，返回的订阅对象必须在总线之前销毁
+        std::unique_ptr<Subscription> subscribe(const std::string &name, DeliveryMode mode = DeliveryMode::Latest);
+
+        // 挂接/摘除队列，发布时每帧都会推入所有已挂接的队列（是否丢帧取决于队列的溢出策略）
+        void attachRing(const std::shared_ptr<FrameRing> &ring);
+        void detachRing(const std::shared_ptr<FrameRing> &ring);
+
+        // 新帧写入槽位后在发布线程上调用，回调必须很快（通常只是投递一个重绘请求），不能在回调里注册或注销
+        using Listener = std::function<void()>;
+        uint64_t addListener(Listener listener);
+        void removeListener(uint64_t id); // 返回后回调不会再被调用
+
+        // 已发布的帧数
+        uint64_t published() const { return m_latest.load(std::memory_order_acquire); }
+
+        // 总线和消费者最多同时持有的帧数：全部槽位 + 每个订阅者手里的一帧 + 已挂接队列的深度之和
+        // 生产者按它确定帧池容量，挂接队列后容量不够时重建帧池，否则多出的帧会退化为堆分配
+        size_t retainedFrames() const
+        {
+            return m_slots.size() + m_subscriberCount.load(std::memory_order_relaxed) +
+                   m_ringDepth.load(std::memory_order_relaxed);
+        }
+
+        // 所有订阅者的统计信息
+        std::vector<SubscriberStatistics> statistics() const;
+
+    private:
+        FrameBus(const FrameBus &) = delete;
+        FrameBus &operator=(const FrameBus &) = delete;
+
+        struct Slot
+        {
+            NonBlockingSpinLock lock;
+            Frame frame;
+            uint64_t sequence = 0;
+        };
+
+        // 读取指定序号的帧，槽位已被覆盖时返回 false
+        bool read(uint64_t sequence, Frame &frame);
+
+        std::vector<Slot> m_slots;
+        std::atomic<uint64_t> m_latest{0}; // 最新已发布的序号，从1开始
+
+        mutable std::mutex m_subscribersMutex;
+        std::vector<Subscription *> m_subscribers;
+        std::atomic<size_t> m_subscriberCount{0};
+
+        std::mutex m_ringsMutex;
+        std::vector<std::shared_ptr<FrameRing>> m_rings;
+        std::atomic<size_t> m_ringCount{0}; // 没有挂接队列时发布路径不加锁
+        std::atomic<size_t> m_ringDepth{0}; // 已挂接队列的深度之和
+
+        std::mutex m_listenersMutex;
+        std::vector<std::pair<uint64_t, Listener>> m_listeners;
+        uint64_t m_nextListenerId = 0;
+        std::atomic<size_t> m_listenerCount{0};
+    };
+}
+
+#endif
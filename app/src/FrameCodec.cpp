@@ -0,0 +1,453 @@
+#include "FrameCodec.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRAME_CODEC_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "ThreadPool.h"
+
+namespace lzx
+{
+    namespace
+    {
+        constexpr uint32_t EncodedMagic = 0x31444346; // "FCD1"
+
+#pragma pack(push, 1)
+        struct EncodedHeader
+        {
+            uint32_t magic;
+            int32_t width;
+            int32_t height;
+            uint16_t channels;
+            uint16_t bitDepth;
+            uint32_t tileRows;
+            uint32_t tileCount;
+            // 后接 uint32_t tileBytes[tileCount]，再接各图块数据
+        };
+#pragma pack(pop)
+
+        constexpr int GroupSize = FrameCodec::GroupSize;
+
+        inline int bitWidth(uint32_t value)
+        {
+#ifdef _MSC_VER
+            unsigned long index;
+            return _BitScanReverse(&index, value) ? static_cast<int>(index) + 1 : 0;
+#else
+            return value ? 32 - __builtin_clz(value) : 0;
+#endif
+        }
+
+        inline size_t groupsPerRow(int samples)
+        {
+            return (samples + GroupSize - 1) / GroupSize;
+        }
+
+        template <typename T>
+        size_t maxRowBytes(int samples)
+        {
+            return groupsPerRow(samples) * (1 + GroupSize * sizeof(T));
+        }
+
+        // 图块内所有采样共同的末尾零位数：12 位传感器左对齐输出的 16 位数据低 4 位恒为 0，先移掉
+        template <typename T>
+        int commonShift(const FrameView &src, int y0, int y1, int samples)
+        {
+            T bits = 0;
+            for (int y = y0; y < y1; y++)
+            {
+                const T *row = src.row<T>(y);
+                for (int x = 0; x < samples; x++)
+                    bits |= row[x];
+            }
+
+            int shift = 0;
+            while (bits && shift < static_cast<int>(sizeof(T) * 8) - 1 && !((bits >> shift) & 1))
+                shift++;
+            return shift;
+        }
+
+        // 预测残差 + zigzag，结果写入 out（长度按组补零）
+        template <typename T>
+        void residuals(const T *row, const T *above, int samples, int step, int shift, T *out)
+        {
+            using Signed = typename std::make_signed<T>::type;
+            constexpr int SignShift = sizeof(T) * 8 - 1;
+
+            int x = 0;
+            for (; x < step && x < samples; x++)
+            {
+                T r = static_cast<T>((row[x] >> shift) - (above ? above[x] >> shift : 0));
+                out[x] = static_cast<T>((r << 1) ^ static_cast<T>(static_cast<Signed>(r) >> SignShift));
+            }
+
+#ifdef FRAME_CODEC_SSE2
+            constexpr int Lanes = 16 / sizeof(T);
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i count = _mm_cvtsi32_si128(shift);
+            const __m128i byteMask = _mm_set1_epi8(static_cast<char>(0xFF >> (sizeof(T) == 1 ? shift : 0)));
+            for (; x + Lanes <= samples; x += Lanes)
+            {
+                __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x));
+                __m128i left = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x - step));
+                __m128i zigzag;
+                if (sizeof(T) == 2)
+                {
+                    __m128i r = _mm_sub_epi16(_mm_srl_epi16(current, count), _mm_srl_epi16(left, count));
+                    zigzag = _mm_xor_si128(_mm_slli_epi16(r, 1), _mm_srai_epi16(r, 15));
+                }
+                else
+                {
+                    // SSE2 没有 8 位移位，按 16 位移位后去掉相邻字节移进来的位
+                    current = _mm_and_si128(_mm_srl_epi16(current, count), byteMask);
+                    left = _mm_and_si128(_mm_srl_epi16(left, count), byteMask);
+                    __m128i r = _mm_sub_epi8(current, left);
+                    zigzag = _mm_xor_si128(_mm_add_epi8(r, r), _mm_cmpgt_epi8(zero, r));
+                }
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + x), zigzag);
+            }
+#endif
+            for (; x < samples; x++)
+            {
+                T r = static_cast<T>((row[x] >> shift) - (row[x - step] >> shift));
+                out[x] = static_cast<T>((r << 1) ^ static_cast<T>(static_cast<Signed>(r) >> SignShift));
+            }
+
+            int padded = static_cast<int>(groupsPerRow(samples)) * GroupSize;
+            for (; x < padded; x++)
+            {
+                out[x] = 0;
+            }
+        }
+
+        // 一组 16 个值按位或，得到所需位宽
+        template <typename T>
+        int groupBits(const T *values)
+        {
+#ifdef FRAME_CODEC_SSE2
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values));
+            if (sizeof(T) == 2)
+            {
+                a = _mm_or_si128(a, _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + 8)));
+            }
+            a = _mm_or_si128(a, _mm_srli_si128(a, 8));
+            a = _mm_or_si128(a, _mm_srli_si128(a, 4));
+            a = _mm_or_si128(a, _mm_srli_si128(a, 2));
+            uint32_t bits = static_cast<uint32_t>(_mm_cvtsi128_si32(a)) & 0xFFFF;
+            if (sizeof(T) == 1)
+            {
+                bits = (bits | (bits >> 8)) & 0xFF;
+            }
+            return bitWidth(bits);
+#else
+            uint32_t bits = 0;
+            for (int i = 0; i < GroupSize; i++)
+                bits |= values[i];
+            return bitWidth(bits);
+#endif
+        }
+
+        // 16 个值各取低 bits 位，紧密写出 2×bits 字节
+        template <typename T>
+        unsigned char *packGroup(const T *values, int bits, unsigned char *out)
+        {
+            if (bits == 0)
+                return out;
+
+            if (bits == sizeof(T) * 8)
+            {
+                memcpy(out, values, GroupSize * sizeof(T));
+                return out + GroupSize * sizeof(T);
+            }
+
+            uint64_t acc = 0;
+            int filled = 0;
+            for (int i = 0; i < GroupSize; i++)
+            {
+                acc |= static_cast<uint64_t>(values[i]) << filled;
+                filled += bits;
+                if (filled >= 32)
+                {
+                    uint32_t word = static_cast<uint32_t>(acc);
+                    memcpy(out, &word, 4);
+                    out += 4;
+                    acc >>= 32;
+                    filled -= 32;
+                }
+            }
+
+            // 总位数 16×bits 是 16 的倍数，剩下的只可能是半个字
+            if (filled)
+            {
+                uint16_t half = static_cast<uint16_t>(acc);
+                memcpy(out, &half, 2);
+                out += 2;
+            }
+            return out;
+        }
+
+        template <typename T>
+        const unsigned char *unpackGroup(const unsigned char *in, int bits, T *values)
+        {
+            if (bits == 0)
+            {
+                memset(values, 0, GroupSize * sizeof(T));
+                return in;
+            }
+
+            if (bits == sizeof(T) * 8)
+            {
+                memcpy(values, in, GroupSize * sizeof(T));
+                return in + GroupSize * sizeof(T);
+            }
+
+            const unsigned char *end = in + 2 * bits;
+            const uint64_t mask = (uint64_t(1) << bits) - 1;
+            uint64_t acc = 0;
+            int available = 0;
+            for (int i = 0; i < GroupSize; i++)
+            {
+                if (available < bits)
+                {
+                    if (end - in >= 4)
+                    {
+                        uint32_t word;
+                        memcpy(&word, in, 4);
+                        acc |= static_cast<uint64_t>(word) << available;
+                        available += 32;
+                        in += 4;
+                    }
+                    else
+                    {
+                        uint16_t half;
+                        memcpy(&half, in, 2);
+                        acc |= static_cast<uint64_t>(half) << available;
+                        available += 16;
+                        in += 2;
+                    }
+                }
+                values[i] = static_cast<T>(acc & mask);
+                acc >>= bits;
+                available -= bits;
+            }
+            return end;
+        }
+
+        template <typename T>
+        size_t encodeTile(const FrameView &src, int y0, int y1, int samples, int step, unsigned char *out)
+        {
+            std::vector<T> scratch(groupsPerRow(samples) * GroupSize);
+            const size_t groups = groupsPerRow(samples);
+            unsigned char *p = out;
+
+            // 图块头：共同移位
+            int shift = commonShift<T>(src, y0, y1, samples);
+            *p++ = static_cast<unsigned char>(shift);
+
+            for (int y = y0; y < y1; y++)
+            {
+                const T *above = y > y0 ? src.row<T>(y - 1) : nullptr;
+                residuals(src.row<T>(y), above, samples, step, shift, scratch.data());
+
+                for (size_t g = 0; g < groups; g++)
+                {
+                    const T *values = scratch.data() + g * GroupSize;
+                    int bits = groupBits(values);
+                    *p++ = static_cast<unsigned char>(bits);
+                    p = packGroup(values, bits, p);
+                }
+            }
+            return p - out;
+        }
+
+        template <typename T>
+        bool decodeTile(const unsigned char *in, size_t bytes, unsigned char *dst, size_t dstStride,
+                        int y0, int y1, int samples, int step)
+        {
+            using Signed = typename std::make_signed<T>::type;
+
+            std::vector<T> scratch(groupsPerRow(samples) * GroupSize);
+            const size_t groups = groupsPerRow(samples);
+            const unsigned char *end = in + bytes;
+
+            if (in >= end || *in >= sizeof(T) * 8)
+                return false;
+            const int shift = *in++;
+
+            for (int y = y0; y < y1; y++)
+            {
+                for (size_t g = 0; g < groups; g++)
+                {
+                    if (in >= end)
+                        return false;
+                    int bits = *in++;
+                    size_t groupBytes = bits == sizeof(T) * 8 ? GroupSize * sizeof(T) : 2 * bits;
+                    if (bits > static_cast<int>(sizeof(T) * 8) || static_cast<size_t>(end - in) < groupBytes)
+                        return false;
+                    in = unpackGroup(in, bits, scratch.data() + g * GroupSize);
+                }
+
+                // 反 zigzag 后按预测顺序累加
+                T *row = reinterpret_cast<T *>(dst + y * dstStride);
+                const T *above = y > y0 ? reinterpret_cast<const T *>(dst + (y - 1) * dstStride) : nullptr;
+                for (int x = 0; x < samples; x++)
+                {
+                    T z = scratch[x];
+                    T r = static_cast<T>((z >> 1) ^ static_cast<T>(-static_cast<Signed>(z & 1)));
+                    T prediction = x < step ? (above ? above[x] >> shift : 0) : row[x - step] >> shift;
+                    row[x] = static_cast<T>(static_cast<T>(prediction + r) << shift);
+                }
+            }
+            return in == end;
+        }
+    }
+
+    FrameCodec::FrameCodec(ThreadPool *pool)
+        : m_pool(pool)
+    {
+    }
+
+    size_t FrameCodec::maxEncodedBytes(int width, int height, int channels, int bitDepth)
+    {
+        int samples = width * channels;
+        size_t tileCount = (height + TileRows - 1) / TileRows;
+        size_t rowBytes = bitDepth > 8 ? maxRowBytes<uint16_t>(samples) : maxRowBytes<uint8_t>(samples);
+        return sizeof(EncodedHeader) + tileCount * (sizeof(uint32_t) + 1) + rowBytes * height;
+    }
+
+    size_t FrameCodec::encode(const FrameView &src, unsigned char *dst)
+    {
+        if (src.empty() || !src.isRowContiguous())
+            return 0;
+
+        const int samples = src.width() * src.channels();
+        const int step = src.channels();
+        const bool wide = src.bitDepth() > 8;
+        const size_t tileCount = (src.height() + TileRows - 1) / TileRows;
+        const size_t tileCapacity = 1 + (wide ? maxRowBytes<uint16_t>(samples) : maxRowBytes<uint8_t>(samples)) * TileRows;
+
+        if (m_tileBuffers.size() < tileCount)
+            m_tileBuffers.resize(tileCount);
+
+        std::vector<size_t> tileBytes(tileCount);
+        auto encodeOne = [&](size_t tile)
+        {
+            std::vector<unsigned char> &buffer = m_tileBuffers[tile];
+            if (buffer.size() < tileCapacity)
+                buffer.resize(tileCapacity);
+
+            int y0 = static_cast<int>(tile) * TileRows;
+            int y1 = std::min(y0 + TileRows, src.height());
+            tileBytes[tile] = wide ? encodeTile<uint16_t>(src, y0, y1, samples, step, buffer.data())
+                                   : encodeTile<uint8_t>(src, y0, y1, samples, step, buffer.data());
+        };
+
+        if (m_pool)
+            m_pool->parallelFor(tileCount, encodeOne);
+        else
+            for (size_t tile = 0; tile < tileCount; tile++)
+                encodeOne(tile);
+
+        EncodedHeader header;
+        header.magic = EncodedMagic;
+        header.width = src.width();
+        header.height = src.height();
+        header.channels = static_cast<uint16_t>(src.channels());
+        header.bitDepth = static_cast<uint16_t>(src.bitDepth());
+        header.tileRows = TileRows;
+        header.tileCount = static_cast<uint32_t>(tileCount);
+
+        unsigned char *p = dst;
+        memcpy(p, &header, sizeof(header));
+        p += sizeof(header);
+        for (size_t tile = 0; tile < tileCount; tile++)
+        {
+            uint32_t bytes = static_cast<uint32_t>(tileBytes[tile]);
+            memcpy(p, &bytes, sizeof(bytes));
+            p += sizeof(bytes);
+        }
+        for (size_t tile = 0; tile < tileCount; tile++)
+        {
+            memcpy(p, m_tileBuffers[tile].data(), tileBytes[tile]);
+            p += tileBytes[tile];
+        }
+        return p - dst;
+    }
+
+    bool FrameCodec::decode(const unsigned char *src, size_t bytes, unsigned char *dst,
+                            int width, int height, int channels, int bitDepth, size_t dstStride)
+    {
+        EncodedHeader header;
+        if (bytes < sizeof(header))
+            return false;
+        memcpy(&header, src, sizeof(header));
+
+        if (header.magic != EncodedMagic || header.width != width || header.height != height ||
+            header.channels != channels || header.bitDepth != bitDepth || header.tileRows == 0 ||
+            header.tileCount != (height + header.tileRows - 1) / header.tileRows)
+        {
+            return false;
+        }
+
+        const size_t tableBytes = header.tileCount * sizeof(uint32_t);
+        if (bytes < sizeof(header) + tableBytes)
+            return false;
+
+        // 各图块的起始偏移
+        std::vector<size_t> offsets(header.tileCount + 1);
+        offsets[0] = sizeof(header) + tableBytes;
+        for (uint32_t tile = 0; tile < header.tileCount; tile++)
+        {
+            uint32_t tileBytes;
+            memcpy(&tileBytes, src + sizeof(header) + tile * sizeof(uint32_t), sizeof(tileBytes));
+            offsets[tile + 1] = offsets[tile] + tileBytes;
+        }
+        if (offsets[header.tileCount] != bytes)
+            return false;
+
+        const int samples = width * channels;
+        const bool wide = bitDepth > 8;
+        if (dstStride == 0)
+            dstStride = static_cast<size_t>(samples) * (wide ? 2 : 1);
+
+        std::atomic<bool> ok{true};
+        auto decodeOne = [&](size_t tile)
+        {
+            int y0 = static_cast<int>(tile * header.tileRows);
+            int y1 = std::min(y0 + static_cast<int>(header.tileRows), height);
+            const unsigned char *in = src + offsets[tile];
+            size_t tileBytes = offsets[tile + 1] - offsets[tile];
+            bool decoded = wide ? decodeTile<uint16_t>(in, tileBytes, dst, dstStride, y0, y1, samples, channels)
+                                : decodeTile<uint8_t>(in, tileBytes, dst, dstStride, y0, y1, samples, channels);
+            if (!decoded)
+                ok = false;
+        };
+
+        if (m_pool)
+            m_pool->parallelFor(header.tileCount, decodeOne);
+        else
+            for (size_t tile = 0; tile < header.tileCount; tile++)
+                decodeOne(tile);
+
+        return ok;
+    }
+
+    const char *FrameCodec::simdName()
+    {
+#ifdef FRAME_CODEC_SSE2
+        return "SSE2";
+#else
+        return "scalar";
+#endif
+    }
+}
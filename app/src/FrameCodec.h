@@ -0,0 +1,49 @@
+#ifndef FRAME_CODEC_H
+#define FRAME_CODEC_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "FrameView.h"
+
+namespace lzx
+{
+    class ThreadPool;
+
+    // 8/16 位帧的快速无损编码，针对暗背景、少量亮区的 HDR 图像：
+    //   0. 移位：去掉图块内所有采样共同的末尾零位（左对齐的 10/12 位数据）
+    //   1. 预测：每个采样减去同一行前一个像素的同通道值（行首减去上一行行首），差值按位宽回绕
+    //   2. zigzag：有符号差值映射为无符号，小幅度的正负差值都变成小数
+    //   3. 位打包：每 16 个差值一组，按组内最大值确定位宽，写 1 字节位宽 + 2×位宽 字节数据，
+    //      全零组只占 1 字节，满位宽的组直接拷贝
+    // 帧按 TileRows 行切成互相独立的图块，编码和解码都可以在线程池上并行。
+    // 预测、zigzag 和组内最大值用 SSE2 计算；编码结果按小端存储。
+    class FrameCodec
+    {
+    public:
+        static constexpr int TileRows = 64;
+        static constexpr int GroupSize = 16;
+
+        explicit FrameCodec(ThreadPool *pool = nullptr);
+
+        // 编码后可能的最大字节数（不可压缩时略大于原始数据）
+        static size_t maxEncodedBytes(int width, int height, int channels, int bitDepth);
+
+        // 编码到 dst（至少 maxEncodedBytes 字节），返回编码后的字节数；视图行内不连续时返回 0
+        size_t encode(const FrameView &src, unsigned char *dst);
+
+        // 解码到 dst（行距 dstStride，0 表示紧密排列）；尺寸与编码时不一致或数据损坏时返回 false
+        bool decode(const unsigned char *src, size_t bytes, unsigned char *dst,
+                    int width, int height, int channels, int bitDepth, size_t dstStride = 0);
+
+        // 内层循环使用的指令集
+        static const char *simdName();
+
+    private:
+        ThreadPool *m_pool;
+        std::vector<std::vector<unsigned char>> m_tileBuffers; // 每个图块的编码结果，全部完成后按顺序拼接
+    };
+}
+
+#endif
@@ -0,0 +1,170 @@
+#include "FrameMailbox.h"
+
+#include <cstring>
+
+namespace lzx
+{
+    FrameMailbox::FrameMailbox(size_t initialCapacity)
+    {
+        if (initialCapacity > 0)
+        {
+            m_generations.push_back(std::make_unique<Storage>(initialCapacity));
+            m_storage.store(m_generations.back().get(), std::memory_order_release);
+        }
+    }
+
+    FrameMailbox::~FrameMailbox()
+    {
+    }
+
+    void FrameMailbox::write(const FrameView &view, const FrameMetadata &metadata)
+    {
+        if (view.empty() || !view.isRowContiguous())
+        {
+            return;
+        }
+
+        size_t rowBytes = view.width() * view.bytesPerPixel();
+        size_t size = rowBytes * view.height();
+
+        Storage *storage = m_storage.load(std::memory_order_relaxed);
+        if (!storage || storage->capacity < size)
+        {
+            // 帧变大：换一组新槽位，旧槽位可能还有读取方在拷贝，不能释放
+            m_generations.push_back(std::make_unique<Storage>(size));
+            storage = m_generations.back().get();
+            m_storage.store(storage, std::memory_order_release);
+            m_regrows.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        uint64_t sequence = m_sequence.load(std::memory_order_relaxed) + 1;
+        int index = static_cast<int>(sequence & 1);
+        Slot &slot = storage->slots[index];
+        unsigned char *dst = storage->buffers[index].get();
+
+        // 序列锁写端：版本号变为奇数 -> 写数据 -> 版本号变为偶数
+        uint64_t version = slot.version.load(std::memory_order_relaxed);
+        slot.version.store(version + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        if (view.isContiguous())
+        {
+            memcpy(dst, view.data(), size);
+        }
+        else
+        {
+            for (int y = 0; y < view.height(); y++)
+            {
+                memcpy(dst + y * rowBytes, view.row(y), rowBytes);
+            }
+        }
+
+        slot.info.width = view.width();
+        slot.info.height = view.height();
+        slot.info.channels = view.channels();
+        slot.info.bitDepth = view.bitDepth();
+        slot.info.sequence = sequence;
+        slot.info.metadata = metadata;
+        slot.size = size;
+
+        slot.version.store(version + 2, std::memory_order_release);
+        m_sequence.store(sequence, std::memory_order_release);
+        m_writes.fetch_add(1, std::memory_order_relaxed);
+
+        // 只有存在等待者时才碰互斥量，写入路径保持无等待
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_waiters.load(std::memory_order_relaxed) > 0)
+        {
+            std::lock_guard<std::mutex> lock(m_waitMutex);
+            m_newFrame.notify_all();
+        }
+    }
+
+    bool FrameMailbox::read(std::vector<unsigned char> &buffer, FrameInfo &info, uint64_t lastSequence)
+    {
+        while (true)
+        {
+            uint64_t sequence = m_sequence.load(std::memory_order_acquire);
+            if (sequence == 0 || sequence <= lastSequence)
+            {
+                return false;
+            }
+
+            Storage *storage = m_storage.load(std::memory_order_acquire);
+            int index = static_cast<int>(sequence & 1);
+            const Slot &slot = storage->slots[index];
+
+            // 序列锁读端：前后两次版本号一致且为偶数，才说明拷贝期间没有被写入
+            uint64_t before = slot.version.load(std::memory_order_acquire);
+            if (before & 1)
+            {
+                m_retries.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            size_t size = slot.size;
+            if (size > storage->capacity)
+            {
+                m_retries.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            if (buffer.size() < size)
+            {
+                buffer.resize(size);
+            }
+            memcpy(buffer.data(), storage->buffers[index].get(), size);
+            FrameInfo snapshot = slot.info;
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            uint64_t after = slot.version.load(std::memory_order_relaxed);
+            if (before != after || snapshot.sequence <= lastSequence)
+            {
+                // 拷贝期间写入方已经绕回这个槽位，重读最新的
+                m_retries.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            info = snapshot;
+            m_reads.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    bool FrameMailbox::waitForNewer(uint64_t sequence, std::chrono::milliseconds timeout)
+    {
+        if (m_sequence.load(std::memory_order_acquire) > sequence)
+        {
+            return true;
+        }
+
+        m_waits.fetch_add(1, std::memory_order_relaxed);
+
+        std::unique_lock<std::mutex> lock(m_waitMutex);
+        m_waiters.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        bool arrived = m_newFrame.wait_for(lock, timeout, [&]()
+                                           { return m_sequence.load(std::memory_order_acquire) > sequence; });
+
+        m_waiters.fetch_sub(1, std::memory_order_relaxed);
+
+        if (!arrived)
+        {
+            m_timeouts.fetch_add(1, std::memory_order_relaxed);
+        }
+        return arrived;
+    }
+
+    FrameMailbox::Statistics FrameMailbox::statistics() const
+    {
+        Statistics stats;
+        stats.writes = m_writes.load(std::memory_order_relaxed);
+        stats.reads = m_reads.load(std::memory_order_relaxed);
+        stats.retries = m_retries.load(std::memory_order_relaxed);
+        stats.waits = m_waits.load(std::memory_order_relaxed);
+        stats.timeouts = m_timeouts.load(std::memory_order_relaxed);
+        stats.regrows = m_regrows.load(std::memory_order_relaxed);
+        return stats;
+    }
+}
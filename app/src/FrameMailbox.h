@@ -0,0 +1,102 @@
+#ifndef FRAME_MAILBOX_H
+#define FRAME_MAILBOX_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+
+#include "Frame.h"
+#include "FrameView.h"
+
+namespace lzx
+{
+    // 低延迟模式下的“最新帧”信箱：双槽位 + 序列锁（seqlock）
+    // 写入方（采集线程）从不等待，交替写两个槽位；读取方只在读到被写了一半的数据时重试。
+    // 取代原来的 ThreadSafeImage：那里生产者和消费者都用 tryLock，竞争时双方都会失败，写入和读取都可能丢失。
+    class FrameMailbox
+    {
+    public:
+        struct FrameInfo
+        {
+            int width = 0;
+            int height = 0;
+            int channels = 0;
+            int bitDepth = 8;
+            uint64_t sequence = 0; // 信箱内的序号，从1开始
+            FrameMetadata metadata;
+        };
+
+        struct Statistics
+        {
+            uint64_t writes = 0;   // 写入次数
+            uint64_t reads = 0;    // 成功读取次数
+            uint64_t retries = 0;  // 读到撕裂数据后的重试次数
+            uint64_t waits = 0;    // waitForNewer 真正进入等待的次数
+            uint64_t timeouts = 0; // waitForNewer 超时次数
+            uint64_t regrows = 0;  // 帧变大后重新分配槽位的次数
+        };
+
+        explicit FrameMailbox(size_t initialCapacity = 0);
+        ~FrameMailbox();
+
+        // 写入方：拷贝一帧（单写者），不等待任何读取方
+        void write(const FrameView &view, const FrameMetadata &metadata = FrameMetadata());
+
+        // 读取方：序号比 lastSequence 新时拷贝到 buffer（紧密排列）并返回 true
+        bool read(std::vector<unsigned char> &buffer, FrameInfo &info, uint64_t lastSequence = 0);
+
+        // 等待比 sequence 更新的帧，返回 false 表示超时
+        bool waitForNewer(uint64_t sequence, std::chrono::milliseconds timeout);
+
+        // 最新已写入的序号，0 表示还没有数据
+        uint64_t sequence() const { return m_sequence.load(std::memory_order_acquire); }
+
+        Statistics statistics() const;
+
+    private:
+        FrameMailbox(const FrameMailbox &) = delete;
+        FrameMailbox &operator=(const FrameMailbox &) = delete;
+
+        struct Slot
+        {
+            std::atomic<uint64_t> version{0}; // 奇数表示正在写
+            FrameInfo info;
+            size_t size = 0;
+        };
+
+        // 一组槽位及其存储，帧变大时整组替换，旧的组保留到信箱析构，读取方不会访问到已释放的内存
+        struct Storage
+        {
+            explicit Storage(size_t capacity) : capacity(capacity)
+            {
+                for (auto &buffer : buffers)
+                    buffer.reset(new unsigned char[capacity]);
+            }
+
+            size_t capacity;
+            Slot slots[2];
+            std::unique_ptr<unsigned char[]> buffers[2];
+        };
+
+        std::atomic<Storage *> m_storage{nullptr};
+        std::vector<std::unique_ptr<Storage>> m_generations; // 仅写入方访问
+        std::atomic<uint64_t> m_sequence{0};
+
+        std::mutex m_waitMutex;
+        std::condition_variable m_newFrame;
+        std::atomic<int> m_waiters{0};
+
+        std::atomic<uint64_t> m_writes{0};
+        std::atomic<uint64_t> m_reads{0};
+        std::atomic<uint64_t> m_retries{0};
+        std::atomic<uint64_t> m_waits{0};
+        std::atomic<uint64_t> m_timeouts{0};
+        std::atomic<uint64_t> m_regrows{0};
+    };
+}
+
+#endif
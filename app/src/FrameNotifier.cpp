@@ -0,0 +1,45 @@
+#include "FrameNotifier.h"
+
+#include <utility>
+
+namespace lzx
+{
+    FrameNotifier::FrameNotifier(FrameBus *bus, Callback callback)
+        : m_bus(bus),
+          m_callback(std::move(callback))
+    {
+        if (m_bus)
+        {
+            m_listenerId = m_bus->addListener([this]()
+                                              { onPublished(); });
+        }
+    }
+
+    FrameNotifier::~FrameNotifier()
+    {
+        if (m_bus)
+        {
+            m_bus->removeListener(m_listenerId);
+        }
+    }
+
+    void FrameNotifier::onPublished()
+    {
+        m_arrived.fetch_add(1, std::memory_order_relaxed);
+        if (m_pending.exchange(true, std::memory_order_acq_rel))
+        {
+            return;
+        }
+
+        m_notified.fetch_add(1, std::memory_order_relaxed);
+        m_callback();
+    }
+
+    FrameNotifier::Statistics FrameNotifier::statistics() const
+    {
+        Statistics stats;
+        stats.arrived = m_arrived.load(std::memory_order_relaxed);
+        stats.notified = m_notified.load(std::memory_order_relaxed);
+        return stats;
+    }
+}
@@ -0,0 +1,50 @@
+#ifndef FRAME_NOTIFIER_H
+#define FRAME_NOTIFIER_H
+
+#include <atomic>
+#include <functional>
+#include <cstdint>
+
+#include "FrameBus.h"
+
+namespace lzx
+{
+    // 帧到达通知：在帧总线上注册监听，把到达的帧合并成一次重绘请求。
+    // 发出通知后，直到显示端调用 acknowledge()（开始重绘时）之前到达的帧都不再通知，
+    // 相机帧率远高于刷新率时界面线程的事件队列里最多只有一个请求；显示端暂时不重绘（窗口隐藏）时不调用 acknowledge()，通知就一直停着。
+    class FrameNotifier
+    {
+    public:
+        using Callback = std::function<void()>;
+
+        struct Statistics
+        {
+            uint64_t arrived = 0;  // 到达的帧
+            uint64_t notified = 0; // 发出的通知
+        };
+
+        // callback 在发布线程上调用；bus 为空时不通知。总线必须比通知对象活得久
+        FrameNotifier(FrameBus *bus, Callback callback);
+        ~FrameNotifier();
+
+        // 开始处理通知（重绘开始时），之后到达的帧会再次通知
+        void acknowledge() { m_pending.store(false, std::memory_order_release); }
+
+        Statistics statistics() const;
+
+    private:
+        FrameNotifier(const FrameNotifier &) = delete;
+        FrameNotifier &operator=(const FrameNotifier &) = delete;
+
+        void onPublished();
+
+        FrameBus *m_bus;
+        Callback m_callback;
+        uint64_t m_listenerId = 0;
+        std::atomic<bool> m_pending{false};
+        std::atomic<uint64_t> m_arrived{0};
+        std::atomic<uint64_t> m_notified{0};
+    };
+}
+
+#endif
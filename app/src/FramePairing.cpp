@@ -0,0 +1,317 @@
+#include "FramePairing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <QString>
+
+#include "logwidget.hpp"
+
+namespace lzx
+{
+    FramePairing::FramePairing(FrameBus *reference, FrameBus *imaging, const MaskTimeline *masks, const Config &config)
+        : m_referenceBus(reference),
+          m_imagingBus(imaging),
+          m_masks(masks),
+          m_config(config)
+    {
+    }
+
+    FramePairing::~FramePairing()
+    {
+        stop();
+    }
+
+    bool FramePairing::start()
+    {
+        if (m_thread)
+            return true;
+
+        if (!m_referenceBus || !m_imagingBus)
+        {
+            Log::error("FramePairing: both cameras need a frame bus");
+            return false;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            m_stats = Statistics();
+            m_offsetM2 = 0.0;
+            m_absoluteOffset.reset();
+        }
+
+        // 配对线程跟不上时丢弃最旧的帧，不能阻塞相机的采集线程
+        m_referenceRing = std::make_shared<FrameRing>("pairing reference", RingDepth, FrameRing::OverflowPolicy::DropOldest);
+        m_imagingRing = std::make_shared<FrameRing>("pairing imaging", RingDepth, FrameRing::OverflowPolicy::DropOldest);
+
+        m_running = true;
+        m_thread = std::make_unique<std::thread>(&FramePairing::pairFunction, this);
+
+        m_referenceBus->attachRing(m_referenceRing);
+        m_imagingBus->attachRing(m_imagingRing);
+
+        Log::info(QString("Frame pairing started: tolerance %1 us, imaging offset %2 us")
+                      .arg(m_config.toleranceNs / 1000.0, 0, 'f', 0)
+                      .arg(m_config.imagingOffsetNs / 1000.0, 0, 'f', 0));
+        return true;
+    }
+
+    void FramePairing::stop()
+    {
+        if (!m_thread)
+            return;
+
+        m_referenceBus->detachRing(m_referenceRing);
+        m_imagingBus->detachRing(m_imagingRing);
+
+        m_running = false;
+        m_imagingRing->wakeConsumer();
+        m_thread->join();
+        m_thread.reset();
+
+        m_pendingReference.clear();
+        m_pendingImaging.clear();
+
+        logStatistics();
+
+        // 唤醒还在等待配对的消费者
+        m_streamReady.notify_all();
+    }
+
+    bool FramePairing::waitPair(Pair &pair, std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(m_streamMutex);
+        if (!m_streamReady.wait_for(lock, timeout, [this]()
+                                    { return !m_stream.empty() || !m_running; }) ||
+            m_stream.empty())
+        {
+            return false;
+        }
+        pair = std::move(m_stream.front());
+        m_stream.pop_front();
+        return true;
+    }
+
+    bool FramePairing::tryPopPair(Pair &pair)
+    {
+        std::lock_guard<std::mutex> lock(m_streamMutex);
+        if (m_stream.empty())
+            return false;
+        pair = std::move(m_stream.front());
+        m_stream.pop_front();
+        return true;
+    }
+
+    FramePairing::Statistics FramePairing::statistics() const
+    {
+        Statistics stats;
+        {
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            stats = m_stats;
+            if (stats.pairs > 1)
+            {
+                stats.stddevOffsetUs = std::sqrt(m_offsetM2 / (stats.pairs - 1));
+            }
+        }
+        stats.absoluteOffset = m_absoluteOffset.summary();
+
+        if (m_referenceRing && m_imagingRing)
+        {
+            stats.referenceRingDropped = m_referenceRing->statistics().droppedOldest;
+            stats.imagingRingDropped = m_imagingRing->statistics().droppedOldest;
+        }
+        return stats;
+    }
+
+    void FramePairing::pairFunction()
+    {
+        m_lastLogNs = FrameMetadata::now();
+
+        Frame frame;
+        while (m_running)
+        {
+            bool received = false;
+            while (m_referenceRing->tryPop(frame))
+            {
+                enqueue(m_pendingReference, std::move(frame), 0);
+                received = true;
+            }
+            while (m_imagingRing->tryPop(frame))
+            {
+                enqueue(m_pendingImaging, std::move(frame), m_config.imagingOffsetNs);
+                received = true;
+            }
+
+            int64_t nowNs = FrameMetadata::now();
+            match(nowNs);
+
+            if (nowNs - m_lastLogNs >= LogIntervalNs)
+            {
+                logStatistics();
+                m_lastLogNs = nowNs;
+            }
+
+            // 没有新帧时在成像队列上短暂等待，参考帧最多晚 PollInterval 被处理
+            if (!received && m_imagingRing->waitPop(frame, PollInterval))
+            {
+                enqueue(m_pendingImaging, std::move(frame), m_config.imagingOffsetNs);
+            }
+        }
+    }
+
+    void FramePairing::enqueue(std::deque<Pending> &queue, Frame frame, int64_t offsetNs)
+    {
+        Pending pending;
+        pending.metadata = frame.metadata();
+        pending.midNs = pending.metadata.exposureMidNs() + offsetNs;
+        if (m_config.streamDepth > 0)
+        {
+            pending.frame = std::move(frame);
+        }
+        queue.push_back(std::move(pending));
+
+        // 持有的帧来自相机帧池，只给最新的几帧保留像素，其余只留元数据
+        if (m_config.streamDepth > 0 && queue.size() > MaxPendingFrames)
+        {
+            queue[queue.size() - 1 - MaxPendingFrames].frame = Frame();
+        }
+    }
+
+    void FramePairing::match(int64_t nowNs)
+    {
+        const int64_t tolerance = m_config.toleranceNs;
+
+        while (!m_pendingImaging.empty())
+        {
+            Pending &imaging = m_pendingImaging.front();
+
+            // 比容差下界还早的参考帧，之后的成像帧也配不上
+            while (!m_pendingReference.empty() && m_pendingReference.front().midNs < imaging.midNs - tolerance)
+            {
+                m_pendingReference.pop_front();
+                std::lock_guard<std::mutex> lock(m_statsMutex);
+                ++m_stats.unusedReference;
+            }
+
+            // 已有的参考帧都早于成像帧时，后面还可能来更近的，等一等；超过 FlushDelayNs 就按现有的决定
+            bool mayImprove = m_pendingReference.empty() || m_pendingReference.back().midNs < imaging.midNs;
+            if (mayImprove && nowNs - imaging.metadata.hostTimestampNs < FlushDelayNs)
+            {
+                break;
+            }
+
+            // 容差内最近的参考帧
+            size_t best = m_pendingReference.size();
+            int64_t bestDistance = 0;
+            for (size_t k = 0; k < m_pendingReference.size() && m_pendingReference[k].midNs <= imaging.midNs + tolerance; ++k)
+            {
+                int64_t distance = std::llabs(m_pendingReference[k].midNs - imaging.midNs);
+                if (best == m_pendingReference.size() || distance < bestDistance)
+                {
+                    best = k;
+                    bestDistance = distance;
+                }
+            }
+
+            if (best == m_pendingReference.size())
+            {
+                m_pendingImaging.pop_front();
+                std::lock_guard<std::mutex> lock(m_statsMutex);
+                ++m_stats.unmatchedImaging;
+                continue;
+            }
+
+            if (best > 0)
+            {
+                m_pendingReference.erase(m_pendingReference.begin(), m_pendingReference.begin() + best);
+                std::lock_guard<std::mutex> lock(m_statsMutex);
+                m_stats.unusedReference += best;
+            }
+
+            publishPair(m_pendingReference.front(), imaging);
+            m_pendingReference.pop_front();
+            m_pendingImaging.pop_front();
+        }
+
+        // 成像相机停了或远慢于参考相机时，参考帧只保留有限的数量
+        while (m_pendingReference.size() > MaxPendingReference)
+        {
+            m_pendingReference.pop_front();
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            ++m_stats.unusedReference;
+        }
+    }
+
+    void FramePairing::publishPair(Pending &reference, Pending &imaging)
+    {
+        Pair pair;
+        pair.referenceMetadata = reference.metadata;
+        pair.imagingMetadata = imaging.metadata;
+        pair.offsetNs = imaging.midNs - reference.midNs;
+
+        // 成像曝光区间（已补偿到参考时间轴）；Mask 在送显 maskDelayNs 之后才出现在 DMD 上
+        if (m_masks)
+        {
+            int64_t halfExposureNs = static_cast<int64_t>(imaging.metadata.exposureUs * 500.0);
+            pair.mask = m_masks->lookup(imaging.midNs - halfExposureNs - m_config.maskDelayNs,
+                                        imaging.midNs + halfExposureNs - m_config.maskDelayNs);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            double offsetUs = pair.offsetNs / 1000.0;
+            ++m_stats.pairs;
+            double delta = offsetUs - m_stats.meanOffsetUs;
+            m_stats.meanOffsetUs += delta / m_stats.pairs;
+            m_offsetM2 += delta * (offsetUs - m_stats.meanOffsetUs);
+            m_stats.minOffsetUs = m_stats.pairs == 1 ? offsetUs : std::min(m_stats.minOffsetUs, offsetUs);
+            m_stats.maxOffsetUs = m_stats.pairs == 1 ? offsetUs : std::max(m_stats.maxOffsetUs, offsetUs);
+            if (m_masks && !pair.mask.known)
+                ++m_stats.maskUnknown;
+            if (pair.mask.changes > 0)
+                ++m_stats.maskChanged;
+        }
+        m_absoluteOffset.record(std::llabs(pair.offsetNs));
+
+        if (m_config.streamDepth == 0)
+            return;
+
+        pair.reference = std::move(reference.frame);
+        pair.imaging = std::move(imaging.frame);
+        {
+            std::lock_guard<std::mutex> lock(m_streamMutex);
+            if (m_stream.size() >= m_config.streamDepth)
+            {
+                m_stream.pop_front();
+                std::lock_guard<std::mutex> statsLock(m_statsMutex);
+                ++m_stats.streamDropped;
+            }
+            m_stream.push_back(std::move(pair));
+        }
+        m_streamReady.notify_one();
+    }
+
+    void FramePairing::logStatistics()
+    {
+        Statistics stats = statistics();
+        if (stats.pairs == 0 && stats.unmatchedImaging == 0)
+            return;
+
+        Log::info(QString("Frame pairing: %1 pairs, offset mean %2 us sd %3 us range [%4, %5] us |p50| %6 us |p99| %7 us, "
+                          "unmatched imaging %8, unused reference %9, ring dropped %10/%11 (reference/imaging), "
+                          "stream dropped %12, mask unknown %13 changed %14")
+                      .arg(stats.pairs)
+                      .arg(stats.meanOffsetUs, 0, 'f', 1)
+                      .arg(stats.stddevOffsetUs, 0, 'f', 1)
+                      .arg(stats.minOffsetUs, 0, 'f', 0)
+                      .arg(stats.maxOffsetUs, 0, 'f', 0)
+                      .arg(stats.absoluteOffset.p50Us, 0, 'f', 0)
+                      .arg(stats.absoluteOffset.p99Us, 0, 'f', 0)
+                      .arg(stats.unmatchedImaging)
+                      .arg(stats.unusedReference)
+                      .arg(stats.referenceRingDropped)
+                      .arg(stats.imagingRingDropped)
+                      .arg(stats.streamDropped)
+                      .arg(stats.maskUnknown)
+                      .arg(stats.maskChanged));
+    }
+}
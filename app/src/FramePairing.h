@@ -0,0 +1,133 @@
+#ifndef FRAME_PAIRING_H
+#define FRAME_PAIRING_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <cstdint>
+
+#include "Frame.h"
+#include "FrameBus.h"
+#include "FrameRing.h"
+#include "LatencyStats.h"
+#include "MaskTimeline.h"
+
+namespace lzx
+{
+    // 参考相机（海康）与成像相机（PlayerOne）的帧配对
+    // 在两条帧总线上各挂一个深度 RingDepth 的队列，配对线程跟不上时丢弃最旧的帧（两个队列分别计数），
+    // 不会阻塞相机的采集线程。相机按总线上挂接的队列深度扩容帧池（见 FrameBus::retainedFrames），
+    // 但等待配对的帧和输出流里的帧不计入，streamDepth 较大时超出帧池的部分退化为堆分配。
+    // 配对线程按曝光中点（主机时钟，见 FrameMetadata::exposureMidNs）
+    // 为每一帧成像图像找最近的、未用过的参考帧，差值在容差内即成对，并查询 MaskTimeline
+    // 得到成像曝光期间 DMD 上的 Mask 及其来源参考帧。配对结果按顺序放进一个有界的输出流。
+    // 两台相机固定的传输/读出延迟差用 imagingOffsetNs 补偿，可以按统计的平均偏差标定。
+    class FramePairing
+    {
+    public:
+        struct Config
+        {
+            int64_t toleranceNs = 2000000;  // 曝光中点之差的容差
+            int64_t imagingOffsetNs = 0;    // 加到成像帧曝光中点上的固定补偿
+            int64_t maskDelayNs = 0;        // 送显到 DMD 实际翻转的延迟
+            size_t streamDepth = 0;         // 输出流深度，0 表示只统计不输出（不持有帧，不占用相机帧池）
+        };
+
+        struct Pair
+        {
+            Frame reference;       // 等待期间超出 MaxPendingFrames 的参考帧只保留了元数据，此时为空帧
+            Frame imaging;
+            FrameMetadata referenceMetadata;
+            FrameMetadata imagingMetadata;
+            int64_t offsetNs = 0;  // 成像曝光中点（含补偿）减去参考曝光中点
+            MaskTimeline::Lookup mask; // 成像曝光期间生效的 Mask
+        };
+
+        struct Statistics
+        {
+            uint64_t pairs = 0;
+            uint64_t unmatchedImaging = 0;  // 容差内没有参考帧的成像帧
+            uint64_t unusedReference = 0;   // 没有配上成像帧的参考帧（参考帧率更高时是正常的）
+            uint64_t streamDropped = 0;     // 输出流满、被挤掉的配对
+            uint64_t referenceRingDropped = 0; // 配对线程跟不上、在参考输入队列里被挤掉的帧
+            uint64_t imagingRingDropped = 0;   // 配对线程跟不上、在成像输入队列里被挤掉的帧
+            uint64_t maskUnknown = 0;       // 曝光开始时的 Mask 不在记录范围内
+            uint64_t maskChanged = 0;       // 曝光期间 Mask 发生了切换
+            double meanOffsetUs = 0.0;
+            double stddevOffsetUs = 0.0;
+            double minOffsetUs = 0.0;
+            double maxOffsetUs = 0.0;
+            LatencyHistogram::Summary absoluteOffset; // |偏差| 的分位数
+        };
+
+        // 总线和 Mask 记录必须比配对对象活得久；masks 可以为空
+        FramePairing(FrameBus *reference, FrameBus *imaging, const MaskTimeline *masks, const Config &config);
+        ~FramePairing();
+
+        bool start();
+        void stop();
+        bool running() const { return m_running; }
+
+        // 取下一个配对，超时返回 false
+        bool waitPair(Pair &pair, std::chrono::milliseconds timeout);
+        bool tryPopPair(Pair &pair);
+
+        const Config &config() const { return m_config; }
+        Statistics statistics() const;
+
+    private:
+        FramePairing(const FramePairing &) = delete;
+        FramePairing &operator=(const FramePairing &) = delete;
+
+        static constexpr size_t RingDepth = 16;
+        static constexpr size_t MaxPendingReference = 1024; // 只保留元数据时的上限，约 5s 的 200 帧/s 参考帧
+        static constexpr size_t MaxPendingFrames = 4;       // 持有帧时的上限，超出的参考帧只保留元数据
+        static constexpr int64_t FlushDelayNs = 500000000;  // 等不到更近的参考帧时，到达后最多等这么久
+        static constexpr auto PollInterval = std::chrono::milliseconds(2);
+        static constexpr int64_t LogIntervalNs = 10000000000LL;
+
+        struct Pending
+        {
+            Frame frame;
+            FrameMetadata metadata;
+            int64_t midNs = 0;
+        };
+
+        void pairFunction();
+        void enqueue(std::deque<Pending> &queue, Frame frame, int64_t offsetNs);
+        void match(int64_t nowNs);
+        void publishPair(Pending &reference, Pending &imaging);
+        void logStatistics();
+
+        FrameBus *m_referenceBus;
+        FrameBus *m_imagingBus;
+        const MaskTimeline *m_masks;
+        Config m_config;
+
+        std::shared_ptr<FrameRing> m_referenceRing;
+        std::shared_ptr<FrameRing> m_imagingRing;
+        std::atomic<bool> m_running{false};
+        std::unique_ptr<std::thread> m_thread;
+
+        // 仅配对线程访问
+        std::deque<Pending> m_pendingReference;
+        std::deque<Pending> m_pendingImaging;
+        int64_t m_lastLogNs = 0;
+
+        // 输出流
+        std::mutex m_streamMutex;
+        std::condition_variable m_streamReady;
+        std::deque<Pair> m_stream;
+
+        mutable std::mutex m_statsMutex;
+        Statistics m_stats;
+        double m_offsetM2 = 0.0; // Welford 方差累计
+        LatencyHistogram m_absoluteOffset{"pairing offset"};
+    };
+}
+
+#endif
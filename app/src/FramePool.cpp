@@ -0,0 +1,106 @@
+#include "FramePool.h"
+
+namespace lzx
+{
+    std::shared_ptr<FramePool> FramePool::create(size_t capacity, size_t bufferSize, bool hugePages)
+    {
+        return std::shared_ptr<FramePool>(new FramePool(capacity, bufferSize, hugePages));
+    }
+
+    FramePool::FramePool(size_t capacity, size_t bufferSize, bool hugePages)
+        : m_bufferSize(bufferSize)
+    {
+        m_all.reserve(capacity);
+        m_free.reserve(capacity);
+
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            FrameBuffer *buffer = new FrameBuffer(bufferSize, hugePages);
+            m_all.push_back(buffer);
+            m_free.push_back(buffer);
+        }
+    }
+
+    FramePool::~FramePool()
+    {
+        // 能走到析构说明所有借出的存储块都已归还
+        for (FrameBuffer *buffer : m_all)
+        {
+            delete buffer;
+        }
+    }
+
+    Frame FramePool::acquire(int width, int height, int channels, int bitDepth, size_t stride)
+    {
+        if (stride == 0)
+            stride = Frame::packedStride(width, channels, bitDepth);
+        size_t size = frameBytes(width, height, channels, bitDepth, stride);
+
+        FrameBuffer *buffer = nullptr;
+
+        if (size <= m_bufferSize)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_free.empty())
+            {
+                buffer = m_free.back();
+                m_free.pop_back();
+
+                size_t inUse = m_all.size() - m_free.size();
+                if (inUse > m_highWater)
+                    m_highWater = inUse;
+            }
+        }
+        else
+        {
+            m_oversized.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (buffer)
+        {
+            buffer->m_owner = shared_from_this();
+            m_acquired.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            if (size <= m_bufferSize)
+                m_exhausted.fetch_add(1, std::memory_order_relaxed);
+
+            buffer = FrameBuffer::create(size);
+        }
+
+        buffer->addRef();
+        return Frame(width, height, channels, bitDepth, stride, buffer, size);
+    }
+
+    void FramePool::recycle(FrameBuffer *buffer)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_free.push_back(buffer);
+        }
+        m_recycled.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    FramePool::Statistics FramePool::statistics() const
+    {
+        Statistics stats;
+        stats.capacity = m_all.size();
+        stats.bufferSize = m_bufferSize;
+        for (const FrameBuffer *buffer : m_all)
+        {
+            if (buffer->hugePages())
+                stats.hugePageBuffers++;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            stats.inUse = m_all.size() - m_free.size();
+            stats.highWater = m_highWater;
+        }
+        stats.acquired = m_acquired.load(std::memory_order_relaxed);
+        stats.recycled = m_recycled.load(std::memory_order_relaxed);
+        stats.exhausted = m_exhausted.load(std::memory_order_relaxed);
+        stats.oversized = m_oversized.load(std::memory_order_relaxed);
+        return stats;
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+
+#include "Frame.h"
+
+namespace lzx
+{
+    // 固定容量的帧存储池：启动采集时一次性分配好对齐的存储块，
+    // 消费者释放帧后存储块自动回到池中，稳态采集不再有堆分配。
+    // 必须通过 create() 以 shared_ptr 持有，借出的存储块会延长池的生命周期。
+    class FramePool : public std::enable_shared_from_this<FramePool>
+    {
+    public:
+        struct Statistics
+        {
+            size_t capacity = 0;   // 池中存储块数量
+            size_t bufferSize = 0; // 每个存储块的字节数
+            size_t hugePageBuffers = 0; // 成功使用大页的存储块数量
+            size_t inUse = 0;      // 当前借出的数量
+            size_t highWater = 0;  // 借出数量的峰值
+            uint64_t acquired = 0; // 从池中成功借出的次数
+            uint64_t recycled = 0; // 归还次数
+            uint64_t exhausted = 0; // 池已空、退化为堆分配的次数
+            uint64_t oversized = 0; // 请求尺寸超过存储块大小、退化为堆分配的次数
+        };
+
+        // 超过这个大小的帧建议使用大页内存
+        static constexpr size_t HugePageThreshold = 4 * 1024 * 1024;
+
+        // hugePages: 尝试用大页内存，失败的存储块退回普通内存
+        static std::shared_ptr<FramePool> create(size_t capacity, size_t bufferSize, bool hugePages = false);
+
+        // 计算一帧所需的字节数，stride 为 0 表示紧密排列
+        static size_t frameBytes(int width, int height, int channels, int bitDepth, size_t stride = 0)
+        {
+            if (stride == 0)
+                stride = Frame::packedStride(width, channels, bitDepth);
+            return stride * height;
+        }
+
+        ~FramePool();
+
+        // 借出一帧（内容未初始化），池空或尺寸不够时退化为普通堆分配并计数
+        // stride 为 0 表示紧密排列（SDK 直接写入整块缓冲区时必须紧密排列）
+        Frame acquire(int width, int height, int channels, int bitDepth, size_t stride = 0);
+
+        size_t capacity() const { return m_all.size(); }
+        size_t bufferSize() const { return m_bufferSize; }
+
+        Statistics statistics() const;
+
+    private:
+        friend class FrameBuffer;
+
+        FramePool(size_t capacity, size_t bufferSize, bool hugePages);
+
+        FramePool(const FramePool &) = delete;
+        FramePool &operator=(const FramePool &) = delete;
+
+        void recycle(FrameBuffer *buffer);
+
+        size_t m_bufferSize;
+        std::vector<FrameBuffer *> m_all;  // 池拥有的全部存储块
+        std::vector<FrameBuffer *> m_free; // 空闲栈，预留了全部容量，不会重新分配
+        mutable std::mutex m_mutex;
+
+        size_t m_highWater = 0;
+        std::atomic<uint64_t> m_acquired{0};
+        std::atomic<uint64_t> m_recycled{0};
+        std::atomic<uint64_t> m_exhausted{0};
+        std::atomic<uint64_t> m_oversized{0};
+    };
+}
+
+#endif
@@ -0,0 +1,181 @@
+#include "FrameReadback.h"
+
+namespace lzx
+{
+    void ReadbackRing::release()
+    {
+        if (!m_gl)
+            return;
+
+        for (Slot &slot : m_slots)
+        {
+            if (slot.fence)
+            {
+                m_gl->glDeleteSync(slot.fence);
+                slot.fence = nullptr;
+            }
+            if (slot.buffer)
+            {
+                m_gl->glDeleteBuffers(1, &slot.buffer);
+                slot.buffer = 0;
+            }
+            slot.capacity = 0;
+        }
+        m_head = 0;
+        m_count = 0;
+        m_gl = nullptr;
+    }
+
+    bool ReadbackRing::request(int width, int height, GLenum format, uint64_t tag, int64_t timestampNs)
+    {
+        if (!m_gl || width <= 0 || height <= 0)
+            return false;
+
+        if (m_count == SlotCount)
+        {
+            ++m_stats.skipped;
+            return false;
+        }
+
+        Slot &slot = m_slots[m_head];
+        size_t bytes = static_cast<size_t>(width) * height * 4;
+        if (!slot.buffer)
+        {
+            m_gl->glGenBuffers(1, &slot.buffer);
+        }
+
+        m_gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+        if (slot.capacity < bytes)
+        {
+            m_gl->glBufferData(GL_PIXEL_PACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_READ);
+            slot.capacity = bytes;
+        }
+
+        // 目标是 PBO 时 glReadPixels 只排进命令队列，不等待
+        m_gl->glPixelStorei(GL_PACK_ALIGNMENT, 4);
+        m_gl->glReadPixels(0, 0, width, height, format, GL_UNSIGNED_BYTE, nullptr);
+        m_gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+        slot.fence = m_gl->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        slot.width = width;
+        slot.height = height;
+        slot.tag = tag;
+        slot.timestampNs = timestampNs;
+
+        m_head = (m_head + 1) % SlotCount;
+        ++m_count;
+        ++m_stats.requested;
+        return true;
+    }
+
+    void ReadbackRing::collect(const Consumer &consumer, bool wait)
+    {
+        if (!m_gl)
+            return;
+
+        while (m_count > 0)
+        {
+            Slot &slot = m_slots[(m_head - m_count + SlotCount) % SlotCount];
+
+            GLuint64 timeout = wait ? 1000000000ULL : 0;
+            GLenum state = m_gl->glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+            if (state == GL_TIMEOUT_EXPIRED)
+            {
+                break;
+            }
+
+            m_gl->glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+            --m_count;
+
+            if (state == GL_WAIT_FAILED)
+            {
+                continue;
+            }
+
+            size_t bytes = static_cast<size_t>(slot.width) * slot.height * 4;
+            m_gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.buffer);
+            const unsigned char *data = static_cast<const unsigned char *>(
+                m_gl->glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes), GL_MAP_READ_BIT));
+            if (data)
+            {
+                consumer(FrameView(data, slot.width, slot.height, 4, 8), slot.tag, slot.timestampNs);
+                m_gl->glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+                ++m_stats.completed;
+            }
+            m_gl->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        }
+    }
+
+    ReadbackWorker::ReadbackWorker(size_t maxPending)
+        : m_maxPending(maxPending)
+    {
+        m_thread = std::thread(&ReadbackWorker::workerFunction, this);
+    }
+
+    ReadbackWorker::~ReadbackWorker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        m_thread.join();
+    }
+
+    bool ReadbackWorker::submit(std::function<void()> task, bool droppable)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (droppable && m_tasks.size() >= m_maxPending)
+            {
+                ++m_dropped;
+                return false;
+            }
+            m_tasks.push_back(std::move(task));
+        }
+        m_wake.notify_one();
+        return true;
+    }
+
+    void ReadbackWorker::drain()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [this]()
+                    { return m_tasks.empty() && !m_busy; });
+    }
+
+    uint64_t ReadbackWorker::dropped() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_dropped;
+    }
+
+    void ReadbackWorker::workerFunction()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_wake.wait(lock, [this]()
+                        { return m_stop || !m_tasks.empty(); });
+            if (m_tasks.empty())
+            {
+                break;
+            }
+
+            std::function<void()> task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+            m_busy = true;
+            lock.unlock();
+
+            task();
+
+            lock.lock();
+            m_busy = false;
+            if (m_tasks.empty())
+            {
+                m_idle.notify_all();
+            }
+        }
+    }
+}
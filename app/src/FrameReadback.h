@@ -0,0 +1,105 @@
+#ifndef FRAME_READBACK_H
+#define FRAME_READBACK_H
+
+#include <QOpenGLFunctions_3_3_Core>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <cstddef>
+#include <cstdint>
+
+#include "FrameView.h"
+
+namespace lzx
+{
+    // 帧缓冲区的异步读回：glReadPixels 写进一个 PBO 后立即返回，插入 fence；
+    // 之后每帧 collect() 检查 fence，GPU 写完的 PBO 才映射读取，渲染线程不等待管线排空。
+    // 读回按请求顺序交出，一般晚一到两帧。所有 PBO 都在等待时 request() 返回 false，本帧不读回。
+    // 只能在 OpenGL 上下文中使用，析构前需要在上下文中调用 release()。
+    class ReadbackRing
+    {
+    public:
+        static constexpr int SlotCount = 3;
+
+        // 读回完成时调用，view 指向映射的 PBO，只在回调期间有效
+        using Consumer = std::function<void(const FrameView &view, uint64_t tag, int64_t timestampNs)>;
+
+        struct Statistics
+        {
+            uint64_t requested = 0;
+            uint64_t completed = 0;
+            uint64_t skipped = 0; // 没有空闲 PBO 而跳过的请求
+        };
+
+        void initialize(QOpenGLFunctions_3_3_Core *f) { m_gl = f; }
+        void release();
+
+        // 从当前绑定的读帧缓冲区读取 width x height 的 8 位四通道像素（GL_RGBA 或 GL_BGRA）
+        // tag、timestampNs 原样交给 consumer
+        bool request(int width, int height, GLenum format, uint64_t tag, int64_t timestampNs);
+
+        // 按请求顺序交出已经完成的读回；wait 为 true 时等所有请求完成（停止录像时用）
+        void collect(const Consumer &consumer, bool wait = false);
+
+        bool pending() const { return m_count > 0; }
+        Statistics statistics() const { return m_stats; }
+
+    private:
+        struct Slot
+        {
+            GLuint buffer = 0;
+            GLsync fence = nullptr;
+            size_t capacity = 0;
+            int width = 0;
+            int height = 0;
+            uint64_t tag = 0;
+            int64_t timestampNs = 0;
+        };
+
+        QOpenGLFunctions_3_3_Core *m_gl = nullptr;
+        Slot m_slots[SlotCount];
+        int m_head = 0;  // 下一个请求使用的 PBO
+        int m_count = 0; // 等待读取的 PBO 数
+        Statistics m_stats;
+    };
+
+    // 读回数据的后台处理线程：PNG 编码、填充视频帧等耗时操作按提交顺序在这里完成
+    class ReadbackWorker
+    {
+    public:
+        // maxPending: 可丢弃任务的积压上限
+        explicit ReadbackWorker(size_t maxPending = 4);
+
+        // 执行完已提交的任务再退出
+        ~ReadbackWorker();
+
+        // droppable 的任务在积压超过上限时被丢弃，返回 false；拍照之类的任务不可丢弃
+        bool submit(std::function<void()> task, bool droppable);
+
+        // 等已提交的任务全部执行完
+        void drain();
+
+        uint64_t dropped() const;
+
+    private:
+        ReadbackWorker(const ReadbackWorker &) = delete;
+        ReadbackWorker &operator=(const ReadbackWorker &) = delete;
+
+        void workerFunction();
+
+        size_t m_maxPending;
+        std::thread m_thread;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;
+        std::condition_variable m_idle;
+        std::deque<std::function<void()>> m_tasks;
+        bool m_busy = false;
+        bool m_stop = false;
+        uint64_t m_dropped = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,247 @@
+#include "FrameRing.h"
+
+#include <thread>
+
+namespace lzx
+{
+    FrameRing::FrameRing(const std::string &name, size_t depth, OverflowPolicy policy,
+                         std::chrono::milliseconds blockTimeout)
+        : m_name(name),
+          m_policy(policy),
+          m_blockTimeout(blockTimeout)
+    {
+        size_t capacity = 2;
+        while (capacity < depth)
+        {
+            capacity <<= 1;
+        }
+
+        m_cells.reset(new Cell[capacity]);
+        m_mask = capacity - 1;
+        for (size_t i = 0; i < capacity; i++)
+        {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    FrameRing::~FrameRing()
+    {
+    }
+
+    bool FrameRing::tryPush(Frame &frame)
+    {
+        size_t pos = m_enqueuePos.load(std::memory_order_relaxed);
+        Cell &cell = m_cells[pos & m_mask];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (sequence != pos)
+        {
+            // 队列已满（或者消费者正在读这个单元）
+            return false;
+        }
+
+        cell.frame = std::move(frame);
+        cell.sequence.store(pos + 1, std::memory_order_release);
+        m_enqueuePos.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool FrameRing::dequeue(Frame &frame)
+    {
+        size_t pos = m_dequeuePos.load(std::memory_order_relaxed);
+        while (true)
+        {
+            Cell &cell = m_cells[pos & m_mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+
+            if (diff == 0)
+            {
+                if (m_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    frame = std::move(cell.frame);
+                    cell.sequence.store(pos + m_mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false; // 空
+            }
+            else
+            {
+                pos = m_dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool FrameRing::push(Frame frame)
+    {
+        bool pushed = tryPush(frame);
+
+        if (!pushed)
+        {
+            switch (m_policy)
+            {
+            case OverflowPolicy::DropNewest:
+                break;
+
+            case OverflowPolicy::DropOldest:
+            {
+                // 每次入队最多挤掉一帧：tryPush 失败也可能是消费者已经取走了这个单元、还没写回序号，
+                // 这时队列并不满，只等它写回，不能再丢一帧
+                bool dropped = false;
+                while (!(pushed = tryPush(frame)))
+                {
+                    size_t tail = m_enqueuePos.load(std::memory_order_relaxed);
+                    size_t head = m_dequeuePos.load(std::memory_order_acquire);
+                    Frame oldest;
+                    if (!dropped && tail - head > m_mask && dequeue(oldest))
+                    {
+                        m_droppedOldest.fetch_add(1, std::memory_order_relaxed);
+                        dropped = true;
+                    }
+                    else
+                    {
+                        std::this_thread::yield();
+                    }
+                }
+                break;
+            }
+
+            case OverflowPolicy::Block:
+            {
+                m_blockedWaits.fetch_add(1, std::memory_order_relaxed);
+
+                auto deadline = std::chrono::steady_clock::now() + m_blockTimeout;
+                std::unique_lock<std::mutex> lock(m_waitMutex);
+                markWaiting(m_producerWaiting);
+                while (!(pushed = tryPush(frame)))
+                {
+                    if (m_notFull.wait_until(lock, deadline) == std::cv_status::timeout)
+                    {
+                        pushed = tryPush(frame);
+                        break;
+                    }
+                }
+                m_producerWaiting.store(false);
+                break;
+            }
+            }
+        }
+
+        if (!pushed)
+        {
+            m_droppedNewest.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        m_pushed.fetch_add(1, std::memory_order_relaxed);
+
+        size_t length = size();
+        if (length > m_highWater.load(std::memory_order_relaxed))
+        {
+            m_highWater.store(length, std::memory_order_relaxed);
+        }
+
+        notifyConsumer();
+        return true;
+    }
+
+    bool FrameRing::tryPop(Frame &frame)
+    {
+        if (!dequeue(frame))
+        {
+            return false;
+        }
+
+        m_popped.fetch_add(1, std::memory_order_relaxed);
+        notifyProducer();
+        return true;
+    }
+
+    bool FrameRing::waitPop(Frame &frame, std::chrono::milliseconds timeout)
+    {
+        if (tryPop(frame))
+        {
+            return true;
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        bool popped = false;
+        {
+            // 持锁期间只能用 dequeue，tryPop 的唤醒逻辑需要同一把锁
+            std::unique_lock<std::mutex> lock(m_waitMutex);
+            markWaiting(m_consumerWaiting);
+            while (!(popped = dequeue(frame)))
+            {
+                if (m_notEmpty.wait_until(lock, deadline) == std::cv_status::timeout)
+                {
+                    popped = dequeue(frame);
+                    break;
+                }
+            }
+            m_consumerWaiting.store(false);
+        }
+
+        if (popped)
+        {
+            m_popped.fetch_add(1, std::memory_order_relaxed);
+            notifyProducer();
+        }
+        return popped;
+    }
+
+    void FrameRing::wakeConsumer()
+    {
+        std::lock_guard<std::mutex> lock(m_waitMutex);
+        m_notEmpty.notify_all();
+    }
+
+    void FrameRing::markWaiting(std::atomic<bool> &flag)
+    {
+        flag.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    void FrameRing::notifyConsumer()
+    {
+        // 与 markWaiting 中的栅栏配对：要么等待方看到新数据，要么这里看到等待标志
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_consumerWaiting.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock(m_waitMutex);
+            m_notEmpty.notify_one();
+        }
+    }
+
+    void FrameRing::notifyProducer()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_producerWaiting.load(std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock(m_waitMutex);
+            m_notFull.notify_one();
+        }
+    }
+
+    size_t FrameRing::size() const
+    {
+        size_t head = m_dequeuePos.load(std::memory_order_relaxed);
+        size_t tail = m_enqueuePos.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    FrameRing::Statistics FrameRing::statistics() const
+    {
+        Statistics stats;
+        stats.name = m_name;
+        stats.depth = depth();
+        stats.highWater = m_highWater.load(std::memory_order_relaxed);
+        stats.pushed = m_pushed.load(std::memory_order_relaxed);
+        stats.popped = m_popped.load(std::memory_order_relaxed);
+        stats.droppedOldest = m_droppedOldest.load(std::memory_order_relaxed);
+        stats.droppedNewest = m_droppedNewest.load(std::memory_order_relaxed);
+        stats.blockedWaits = m_blockedWaits.load(std::memory_order_relaxed);
+        return stats;
+    }
+}
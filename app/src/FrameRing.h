@@ -0,0 +1,107 @@
+#ifndef FRAME_RING_H
+#define FRAME_RING_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <cstdint>
+
+#include "Frame.h"
+
+namespace lzx
+{
+    // 有界的单生产者/单消费者帧队列，用于录像等不允许悄悄丢帧的场景
+    // 队列满时按溢出策略处理，所有丢帧都记在计数器里。
+    // 每个单元带序号（Vyukov 有界队列），生产者在 DropOldest 时可以安全地代替消费者出队。
+    class FrameRing
+    {
+    public:
+        enum class OverflowPolicy
+        {
+            Block,      // 等待消费者腾出空间，超时后丢弃新帧
+            DropOldest, // 丢弃队列中最旧的帧，每次入队最多丢一帧
+            DropNewest  // 丢弃正在写入的新帧
+        };
+
+        struct Statistics
+        {
+            std::string name;
+            size_t depth = 0;
+            size_t highWater = 0;       // 队列长度的峰值
+            uint64_t pushed = 0;        // 入队成功的帧数
+            uint64_t popped = 0;        // 消费者取走的帧数
+            uint64_t droppedOldest = 0; // 因 DropOldest 被挤掉的帧数
+            uint64_t droppedNewest = 0; // 因 DropNewest 或 Block 超时被丢弃的帧数
+            uint64_t blockedWaits = 0;  // Block 策略下生产者等待的次数
+        };
+
+        // depth 会向上取整为2的幂
+        FrameRing(const std::string &name, size_t depth, OverflowPolicy policy,
+                  std::chrono::milliseconds blockTimeout = std::chrono::milliseconds(100));
+        ~FrameRing();
+
+        // 生产者：入队，返回 false 表示这一帧被丢弃
+        bool push(Frame frame);
+
+        // 消费者：非阻塞出队
+        bool tryPop(Frame &frame);
+
+        // 消费者：等待一帧，超时返回 false
+        bool waitPop(Frame &frame, std::chrono::milliseconds timeout);
+
+        // 唤醒正在 waitPop 的消费者（停止录像时使用）
+        void wakeConsumer();
+
+        size_t size() const;
+        size_t depth() const { return m_mask + 1; }
+        const std::string &name() const { return m_name; }
+        OverflowPolicy policy() const { return m_policy; }
+
+        Statistics statistics() const;
+
+    private:
+        FrameRing(const FrameRing &) = delete;
+        FrameRing &operator=(const FrameRing &) = delete;
+
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            Frame frame;
+        };
+
+        bool tryPush(Frame &frame);
+        bool dequeue(Frame &frame);
+        void markWaiting(std::atomic<bool> &flag);
+        void notifyConsumer();
+        void notifyProducer();
+
+        std::string m_name;
+        OverflowPolicy m_policy;
+        std::chrono::milliseconds m_blockTimeout;
+
+        std::unique_ptr<Cell[]> m_cells;
+        size_t m_mask;
+
+        alignas(64) std::atomic<size_t> m_enqueuePos{0}; // 仅生产者写入
+        alignas(64) std::atomic<size_t> m_dequeuePos{0}; // 消费者（以及 DropOldest 时的生产者）竞争
+
+        // 慢路径：只有真正需要等待时才使用互斥量和条件变量
+        std::mutex m_waitMutex;
+        std::condition_variable m_notEmpty;
+        std::condition_variable m_notFull;
+        std::atomic<bool> m_consumerWaiting{false};
+        std::atomic<bool> m_producerWaiting{false};
+
+        std::atomic<size_t> m_highWater{0};
+        std::atomic<uint64_t> m_pushed{0};
+        std::atomic<uint64_t> m_popped{0};
+        std::atomic<uint64_t> m_droppedOldest{0};
+        std::atomic<uint64_t> m_droppedNewest{0};
+        std::atomic<uint64_t> m_blockedWaits{0};
+    };
+}
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef FRAME_VIEW_H
+#define FRAME_VIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+namespace lzx
+{
+    // 不持有数据的图像视图：描述父帧中的一个矩形区域或者抽样后的网格
+    // 视图的生命周期不能超过它引用的帧（持有 Frame 租约期间使用）
+    class FrameView
+    {
+    public:
+        FrameView() = default;
+
+        // stride: 行间距（字节），0 表示紧密排列
+        FrameView(const unsigned char *data, int width, int height, int channels, int bitDepth, size_t stride = 0)
+            : m_data(data),
+              m_width(width),
+              m_height(height),
+              m_channels(channels),
+              m_bitDepth(bitDepth),
+              m_stride(stride ? stride : static_cast<size_t>(width) * channels * (bitDepth > 8 ? 2 : 1))
+        {
+        }
+
+        bool empty() const { return m_data == nullptr || m_width <= 0 || m_height <= 0; }
+
+        int width() const { return m_width; }
+        int height() const { return m_height; }
+        int channels() const { return m_channels; }
+        int bitDepth() const { return m_bitDepth; }
+
+        // 相邻两行起始地址的间距（字节）
+        size_t stride() const { return m_stride; }
+
+        // 相邻两个采样像素的间距（像素），抽样视图大于1
+        int pixelStep() const { return m_pixelStep; }
+
+        size_t bytesPerComponent() const { return m_bitDepth > 8 ? 2 : 1; }
+        size_t bytesPerPixel() const { return m_channels * bytesPerComponent(); }
+
+        // 行内像素是否相邻（可以直接按行整块处理或上传）
+        bool isRowContiguous() const { return m_pixelStep == 1; }
+
+        // 整个视图是否是一块连续内存
+        bool isContiguous() const { return isRowContiguous() && m_stride == m_width * bytesPerPixel(); }
+
+        const unsigned char *data() const { return m_data; }
+        const unsigned char *row(int y) const { return m_data + static_cast<size_t>(y) * m_stride; }
+
+        template <typename T>
+        const T *row(int y) const { return reinterpret_cast<const T *>(row(y)); }
+
+        // 矩形区域，越界部分会被裁掉
+        FrameView roi(int x, int y, int width, int height) const
+        {
+            x = std::max(0, x);
+            y = std::max(0, y);
+            width = std::min(width, m_width - x);
+            height = std::min(height, m_height - y);
+            if (width <= 0 || height <= 0)
+                return FrameView();
+
+            FrameView view = *this;
+            view.m_data = row(y) + static_cast<size_t>(x) * m_pixelStep * bytesPerPixel();
+            view.m_width = width;
+            view.m_height = height;
+            return view;
+        }
+
+        // 每 factor 个像素取一个（行列同时抽样）
+        FrameView decimate(int factor) const
+        {
+            if (factor <= 1)
+                return *this;
+
+            FrameView view = *this;
+            view.m_width = (m_width + factor - 1) / factor;
+            view.m_height = (m_height + factor - 1) / factor;
+            view.m_stride = m_stride * factor;
+            view.m_pixelStep = m_pixelStep * factor;
+            return view;
+        }
+
+    private:
+        const unsigned char *m_data = nullptr;
+        int m_width = 0;
+        int m_height = 0;
+        int m_channels = 0;
+        int m_bitDepth = 8;
+        size_t m_stride = 0;
+        int m_pixelStep = 1;
+    };
+}
+
+#endif
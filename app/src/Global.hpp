@@ -2,10 +2,11 @@
 
 #include <memory>
 
-#include "ThreadSafeImage.hpp"
+#include "FrameMailbox.h"
 #include "ICamera.hpp"
-#include "TripleBuffer.h"
+#include "FrameBus.h"
 #include "Frame.h"
+#include "MaskTimeline.h"
 #include "framerenderer.hpp"
 #include "maskwindow.hpp"
 
@@ -14,10 +15,11 @@ class GlobalResourceManager
 private:
     // Private constructor to prevent instantiation
     GlobalResourceManager()
-        : image(new ThreadSafeImage(1024, 768, 3)),
+        : mailbox(new lzx::FrameMailbox(1024 * 768 * 3)),
           camera(nullptr)
     {
-        tripleBuffer = std::make_unique<lzx::TripleBuffer<lzx::Frame>>();
+        frameBus = std::make_unique<lzx::FrameBus>();
+        maskTimeline = std::make_unique<lzx::MaskTimeline>();
 
         maskWindow = MaskWindow::instance();
     }
@@ -42,8 +44,9 @@ public:
 
     // Global reosurces here
     std::unique_ptr<lzx::ICamera> camera;                        // The camera
-    std::unique_ptr<ThreadSafeImage> image;                      // The image buffer (low latency mode)
-    std::unique_ptr<lzx::TripleBuffer<lzx::Frame>> tripleBuffer; // The triple buffer (non low latency mode)
+    std::unique_ptr<lzx::FrameMailbox> mailbox;                  // The latest frame mailbox (low latency mode)
+    std::unique_ptr<lzx::FrameBus> frameBus;                     // The reference frame bus (non low latency mode), shared by preview and mask
+    std::unique_ptr<lzx::MaskTimeline> maskTimeline;             // Which reference frame each presented mask came from, used by frame pairing
 
     MaskWindow *maskWindow; // The mask window
 
@@ -2,7 +2,10 @@
 
 #include <QDebug>
 
+#include <algorithm>
+
 #include "logwidget.hpp"
+#include "Settings.hpp"
 
 // GrayMappingWidget.cpp
 GrayMappingWidget::GrayMappingWidget(QWidget *parent)
@@ -10,6 +13,9 @@ GrayMappingWidget::GrayMappingWidget(QWidget *parent)
 {
     setupUI();
 
+    m_histogramTimer = new QTimer(this);
+    connect(m_histogramTimer, &QTimer::timeout, this, &GrayMappingWidget::pullHistogram);
+
     updateLutCurve();
 
     connect(minSpinBox, &QDoubleSpinBox::editingFinished,
@@ -19,13 +25,68 @@ GrayMappingWidget::GrayMappingWidget(QWidget *parent)
     connect(gammaSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
             this, &GrayMappingWidget::updateLutCurve);
 
+    connect(autoRangeCheckBox, &QCheckBox::toggled, this, [this](bool checked)
+            {
+        minSpinBox->setEnabled(!checked);
+        maxSpinBox->setEnabled(!checked);
+        emit autoRangeToggled(checked); });
+
     connect(plotWidget, &QCustomPlot::mousePress, this, &GrayMappingWidget::onMousePress);
     connect(plotWidget, &QCustomPlot::mouseMove, this, &GrayMappingWidget::onMouseMove);
     connect(plotWidget, &QCustomPlot::mouseRelease, this, &GrayMappingWidget::onMouseRelease);
 }
 
+void GrayMappingWidget::setHistogramChannel(std::shared_ptr<lzx::HistogramChannel> channel)
+{
+    m_histogramChannel = std::move(channel);
+}
+
+void GrayMappingWidget::setDisplayRange(double min, double max)
+{
+    minSpinBox->setValue(qBound(0.0, min, (double)m_maxValue));
+    maxSpinBox->setValue(qBound(0.0, max, (double)m_maxValue));
+    updateLutCurve();
+}
+
+void GrayMappingWidget::showEvent(QShowEvent *event)
+{
+    // 刷新率在每次显示时读取，设置修改后重新打开弹窗即生效
+    int refreshRate = std::max(1, Settings::getInstance().getHistogramRefreshRate());
+    m_histogramTimer->start(1000 / refreshRate);
+    m_histogramShown = 0;
+    m_histogramCoalesced = 0;
+
+    QWidget::showEvent(event);
+}
+
+void GrayMappingWidget::hideEvent(QHideEvent *event)
+{
+    m_histogramTimer->stop();
+    if (m_histogramShown > 0)
+    {
+        Log::info(QString("Histogram display: %1 updates drawn, %2 merged between refreshes")
+                      .arg(m_histogramShown)
+                      .arg(m_histogramCoalesced));
+    }
+
+    QWidget::hideEvent(event);
+}
+
+void GrayMappingWidget::pullHistogram()
+{
+    if (!m_histogramChannel || !m_histogramChannel->take(m_snapshot))
+        return;
+
+    m_histogramCoalesced += m_snapshot.coalesced;
+    setHistogram(m_snapshot.bins, m_snapshot.maxValue);
+}
+
 void GrayMappingWidget::setHistogram(const std::vector<int> &histogram, int maxValue)
 {
+    if (histogram.empty())
+        return;
+
+    bool rangeChanged = maxValue != m_maxValue;
 
     if (maxValue != m_maxValue)
     {
@@ -38,8 +99,12 @@ void GrayMappingWidget::setHistogram(const std::vector<int> &histogram, int maxV
         minSpinBox->setRange(0, m_maxValue);
         maxSpinBox->setRange(0, m_maxValue);
 
-        minSpinBox->setValue(0);
-        maxSpinBox->setValue(m_maxValue);
+        // 自动范围打开时黑白点由 FrameRenderer 发过来
+        if (!autoRangeCheckBox->isChecked())
+        {
+            minSpinBox->setValue(0);
+            maxSpinBox->setValue(m_maxValue);
+        }
 
         blackLine->start->setCoords(0, 0);
         blackLine->end->setCoords(0, 255);
@@ -50,19 +115,28 @@ void GrayMappingWidget::setHistogram(const std::vector<int> &histogram, int maxV
         updateLutCurve();
     }
 
-    int histogramPeak = *std::max_element(histogram.begin(), histogram.end());
-
-    this->m_histogram.clear();
+    int histogramPeak = std::max(*std::max_element(histogram.begin(), histogram.end()), 1);
 
-    if (m_histogram.size() != histogram.size())
-        this->m_histogram.resize(histogram.size());
+    // 归一化到0-255,因为绘制的时候y轴是0-255；与上一次相同时不重绘
+    bool changed = rangeChanged || m_histogram.size() != static_cast<qsizetype>(histogram.size());
+    if (changed)
+        m_histogram.resize(histogram.size());
 
     for (int i = 0; i < m_histogram.size(); i++)
     {
-        this->m_histogram[i] = (histogram[i] / (double)histogramPeak * 255); // 归一化到0-255,因为绘制的时候y轴是0-255
+        double value = histogram[i] / (double)histogramPeak * 255;
+        if (value != m_histogram[i])
+        {
+            m_histogram[i] = value;
+            changed = true;
+        }
     }
 
-    updatePlot();
+    if (!changed)
+        return;
+
+    m_histogramShown++;
+    updateHistogramGraph();
 }
 
 void GrayMappingWidget::setupUI()
@@ -96,6 +170,16 @@ void GrayMappingWidget::setupUI()
     plotWidget->xAxis->grid()->setPen(QPen(QColor(140, 140, 140, 128), .5, Qt::DashLine));
     plotWidget->yAxis->grid()->setPen(QPen(QColor(140, 140, 140, 128), .5, Qt::DashLine));
 
+    // 直方图在下，LUT 曲线在上
+    histogramGraph = plotWidget->addGraph();
+    histogramGraph->setLineStyle(QCPGraph::lsLine);
+    QColor histColor = QColor(31, 53, 101, 200);
+    histogramGraph->setPen(QPen(histColor.lighter(200)));
+    histogramGraph->setBrush(QBrush(histColor));
+
+    lutGraph = plotWidget->addGraph();
+    lutGraph->setPen(QPen(QColor(80, 134, 255), 2));
+
     // 两条线，调整黑白点
     {
         blackLine = new QCPItemLine(plotWidget);
@@ -154,13 +238,18 @@ void GrayMappingWidget::setupUI()
     controlPanel->addWidget(new QLabel("Gamma:"));
     controlPanel->addWidget(gammaSpinBox);
 
+    // 自动范围
+    autoRangeCheckBox = new QCheckBox("Auto", this);
+    autoRangeCheckBox->setToolTip("黑白点跟随直方图的百分位（系统设置 → 自动范围）");
+    controlPanel->addWidget(autoRangeCheckBox);
+
     layout->addWidget(plotWidget);
     layout->addLayout(controlPanel);
 }
 
 void GrayMappingWidget::onMousePress(QMouseEvent *event)
 {
-    if (event->button() == Qt::LeftButton)
+    if (event->button() == Qt::LeftButton && !autoRangeCheckBox->isChecked())
     {
 
         // 获取鼠标位置
@@ -310,50 +399,32 @@ void GrayMappingWidget::updateLutCurve(bool fromDrag)
         }
     }
 
-    updatePlot();
+    updateLutGraph();
 
     emit lutChanged(minSpinBox->value(), maxSpinBox->value(), gammaSpinBox->value());
 }
 
-void GrayMappingWidget::updatePlot()
+void GrayMappingWidget::updateHistogramGraph()
 {
-    plotWidget->clearGraphs();
-
-    // 绘制直方图
+    QVector<double> x(m_histogram.size());
+    for (int i = 0; i < m_histogram.size(); ++i)
     {
-        auto histGraph = plotWidget->addGraph();
-        histGraph->setLineStyle(QCPGraph::lsLine);
-        QColor histColor = QColor(31, 53, 101, 200);
-        histGraph->setPen(QPen(histColor.lighter(200)));
-        histGraph->setBrush(QBrush(histColor));
-
-        if (m_histogram.size())
-        {
-            QVector<double> x(m_histogram.size()), y(m_histogram.size());
-            for (int i = 0; i < m_histogram.size(); ++i)
-            {
-                x[i] = i / (m_histogram.size() - 1.0) * m_maxValue;
-                y[i] = m_histogram[i];
-            }
-            histGraph->setData(x, y);
-        }
+        x[i] = i / (m_histogram.size() - 1.0) * m_maxValue;
     }
+    histogramGraph->setData(x, m_histogram, true);
 
-    // 添加LUT曲线
+    // 同一轮事件循环里的多次修改合并成一次重绘
+    plotWidget->replot(QCustomPlot::rpQueuedReplot);
+}
 
+void GrayMappingWidget::updateLutGraph()
+{
+    QVector<double> x(LUT_SIZE);
+    for (int i = 0; i < LUT_SIZE; ++i)
     {
-        auto lutGraph = plotWidget->addGraph();
-
-        QVector<double> x(LUT_SIZE), y(LUT_SIZE);
-        for (int i = 0; i < LUT_SIZE; ++i)
-        {
-            x[i] = i / (LUT_SIZE - 1.0) * m_maxValue;
-            y[i] = m_lutCurve[i];
-        }
-        lutGraph->setData(x, y);
-
-        lutGraph->setPen(QPen(QColor(80, 134, 255), 2));
+        x[i] = i / (LUT_SIZE - 1.0) * m_maxValue;
     }
+    lutGraph->setData(x, m_lutCurve, true);
 
-    plotWidget->replot();
+    plotWidget->replot(QCustomPlot::rpQueuedReplot);
 }
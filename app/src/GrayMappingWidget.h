@@ -2,9 +2,14 @@
 
 #include <QWidget>
 #include <QDoubleSpinBox>
+#include <QCheckBox>
+#include <QTimer>
 #include <QVector>
 
+#include <memory>
+
 #include "qcustomplot.h"
+#include "HistogramChannel.h"
 
 class GrayMappingWidget : public QWidget
 {
@@ -14,8 +19,19 @@ public:
 
     void setHistogram(const std::vector<int> &histogram, int maxValue);
 
+    // 显示期间按“系统设置 → 直方图刷新”的频率从通道取最新的直方图
+    void setHistogramChannel(std::shared_ptr<lzx::HistogramChannel> channel);
+
+    // 自动范围切换后移动黑白点
+    void setDisplayRange(double min, double max);
+
 signals:
     void lutChanged(double min, double max, double gamma); // Added lutChanged signal
+    void autoRangeToggled(bool enabled);
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
 
 private:
     const int LUT_SIZE = 360;
@@ -27,18 +43,31 @@ private:
     QDoubleSpinBox *minSpinBox;
     QDoubleSpinBox *maxSpinBox;
     QDoubleSpinBox *gammaSpinBox;
+    QCheckBox *autoRangeCheckBox; // 打开后黑白点跟随直方图，不能手动调整
 
     QCPItemLine *blackLine;           // 黑点控制线
     QCPItemLine *whiteLine;           // 白点控制线
     QCPItemLine *currentDraggingLine; // 当前正在拖动的线
 
+    QCPGraph *histogramGraph; // 两条曲线只创建一次，数据变化时只更新对应的那条
+    QCPGraph *lutGraph;
+
     // Data
     QVector<double> m_histogram; // 存储直方图数据
     QVector<double> m_lutCurve;  // 存储LUT曲线数据
 
+    // 直方图拉取
+    std::shared_ptr<lzx::HistogramChannel> m_histogramChannel;
+    lzx::HistogramChannel::Snapshot m_snapshot;
+    QTimer *m_histogramTimer;
+    uint64_t m_histogramShown = 0;     // 本次显示期间画出的直方图数
+    uint64_t m_histogramCoalesced = 0; // 本次显示期间在两次刷新之间被合并掉的直方图数
+
     void setupUI();
     void updateLutCurve(bool fromDrag = false);
-    void updatePlot();
+    void updateHistogramGraph();
+    void updateLutGraph();
+    void pullHistogram();
 
     void onMousePress(QMouseEvent *event);
     void onMouseMove(QMouseEvent *event);
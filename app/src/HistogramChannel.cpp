@@ -0,0 +1,42 @@
+#include "HistogramChannel.h"
+
+#include <utility>
+
+namespace lzx
+{
+    void HistogramChannel::publish()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_write.sequence = ++m_sequence;
+        m_write.coalesced = 0;
+        if (m_hasReady)
+        {
+            // 就绪的那份还没被取走，被这次发布覆盖
+            m_write.coalesced = m_ready.coalesced + 1;
+            ++m_stats.coalesced;
+        }
+
+        std::swap(m_write, m_ready);
+        m_hasReady = true;
+        ++m_stats.published;
+    }
+
+    bool HistogramChannel::take(Snapshot &snapshot)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_hasReady)
+            return false;
+
+        std::swap(snapshot, m_ready);
+        m_hasReady = false;
+        ++m_stats.delivered;
+        return true;
+    }
+
+    HistogramChannel::Statistics HistogramChannel::statistics() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+}
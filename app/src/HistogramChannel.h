@@ -0,0 +1,54 @@
+#ifndef HISTOGRAM_CHANNEL_H
+#define HISTOGRAM_CHANNEL_H
+
+#include <mutex>
+#include <vector>
+#include <cstdint>
+
+namespace lzx
+{
+    // 直方图的发布通道：生产者（直方图线程）每帧写一次，显示端按自己的刷新率取最新的一份。
+    // 双缓冲：生产者在自己的写缓冲里填好数据，发布时在锁内与就绪缓冲交换；
+    // 显示端取出时与自己的缓冲交换，两边都不复制数据、稳定后不再分配内存。
+    // 显示端两次取出之间的多次发布只保留最后一次，被覆盖的次数计入 coalesced。
+    class HistogramChannel
+    {
+    public:
+        struct Snapshot
+        {
+            std::vector<int> bins;
+            int maxValue = 0;
+            uint64_t sequence = 0;  // 发布序号，从 1 开始
+            uint64_t coalesced = 0; // 上次取出之后被覆盖、没有显示的发布次数
+        };
+
+        struct Statistics
+        {
+            uint64_t published = 0;
+            uint64_t delivered = 0;
+            uint64_t coalesced = 0;
+        };
+
+        // 生产者的写缓冲，只能在发布线程上使用
+        Snapshot &writeBuffer() { return m_write; }
+
+        // 发布写缓冲中的数据
+        void publish();
+
+        // 有新数据时与 snapshot 交换并返回 true
+        bool take(Snapshot &snapshot);
+
+        Statistics statistics() const;
+
+    private:
+        Snapshot m_write;
+
+        mutable std::mutex m_mutex;
+        Snapshot m_ready;
+        bool m_hasReady = false;
+        uint64_t m_sequence = 0;
+        Statistics m_stats;
+    };
+}
+
+#endif
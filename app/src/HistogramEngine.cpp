@@ -0,0 +1,347 @@
+#include "HistogramEngine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#include "ThreadPool.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HISTOGRAM_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace lzx
+{
+    namespace
+    {
+        constexpr size_t MergeBlock = 4096; // 合并时每个任务负责的 bin 数
+
+        // 逐个采样点计数，step 为相邻采样点之间的分量数；
+        // laneStride 为相邻子直方图的间距，0 表示只用一份（采样点少于 bin 数时不值得清零、合并多份）
+        template <typename T>
+        void countScalar(const T *row, int width, int step, uint32_t *lanes, size_t laneStride, uint32_t maxValue)
+        {
+            uint32_t *h0 = lanes;
+            uint32_t *h1 = lanes + laneStride;
+            uint32_t *h2 = lanes + laneStride * 2;
+            uint32_t *h3 = lanes + laneStride * 3;
+
+            int x = 0;
+            for (; x + 4 <= width; x += 4)
+            {
+                const T *p = row + static_cast<size_t>(x) * step;
+                h0[std::min<uint32_t>(p[0], maxValue)]++;
+                h1[std::min<uint32_t>(p[step], maxValue)]++;
+                h2[std::min<uint32_t>(p[step * 2], maxValue)]++;
+                h3[std::min<uint32_t>(p[step * 3], maxValue)]++;
+            }
+            for (; x < width; x++)
+            {
+                h0[std::min<uint32_t>(row[static_cast<size_t>(x) * step], maxValue)]++;
+            }
+        }
+
+#ifdef HISTOGRAM_SSE2
+        // 一次读 8 个 16 位像素，限幅后逐个取出作为下标
+        void count16(const uint16_t *row, int width, uint32_t *lanes, size_t laneStride, uint32_t maxValue)
+        {
+            uint32_t *h0 = lanes;
+            uint32_t *h1 = lanes + laneStride;
+            uint32_t *h2 = lanes + laneStride * 2;
+            uint32_t *h3 = lanes + laneStride * 3;
+            const __m128i limit = _mm_set1_epi16(static_cast<short>(maxValue));
+
+            int x = 0;
+            for (; x + 8 <= width; x += 8)
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x));
+                v = _mm_sub_epi16(v, _mm_subs_epu16(v, limit)); // 无符号 min
+                h0[_mm_extract_epi16(v, 0)]++;
+                h1[_mm_extract_epi16(v, 1)]++;
+                h2[_mm_extract_epi16(v, 2)]++;
+                h3[_mm_extract_epi16(v, 3)]++;
+                h0[_mm_extract_epi16(v, 4)]++;
+                h1[_mm_extract_epi16(v, 5)]++;
+                h2[_mm_extract_epi16(v, 6)]++;
+                h3[_mm_extract_epi16(v, 7)]++;
+            }
+            countScalar(row + x, width - x, 1, lanes, laneStride, maxValue);
+        }
+
+        inline void countPair(uint32_t *low, uint32_t *high, int pair)
+        {
+            low[pair & 0xff]++;
+            high[pair >> 8]++;
+        }
+
+        // 一次读 16 个 8 位像素，每次取出两个像素拆成高低字节
+        void count8(const uint8_t *row, int width, uint32_t *lanes, size_t laneStride)
+        {
+            uint32_t *h0 = lanes;
+            uint32_t *h1 = lanes + laneStride;
+            uint32_t *h2 = lanes + laneStride * 2;
+            uint32_t *h3 = lanes + laneStride * 3;
+
+            int x = 0;
+            for (; x + 16 <= width; x += 16)
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x));
+                countPair(h0, h1, _mm_extract_epi16(v, 0));
+                countPair(h2, h3, _mm_extract_epi16(v, 1));
+                countPair(h0, h1, _mm_extract_epi16(v, 2));
+                countPair(h2, h3, _mm_extract_epi16(v, 3));
+                countPair(h0, h1, _mm_extract_epi16(v, 4));
+                countPair(h2, h3, _mm_extract_epi16(v, 5));
+                countPair(h0, h1, _mm_extract_epi16(v, 6));
+                countPair(h2, h3, _mm_extract_epi16(v, 7));
+            }
+            countScalar(row + x, width - x, 1, lanes, laneStride, 255);
+        }
+#endif
+
+        void countRows(const FrameView &view, int y0, int y1, uint32_t *lanes, size_t laneStride, uint32_t maxValue)
+        {
+            const int step = view.pixelStep() * view.channels();
+            const bool wide = view.bitDepth() > 8;
+
+            for (int y = y0; y < y1; y++)
+            {
+#ifdef HISTOGRAM_SSE2
+                if (step == 1)
+                {
+                    if (wide)
+                        count16(view.row<uint16_t>(y), view.width(), lanes, laneStride, maxValue);
+                    else
+                        count8(view.row(y), view.width(), lanes, laneStride);
+                    continue;
+                }
+#endif
+                if (wide)
+                    countScalar(view.row<uint16_t>(y), view.width(), step, lanes, laneStride, maxValue);
+                else
+                    countScalar(view.row(y), view.width(), step, lanes, laneStride, maxValue);
+            }
+        }
+    }
+
+    int HistogramEngine::Result::percentile(double fraction) const
+    {
+        if (samples == 0)
+            return 0;
+
+        fraction = std::min(std::max(fraction, 0.0), 1.0);
+        uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(samples))));
+
+        uint64_t cumulative = 0;
+        for (size_t value = 0; value < counts.size(); value++)
+        {
+            cumulative += counts[value];
+            if (cumulative >= target)
+                return static_cast<int>(value);
+        }
+        return maxValue;
+    }
+
+    std::vector<int> HistogramEngine::Result::rebin(int bins) const
+    {
+        std::vector<int> histogram;
+        rebin(bins, histogram);
+        return histogram;
+    }
+
+    void HistogramEngine::Result::rebin(int bins, std::vector<int> &histogram) const
+    {
+        bins = std::max(bins, 1);
+        histogram.assign(bins, 0);
+
+        const uint64_t range = counts.size();
+        for (size_t value = 0; value < counts.size(); value++)
+        {
+            histogram[value * bins / range] += static_cast<int>(counts[value]);
+        }
+    }
+
+    HistogramEngine::HistogramEngine(ThreadPool *pool)
+        : m_pool(pool)
+    {
+    }
+
+    bool HistogramEngine::compute(const FrameView &view, Result &result)
+    {
+        if (view.empty())
+            return false;
+
+        const int bitDepth = std::min(std::max(view.bitDepth(), 8), 16);
+        const uint32_t maxValue = (1u << bitDepth) - 1;
+        const size_t bins = maxValue + 1;
+
+        // 分段数不超过线程数，每段至少 MinChunkRows 行、bins 个采样点；
+        // 每段采样点不到 bin 数的 16 倍时清零、合并多份子直方图的开销超过计数本身，只用一份
+        const size_t points = static_cast<size_t>(view.width()) * view.height();
+        size_t threads = m_pool ? m_pool->workerCount() + 1 : 1;
+        size_t chunks = std::min({threads, static_cast<size_t>(view.height() / MinChunkRows), points / bins});
+        chunks = std::max<size_t>(chunks, 1);
+        const size_t lanesPerChunk = points / chunks >= bins * 16 ? Lanes : 1;
+        const size_t laneCount = chunks * lanesPerChunk;
+
+        result.bitDepth = bitDepth;
+        result.maxValue = static_cast<int>(maxValue);
+        result.counts.resize(bins);
+
+        // 只有一份时直接计入结果，不用合并
+        uint32_t *lanes = result.counts.data();
+        if (laneCount > 1)
+        {
+            if (m_lanes.size() < laneCount * bins)
+                m_lanes.resize(laneCount * bins);
+            lanes = m_lanes.data();
+        }
+
+        auto run = [this](size_t count, const std::function<void(size_t)> &task)
+        {
+            if (m_pool && count > 1)
+                m_pool->parallelFor(count, task);
+            else
+                for (size_t i = 0; i < count; i++)
+                    task(i);
+        };
+
+        run(chunks, [&](size_t chunk)
+            {
+                uint32_t *chunkLanes = lanes + chunk * lanesPerChunk * bins;
+                memset(chunkLanes, 0, lanesPerChunk * bins * sizeof(uint32_t));
+
+                int y0 = static_cast<int>(view.height() * chunk / chunks);
+                int y1 = static_cast<int>(view.height() * (chunk + 1) / chunks);
+                countRows(view, y0, y1, chunkLanes, lanesPerChunk > 1 ? bins : 0, maxValue); });
+
+        // 按 bin 区间合并所有子直方图
+        if (laneCount > 1)
+        {
+            run((bins + MergeBlock - 1) / MergeBlock, [&](size_t block)
+                {
+                    size_t begin = block * MergeBlock;
+                    size_t end = std::min(begin + MergeBlock, bins);
+                    uint32_t *out = result.counts.data();
+                    memcpy(out + begin, lanes + begin, (end - begin) * sizeof(uint32_t));
+                    for (size_t lane = 1; lane < laneCount; lane++)
+                    {
+                        const uint32_t *src = lanes + lane * bins;
+                        for (size_t i = begin; i < end; i++)
+                            out[i] += src[i];
+                    } });
+        }
+
+        // 派生统计
+        uint64_t samples = 0;
+        double sum = 0.0;
+        int minValue = -1;
+        int maxSeen = 0;
+        for (size_t value = 0; value < bins; value++)
+        {
+            uint32_t count = result.counts[value];
+            if (count == 0)
+                continue;
+            if (minValue < 0)
+                minValue = static_cast<int>(value);
+            maxSeen = static_cast<int>(value);
+            samples += count;
+            sum += static_cast<double>(value) * count;
+        }
+
+        result.samples = samples;
+        result.min = std::max(minValue, 0);
+        result.max = maxSeen;
+        result.mean = samples ? sum / static_cast<double>(samples) : 0.0;
+        return true;
+    }
+
+    const char *HistogramEngine::simdName()
+    {
+#ifdef HISTOGRAM_SSE2
+        return "SSE2";
+#else
+        return "scalar";
+#endif
+    }
+
+    HistogramWorker::HistogramWorker(Consumer consumer, size_t threads)
+        : m_consumer(std::move(consumer)),
+          m_pool(threads > 0 ? std::make_unique<ThreadPool>(threads) : nullptr),
+          m_engine(m_pool.get())
+    {
+        m_thread = std::thread(&HistogramWorker::workerFunction, this);
+    }
+
+    HistogramWorker::~HistogramWorker()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        m_thread.join();
+    }
+
+    void HistogramWorker::submit(const Frame &frame, int sampling)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_hasPending)
+                ++m_stats.replaced;
+            m_pending = frame;
+            m_sampling = std::max(sampling, 1);
+            m_hasPending = true;
+        }
+        m_wake.notify_one();
+    }
+
+    HistogramWorker::Statistics HistogramWorker::statistics() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stats;
+    }
+
+    void HistogramWorker::workerFunction()
+    {
+        HistogramEngine::Result result;
+
+        while (true)
+        {
+            Frame frame;
+            int sampling = 1;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [this]
+                            { return m_stop || m_hasPending; });
+                if (m_stop)
+                    break;
+
+                frame = std::move(m_pending);
+                sampling = m_sampling;
+                m_hasPending = false;
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            bool computed = m_engine.compute(frame.view().decimate(sampling), result);
+            result.timestampNs = frame.metadata().hostTimestampNs;
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+            // 尽早归还帧的租约
+            frame.reset();
+
+            if (!computed)
+                continue;
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                ++m_stats.computed;
+                m_stats.averageMs += (ms - m_stats.averageMs) / static_cast<double>(std::min<uint64_t>(m_stats.computed, 64));
+            }
+
+            m_consumer(result);
+        }
+    }
+}
@@ -0,0 +1,108 @@
+#ifndef HISTOGRAM_ENGINE_H
+#define HISTOGRAM_ENGINE_H
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "Frame.h"
+#include "FrameView.h"
+
+namespace lzx
+{
+    class ThreadPool;
+
+    // 精确直方图：每个灰度值一个 bin（8 位 256 个，16 位 65536 个，10/12 位按有效位数），
+    // 显示用的粗直方图由 rebin() 合并得到，百分位、均值等统计都在精确直方图上计算。
+    // 帧按行分成与线程数相同的几段并行统计，每段用 Lanes 份子直方图轮流计数（相邻像素同值时不会连续读写同一个计数），
+    // 最后按 bin 区间并行合并；抽样后采样点少于 bin 数时只用一份，省去清零和合并。行内 SSE2 一次读 8/16 个像素并限幅，单通道逐像素时才走 SIMD。
+    class HistogramEngine
+    {
+    public:
+        static constexpr int MinChunkRows = 64; // 每段至少这么多行，小图不值得分段
+        static constexpr int Lanes = 4;
+
+        struct Result
+        {
+            int bitDepth = 0;
+            int maxValue = 0;             // 满量程，超出的值（如 12 位数据里的噪声）计入最后一个 bin
+            std::vector<uint32_t> counts; // maxValue + 1 个 bin
+            uint64_t samples = 0;
+            int min = 0;
+            int max = 0;
+            double mean = 0.0;
+            int64_t timestampNs = 0;      // 帧的主机时间戳，由 HistogramWorker 填写，compute() 不修改
+
+            bool empty() const { return samples == 0; }
+
+            // 累计比例达到 fraction（0~1）的最小灰度值
+            int percentile(double fraction) const;
+
+            // 合并成 bins 个等宽区间，用于显示
+            std::vector<int> rebin(int bins) const;
+            void rebin(int bins, std::vector<int> &histogram) const; // 复用 histogram 的内存
+        };
+
+        explicit HistogramEngine(ThreadPool *pool = nullptr);
+
+        // 统计第一个通道；抽样由视图决定（FrameView::decimate）。视图为空时返回 false
+        bool compute(const FrameView &view, Result &result);
+
+        // 内层循环使用的指令集
+        static const char *simdName();
+
+    private:
+        ThreadPool *m_pool;
+        std::vector<uint32_t> m_lanes; // 每段 Lanes 份子直方图，跨帧复用
+    };
+
+    // 直方图的后台线程：只计算最新提交的一帧，还没开始计算的旧帧直接被替换，
+    // 结果在后台线程上交给 consumer。持有帧的租约直到计算完成。
+    class HistogramWorker
+    {
+    public:
+        using Consumer = std::function<void(const HistogramEngine::Result &result)>;
+
+        struct Statistics
+        {
+            uint64_t computed = 0;
+            uint64_t replaced = 0;  // 没来得及计算就被新帧替换的帧数
+            double averageMs = 0.0; // 每帧计算耗时的平均值
+        };
+
+        // threads 为线程池的工作线程数（后台线程自身也参与计算），0 表示只用后台线程
+        HistogramWorker(Consumer consumer, size_t threads);
+        ~HistogramWorker();
+
+        // sampling: 行列抽样步长，1 为逐像素
+        void submit(const Frame &frame, int sampling);
+
+        Statistics statistics() const;
+
+    private:
+        HistogramWorker(const HistogramWorker &) = delete;
+        HistogramWorker &operator=(const HistogramWorker &) = delete;
+
+        void workerFunction();
+
+        Consumer m_consumer;
+        std::unique_ptr<ThreadPool> m_pool;
+        HistogramEngine m_engine;
+        std::thread m_thread;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_wake;
+        Frame m_pending;
+        int m_sampling = 1;
+        bool m_hasPending = false;
+        bool m_stop = false;
+        Statistics m_stats;
+    };
+}
+
+#endif
@@ -4,6 +4,11 @@
 #include <string>
 #include <functional>
 #include <map>
+#include <cstring>
+
+#include "CameraProperty.h"
+#include "Frame.h"
+#include "FrameBus.h"
 
 namespace lzx
 {
@@ -28,7 +33,49 @@ namespace lzx
         virtual bool get(const std::string &name, int &value) { return false; }                                               // get int
         virtual bool get(const std::string &name, bool &value) { return false; }                                              // get bool
         virtual bool get(const std::string &name, std::string &value) { return false; }                                       // get string
-        virtual bool getFrame(unsigned char *buffer, int &width, int &height, int &channels, int &bitDepth) { return false; } // get latest frame
+
+        // 打开时查询到的参数范围、步长和当前值，不调用 SDK
+        const PropertyRegistry &properties() const { return propertyRegistry; }
+
+        // 提交一组参数，在两帧之间一起生效（取流时由采集线程应用，否则立即应用）
+        // 返回这组参数的编号，之后 FrameMetadata::parameterEpoch 不小于它的帧都是按新参数拍摄的；失败或不支持时返回 0
+        virtual uint64_t apply(const ParameterTransaction &transaction) { return 0; }
+
+        // 租用最新帧：返回的 Frame 引用生产者的缓冲区（不拷贝像素），持有期间缓冲区不会被回收，
+        // 析构或 reset() 即归还。没有新帧时返回空帧。
+        virtual Frame acquireLatestFrame() { return Frame(); }
+
+        // 相机发布帧的总线，录像、配对等额外消费者可以在上面订阅自己的游标
+        virtual FrameBus *frameBus() { return nullptr; }
+
+        // 兼容接口：把最新帧拷贝到调用者的缓冲区，新代码请使用 acquireLatestFrame() 直接读取生产者的缓冲区
+        virtual bool getFrame(unsigned char *buffer, int &width, int &height, int &channels, int &bitDepth)
+        {
+            if (!buffer)
+            {
+                return false;
+            }
+
+            Frame frame = acquireLatestFrame();
+            if (frame.empty())
+            {
+                return false;
+            }
+
+            width = frame.width();
+            height = frame.height();
+            channels = frame.channels();
+            bitDepth = frame.bitDepth();
+
+            // 调用方的缓冲区是紧密排列的，逐行去掉行填充
+            FrameView view = frame.view();
+            size_t rowBytes = view.width() * view.bytesPerPixel();
+            for (int y = 0; y < view.height(); y++)
+            {
+                memcpy(buffer + y * rowBytes, view.row(y), rowBytes);
+            }
+            return true;
+        }
         virtual void setStateChangedCallback(StateChangedCallback callback) { stateChangedCallback = callback; }
 
     protected:
@@ -41,6 +88,7 @@ namespace lzx
         }
 
         StateChangedCallback stateChangedCallback;
+        PropertyRegistry propertyRegistry;
     };
 }
 
@@ -1,48 +1,154 @@
 #include "ImageRenderer.hpp"
 
+#include <algorithm>
+
 #include "Global.hpp"
 
-void ImageRenderer::updateTextureFromCamera()
+bool ImageRenderer::updateTextureFromCamera()
+{
+    // 不能在构造时注册：全局资源构造期间会创建 Mask 窗口
+    if (!frameNotifier && frameArrivedCallback)
+    {
+        frameNotifier = std::make_unique<lzx::FrameNotifier>(GlobalResourceManager::getInstance().frameBus.get(), frameArrivedCallback);
+    }
+
+    // 低延迟模式：采集线程把最新帧直接写进信箱，优先从信箱取
+    auto mailbox = GlobalResourceManager::getInstance().mailbox.get();
+    if (mailbox)
+    {
+        // 信箱在用时，没有新帧就短暂阻塞等待，而不是空转重绘
+        if (mailboxActive && !mailbox->waitForNewer(mailboxSequence, std::chrono::milliseconds(MailboxWaitMs)))
+        {
+            mailboxActive = false;
+        }
+
+        lzx::FrameMailbox::FrameInfo info;
+        if (mailbox->read(mailboxBuffer, info, mailboxSequence))
+        {
+            mailboxSequence = info.sequence;
+            mailboxActive = true;
+            uploadFrame(lzx::FrameView(mailboxBuffer.data(), info.width, info.height, info.channels, info.bitDepth), info.metadata);
+            return true;
+        }
+    }
+
+    auto frameBus = GlobalResourceManager::getInstance().frameBus.get();
+    if (frameBus)
+    {
+        if (!subscription)
+        {
+            subscription = frameBus->subscribe("mask");
+        }
+
+        // 只取最新帧，跟不上时跳过中间帧；纹理上传直接读取生产者的缓冲区
+        lzx::Frame frame = subscription->acquire();
+        if (!frame.empty())
+        {
+            uploadFrame(frame.view(), frame.metadata());
+            return true;
+        }
+    }
+    return false;
+}
+
+void ImageRenderer::uploadFrame(const lzx::FrameView &view, const lzx::FrameMetadata &metadata)
 {
+    // 检查是否要更新
+    if (view.empty() || view.channels() <= 0)
+    {
+        return;
+    }
+
+    // 检查是否需要重建纹理，高位深的帧用16位纹理，保留Mask灰度的精度
+    QOpenGLTexture::TextureFormat textureFormat = view.bitDepth() > 8 ? QOpenGLTexture::RGBA16_UNorm : QOpenGLTexture::RGBA8_UNorm;
+    if (QSize(texture->width(), texture->height()) != QSize(view.width(), view.height()) || texture->format() != textureFormat)
+    {
+        // 删除旧的纹理
+        delete texture;
+
+        // 创建一个新的纹理
+        texture = new QOpenGLTexture(QOpenGLTexture::Target2D);
+        texture->setSize(view.width(), view.height());
+        texture->setFormat(textureFormat);
+        texture->setWrapMode(QOpenGLTexture::ClampToBorder);
+        texture->setBorderColor(QColor(Qt::black));
+        texture->allocateStorage();
+        texture->setMinificationFilter(QOpenGLTexture::LinearMipMapLinear);
+        texture->setMagnificationFilter(QOpenGLTexture::Linear);
+    }
+
+    // 更新纹理
+    updateOpenGLTexture(texture->textureId(), view);
+    int effectiveBits = std::min(std::max(view.bitDepth(), 8), 16);
+    valueScale = effectiveBits > 8 ? 65535.0f / ((1 << effectiveBits) - 1) : 1.0f;
+
+    pendingMetadata = metadata;
+    pendingMetadata.mark(lzx::FrameMetadata::TextureUpload);
+    presentPending = true;
+}
+
+void ImageRenderer::markMaskEncoded()
+{
+    if (presentPending)
+    {
+        pendingMetadata.mark(lzx::FrameMetadata::MaskEncode);
+    }
+}
 
-    auto frameBuffer = GlobalResourceManager::getInstance().tripleBuffer.get();
-    if (frameBuffer)
+void ImageRenderer::onPresented()
+{
+    if (!presentPending)
     {
-        lzx::Frame *frame = frameBuffer->consume();
+        return;
+    }
+
+    presentPending = false;
+    pendingMetadata.mark(lzx::FrameMetadata::Present);
 
-        // 检查是否要更新
-        if (frame && frame->width() > 0 && frame->height() > 0 && frame->channels() > 0)
+    // 记录这幅 Mask 来自哪一帧参考图像，配对时据此查询成像曝光期间的 Mask
+    lzx::MaskTimeline::Entry entry;
+    entry.presentNs = pendingMetadata.stageNs[lzx::FrameMetadata::Present];
+    entry.referenceFrameCounter = pendingMetadata.deviceFrameCounter;
+    entry.referenceTimestampNs = pendingMetadata.hostTimestampNs;
+    entry.referenceExposureMidNs = pendingMetadata.exposureMidNs();
+    GlobalResourceManager::getInstance().maskTimeline->record(entry);
+
+    if (!dmdLatency)
+    {
+        dmdLatency = lzx::LatencyTracker::getInstance().histogram("grab-to-dmd");
+        lastLatencyLogNs = pendingMetadata.stageNs[lzx::FrameMetadata::Present];
+    }
+    dmdLatency->record(pendingMetadata.elapsed(lzx::FrameMetadata::Grab, lzx::FrameMetadata::Present));
+
+    // 每10秒输出一次分位数，输出后清零
+    int64_t nowNs = pendingMetadata.stageNs[lzx::FrameMetadata::Present];
+    if (nowNs - lastLatencyLogNs >= 10000000000LL)
+    {
+        lzx::LatencyHistogram::Summary summary = dmdLatency->summary();
+        if (summary.count > 0)
         {
-            // 检查是否需要重建纹理
-            if (QSize(texture->width(), texture->height()) != QSize(frame->width(), frame->height()) || texture->format() != QOpenGLTexture::RGBA8_UNorm)
-            {
-                // 删除旧的纹理
-                delete texture;
-
-                // 创建一个新的纹理
-                texture = new QOpenGLTexture(QOpenGLTexture::Target2D);
-                texture->setSize(frame->width(), frame->height());
-                texture->setFormat(QOpenGLTexture::RGBA8_UNorm);
-                texture->setWrapMode(QOpenGLTexture::ClampToBorder);
-                texture->setBorderColor(QColor(Qt::black));
-                texture->allocateStorage();
-                texture->setMinificationFilter(QOpenGLTexture::LinearMipMapLinear);
-                texture->setMagnificationFilter(QOpenGLTexture::Linear);
-            }
-
-            // 更新纹理
-            updateOpenGLTexture(texture->textureId(), frame->width(), frame->height(), frame->data(), frame->channels());
+            Log::info(QString("Latency %1: p50 %2 ms p99 %3 ms max %4 ms (%5 frames)")
+                          .arg(QString::fromStdString(summary.name))
+                          .arg(summary.p50Us / 1000.0, 0, 'f', 2)
+                          .arg(summary.p99Us / 1000.0, 0, 'f', 2)
+                          .arg(summary.maxUs / 1000.0, 0, 'f', 2)
+                          .arg(summary.count));
         }
-        frameBuffer->consumeDone();
+        dmdLatency->reset();
+        lastLatencyLogNs = nowNs;
     }
 }
 
-void ImageRenderer::updateOpenGLTexture(GLuint textureID, int width, int height, const GLubyte *data, int bytesPerPixel)
+void ImageRenderer::updateOpenGLTexture(GLuint textureID, const lzx::FrameView &view)
 {
+    int bytesPerPixel = view.channels() * static_cast<int>(view.bytesPerComponent());
     GLenum availFormats[] = {GL_RED, GL_RG, GL_RGB, GL_RGBA};
-    GLenum format = availFormats[bytesPerPixel - 1];
+    GLenum format = availFormats[view.channels() - 1];
+    GLenum type = view.bitDepth() > 8 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_BYTE;
     glBindTexture(GL_TEXTURE_2D, textureID);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, (bytesPerPixel == 4) ? 4 : 1);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, data);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, (bytesPerPixel % 4 == 0) ? 4 : (bytesPerPixel % 2 == 0 ? 2 : 1));
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(view.stride() / bytesPerPixel)); // 带行填充的帧直接上传
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, view.width(), view.height(), format, type, view.data());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     glBindTexture(GL_TEXTURE_2D, 0);
 }
\ No newline at end of file
@@ -8,6 +8,9 @@
 #include <QDebug>
 
 #include "Common.h"
+#include "FrameBus.h"
+#include "FrameNotifier.h"
+#include "LatencyStats.h"
 
 class ImageRenderer : protected QOpenGLFunctions_3_3_Core
 {
@@ -15,6 +18,7 @@ public:
     ImageRenderer() {}
     ~ImageRenderer()
     {
+        frameNotifier.reset();
         vao.destroy();
         vbo.destroy();
         delete texture;
@@ -31,7 +35,33 @@ public:
         generateTransferFuntionTexture(TransferFunction());
     }
 
-    void draw(bool inverse, TransferFunction tf, float rotation, const QVector2D &translation, bool flipHorizontal, bool flipVertical, int lumOffset)
+    // DMD 编码完成（paintGL 末尾调用）
+    void markMaskEncoded();
+
+    // 缓冲区交换后调用，统计抓取到 DMD 的延迟
+    void onPresented();
+
+    // 全局总线上有新帧时调用 callback（在发布线程上），第一次 draw() 时才注册；传空时注销
+    void setFrameArrivedCallback(lzx::FrameNotifier::Callback callback)
+    {
+        frameNotifier.reset();
+        frameArrivedCallback = std::move(callback);
+    }
+
+    // 重绘开始时调用，之后到达的帧会再次通知
+    void acknowledgeFrames()
+    {
+        if (frameNotifier)
+            frameNotifier->acknowledge();
+    }
+
+    lzx::FrameNotifier::Statistics frameStatistics() const
+    {
+        return frameNotifier ? frameNotifier->statistics() : lzx::FrameNotifier::Statistics();
+    }
+
+    // 返回这次是否上传了新帧
+    bool draw(bool inverse, TransferFunction tf, float rotation, const QVector2D &translation, bool flipHorizontal, bool flipVertical, int lumOffset)
     {
         qDebug() << "ImageRenderer::draw()";
 
@@ -46,7 +76,7 @@ public:
         }
 
         // 更新纹理
-        updateTextureFromCamera();
+        bool uploaded = updateTextureFromCamera();
 
         shaderProgram.bind();
 
@@ -57,6 +87,7 @@ public:
         shaderProgram.setUniformValue("flipHorizontal", flipHorizontal);
         shaderProgram.setUniformValue("flipVertical", flipVertical);
         shaderProgram.setUniformValue("lumOffset", lumOffset);
+        shaderProgram.setUniformValue("valueScale", valueScale);
 
         // 绑定纹理
         glFuncs->glActiveTexture(GL_TEXTURE0);
@@ -72,6 +103,8 @@ public:
         vao.release();
 
         shaderProgram.release();
+
+        return uploaded;
     }
 
 private:
@@ -83,6 +116,25 @@ private:
     float gamma = 2.0f;                               // 伽马值
     QOpenGLFunctions_3_3_Core *glFuncs = nullptr;
     float aspect = 1024.0f / 768.0f;
+    float valueScale = 1.0f; // 16位纹理按 65535 归一化，有效位数不足16位时乘上这个系数
+
+    std::unique_ptr<lzx::FrameBus::Subscription> subscription; // Mask窗口在全局总线上的订阅
+
+    // 低延迟模式的信箱
+    std::vector<unsigned char> mailboxBuffer; // 从信箱拷出的最新帧，复用不重新分配
+    uint64_t mailboxSequence = 0;
+    bool mailboxActive = false;               // 信箱最近有数据，等待新帧而不是空转
+    static constexpr int MailboxWaitMs = 2;
+
+    // 帧到达通知，没有新帧时 Mask 窗口停止循环重绘
+    std::unique_ptr<lzx::FrameNotifier> frameNotifier;
+    lzx::FrameNotifier::Callback frameArrivedCallback;
+
+    // 延迟统计
+    lzx::FrameMetadata pendingMetadata; // 最近一次上传的帧，等待送显
+    bool presentPending = false;
+    lzx::LatencyHistogram *dmdLatency = nullptr;
+    int64_t lastLatencyLogNs = 0;
 
     void initShaders()
     {
@@ -117,8 +169,10 @@ private:
                                               "uniform sampler1D gammaCorrectionTexture;\n"
                                               "uniform bool inverse;\n"
                                               "uniform int lumOffset;\n"
+                                              "uniform float valueScale;\n" // 10/12位数据放大到满量程
                                               "void main() {\n"
                                               "   FragColor = texture(texture1, TexCoords);\n"
+                                              "   FragColor.r = min(FragColor.r * valueScale, 1.0);\n"
                                               "   FragColor.g=FragColor.r;\n"
                                               "   FragColor.b=FragColor.r;\n"
                                               "   float colorGammaCorrected = texture(gammaCorrectionTexture, FragColor.r).r;\n"
@@ -230,7 +284,8 @@ private:
         gammaCorrectionTexture->setData(QOpenGLTexture::Red, QOpenGLTexture::UInt8, lutData);
     }
 
-    void updateTextureFromCamera();
+    bool updateTextureFromCamera(); // 上传了新帧时返回 true
+    void uploadFrame(const lzx::FrameView &view, const lzx::FrameMetadata &metadata);
 
-    void updateOpenGLTexture(GLuint textureID, int width, int height, const GLubyte *data, int bytesPerPixel);
+    void updateOpenGLTexture(GLuint textureID, const lzx::FrameView &view);
 };
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "LatencyStats.h"
+
+#include <cmath>
+#include <limits>
+
+namespace lzx
+{
+    int LatencyHistogram::bucketOf(uint64_t us)
+    {
+        if (us < 1)
+        {
+            return 0;
+        }
+
+        int octave = 0;
+        while ((us >> (octave + 1)) != 0)
+        {
+            octave++;
+        }
+
+        if (octave >= Octaves)
+        {
+            return BucketCount - 1;
+        }
+
+        // 取最高位之后的3位作为子桶
+        int sub = octave >= 3 ? static_cast<int>((us >> (octave - 3)) & (SubBuckets - 1))
+                              : static_cast<int>((us << (3 - octave)) & (SubBuckets - 1));
+        return octave * SubBuckets + sub + 1;
+    }
+
+    double LatencyHistogram::bucketUpperUs(int bucket)
+    {
+        if (bucket == 0)
+        {
+            return 1.0;
+        }
+
+        int octave = (bucket - 1) / SubBuckets;
+        int sub = (bucket - 1) % SubBuckets;
+        return std::ldexp(1.0 + (sub + 1) / double(SubBuckets), octave);
+    }
+
+    void LatencyHistogram::record(int64_t ns)
+    {
+        if (ns < 0)
+        {
+            return;
+        }
+
+        uint64_t us = static_cast<uint64_t>(ns) / 1000;
+        m_buckets[bucketOf(us)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sumUs.fetch_add(us, std::memory_order_relaxed);
+
+        uint64_t current = m_minUs.load(std::memory_order_relaxed);
+        while (us < current && !m_minUs.compare_exchange_weak(current, us, std::memory_order_relaxed))
+        {
+        }
+
+        current = m_maxUs.load(std::memory_order_relaxed);
+        while (us > current && !m_maxUs.compare_exchange_weak(current, us, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    double LatencyHistogram::percentile(double p) const
+    {
+        uint64_t count = m_count.load(std::memory_order_relaxed);
+        if (count == 0)
+        {
+            return 0.0;
+        }
+
+        uint64_t target = static_cast<uint64_t>(std::ceil(p * count));
+        if (target == 0)
+        {
+            target = 1;
+        }
+
+        uint64_t accumulated = 0;
+        for (int i = 0; i < BucketCount; i++)
+        {
+            accumulated += m_buckets[i].load(std::memory_order_relaxed);
+            if (accumulated >= target)
+            {
+                return bucketUpperUs(i);
+            }
+        }
+        return bucketUpperUs(BucketCount - 1);
+    }
+
+    LatencyHistogram::Summary LatencyHistogram::summary() const
+    {
+        Summary summary;
+        summary.name = m_name;
+        summary.count = m_count.load(std::memory_order_relaxed);
+        if (summary.count == 0)
+        {
+            return summary;
+        }
+
+        summary.minUs = double(m_minUs.load(std::memory_order_relaxed));
+        summary.maxUs = double(m_maxUs.load(std::memory_order_relaxed));
+        summary.meanUs = double(m_sumUs.load(std::memory_order_relaxed)) / summary.count;
+        summary.p50Us = percentile(0.50);
+        summary.p90Us = percentile(0.90);
+        summary.p99Us = percentile(0.99);
+        return summary;
+    }
+
+    void LatencyHistogram::reset()
+    {
+        for (auto &bucket : m_buckets)
+        {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+        m_count.store(0, std::memory_order_relaxed);
+        m_sumUs.store(0, std::memory_order_relaxed);
+        m_minUs.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+        m_maxUs.store(0, std::memory_order_relaxed);
+    }
+
+    LatencyHistogram *LatencyTracker::histogram(const std::string &name)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto &histogram = m_histograms[name];
+        if (!histogram)
+        {
+            histogram = std::make_unique<LatencyHistogram>(name);
+        }
+        return histogram.get();
+    }
+
+    std::vector<LatencyHistogram::Summary> LatencyTracker::summaries() const
+    {
+        std::vector<LatencyHistogram::Summary> result;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto &entry : m_histograms)
+        {
+            result.push_back(entry.second->summary());
+        }
+        return result;
+    }
+}
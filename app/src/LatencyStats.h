@@ -0,0 +1,86 @@
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace lzx
+{
+    // 对数分桶的延迟直方图：每个2倍区间分8个子桶，覆盖 1us ~ 16s，相对误差约 9%
+    // 记录是无锁的，可以在任意线程调用
+    class LatencyHistogram
+    {
+    public:
+        struct Summary
+        {
+            std::string name;
+            uint64_t count = 0;
+            double minUs = 0.0;
+            double maxUs = 0.0;
+            double meanUs = 0.0;
+            double p50Us = 0.0;
+            double p90Us = 0.0;
+            double p99Us = 0.0;
+        };
+
+        explicit LatencyHistogram(const std::string &name) : m_name(name) { reset(); }
+
+        // 记录一次延迟（ns），负值忽略
+        void record(int64_t ns);
+
+        // 百分位（0~1），返回 us
+        double percentile(double p) const;
+
+        Summary summary() const;
+        void reset();
+
+        const std::string &name() const { return m_name; }
+
+    private:
+        static constexpr int SubBuckets = 8;
+        static constexpr int Octaves = 24;
+        static constexpr int BucketCount = SubBuckets * Octaves + 2; // 最后一个桶收容溢出
+
+        static int bucketOf(uint64_t us);
+        static double bucketUpperUs(int bucket);
+
+        std::string m_name;
+        std::array<std::atomic<uint64_t>, BucketCount> m_buckets;
+        std::atomic<uint64_t> m_count{0};
+        std::atomic<uint64_t> m_sumUs{0};
+        std::atomic<uint64_t> m_minUs{0};
+        std::atomic<uint64_t> m_maxUs{0};
+    };
+
+    // 全局延迟统计，按名称取直方图，例如 "grab-to-display"、"grab-to-dmd"
+    class LatencyTracker
+    {
+    public:
+        static LatencyTracker &getInstance()
+        {
+            static LatencyTracker instance;
+            return instance;
+        }
+
+        // 返回的指针在程序生命周期内有效
+        LatencyHistogram *histogram(const std::string &name);
+
+        std::vector<LatencyHistogram::Summary> summaries() const;
+
+    private:
+        LatencyTracker() = default;
+        LatencyTracker(const LatencyTracker &) = delete;
+        LatencyTracker &operator=(const LatencyTracker &) = delete;
+
+        mutable std::mutex m_mutex;
+        std::map<std::string, std::unique_ptr<LatencyHistogram>> m_histograms;
+    };
+}
+
+#endif
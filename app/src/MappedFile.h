@@ -0,0 +1,40 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+
+namespace lzx
+{
+    // 只读内存映射文件（Windows: CreateFileMapping，其他平台: mmap）
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile() { close(); }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        // 映射整个文件，失败返回 false
+        bool open(const std::string &path);
+        void close();
+
+        bool isOpen() const { return m_data != nullptr; }
+        const unsigned char *data() const { return m_data; }
+        size_t size() const { return m_size; }
+
+    private:
+        const unsigned char *m_data = nullptr;
+        size_t m_size = 0;
+
+#ifdef _WIN32
+        void *m_file = nullptr;
+        void *m_mapping = nullptr;
+#else
+        int m_fd = -1;
+#endif
+    };
+}
+
+#endif
@@ -0,0 +1,70 @@
+#include "MaskTimeline.h"
+
+#include <algorithm>
+
+namespace lzx
+{
+    MaskTimeline::MaskTimeline(size_t capacity)
+        : m_entries(std::max<size_t>(capacity, 1))
+    {
+    }
+
+    void MaskTimeline::record(const Entry &entry)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_count < m_entries.size())
+        {
+            m_entries[(m_head + m_count) % m_entries.size()] = entry;
+            ++m_count;
+        }
+        else
+        {
+            m_entries[m_head] = entry;
+            m_head = (m_head + 1) % m_entries.size();
+        }
+    }
+
+    MaskTimeline::Lookup MaskTimeline::lookup(int64_t startNs, int64_t endNs) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        Lookup result;
+
+        // 送显时间单调递增，二分找到最后一条不晚于曝光开始的记录
+        size_t lo = 0, hi = m_count;
+        while (lo < hi)
+        {
+            size_t mid = (lo + hi) / 2;
+            if (at(mid).presentNs <= startNs)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        if (lo > 0)
+        {
+            result.known = true;
+            result.mask = at(lo - 1);
+        }
+
+        for (size_t i = lo; i < m_count && at(i).presentNs <= endNs; ++i)
+        {
+            ++result.changes;
+        }
+        return result;
+    }
+
+    size_t MaskTimeline::size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_count;
+    }
+
+    void MaskTimeline::clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_head = 0;
+        m_count = 0;
+    }
+}
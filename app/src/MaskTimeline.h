@@ -0,0 +1,55 @@
+#ifndef MASK_TIMELINE_H
+#define MASK_TIMELINE_H
+
+#include <mutex>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace lzx
+{
+    // Mask 送显记录：Mask 窗口每次把由新参考帧生成的图案送到 DMD 时记一条，
+    // 用来查询成像相机某次曝光期间 DMD 上是哪一幅 Mask、由哪一帧参考图像计算得到。
+    // 记录保存在固定容量的环形缓冲区里，界面线程写入，配对线程查询。
+    class MaskTimeline
+    {
+    public:
+        struct Entry
+        {
+            int64_t presentNs = 0;                // 送显（交换缓冲区）的主机时间，之后一直生效到下一条
+            uint64_t referenceFrameCounter = 0;   // 生成这幅 Mask 的参考帧的设备帧号
+            int64_t referenceTimestampNs = 0;     // 该参考帧的到达时间
+            int64_t referenceExposureMidNs = 0;   // 该参考帧的曝光中点（主机时钟）
+        };
+
+        struct Lookup
+        {
+            bool known = false;   // 曝光开始时生效的 Mask 是否还在记录范围内
+            Entry mask;           // 曝光开始时生效的 Mask
+            size_t changes = 0;   // 曝光期间又送显了几幅 Mask，非 0 时这次曝光混合了多幅图案
+        };
+
+        explicit MaskTimeline(size_t capacity = 1024);
+
+        void record(const Entry &entry);
+
+        // 查询主机时间区间 [startNs, endNs] 内生效的 Mask
+        Lookup lookup(int64_t startNs, int64_t endNs) const;
+
+        size_t size() const;
+        void clear();
+
+    private:
+        MaskTimeline(const MaskTimeline &) = delete;
+        MaskTimeline &operator=(const MaskTimeline &) = delete;
+
+        const Entry &at(size_t index) const { return m_entries[(m_head + index) % m_entries.size()]; }
+
+        std::vector<Entry> m_entries;
+        size_t m_head = 0;  // 最旧一条的位置
+        size_t m_count = 0;
+        mutable std::mutex m_mutex;
+    };
+}
+
+#endif
@@ -13,12 +13,14 @@
 
 #include <QMainWindow>
 #include <QCloseEvent>
+#include <QWindow>
 
 #include <QDebug>
 
 #include "Common.h"
 #include "polygonrenderer.hpp"
 #include "ImageRenderer.hpp"
+#include "logwidget.hpp"
 
 class MaskOpenGLWidget : public QOpenGLWidget, protected QOpenGLFunctions_3_3_Core
 {
@@ -37,10 +39,31 @@ public:
           imageRenderer(new ImageRenderer())
     {
         polygonRenderer->setFlipX(true); // 默认反转X轴
+
+        // 交换缓冲区即图案送到 DMD，用于统计抓取到 DMD 的延迟
+        connect(this, &QOpenGLWidget::frameSwapped, this, [this]()
+                { imageRenderer->onPresented(); });
+
+        // 连续模式下没有新帧时停止循环，由全局总线的到达通知重新触发
+        imageRenderer->setFrameArrivedCallback([this]()
+                                               { QMetaObject::invokeMethod(this, [this]()
+                                                                           { onFrameArrived(); }, Qt::QueuedConnection); });
     }
 
     ~MaskOpenGLWidget()
     {
+        if (busyFrames > 0 || idleFrames > 0)
+        {
+            lzx::FrameNotifier::Statistics stats = imageRenderer->frameStatistics();
+            Log::info(QString("Render mask: %1 busy, %2 idle, %3 deferred while hidden, %4 frames arrived, %5 notifications")
+                          .arg(busyFrames)
+                          .arg(idleFrames)
+                          .arg(hiddenFrames)
+                          .arg(stats.arrived)
+                          .arg(stats.notified));
+        }
+        imageRenderer->setFrameArrivedCallback(nullptr);
+
         makeCurrent();
         doneCurrent();
     }
@@ -266,6 +289,10 @@ protected:
     {
         qDebug() << "mask paintGL";
 
+        // 这次重绘会取走最新帧，之后到达的帧再发通知
+        imageRenderer->acknowledgeFrames();
+        frameUploaded = false;
+
         if (workMode == DMDWorkMode::Normal)
         {
             renderCommonPart();
@@ -303,13 +330,38 @@ protected:
             }
         }
 
-        // 连续模式下，需要不断更新
-        if (mode == UpdateMode::Continuous)
+        imageRenderer->markMaskEncoded();
+
+        if (frameUploaded)
+            ++busyFrames;
+        else
+            ++idleFrames;
+
+        // 连续模式下有帧流入时继续循环，信箱的等待能最快拿到下一帧；
+        // 没有新帧时停下，等到达通知再重绘
+        if (mode == UpdateMode::Continuous && frameUploaded)
         {
             update();
         }
     }
 
+private slots:
+    void onFrameArrived()
+    {
+        if (mode != UpdateMode::Continuous)
+            return;
+
+        // 隐藏或被遮挡时不确认通知，重新显示时 Qt 会补一次重绘
+        QWindow *handle = window()->windowHandle();
+        if (!isVisible() || visibleRegion().isEmpty() || (handle && !handle->isExposed()))
+        {
+            ++hiddenFrames;
+            return;
+        }
+
+        update();
+    }
+
 private:
     PolygonRenderer *polygonRenderer = nullptr;
     ImageRenderer *imageRenderer = nullptr;
@@ -329,6 +381,12 @@ private:
     QOpenGLShaderProgram *shaderProgramEncoding = nullptr; // 编码模式的着色器程序
     QOpenGLVertexArrayObject *vaoQuad = nullptr;           // 用于渲染到屏幕的四边形的VAO
 
+    // 重绘统计
+    bool frameUploaded = false; // 这次重绘上传了新帧
+    uint64_t busyFrames = 0;
+    uint64_t idleFrames = 0;
+    uint64_t hiddenFrames = 0;
+
 private:
     // 渲染公共部分 也就是不包含压缩变化的部分
     void renderCommonPart()
@@ -361,7 +419,7 @@ private:
         if (mode == UpdateMode::Continuous)
         {
             // Draw the image
-            imageRenderer->draw(globalInverse,
+            frameUploaded = imageRenderer->draw(globalInverse,
                                 transferFunction,
                                 rotateAngle * 3.1415926 / 180,
                                 QVector2D(xTranslate / 1024.f, yTranslate / 768.f),
@@ -0,0 +1,584 @@
+#include "PixelConvert.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <QString>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+#include "PixelConvertKernels.h"
+#include "logwidget.hpp"
+
+namespace lzx
+{
+    namespace pixel
+    {
+        namespace
+        {
+            // 每 3 字节两个像素：高 8 位各占一个字节，低位拼在中间字节的低半和高半
+            template <int Bits>
+            void unpackPacked(const uint8_t *src, uint16_t *dst, size_t pixels)
+            {
+                constexpr int LowBits = Bits - 8;
+                constexpr unsigned LowMask = (1u << LowBits) - 1;
+
+                size_t i = 0;
+                for (; i + 2 <= pixels; i += 2)
+                {
+                    const uint8_t *group = src + i / 2 * 3;
+                    dst[i] = static_cast<uint16_t>(group[0] << LowBits | (group[1] & LowMask));
+                    dst[i + 1] = static_cast<uint16_t>(group[2] << LowBits | ((group[1] >> 4) & LowMask));
+                }
+                if (i < pixels)
+                {
+                    const uint8_t *group = src + i / 2 * 3;
+                    dst[i] = static_cast<uint16_t>(group[0] << LowBits | (group[1] & LowMask));
+                }
+            }
+
+            void unpackMono10Packed(const uint8_t *src, uint16_t *dst, size_t pixels)
+            {
+                unpackPacked<10>(src, dst, pixels);
+            }
+
+            void unpackMono12Packed(const uint8_t *src, uint16_t *dst, size_t pixels)
+            {
+                unpackPacked<12>(src, dst, pixels);
+            }
+
+            void packMono12Packed(const uint16_t *src, uint8_t *dst, size_t pixels)
+            {
+                size_t i = 0;
+                for (; i + 2 <= pixels; i += 2)
+                {
+                    uint8_t *group = dst + i / 2 * 3;
+                    group[0] = static_cast<uint8_t>(src[i] >> 4);
+                    group[1] = static_cast<uint8_t>((src[i] & 0xF) | (src[i + 1] & 0xF) << 4);
+                    group[2] = static_cast<uint8_t>(src[i + 1] >> 4);
+                }
+                if (i < pixels)
+                {
+                    uint8_t *group = dst + i / 2 * 3;
+                    group[0] = static_cast<uint8_t>(src[i] >> 4);
+                    group[1] = static_cast<uint8_t>(src[i] & 0xF);
+                }
+            }
+
+            void mono8ToMono16(const uint8_t *src, uint16_t *dst, size_t pixels, int shift)
+            {
+                for (size_t i = 0; i < pixels; i++)
+                    dst[i] = static_cast<uint16_t>(src[i] << shift);
+            }
+
+            void mono16ToMono8(const uint16_t *src, uint8_t *dst, size_t pixels, int shift)
+            {
+                for (size_t i = 0; i < pixels; i++)
+                    dst[i] = static_cast<uint8_t>(std::min(src[i] >> shift, 255));
+            }
+
+            void mono16ToMono8Lut(const uint16_t *src, uint8_t *dst, size_t pixels, const uint8_t *lut, size_t lutSize)
+            {
+                // 查表没有合适的 SIMD 写法（gather 比标量还慢），各指令集共用这一份
+                const size_t last = lutSize - 1;
+                for (size_t i = 0; i < pixels; i++)
+                    dst[i] = lut[std::min<size_t>(src[i], last)];
+            }
+
+            void mono8ToRgba(const uint8_t *src, uint8_t *dst, size_t pixels)
+            {
+                for (size_t i = 0; i < pixels; i++)
+                {
+                    dst[i * 4 + 0] = src[i];
+                    dst[i * 4 + 1] = src[i];
+                    dst[i * 4 + 2] = src[i];
+                    dst[i * 4 + 3] = 255;
+                }
+            }
+
+            void rgbToRgba(const uint8_t *src, uint8_t *dst, size_t pixels)
+            {
+                for (size_t i = 0; i < pixels; i++)
+                {
+                    dst[i * 4 + 0] = src[i * 3 + 0];
+                    dst[i * 4 + 1] = src[i * 3 + 1];
+                    dst[i * 4 + 2] = src[i * 3 + 2];
+                    dst[i * 4 + 3] = 255;
+                }
+            }
+
+            void rgbaToRgb(const uint8_t *src, uint8_t *dst, size_t pixels)
+            {
+                for (size_t i = 0; i < pixels; i++)
+                {
+                    dst[i * 3 + 0] = src[i * 4 + 0];
+                    dst[i * 3 + 1] = src[i * 4 + 1];
+                    dst[i * 3 + 2] = src[i * 4 + 2];
+                }
+            }
+
+            void swapRedBlue24(const uint8_t *src, uint8_t *dst, size_t pixels)
+            {
+                for (size_t i = 0; i < pixels; i++)
+                {
+                    uint8_t r = src[i * 3 + 0];
+                    dst[i * 3 + 0] = src[i * 3 + 2];
+                    dst[i * 3 + 1] = src[i * 3 + 1];
+                    dst[i * 3 + 2] = r;
+                }
+            }
+
+            void swapRedBlue32(const uint8_t *src, uint8_t *dst, size_t pixels)
+            {
+                for (size_t i = 0; i < pixels; i++)
+                {
+                    uint8_t r = src[i * 4 + 0];
+                    uint8_t g = src[i * 4 + 1];
+                    uint8_t a = src[i * 4 + 3];
+                    dst[i * 4 + 0] = src[i * 4 + 2];
+                    dst[i * 4 + 1] = g;
+                    dst[i * 4 + 2] = r;
+                    dst[i * 4 + 3] = a;
+                }
+            }
+
+            template <typename T>
+            void mirrorRow(const T *src, T *dst, size_t pixels)
+            {
+                for (size_t i = 0; i < pixels; i++)
+                    dst[i] = src[pixels - 1 - i];
+            }
+
+            void mirror8(const uint8_t *src, uint8_t *dst, size_t pixels) { mirrorRow(src, dst, pixels); }
+            void mirror16(const uint16_t *src, uint16_t *dst, size_t pixels) { mirrorRow(src, dst, pixels); }
+            void mirror32(const uint32_t *src, uint32_t *dst, size_t pixels) { mirrorRow(src, dst, pixels); }
+
+            const Kernels kScalar = {
+                "scalar",
+                unpackMono10Packed,
+                unpackMono12Packed,
+                packMono12Packed,
+                mono8ToMono16,
+                mono16ToMono8,
+                mono16ToMono8Lut,
+                mono8ToRgba,
+                rgbToRgba,
+                rgbaToRgb,
+                swapRedBlue24,
+                swapRedBlue32,
+                mirror8,
+                mirror16,
+                mirror32,
+            };
+        }
+
+        const Kernels &scalarKernels()
+        {
+            return kScalar;
+        }
+    }
+
+    using pixel::Kernels;
+
+    namespace
+    {
+        struct FormatInfo
+        {
+            PixelFormat format;
+            const char *name;
+            int bitDepth;
+            bool packed;
+        };
+
+        const FormatInfo kFormats[] = {
+            {PixelFormat::Mono8, "Mono8", 8, false},
+            {PixelFormat::Mono10, "Mono10", 10, false},
+            {PixelFormat::Mono10Packed, "Mono10Packed", 10, true},
+            {PixelFormat::Mono12, "Mono12", 12, false},
+            {PixelFormat::Mono12Packed, "Mono12Packed", 12, true},
+            {PixelFormat::Mono16, "Mono16", 16, false},
+        };
+
+        const FormatInfo &info(PixelFormat format)
+        {
+            for (const auto &entry : kFormats)
+            {
+                if (entry.format == format)
+                    return entry;
+            }
+            return kFormats[0];
+        }
+
+        bool cpuHasAvx2()
+        {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+            int regs[4];
+            __cpuid(regs, 0);
+            if (regs[0] < 7)
+                return false;
+
+            // 还要确认操作系统保存了 YMM 寄存器
+            __cpuid(regs, 1);
+            bool osxsave = (regs[2] & (1 << 27)) != 0;
+            bool avx = (regs[2] & (1 << 28)) != 0;
+            if (!osxsave || !avx || (_xgetbv(0) & 6) != 6)
+                return false;
+
+            __cpuidex(regs, 7, 0);
+            return (regs[1] & (1 << 5)) != 0;
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2");
+#else
+            return false;
+#endif
+        }
+
+        const Kernels *kernelsFor(PixelConvert::SimdLevel level)
+        {
+            switch (level)
+            {
+            case PixelConvert::SimdLevel::SSE2:
+                return pixel::sse2Kernels();
+            case PixelConvert::SimdLevel::AVX2:
+                return cpuHasAvx2() ? pixel::avx2Kernels() : nullptr;
+            case PixelConvert::SimdLevel::NEON:
+                return pixel::neonKernels();
+            default:
+                return &pixel::scalarKernels();
+            }
+        }
+
+        PixelConvert::SimdLevel detectBestLevel()
+        {
+            for (auto level : {PixelConvert::SimdLevel::AVX2, PixelConvert::SimdLevel::NEON, PixelConvert::SimdLevel::SSE2})
+            {
+                if (kernelsFor(level))
+                    return level;
+            }
+            return PixelConvert::SimdLevel::Scalar;
+        }
+
+        // 用随机数据把 k 和标量参考逐个内核对比，不一致时记日志
+        bool matchesScalar(const Kernels &k)
+        {
+            const Kernels &ref = pixel::scalarKernels();
+            if (&k == &ref)
+                return true;
+
+            std::mt19937 generator(12345);
+            std::vector<unsigned char> input(4 * 1100 + 64);
+            for (auto &value : input)
+                value = static_cast<unsigned char>(generator());
+            std::vector<uint8_t> lut(4096);
+            for (size_t i = 0; i < lut.size(); i++)
+                lut[i] = static_cast<uint8_t>((i * 255 + 2047) / 4095);
+
+            // 输出缓冲区末尾留保护字节，检查越界写；输入故意不对齐
+            const size_t Guard = 64;
+            std::vector<unsigned char> expected(4 * 1100 + Guard), actual(4 * 1100 + Guard);
+            const unsigned char *src = input.data() + 1;
+            const uint16_t *src16 = reinterpret_cast<const uint16_t *>(input.data() + 2);
+
+            struct Case
+            {
+                const char *name;
+                void (*run)(const Kernels &, const unsigned char *, const uint16_t *, unsigned char *, size_t, const uint8_t *);
+            };
+            const Case cases[] = {
+                {"unpackMono10Packed", [](const Kernels &kk, const unsigned char *s, const uint16_t *, unsigned char *d, size_t n, const uint8_t *)
+                 { kk.unpackMono10Packed(s, reinterpret_cast<uint16_t *>(d), n); }},
+                {"unpackMono12Packed", [](const Kernels &kk, const unsigned char *s, const uint16_t *, unsigned char *d, size_t n, const uint8_t *)
+                 { kk.unpackMono12Packed(s, reinterpret_cast<uint16_t *>(d), n); }},
+                {"packMono12Packed", [](const Kernels &kk, const unsigned char *, const uint16_t *s, unsigned char *d, size_t n, const uint8_t *)
+                 { kk.packMono12Packed(s, d, n); }},
+                {"mono8ToMono16", [](const Kernels &kk, const unsigned char *s, const uint16_t *, unsigned char *d, size_t n, const uint8_t *)
+                 { kk.mono8ToMono16(s, reinterpret_cast<uint16_t *>(d), n, 4); }},
+                {"mono16ToMono8", [](const Kernels &kk, const unsigned char *, const uint16_t *s, unsigned char *d, size_t n, const uint8_t *)
+                 { kk.mono16ToMono8(s, d, n, 4); }},
+                {"mono16ToMono8 (no shift)", [](const Kernels &kk, const unsigned char *, const uint16_t *s, unsigned char *d, size_t n, const uint8_t *)
+                 { kk.mono16ToMono8(s, d, n, 0); }},
+                {"mono16ToMono8Lut", [](const Kernels &kk, const unsigned char *, const uint16_t *s, unsigned char *d, size_t n, const uint8_t *l)
+                 { kk.mono16ToMono8Lut(s, d, n, l, 4096); }},
+                {"mono8ToRgba", [](const Kernels &kk, const unsigned char *s, const uint16_t *, unsigned char *d, size_t n, const uint8_t *)
+                 { kk.mono8ToRgba(s, d, n); }},
+                {"rgbToRgba", [](const Kernels &kk, const unsigned char *s, const uint16_t *, unsigned char *d, size_t n, const uint8_t *)
+                 { kk.rgbToRgba(s, d, n); }},
+                {"rgbaToRgb", [](const Kernels &kk, const unsigned char *s, const uint16_t *, unsigned char *d, size_t n, const uint8_t *)
+                 { kk.rgbaToRgb(s, d, n); }},
+                {"swapRedBlue24", [](const Kernels &kk, const unsigned char *s, const uint16_t *, unsigned char *d, size_t n, const uint8_t *)
+                 { kk.swapRedBlue24(s, d, n); }},
+                {"swapRedBlue32", [](const Kernels &kk, const unsigned char *s, const uint16_t *, unsigned char *d, size_t n, const uint8_t *)
+                 { kk.swapRedBlue32(s, d, n); }},
+                {"mirror8", [](const Kernels &kk, const unsigned char *s, const uint16_t *, unsigned char *d, size_t n, const uint8_t *)
+                 { kk.mirror8(s, d, n); }},
+                {"mirror16", [](const Kernels &kk, const unsigned char *, const uint16_t *s, unsigned char *d, size_t n, const uint8_t *)
+                 { kk.mirror16(s, reinterpret_cast<uint16_t *>(d), n); }},
+                {"mirror32", [](const Kernels &kk, const unsigned char *s, const uint16_t *, unsigned char *d, size_t n, const uint8_t *)
+                 { kk.mirror32(reinterpret_cast<const uint32_t *>(s + 3), reinterpret_cast<uint32_t *>(d), n); }},
+            };
+
+            bool ok = true;
+            for (const Case &c : cases)
+            {
+                for (size_t pixels : {0, 1, 2, 3, 5, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 257, 1000})
+                {
+                    std::fill(expected.begin(), expected.end(), 0xA5);
+                    std::fill(actual.begin(), actual.end(), 0xA5);
+                    // 输出错开 4 字节，不按向量宽度对齐
+                    c.run(ref, src, src16, expected.data() + 4, pixels, lut.data());
+                    c.run(k, src, src16, actual.data() + 4, pixels, lut.data());
+                    if (expected != actual)
+                    {
+                        Log::error(QString("PixelConvert self test: %1 %2 differs from scalar at %3 pixels")
+                                       .arg(k.name)
+                                       .arg(c.name)
+                                       .arg(pixels));
+                        ok = false;
+                        break;
+                    }
+                }
+            }
+
+            return ok;
+        }
+
+        struct Active
+        {
+            std::atomic<const Kernels *> kernels;
+            std::atomic<PixelConvert::SimdLevel> level;
+        };
+
+        Active &active()
+        {
+            // 第一次用到时选择实现并与标量参考对比，SIMD 内核有错时退回标量，不会悄悄写坏每一帧
+            static Active instance = []
+            {
+                PixelConvert::SimdLevel level = detectBestLevel();
+                if (!matchesScalar(*kernelsFor(level)))
+                {
+                    Log::warn(QString("PixelConvert: %1 kernels failed self test, falling back to scalar").arg(PixelConvert::name(level)));
+                    level = PixelConvert::SimdLevel::Scalar;
+                }
+                Log::info(QString("PixelConvert kernels: %1").arg(PixelConvert::name(level)));
+                return Active{{kernelsFor(level)}, {level}};
+            }();
+            return instance;
+        }
+
+        const Kernels &kernels()
+        {
+            return *active().kernels.load(std::memory_order_relaxed);
+        }
+    }
+
+    const char *PixelConvert::name(PixelFormat format)
+    {
+        return info(format).name;
+    }
+
+    bool PixelConvert::parse(const std::string &text, PixelFormat &format)
+    {
+        for (const auto &entry : kFormats)
+        {
+            if (text == entry.name)
+            {
+                format = entry.format;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    int PixelConvert::bitDepth(PixelFormat format)
+    {
+        return info(format).bitDepth;
+    }
+
+    bool PixelConvert::isPacked(PixelFormat format)
+    {
+        return info(format).packed;
+    }
+
+    size_t PixelConvert::rowBytes(PixelFormat format, int width)
+    {
+        if (isPacked(format))
+            return (static_cast<size_t>(width) * 3 + 1) / 2;
+        return Frame::packedStride(width, 1, bitDepth(format));
+    }
+
+    void PixelConvert::unpackMono10Packed(const uint8_t *src, uint16_t *dst, size_t pixels)
+    {
+        kernels().unpackMono10Packed(src, dst, pixels);
+    }
+
+    void PixelConvert::unpackMono12Packed(const uint8_t *src, uint16_t *dst, size_t pixels)
+    {
+        kernels().unpackMono12Packed(src, dst, pixels);
+    }
+
+    void PixelConvert::packMono12Packed(const uint16_t *src, uint8_t *dst, size_t pixels)
+    {
+        kernels().packMono12Packed(src, dst, pixels);
+    }
+
+    void PixelConvert::mono8ToMono16(const uint8_t *src, uint16_t *dst, size_t pixels, int shift)
+    {
+        kernels().mono8ToMono16(src, dst, pixels, shift);
+    }
+
+    void PixelConvert::mono16ToMono8(const uint16_t *src, uint8_t *dst, size_t pixels, int shift)
+    {
+        kernels().mono16ToMono8(src, dst, pixels, shift);
+    }
+
+    void PixelConvert::mono16ToMono8(const uint16_t *src, uint8_t *dst, size_t pixels, const uint8_t *lut, size_t lutSize)
+    {
+        if (lutSize == 0)
+            return;
+        kernels().mono16ToMono8Lut(src, dst, pixels, lut, lutSize);
+    }
+
+    void PixelConvert::mono8ToRgba(const uint8_t *src, uint8_t *dst, size_t pixels)
+    {
+        kernels().mono8ToRgba(src, dst, pixels);
+    }
+
+    void PixelConvert::rgbToRgba(const uint8_t *src, uint8_t *dst, size_t pixels)
+    {
+        kernels().rgbToRgba(src, dst, pixels);
+    }
+
+    void PixelConvert::rgbaToRgb(const uint8_t *src, uint8_t *dst, size_t pixels)
+    {
+        kernels().rgbaToRgb(src, dst, pixels);
+    }
+
+    void PixelConvert::rgbToBgr(const uint8_t *src, uint8_t *dst, size_t pixels)
+    {
+        kernels().swapRedBlue24(src, dst, pixels);
+    }
+
+    void PixelConvert::rgbaToBgra(const uint8_t *src, uint8_t *dst, size_t pixels)
+    {
+        kernels().swapRedBlue32(src, dst, pixels);
+    }
+
+    void PixelConvert::mirror(const unsigned char *src, unsigned char *dst, size_t pixels, int bytesPerPixel)
+    {
+        const Kernels &k = kernels();
+        switch (bytesPerPixel)
+        {
+        case 1:
+            k.mirror8(src, dst, pixels);
+            break;
+        case 2:
+            k.mirror16(reinterpret_cast<const uint16_t *>(src), reinterpret_cast<uint16_t *>(dst), pixels);
+            break;
+        case 4:
+            k.mirror32(reinterpret_cast<const uint32_t *>(src), reinterpret_cast<uint32_t *>(dst), pixels);
+            break;
+        default:
+            // RGB 等其他像素宽度逐像素拷贝
+            for (size_t i = 0; i < pixels; i++)
+                memcpy(dst + i * bytesPerPixel, src + (pixels - 1 - i) * bytesPerPixel, bytesPerPixel);
+            break;
+        }
+    }
+
+    void PixelConvert::flipVertical(const unsigned char *src, size_t srcStride, unsigned char *dst, size_t dstStride,
+                                    size_t rowBytes, int height)
+    {
+        for (int y = 0; y < height; y++)
+        {
+            memcpy(dst + static_cast<size_t>(height - 1 - y) * dstStride, src + static_cast<size_t>(y) * srcStride, rowBytes);
+        }
+    }
+
+    bool PixelConvert::toFrame(const unsigned char *src, size_t srcBytes, PixelFormat format, Frame &dst)
+    {
+        if (dst.empty() || dst.channels() != 1 || dst.bitDepth() != bitDepth(format))
+            return false;
+
+        const int width = dst.width();
+        const int height = dst.height();
+        const size_t srcRowBytes = rowBytes(format, width);
+        if (srcBytes < srcRowBytes * height)
+            return false;
+
+        if (!isPacked(format))
+        {
+            dst.fill(src, srcRowBytes);
+            return true;
+        }
+
+        // 打包数据是连续的位流，奇数宽度时行首不在组边界上，这里不支持
+        if (width % 2 != 0)
+            return false;
+
+        const Kernels &k = kernels();
+        auto unpack = format == PixelFormat::Mono12Packed ? k.unpackMono12Packed : k.unpackMono10Packed;
+        for (int y = 0; y < height; y++)
+        {
+            unpack(src + y * srcRowBytes, reinterpret_cast<uint16_t *>(dst.buffer() + y * dst.stride()), width);
+        }
+        return true;
+    }
+
+    const char *PixelConvert::name(SimdLevel level)
+    {
+        switch (level)
+        {
+        case SimdLevel::SSE2:
+            return "SSE2";
+        case SimdLevel::AVX2:
+            return "AVX2";
+        case SimdLevel::NEON:
+            return "NEON";
+        default:
+            return "scalar";
+        }
+    }
+
+    PixelConvert::SimdLevel PixelConvert::simdLevel()
+    {
+        return active().level.load(std::memory_order_relaxed);
+    }
+
+    const char *PixelConvert::simdName()
+    {
+        return kernels().name;
+    }
+
+    PixelConvert::SimdLevel PixelConvert::bestSupportedLevel()
+    {
+        return detectBestLevel();
+    }
+
+    bool PixelConvert::setSimdLevel(SimdLevel level)
+    {
+        const Kernels *selected = kernelsFor(level);
+        if (!selected)
+            return false;
+
+        active().kernels.store(selected, std::memory_order_relaxed);
+        active().level.store(level, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool PixelConvert::selfTest()
+    {
+        bool ok = matchesScalar(kernels());
+        if (!ok)
+        {
+            setSimdLevel(SimdLevel::Scalar);
+            Log::warn("PixelConvert: falling back to scalar kernels");
+        }
+        return ok;
+    }
+}
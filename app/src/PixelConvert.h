@@ -0,0 +1,91 @@
+#ifndef PIXEL_CONVERT_H
+#define PIXEL_CONVERT_H
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+#include "Frame.h"
+
+namespace lzx
+{
+    // 相机输出的单色像素格式。10/12 位非打包格式每像素 2 字节（右对齐），
+    // 打包格式按 GigE Vision 约定每 2 个像素占 3 字节：
+    //   Mono12Packed: byte0 = p0[11:4], byte1 = p0[3:0] | p1[3:0] << 4, byte2 = p1[11:4]
+    //   Mono10Packed: byte0 = p0[9:2],  byte1 = p0[1:0] | p1[1:0] << 4, byte2 = p1[9:2]
+    enum class PixelFormat
+    {
+        Mono8,
+        Mono10,
+        Mono10Packed,
+        Mono12,
+        Mono12Packed,
+        Mono16
+    };
+
+    // 像素格式转换：相机缓冲区转帧、单色位深转换、RGB/BGR/RGBA 互转、翻转。
+    // 内层循环有标量、SSE2、AVX2、NEON 几种实现，第一次使用时按 CPU 选择最快的一种，
+    // 并与标量参考逐个内核对比，不一致时退回标量实现；选择结果记入日志。
+    class PixelConvert
+    {
+    public:
+        enum class SimdLevel
+        {
+            Scalar,
+            SSE2,
+            AVX2,
+            NEON
+        };
+
+        static const char *name(PixelFormat format);
+        static bool parse(const std::string &text, PixelFormat &format);
+
+        // 有效位数：8/10/12/16
+        static int bitDepth(PixelFormat format);
+        static bool isPacked(PixelFormat format);
+
+        // 紧密排列时一行源数据的字节数
+        static size_t rowBytes(PixelFormat format, int width);
+
+        // 单色：打包格式解包（pixels 为奇数时最后一组只取 p0）和打包（取低 12 位）
+        static void unpackMono10Packed(const uint8_t *src, uint16_t *dst, size_t pixels);
+        static void unpackMono12Packed(const uint8_t *src, uint16_t *dst, size_t pixels);
+        static void packMono12Packed(const uint16_t *src, uint8_t *dst, size_t pixels);
+
+        // 单色位深转换：8→16 左移 shift 位；16→8 右移 shift 位，超过 255 的饱和
+        static void mono8ToMono16(const uint8_t *src, uint16_t *dst, size_t pixels, int shift = 8);
+        static void mono16ToMono8(const uint16_t *src, uint8_t *dst, size_t pixels, int shift = 8);
+        // 16→8 查表：dst = lut[min(src, lutSize - 1)]，lutSize 一般为 1 << bitDepth
+        static void mono16ToMono8(const uint16_t *src, uint8_t *dst, size_t pixels, const uint8_t *lut, size_t lutSize);
+
+        // 彩色（按内存中的字节顺序命名，BGR/BGRA 用同一组函数）
+        static void mono8ToRgba(const uint8_t *src, uint8_t *dst, size_t pixels); // 灰度复制到三个通道，alpha 255
+        static void rgbToRgba(const uint8_t *src, uint8_t *dst, size_t pixels);   // 补 alpha 255
+        static void rgbaToRgb(const uint8_t *src, uint8_t *dst, size_t pixels);   // 去掉 alpha
+        static void rgbToBgr(const uint8_t *src, uint8_t *dst, size_t pixels);
+        static void rgbaToBgra(const uint8_t *src, uint8_t *dst, size_t pixels);  // 可以原地转换
+
+        // 翻转：mirror 为行内左右翻转（src 和 dst 不能重叠），flipVertical 为上下翻转整幅图
+        static void mirror(const unsigned char *src, unsigned char *dst, size_t pixels, int bytesPerPixel);
+        static void flipVertical(const unsigned char *src, size_t srcStride, unsigned char *dst, size_t dstStride,
+                                 size_t rowBytes, int height);
+
+        // 紧密排列的整帧源数据写入 dst（尺寸、位深须与 format 一致），srcBytes 不足时返回 false
+        static bool toFrame(const unsigned char *src, size_t srcBytes, PixelFormat format, Frame &dst);
+
+        static const char *name(SimdLevel level);
+
+        // 当前使用的实现
+        static SimdLevel simdLevel();
+        static const char *simdName();
+        // 当前 CPU 支持的最快实现
+        static SimdLevel bestSupportedLevel();
+        // 强制使用某种实现（测试和基准用），CPU 不支持时返回 false
+        static bool setSimdLevel(SimdLevel level);
+
+        // 用随机数据把当前实现和标量参考逐个内核对比，不一致时记日志并退回标量实现（setSimdLevel 强制选择后使用）
+        static bool selfTest();
+    };
+}
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef PIXEL_CONVERT_KERNELS_H
+#define PIXEL_CONVERT_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace lzx
+{
+    // PixelConvert 的内部接口：每种指令集一张内核表，运行时按 CPU 选一张。
+    // 所有内核都处理 pixels 个像素、src 和 dst 不重叠（swapRedBlue32 允许原地），
+    // SIMD 版本只处理整块，余下的像素交给标量版本。
+    namespace pixel
+    {
+        struct Kernels
+        {
+            const char *name;
+
+            void (*unpackMono10Packed)(const uint8_t *src, uint16_t *dst, size_t pixels);
+            void (*unpackMono12Packed)(const uint8_t *src, uint16_t *dst, size_t pixels);
+            void (*packMono12Packed)(const uint16_t *src, uint8_t *dst, size_t pixels);
+
+            void (*mono8ToMono16)(const uint8_t *src, uint16_t *dst, size_t pixels, int shift);
+            void (*mono16ToMono8)(const uint16_t *src, uint8_t *dst, size_t pixels, int shift);
+            void (*mono16ToMono8Lut)(const uint16_t *src, uint8_t *dst, size_t pixels, const uint8_t *lut, size_t lutSize);
+
+            void (*mono8ToRgba)(const uint8_t *src, uint8_t *dst, size_t pixels);
+            void (*rgbToRgba)(const uint8_t *src, uint8_t *dst, size_t pixels);
+            void (*rgbaToRgb)(const uint8_t *src, uint8_t *dst, size_t pixels);
+            void (*swapRedBlue24)(const uint8_t *src, uint8_t *dst, size_t pixels);
+            void (*swapRedBlue32)(const uint8_t *src, uint8_t *dst, size_t pixels);
+
+            void (*mirror8)(const uint8_t *src, uint8_t *dst, size_t pixels);
+            void (*mirror16)(const uint16_t *src, uint16_t *dst, size_t pixels);
+            void (*mirror32)(const uint32_t *src, uint32_t *dst, size_t pixels);
+        };
+
+        // 标量参考实现，总是可用，也是自检的基准
+        const Kernels &scalarKernels();
+
+        // 编译器或平台不支持时返回 nullptr；是否能在当前 CPU 上运行由调用方检测
+        const Kernels *sse2Kernels();
+        const Kernels *avx2Kernels();
+        const Kernels *neonKernels();
+    }
+}
+
+#endif
@@ -0,0 +1,230 @@
+#include "PixelConvertKernels.h"
+
+#if defined(__ARM_NEON) || defined(__aarch64__) || defined(_M_ARM64)
+#define PIXEL_CONVERT_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace lzx
+{
+    namespace pixel
+    {
+#ifdef PIXEL_CONVERT_NEON
+        namespace
+        {
+            const Kernels &scalar()
+            {
+                return scalarKernels();
+            }
+
+            // vld3 按字节解交错正好把每组的三个字节分到三个寄存器
+            template <int Bits>
+            void neonUnpack(const uint8_t *src, uint16_t *dst, size_t pixels)
+            {
+                constexpr int LowBits = Bits - 8;
+                const uint16x8_t lowMask = vdupq_n_u16((1 << LowBits) - 1);
+
+                // 一次 16 个像素（8 组，24 字节）
+                size_t i = 0;
+                for (; i + 16 <= pixels; i += 16)
+                {
+                    uint8x8x3_t groups = vld3_u8(src + i / 2 * 3);
+                    uint16x8_t middle = vmovl_u8(groups.val[1]);
+                    uint16x8_t p0 = vorrq_u16(vshlq_n_u16(vmovl_u8(groups.val[0]), LowBits), vandq_u16(middle, lowMask));
+                    uint16x8_t p1 = vorrq_u16(vshlq_n_u16(vmovl_u8(groups.val[2]), LowBits), vandq_u16(vshrq_n_u16(middle, 4), lowMask));
+                    uint16x8x2_t out = {{p0, p1}};
+                    vst2q_u16(dst + i, out);
+                }
+                auto tail = Bits == 12 ? scalar().unpackMono12Packed : scalar().unpackMono10Packed;
+                tail(src + i / 2 * 3, dst + i, pixels - i);
+            }
+
+            void neonUnpackMono10Packed(const uint8_t *src, uint16_t *dst, size_t pixels)
+            {
+                neonUnpack<10>(src, dst, pixels);
+            }
+
+            void neonUnpackMono12Packed(const uint8_t *src, uint16_t *dst, size_t pixels)
+            {
+                neonUnpack<12>(src, dst, pixels);
+            }
+
+            void neonPackMono12Packed(const uint16_t *src, uint8_t *dst, size_t pixels)
+            {
+                const uint16x8_t mask12 = vdupq_n_u16(0x0FFF);
+                const uint16x8_t nibble = vdupq_n_u16(0xF);
+                size_t i = 0;
+                for (; i + 16 <= pixels; i += 16)
+                {
+                    uint16x8x2_t pairs = vld2q_u16(src + i);
+                    uint16x8_t p0 = vandq_u16(pairs.val[0], mask12);
+                    uint16x8_t p1 = vandq_u16(pairs.val[1], mask12);
+                    uint8x8x3_t groups;
+                    groups.val[0] = vshrn_n_u16(p0, 4);
+                    groups.val[1] = vmovn_u16(vorrq_u16(vandq_u16(p0, nibble), vshlq_n_u16(vandq_u16(p1, nibble), 4)));
+                    groups.val[2] = vshrn_n_u16(p1, 4);
+                    vst3_u8(dst + i / 2 * 3, groups);
+                }
+                scalar().packMono12Packed(src + i, dst + i / 2 * 3, pixels - i);
+            }
+
+            void neonMono8ToMono16(const uint8_t *src, uint16_t *dst, size_t pixels, int shift)
+            {
+                const int16x8_t count = vdupq_n_s16(static_cast<int16_t>(shift));
+                size_t i = 0;
+                for (; i + 16 <= pixels; i += 16)
+                {
+                    uint8x16_t v = vld1q_u8(src + i);
+                    vst1q_u16(dst + i, vshlq_u16(vmovl_u8(vget_low_u8(v)), count));
+                    vst1q_u16(dst + i + 8, vshlq_u16(vmovl_u8(vget_high_u8(v)), count));
+                }
+                scalar().mono8ToMono16(src + i, dst + i, pixels - i, shift);
+            }
+
+            void neonMono16ToMono8(const uint16_t *src, uint8_t *dst, size_t pixels, int shift)
+            {
+                // vshl 的负移位量即右移；vqmovn 饱和到 255
+                const int16x8_t count = vdupq_n_s16(static_cast<int16_t>(-shift));
+                size_t i = 0;
+                for (; i + 16 <= pixels; i += 16)
+                {
+                    uint8x8_t lo = vqmovn_u16(vshlq_u16(vld1q_u16(src + i), count));
+                    uint8x8_t hi = vqmovn_u16(vshlq_u16(vld1q_u16(src + i + 8), count));
+                    vst1q_u8(dst + i, vcombine_u8(lo, hi));
+                }
+                scalar().mono16ToMono8(src + i, dst + i, pixels - i, shift);
+            }
+
+            void neonMono8ToRgba(const uint8_t *src, uint8_t *dst, size_t pixels)
+            {
+                size_t i = 0;
+                for (; i + 16 <= pixels; i += 16)
+                {
+                    uint8x16_t v = vld1q_u8(src + i);
+                    uint8x16x4_t out = {{v, v, v, vdupq_n_u8(255)}};
+                    vst4q_u8(dst + i * 4, out);
+                }
+                scalar().mono8ToRgba(src + i, dst + i * 4, pixels - i);
+            }
+
+            void neonRgbToRgba(const uint8_t *src, uint8_t *dst, size_t pixels)
+            {
+                size_t i = 0;
+                for (; i + 16 <= pixels; i += 16)
+                {
+                    uint8x16x3_t rgb = vld3q_u8(src + i * 3);
+                    uint8x16x4_t out = {{rgb.val[0], rgb.val[1], rgb.val[2], vdupq_n_u8(255)}};
+                    vst4q_u8(dst + i * 4, out);
+                }
+                scalar().rgbToRgba(src + i * 3, dst + i * 4, pixels - i);
+            }
+
+            void neonRgbaToRgb(const uint8_t *src, uint8_t *dst, size_t pixels)
+            {
+                size_t i = 0;
+                for (; i + 16 <= pixels; i += 16)
+                {
+                    uint8x16x4_t rgba = vld4q_u8(src + i * 4);
+                    uint8x16x3_t out = {{rgba.val[0], rgba.val[1], rgba.val[2]}};
+                    vst3q_u8(dst + i * 3, out);
+                }
+                scalar().rgbaToRgb(src + i * 4, dst + i * 3, pixels - i);
+            }
+
+            void neonSwapRedBlue24(const uint8_t *src, uint8_t *dst, size_t pixels)
+            {
+                size_t i = 0;
+                for (; i + 16 <= pixels; i += 16)
+                {
+                    uint8x16x3_t rgb = vld3q_u8(src + i * 3);
+                    uint8x16_t red = rgb.val[0];
+                    rgb.val[0] = rgb.val[2];
+                    rgb.val[2] = red;
+                    vst3q_u8(dst + i * 3, rgb);
+                }
+                scalar().swapRedBlue24(src + i * 3, dst + i * 3, pixels - i);
+            }
+
+            void neonSwapRedBlue32(const uint8_t *src, uint8_t *dst, size_t pixels)
+            {
+                size_t i = 0;
+                for (; i + 16 <= pixels; i += 16)
+                {
+                    uint8x16x4_t rgba = vld4q_u8(src + i * 4);
+                    uint8x16_t red = rgba.val[0];
+                    rgba.val[0] = rgba.val[2];
+                    rgba.val[2] = red;
+                    vst4q_u8(dst + i * 4, rgba);
+                }
+                scalar().swapRedBlue32(src + i * 4, dst + i * 4, pixels - i);
+            }
+
+            // 镜像：vrev64 反转 64 位内的元素，再交换高低两半
+            void neonMirror8(const uint8_t *src, uint8_t *dst, size_t pixels)
+            {
+                size_t i = 0;
+                for (; i + 16 <= pixels; i += 16)
+                {
+                    uint8x16_t v = vrev64q_u8(vld1q_u8(src + pixels - i - 16));
+                    vst1q_u8(dst + i, vcombine_u8(vget_high_u8(v), vget_low_u8(v)));
+                }
+                scalar().mirror8(src, dst + i, pixels - i);
+            }
+
+            void neonMirror16(const uint16_t *src, uint16_t *dst, size_t pixels)
+            {
+                size_t i = 0;
+                for (; i + 8 <= pixels; i += 8)
+                {
+                    uint16x8_t v = vrev64q_u16(vld1q_u16(src + pixels - i - 8));
+                    vst1q_u16(dst + i, vcombine_u16(vget_high_u16(v), vget_low_u16(v)));
+                }
+                scalar().mirror16(src, dst + i, pixels - i);
+            }
+
+            void neonMirror32(const uint32_t *src, uint32_t *dst, size_t pixels)
+            {
+                size_t i = 0;
+                for (; i + 4 <= pixels; i += 4)
+                {
+                    uint32x4_t v = vrev64q_u32(vld1q_u32(src + pixels - i - 4));
+                    vst1q_u32(dst + i, vcombine_u32(vget_high_u32(v), vget_low_u32(v)));
+                }
+                scalar().mirror32(src, dst + i, pixels - i);
+            }
+
+            Kernels makeNeonKernels()
+            {
+                Kernels table = {
+                    "NEON",
+                    neonUnpackMono10Packed,
+                    neonUnpackMono12Packed,
+                    neonPackMono12Packed,
+                    neonMono8ToMono16,
+                    neonMono16ToMono8,
+                    scalar().mono16ToMono8Lut, // 查表沿用标量
+                    neonMono8ToRgba,
+                    neonRgbToRgba,
+                    neonRgbaToRgb,
+                    neonSwapRedBlue24,
+                    neonSwapRedBlue32,
+                    neonMirror8,
+                    neonMirror16,
+                    neonMirror32,
+                };
+                return table;
+            }
+        }
+#endif
+
+        const Kernels *neonKernels()
+        {
+#ifdef PIXEL_CONVERT_NEON
+            static const Kernels table = makeNeonKernels();
+            return &table;
+#else
+            return nullptr;
+#endif
+        }
+    }
+}
@@ -0,0 +1,539 @@
+#include "PixelConvertKernels.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PIXEL_CONVERT_SSE2 1
+#include <immintrin.h>
+#endif
+
+// AVX2 内核只在运行时检测到 CPU 支持时才调用，整个文件不需要 /arch:AVX2 或 -mavx2；
+// GCC/Clang 用 target 属性单独为这些函数打开 AVX2
+#if defined(PIXEL_CONVERT_SSE2) && (defined(_MSC_VER) || defined(__GNUC__) || defined(__clang__))
+#define PIXEL_CONVERT_AVX2 1
+#if defined(__GNUC__) || defined(__clang__)
+#define AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define AVX2_TARGET
+#endif
+#endif
+
+namespace lzx
+{
+    namespace pixel
+    {
+#ifdef PIXEL_CONVERT_SSE2
+        namespace
+        {
+            const Kernels &scalar()
+            {
+                return scalarKernels();
+            }
+
+            // 4 个 3 字节组（共 12 字节）分别移到 4 个 32 位通道的低 3 字节
+            inline __m128i spreadGroups(__m128i v)
+            {
+                const __m128i lane0 = _mm_setr_epi32(0x00FFFFFF, 0, 0, 0);
+                const __m128i lane1 = _mm_setr_epi32(0, 0x00FFFFFF, 0, 0);
+                const __m128i lane2 = _mm_setr_epi32(0, 0, 0x00FFFFFF, 0);
+                const __m128i lane3 = _mm_setr_epi32(0, 0, 0, 0x00FFFFFF);
+                return _mm_or_si128(
+                    _mm_or_si128(_mm_and_si128(v, lane0), _mm_and_si128(_mm_slli_si128(v, 1), lane1)),
+                    _mm_or_si128(_mm_and_si128(_mm_slli_si128(v, 2), lane2), _mm_and_si128(_mm_slli_si128(v, 3), lane3)));
+            }
+
+            // spreadGroups 的逆操作：4 个通道的低 3 字节紧凑到前 12 字节，后 4 字节为 0
+            inline __m128i compactGroups(__m128i v)
+            {
+                const __m128i bytes0 = _mm_setr_epi8(-1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+                const __m128i bytes1 = _mm_setr_epi8(0, 0, 0, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+                const __m128i bytes2 = _mm_setr_epi8(0, 0, 0, 0, 0, 0, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0);
+                const __m128i bytes3 = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 0, -1, -1, -1, 0, 0, 0, 0);
+                return _mm_or_si128(
+                    _mm_or_si128(_mm_and_si128(v, bytes0), _mm_and_si128(_mm_srli_si128(v, 1), bytes1)),
+                    _mm_or_si128(_mm_and_si128(_mm_srli_si128(v, 2), bytes2), _mm_and_si128(_mm_srli_si128(v, 3), bytes3)));
+            }
+
+            inline void store12(uint8_t *dst, __m128i v)
+            {
+                _mm_storel_epi64(reinterpret_cast<__m128i *>(dst), v);
+                uint32_t last = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(v, 8)));
+                memcpy(dst + 8, &last, 4);
+            }
+
+            // 一次 8 个像素（12 字节）：在 32 位通道内算出 p0、p1，p0 | p1 << 16 正好是小端的两个相邻 uint16
+            template <int Bits>
+            void sse2Unpack(const uint8_t *src, uint16_t *dst, size_t pixels)
+            {
+                constexpr int LowBits = Bits - 8;
+                const __m128i byteMask = _mm_set1_epi32(0xFF);
+                const __m128i lowMask = _mm_set1_epi32((1 << LowBits) - 1);
+                const size_t srcBytes = (pixels * 3 + 1) / 2;
+
+                // 每次读 16 字节，只用前 12 字节，最后不足 16 字节的部分交给标量
+                size_t i = 0;
+                for (; i + 8 <= pixels && i / 2 * 3 + 16 <= srcBytes; i += 8)
+                {
+                    __m128i groups = spreadGroups(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i / 2 * 3)));
+                    __m128i p0 = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(groups, byteMask), LowBits),
+                                              _mm_and_si128(_mm_srli_epi32(groups, 8), lowMask));
+                    __m128i p1 = _mm_or_si128(_mm_slli_epi32(_mm_srli_epi32(groups, 16), LowBits),
+                                              _mm_and_si128(_mm_srli_epi32(groups, 12), lowMask));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_or_si128(p0, _mm_slli_epi32(p1, 16)));
+                }
+                auto tail = Bits == 12 ? scalar().unpackMono12Packed : scalar().unpackMono10Packed;
+                tail(src + i / 2 * 3, dst + i, pixels - i);
+            }
+
+            void sse2UnpackMono10Packed(const uint8_t *src, uint16_t *dst, size_t pixels)
+            {
+                sse2Unpack<10>(src, dst, pixels);
+            }
+
+            void sse2UnpackMono12Packed(const uint8_t *src, uint16_t *dst, size_t pixels)
+            {
+                sse2Unpack<12>(src, dst, pixels);
+            }
+
+            // 每个 32 位通道拼出一组 3 字节，再紧凑成 12 字节
+            inline __m128i packGroups(__m128i v)
+            {
+                const __m128i mask12 = _mm_set1_epi32(0x0FFF);
+                const __m128i nibble = _mm_set1_epi32(0xF);
+                __m128i p0 = _mm_and_si128(v, mask12);
+                __m128i p1 = _mm_and_si128(_mm_srli_epi32(v, 16), mask12);
+                __m128i middle = _mm_or_si128(_mm_and_si128(p0, nibble), _mm_slli_epi32(_mm_and_si128(p1, nibble), 4));
+                return _mm_or_si128(_mm_or_si128(_mm_srli_epi32(p0, 4), _mm_slli_epi32(middle, 8)),
+                                    _mm_slli_epi32(_mm_srli_epi32(p1, 4), 16));
+            }
+
+            void sse2PackMono12Packed(const uint16_t *src, uint8_t *dst, size_t pixels)
+            {
+                size_t i = 0;
+                for (; i + 8 <= pixels; i += 8)
+                {
+                    __m128i groups = packGroups(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)));
+                    store12(dst + i / 2 * 3, compactGroups(groups));
+                }
+                scalar().packMono12Packed(src + i, dst + i / 2 * 3, pixels - i);
+            }
+
+            void sse2Mono8ToMono16(const uint8_t *src, uint16_t *dst, size_t pixels, int shift)
+            {
+                const __m128i zero = _mm_setzero_si128();
+                const __m128i count = _mm_cvtsi32_si128(shift);
+                size_t i = 0;
+                for (; i + 16 <= pixels; i += 16)
+                {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_sll_epi16(_mm_unpacklo_epi8(v, zero), count));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 8), _mm_sll_epi16(_mm_unpackhi_epi8(v, zero), count));
+                }
+                scalar().mono8ToMono16(src + i, dst + i, pixels - i, shift);
+            }
+
+            void sse2Mono16ToMono8(const uint16_t *src, uint8_t *dst, size_t pixels, int shift)
+            {
+                // SSE2 没有无符号 16 位 min，用 x - subs(x, 255) 饱和到 255，packus 再按有符号数处理也不会出错
+                const __m128i max8 = _mm_set1_epi16(255);
+                const __m128i count = _mm_cvtsi32_si128(shift);
+                size_t i = 0;
+                for (; i + 16 <= pixels; i += 16)
+                {
+                    __m128i a = _mm_srl_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)), count);
+                    __m128i b = _mm_srl_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i + 8)), count);
+                    a = _mm_sub_epi16(a, _mm_subs_epu16(a, max8));
+                    b = _mm_sub_epi16(b, _mm_subs_epu16(b, max8));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packus_epi16(a, b));
+                }
+                scalar().mono16ToMono8(src + i, dst + i, pixels - i, shift);
+            }
+
+            void sse2Mono8ToRgba(const uint8_t *src, uint8_t *dst, size_t pixels)
+            {
+                const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+                size_t i = 0;
+                for (; i + 16 <= pixels; i += 16)
+                {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+                    __m128i lo = _mm_unpacklo_epi8(v, v);
+                    __m128i hi = _mm_unpackhi_epi8(v, v);
+                    __m128i *out = reinterpret_cast<__m128i *>(dst + i * 4);
+                    _mm_storeu_si128(out + 0, _mm_or_si128(_mm_unpacklo_epi16(lo, lo), alpha));
+                    _mm_storeu_si128(out + 1, _mm_or_si128(_mm_unpackhi_epi16(lo, lo), alpha));
+                    _mm_storeu_si128(out + 2, _mm_or_si128(_mm_unpacklo_epi16(hi, hi), alpha));
+                    _mm_storeu_si128(out + 3, _mm_or_si128(_mm_unpackhi_epi16(hi, hi), alpha));
+                }
+                scalar().mono8ToRgba(src + i, dst + i * 4, pixels - i);
+            }
+
+            void sse2RgbToRgba(const uint8_t *src, uint8_t *dst, size_t pixels)
+            {
+                const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+                size_t i = 0;
+                // 每次读 16 字节只用 12 字节
+                for (; (i + 4) * 3 + 4 <= pixels * 3; i += 4)
+                {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 3));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4), _mm_or_si128(spreadGroups(v), alpha));
+                }
+                scalar().rgbToRgba(src + i * 3, dst + i * 4, pixels - i);
+            }
+
+            void sse2RgbaToRgb(const uint8_t *src, uint8_t *dst, size_t pixels)
+            {
+                size_t i = 0;
+                for (; i + 4 <= pixels; i += 4)
+                {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 4));
+                    store12(dst + i * 3, compactGroups(v));
+                }
+                scalar().rgbaToRgb(src + i * 4, dst + i * 3, pixels - i);
+            }
+
+            void sse2SwapRedBlue32(const uint8_t *src, uint8_t *dst, size_t pixels)
+            {
+                const __m128i keep = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+                const __m128i byteMask = _mm_set1_epi32(0xFF);
+                size_t i = 0;
+                for (; i + 4 <= pixels; i += 4)
+                {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 4));
+                    __m128i red = _mm_slli_epi32(_mm_and_si128(v, byteMask), 16);
+                    __m128i blue = _mm_and_si128(_mm_srli_epi32(v, 16), byteMask);
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 4),
+                                     _mm_or_si128(_mm_and_si128(v, keep), _mm_or_si128(red, blue)));
+                }
+                scalar().swapRedBlue32(src + i * 4, dst + i * 4, pixels - i);
+            }
+
+            // 镜像：dst 从头往后写，src 从尾往前读，每块在寄存器内反转；
+            // 剩下的中间部分正好是 src[0, n - i) 镜像到 dst + i
+            inline __m128i reverse16(__m128i v)
+            {
+                v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+                v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+                return _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+            }
+
+            void sse2Mirror8(const uint8_t *src, uint8_t *dst, size_t pixels)
+            {
+                size_t i = 0;
+                for (; i + 16 <= pixels; i += 16)
+                {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + pixels - i - 16));
+                    v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), reverse16(v));
+                }
+                scalar().mirror8(src, dst + i, pixels - i);
+            }
+
+            void sse2Mirror16(const uint16_t *src, uint16_t *dst, size_t pixels)
+            {
+                size_t i = 0;
+                for (; i + 8 <= pixels; i += 8)
+                {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + pixels - i - 8));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), reverse16(v));
+                }
+                scalar().mirror16(src, dst + i, pixels - i);
+            }
+
+            void sse2Mirror32(const uint32_t *src, uint32_t *dst, size_t pixels)
+            {
+                size_t i = 0;
+                for (; i + 4 <= pixels; i += 4)
+                {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + pixels - i - 4));
+                    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3)));
+                }
+                scalar().mirror32(src, dst + i, pixels - i);
+            }
+
+            // 查表和 24 位 RGB 交换没有 pshufb 时做不快，沿用标量
+            const Kernels kSse2 = {
+                "SSE2",
+                sse2UnpackMono10Packed,
+                sse2UnpackMono12Packed,
+                sse2PackMono12Packed,
+                sse2Mono8ToMono16,
+                sse2Mono16ToMono8,
+                nullptr,
+                sse2Mono8ToRgba,
+                sse2RgbToRgba,
+                sse2RgbaToRgb,
+                nullptr,
+                sse2SwapRedBlue32,
+                sse2Mirror8,
+                sse2Mirror16,
+                sse2Mirror32,
+            };
+
+#ifdef PIXEL_CONVERT_AVX2
+            // 两个 128 位通道各装 12 字节有效数据：src 和 src + 12 各读 16 字节，要求 src + 28 以内可读
+            AVX2_TARGET inline __m256i load2x12(const uint8_t *src)
+            {
+                __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src));
+                __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + 12));
+                return _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+            }
+
+            // 与 load2x12 对应：写 dst 和 dst + 12 各 16 字节，要求 dst + 28 以内可写，
+            // 多写的 4 字节由下一块或标量尾部覆盖
+            AVX2_TARGET inline void store2x12(uint8_t *dst, __m256i v)
+            {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm256_castsi256_si128(v));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 12), _mm256_extracti128_si256(v, 1));
+            }
+
+            AVX2_TARGET inline __m256i spreadMask()
+            {
+                return _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+                                        0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+            }
+
+            AVX2_TARGET inline __m256i compactMask()
+            {
+                return _mm256_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+                                        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+            }
+
+            template <int Bits>
+            AVX2_TARGET void avx2Unpack(const uint8_t *src, uint16_t *dst, size_t pixels)
+            {
+                constexpr int LowBits = Bits - 8;
+                const __m256i byteMask = _mm256_set1_epi32(0xFF);
+                const __m256i lowMask = _mm256_set1_epi32((1 << LowBits) - 1);
+                const __m256i spread = spreadMask();
+                const size_t srcBytes = (pixels * 3 + 1) / 2;
+
+                // 一次 16 个像素（24 字节）
+                size_t i = 0;
+                for (; i + 16 <= pixels && i / 2 * 3 + 28 <= srcBytes; i += 16)
+                {
+                    __m256i groups = _mm256_shuffle_epi8(load2x12(src + i / 2 * 3), spread);
+                    __m256i p0 = _mm256_or_si256(_mm256_slli_epi32(_mm256_and_si256(groups, byteMask), LowBits),
+                                                 _mm256_and_si256(_mm256_srli_epi32(groups, 8), lowMask));
+                    __m256i p1 = _mm256_or_si256(_mm256_slli_epi32(_mm256_srli_epi32(groups, 16), LowBits),
+                                                 _mm256_and_si256(_mm256_srli_epi32(groups, 12), lowMask));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_or_si256(p0, _mm256_slli_epi32(p1, 16)));
+                }
+                auto tail = Bits == 12 ? sse2UnpackMono12Packed : sse2UnpackMono10Packed;
+                tail(src + i / 2 * 3, dst + i, pixels - i);
+            }
+
+            AVX2_TARGET void avx2UnpackMono10Packed(const uint8_t *src, uint16_t *dst, size_t pixels)
+            {
+                avx2Unpack<10>(src, dst, pixels);
+            }
+
+            AVX2_TARGET void avx2UnpackMono12Packed(const uint8_t *src, uint16_t *dst, size_t pixels)
+            {
+                avx2Unpack<12>(src, dst, pixels);
+            }
+
+            AVX2_TARGET void avx2PackMono12Packed(const uint16_t *src, uint8_t *dst, size_t pixels)
+            {
+                const __m256i mask12 = _mm256_set1_epi32(0x0FFF);
+                const __m256i nibble = _mm256_set1_epi32(0xF);
+                const __m256i compact = compactMask();
+                const size_t dstBytes = (pixels * 3 + 1) / 2;
+
+                size_t i = 0;
+                for (; i + 16 <= pixels && i / 2 * 3 + 28 <= dstBytes; i += 16)
+                {
+                    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+                    __m256i p0 = _mm256_and_si256(v, mask12);
+                    __m256i p1 = _mm256_and_si256(_mm256_srli_epi32(v, 16), mask12);
+                    __m256i middle = _mm256_or_si256(_mm256_and_si256(p0, nibble), _mm256_slli_epi32(_mm256_and_si256(p1, nibble), 4));
+                    __m256i groups = _mm256_or_si256(_mm256_or_si256(_mm256_srli_epi32(p0, 4), _mm256_slli_epi32(middle, 8)),
+                                                     _mm256_slli_epi32(_mm256_srli_epi32(p1, 4), 16));
+                    store2x12(dst + i / 2 * 3, _mm256_shuffle_epi8(groups, compact));
+                }
+                sse2PackMono12Packed(src + i, dst + i / 2 * 3, pixels - i);
+            }
+
+            AVX2_TARGET void avx2Mono8ToMono16(const uint8_t *src, uint16_t *dst, size_t pixels, int shift)
+            {
+                const __m128i count = _mm_cvtsi32_si128(shift);
+                size_t i = 0;
+                for (; i + 16 <= pixels; i += 16)
+                {
+                    __m256i v = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i)));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_sll_epi16(v, count));
+                }
+                scalar().mono8ToMono16(src + i, dst + i, pixels - i, shift);
+            }
+
+            AVX2_TARGET void avx2Mono16ToMono8(const uint16_t *src, uint8_t *dst, size_t pixels, int shift)
+            {
+                const __m256i max8 = _mm256_set1_epi16(255);
+                const __m128i count = _mm_cvtsi32_si128(shift);
+                size_t i = 0;
+                for (; i + 32 <= pixels; i += 32)
+                {
+                    __m256i a = _mm256_srl_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i)), count);
+                    __m256i b = _mm256_srl_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i + 16)), count);
+                    // packus 按 128 位通道交错，permute 把顺序理回来
+                    __m256i packed = _mm256_packus_epi16(_mm256_min_epu16(a, max8), _mm256_min_epu16(b, max8));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_permute4x64_epi64(packed, _MM_SHUFFLE(3, 1, 2, 0)));
+                }
+                sse2Mono16ToMono8(src + i, dst + i, pixels - i, shift);
+            }
+
+            AVX2_TARGET void avx2Mono8ToRgba(const uint8_t *src, uint8_t *dst, size_t pixels)
+            {
+                const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+                size_t i = 0;
+                for (; i + 8 <= pixels; i += 8)
+                {
+                    __m256i v = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(src + i)));
+                    v = _mm256_or_si256(_mm256_or_si256(v, _mm256_slli_epi32(v, 8)), _mm256_or_si256(_mm256_slli_epi32(v, 16), alpha));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i * 4), v);
+                }
+                scalar().mono8ToRgba(src + i, dst + i * 4, pixels - i);
+            }
+
+            AVX2_TARGET void avx2RgbToRgba(const uint8_t *src, uint8_t *dst, size_t pixels)
+            {
+                const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+                const __m256i spread = spreadMask();
+                size_t i = 0;
+                for (; (i + 8) * 3 + 4 <= pixels * 3; i += 8)
+                {
+                    __m256i v = _mm256_shuffle_epi8(load2x12(src + i * 3), spread);
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i * 4), _mm256_or_si256(v, alpha));
+                }
+                scalar().rgbToRgba(src + i * 3, dst + i * 4, pixels - i);
+            }
+
+            AVX2_TARGET void avx2RgbaToRgb(const uint8_t *src, uint8_t *dst, size_t pixels)
+            {
+                const __m256i compact = compactMask();
+                size_t i = 0;
+                for (; (i + 8) * 3 + 4 <= pixels * 3; i += 8)
+                {
+                    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i * 4));
+                    store2x12(dst + i * 3, _mm256_shuffle_epi8(v, compact));
+                }
+                sse2RgbaToRgb(src + i * 4, dst + i * 3, pixels - i);
+            }
+
+            AVX2_TARGET void avx2SwapRedBlue24(const uint8_t *src, uint8_t *dst, size_t pixels)
+            {
+                const __m256i swap = _mm256_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 12, 13, 14, 15,
+                                                      2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 12, 13, 14, 15);
+                size_t i = 0;
+                for (; (i + 8) * 3 + 4 <= pixels * 3; i += 8)
+                {
+                    store2x12(dst + i * 3, _mm256_shuffle_epi8(load2x12(src + i * 3), swap));
+                }
+                scalar().swapRedBlue24(src + i * 3, dst + i * 3, pixels - i);
+            }
+
+            AVX2_TARGET void avx2SwapRedBlue32(const uint8_t *src, uint8_t *dst, size_t pixels)
+            {
+                const __m256i swap = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                                      2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+                size_t i = 0;
+                for (; i + 8 <= pixels; i += 8)
+                {
+                    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i * 4));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i * 4), _mm256_shuffle_epi8(v, swap));
+                }
+                scalar().swapRedBlue32(src + i * 4, dst + i * 4, pixels - i);
+            }
+
+            AVX2_TARGET void avx2Mirror8(const uint8_t *src, uint8_t *dst, size_t pixels)
+            {
+                const __m256i reverse = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                                         15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+                size_t i = 0;
+                for (; i + 32 <= pixels; i += 32)
+                {
+                    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + pixels - i - 32));
+                    v = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(v, reverse), _MM_SHUFFLE(1, 0, 3, 2));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), v);
+                }
+                scalar().mirror8(src, dst + i, pixels - i);
+            }
+
+            AVX2_TARGET void avx2Mirror16(const uint16_t *src, uint16_t *dst, size_t pixels)
+            {
+                const __m256i reverse = _mm256_setr_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1,
+                                                         14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+                size_t i = 0;
+                for (; i + 16 <= pixels; i += 16)
+                {
+                    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + pixels - i - 16));
+                    v = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(v, reverse), _MM_SHUFFLE(1, 0, 3, 2));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), v);
+                }
+                scalar().mirror16(src, dst + i, pixels - i);
+            }
+
+            AVX2_TARGET void avx2Mirror32(const uint32_t *src, uint32_t *dst, size_t pixels)
+            {
+                const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+                size_t i = 0;
+                for (; i + 8 <= pixels; i += 8)
+                {
+                    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + pixels - i - 8));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_permutevar8x32_epi32(v, reverse));
+                }
+                scalar().mirror32(src, dst + i, pixels - i);
+            }
+
+            const Kernels kAvx2 = {
+                "AVX2",
+                avx2UnpackMono10Packed,
+                avx2UnpackMono12Packed,
+                avx2PackMono12Packed,
+                avx2Mono8ToMono16,
+                avx2Mono16ToMono8,
+                nullptr,
+                avx2Mono8ToRgba,
+                avx2RgbToRgba,
+                avx2RgbaToRgb,
+                avx2SwapRedBlue24,
+                avx2SwapRedBlue32,
+                avx2Mirror8,
+                avx2Mirror16,
+                avx2Mirror32,
+            };
+#endif
+
+            // 表里留空的项用标量实现补上（标量表在另一个翻译单元，不能在静态初始化时取）
+            Kernels withScalarFallback(Kernels table)
+            {
+                const Kernels &ref = scalarKernels();
+                if (!table.mono16ToMono8Lut)
+                    table.mono16ToMono8Lut = ref.mono16ToMono8Lut;
+                if (!table.swapRedBlue24)
+                    table.swapRedBlue24 = ref.swapRedBlue24;
+                return table;
+            }
+        }
+#endif
+
+        const Kernels *sse2Kernels()
+        {
+#ifdef PIXEL_CONVERT_SSE2
+            static const Kernels table = withScalarFallback(kSse2);
+            return &table;
+#else
+            return nullptr;
+#endif
+        }
+
+        const Kernels *avx2Kernels()
+        {
+#ifdef PIXEL_CONVERT_AVX2
+            static const Kernels table = withScalarFallback(kAvx2);
+            return &table;
+#else
+            return nullptr;
+#endif
+        }
+    }
+}
@@ -2,9 +2,22 @@
 
 #include <PlayerOneCamera.h>
 
+#include <algorithm>
+
 #include "logwidget.hpp"
 
+#include "CameraProperty.h"
+#include "Demosaic.h"
 #include "Frame.h"
+#include "FramePool.h"
+#include "LatencyStats.h"
+#include "ThreadPool.h"
+#include "WaitStrategy.h"
+
+// 帧池容量：总线槽位占用4帧，消费者各持有1帧，采集线程写入1帧；
+// 挂接录像、帧配对队列后按 FrameBus::retainedFrames() 加上余量扩容
+static constexpr size_t kFramePoolCapacity = 8;
+static constexpr size_t kFramePoolHeadroom = 2;
 
 std::map<int, std::string> PlayerOne::getALLCameraIDName()
 {
@@ -37,20 +50,42 @@ struct PlayerOne::Impl
     std::string label;
     int cameraId = -1;
     void *handle = nullptr;
-    bool streaming = false;
+    std::atomic<bool> streaming{false}; // GUI线程写，采集线程读
     std::unique_ptr<std::thread> grabThread;
-    double exposureTime = 0.0; // us
+    std::atomic<double> exposureTime{0.0}; // us，GUI线程写，采集线程读
+    std::atomic<double> gain{0.0};
     int width;
     int height;
     int channels;
     int bitDepth;
-    std::unique_ptr<lzx::TripleBuffer<lzx::Frame>> tripleBuffer;
+    std::unique_ptr<lzx::FrameBus> frameBus;
+    std::unique_ptr<lzx::FrameBus::Subscription> subscription; // 显示窗口的订阅
+    std::shared_ptr<lzx::FramePool> framePool;
+
+    // 彩色相机：SDK 把 Bayer 原始数据写入 rawBuffer，采集线程插值成 RGB 帧后再发布
+    bool isColor = false;
+    lzx::Demosaic::Pattern bayerPattern = lzx::Demosaic::Pattern::RGGB;
+    std::atomic<lzx::Demosaic::Method> demosaicMethod{lzx::Demosaic::Method::Bilinear}; // GUI线程写，采集线程读
+    std::vector<unsigned char> rawBuffer;
+    std::unique_ptr<lzx::ThreadPool> demosaicPool;
+    std::unique_ptr<lzx::Demosaic> demosaic;
+
+    // 等待图像就绪的策略，默认按曝光时间预测睡眠
+    lzx::WaitStrategy waitStrategy{lzx::WaitStrategy::Kind::PredictiveSleep};
+    lzx::LatencyHistogram *readyToFetch = lzx::LatencyTracker::getInstance().histogram("playerone ready-to-fetch"); // 就绪到开始取数据，只反映等待策略
+    lzx::LatencyHistogram *transfer = lzx::LatencyTracker::getInstance().histogram("playerone transfer");             // POAGetImageData 的 USB 传输
+
+    // SDK 不带逐帧信息，只能按应用参数的时间判断新参数从哪一帧开始生效
+    lzx::PropertyRegistry *properties = nullptr; // 指向 ICamera::propertyRegistry
+    lzx::ParameterEpoch parameterEpoch{lzx::ParameterEpoch::Confirm::Timing};
+    lzx::ParameterQueue parameterQueue; // 取流时提交的参数，由采集线程在两帧之间应用
 
     // ctor
-    Impl() : tripleBuffer(std::make_unique<lzx::TripleBuffer<lzx::Frame>>()),
+    Impl() : frameBus(std::make_unique<lzx::FrameBus>()),
              channels(1),
              bitDepth(16)
     {
+        subscription = frameBus->subscribe("imaging view");
     }
 
     // dtor
@@ -59,28 +94,167 @@ struct PlayerOne::Impl
         // TODO
     }
 
+    // 按当前尺寸分配帧池，彩色相机还要分配 Bayer 原始数据的缓冲区
+    // POAGetImageData 要求整块紧密排列的缓冲区，这里不加行填充；大画幅时尝试使用大页内存
+    void allocateBuffers()
+    {
+        size_t frameBytes = lzx::FramePool::frameBytes(width, height, channels, bitDepth);
+        framePool = lzx::FramePool::create(poolCapacity(), frameBytes,
+                                           frameBytes >= lzx::FramePool::HugePageThreshold);
+        if (isColor)
+        {
+            rawBuffer.resize(lzx::Frame::packedStride(width, 1, bitDepth) * height);
+        }
+    }
+
+    size_t poolCapacity() const
+    {
+        return std::max(kFramePoolCapacity, frameBus->retainedFrames() + kFramePoolHeadroom);
+    }
+
+    bool writeConfig(POAConfig config, lzx::PropertyId id, double value)
+    {
+        POAConfigValue configValue;
+        configValue.intValue = static_cast<long>(value);
+        POAErrors error = POASetConfig(cameraId, config, configValue, POA_FALSE);
+        if (error != POA_OK)
+        {
+            Log::error(QString("POASetConfig %1 failed with error code %2").arg(lzx::PropertyRegistry::name(id)).arg(error));
+            return false;
+        }
+        properties->update(id, value);
+        return true;
+    }
+
+    // 写入一组已经限制过范围的参数；在采集线程（取流时）或停止取流时调用
+    // 修改 ROI 需要停止曝光，之后按新尺寸重新分配缓冲区
+    bool applyParameters(const lzx::ParameterTransaction &transaction, uint64_t epoch)
+    {
+        bool ok = true;
+        const double previousExposure = exposureTime;
+        if (transaction.has(lzx::PropertyId::ExposureTime) &&
+            writeConfig(POA_EXPOSURE, lzx::PropertyId::ExposureTime, transaction.value(lzx::PropertyId::ExposureTime)))
+        {
+            exposureTime = transaction.value(lzx::PropertyId::ExposureTime);
+        }
+        else if (transaction.has(lzx::PropertyId::ExposureTime))
+        {
+            ok = false;
+        }
+
+        if (transaction.has(lzx::PropertyId::Gain) &&
+            writeConfig(POA_GAIN, lzx::PropertyId::Gain, transaction.value(lzx::PropertyId::Gain)))
+        {
+            gain = transaction.value(lzx::PropertyId::Gain);
+        }
+        else if (transaction.has(lzx::PropertyId::Gain))
+        {
+            ok = false;
+        }
+
+        if (transaction.changesGeometry())
+        {
+            if (streaming)
+            {
+                POAStopExposure(cameraId);
+            }
+
+            // 先缩小尺寸再移动起点，SDK 会拒绝超出传感器的起点
+            int newWidth = static_cast<int>(transaction.value(lzx::PropertyId::Width));
+            int newHeight = static_cast<int>(transaction.value(lzx::PropertyId::Height));
+            int startX = static_cast<int>(transaction.value(lzx::PropertyId::OffsetX));
+            int startY = static_cast<int>(transaction.value(lzx::PropertyId::OffsetY));
+            POAErrors error = POASetImageSize(cameraId, newWidth, newHeight);
+            if (error == POA_OK)
+            {
+                error = POASetImageStartPos(cameraId, startX, startY);
+            }
+            if (error != POA_OK)
+            {
+                Log::error(QString("Set PlayerOne ROI failed with error code %1").arg(error));
+                ok = false;
+            }
+
+            // 读回实际生效的 ROI
+            POAGetImageSize(cameraId, &width, &height);
+            POAGetImageStartPos(cameraId, &startX, &startY);
+            properties->update(lzx::PropertyId::Width, width);
+            properties->update(lzx::PropertyId::Height, height);
+            properties->update(lzx::PropertyId::OffsetX, startX);
+            properties->update(lzx::PropertyId::OffsetY, startY);
+
+            if (streaming)
+            {
+                allocateBuffers();
+                if (POAStartExposure(cameraId, POA_FALSE) != POA_OK)
+                {
+                    Log::error("Restart exposure after ROI change failed");
+                    ok = false;
+                }
+            }
+        }
+
+        // 写入失败时不切换编号，之后的帧仍带旧编号
+        if (ok)
+        {
+            parameterEpoch.applied(epoch, transaction, lzx::FrameMetadata::now(), previousExposure);
+        }
+        return ok;
+    }
+
     void grabFunction()
     {
-        size_t frameCount = 0;
+        long lastDropped = 0;
+        POAGetDroppedImagesCount(cameraId, &lastDropped);
+        uint64_t deviceFrame = 0;
+
+        waitStrategy.reset();
+
         while (streaming)
         {
-            POABool pIsReady = POA_FALSE;
+            // 两帧之间应用界面提交的参数
+            lzx::ParameterTransaction pending;
+            uint64_t pendingEpoch = 0;
+            if (parameterQueue.take(pending, pendingEpoch))
+            {
+                applyParameters(pending, pendingEpoch);
+            }
+
+            waitStrategy.setExposureHint(exposureTime);
+
+            lzx::WaitStrategy::Result ready = waitStrategy.wait(
+                [this]()
+                {
+                    POABool pIsReady = POA_FALSE;
+                    POAImageReady(cameraId, &pIsReady);
+                    return pIsReady == POA_TRUE;
+                },
+                [this]()
+                { return streaming; });
 
-            while (pIsReady == POA_FALSE)
+            if (!ready.ready)
             {
-                POAImageReady(cameraId, &pIsReady);
+                break;
+            }
 
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            // 取流期间挂接了新队列（开始录像、帧配对），帧池容量不够时重建
+            if (framePool->capacity() < poolCapacity())
+            {
+                allocateBuffers();
             }
 
-            lzx::Frame frame(this->width, this->height, this->channels, this->bitDepth);
+            lzx::Frame frame = framePool->acquire(this->width, this->height, this->channels, this->bitDepth);
 
-            frame.setSequenceNumber(frameCount++);
+            frame.setSequenceNumber(lzx::Frame::nextSequenceNumber());
 
             long exposureUs = exposureTime;
+            unsigned char *target = isColor ? rawBuffer.data() : frame.buffer();
+            size_t targetBytes = isColor ? rawBuffer.size() : frame.bufferSize();
+            int64_t fetchNs = lzx::FrameMetadata::now();
+            readyToFetch->record(fetchNs - ready.estimatedReadyNs());
             POAErrors error = POAGetImageData(this->cameraId,
-                                              frame.buffer(),
-                                              frame.bufferSize(),
+                                              target,
+                                              static_cast<long>(targetBytes),
                                               exposureUs / 1000 + 500);
 
             if (error != POA_OK)
@@ -89,7 +263,36 @@ struct PlayerOne::Impl
                 break;
             }
 
-            this->tripleBuffer->produce(std::move(frame));
+            // SDK 不带逐帧信息，曝光和增益取当前设置值，丢帧数由驱动计数的差值得到
+            lzx::FrameMetadata &meta = frame.metadata();
+            meta.hostTimestampNs = lzx::FrameMetadata::now();
+            meta.stageNs[lzx::FrameMetadata::Grab] = meta.hostTimestampNs;
+            transfer->record(meta.hostTimestampNs - fetchNs);
+
+            if (isColor)
+            {
+                lzx::FrameView raw(rawBuffer.data(), this->width, this->height, 1, this->bitDepth);
+                if (!demosaic->process(raw, bayerPattern, demosaicMethod, frame))
+                {
+                    Log::error("PlayerOne demosaic failed");
+                    break;
+                }
+            }
+            meta.exposureUs = exposureTime;
+            meta.gain = gain;
+            meta.parameterEpoch = parameterEpoch.tag(meta, this->width, this->height);
+
+            long dropped = lastDropped;
+            if (POAGetDroppedImagesCount(cameraId, &dropped) == POA_OK && dropped > lastDropped)
+            {
+                meta.droppedGap = dropped - lastDropped;
+                deviceFrame += meta.droppedGap;
+            }
+            lastDropped = dropped;
+            meta.deviceFrameCounter = ++deviceFrame;
+
+            meta.mark(lzx::FrameMetadata::Enqueue);
+            this->frameBus->publish(std::move(frame));
         }
     }
 };
@@ -98,6 +301,7 @@ PlayerOne::PlayerOne()
 {
     // 构造impl
     impl = std::make_unique<Impl>();
+    impl->properties = &propertyRegistry;
 }
 
 std::string PlayerOne::label()
@@ -140,6 +344,36 @@ bool PlayerOne::open()
         return false;
     }
 
+    // 彩色传感器仍取 RAW16，插值在采集线程上完成
+    POACameraProperties properties;
+    error = POAGetCameraPropertiesByID(impl->cameraId, &properties);
+    if (error != POA_OK)
+    {
+        Log::error(QString("POAGetCameraPropertiesByID failed with error code %1").arg(error));
+        return false;
+    }
+
+    impl->isColor = properties.isColorCamera == POA_TRUE && properties.bayerPattern != POA_BAYER_MONO;
+    if (impl->isColor)
+    {
+        switch (properties.bayerPattern)
+        {
+        case POA_BAYER_BG:
+            impl->bayerPattern = lzx::Demosaic::Pattern::BGGR;
+            break;
+        case POA_BAYER_GR:
+            impl->bayerPattern = lzx::Demosaic::Pattern::GRBG;
+            break;
+        case POA_BAYER_GB:
+            impl->bayerPattern = lzx::Demosaic::Pattern::GBRG;
+            break;
+        default:
+            impl->bayerPattern = lzx::Demosaic::Pattern::RGGB;
+            break;
+        }
+    }
+    impl->channels = impl->isColor ? 3 : 1;
+
     // 设置图像格式
     POAImgFormat imgFormat = POA_RAW16;
     error = POASetImageFormat(impl->cameraId, imgFormat);
@@ -174,6 +408,7 @@ bool PlayerOne::open()
         return false;
     }
 
+    impl->exposureTime = exposure_value.intValue;
     notifyStateChanged("exposure", std::to_string(exposure_value.intValue));
 
     // 获取gain
@@ -181,14 +416,36 @@ bool PlayerOne::open()
 
     error = POAGetConfig(impl->cameraId, POA_GAIN, &gain_value,
                          &isAuto);
+    impl->gain = gain_value.intValue;
     notifyStateChanged("gain", std::to_string(gain_value.intValue));
 
-    Log::info(QString("Open Camera: %1 width: %2 height: %3 exp: %4 gain: %5")
+    // 查询参数范围，之后读参数不再调用 SDK；SDK 要求宽度是 4 的倍数、高度是 2 的倍数
+    propertyRegistry.clear();
+    POAConfigAttributes attributes;
+    if (POAGetConfigAttributesByConfigID(impl->cameraId, POA_EXPOSURE, &attributes) == POA_OK)
+    {
+        propertyRegistry.define(lzx::PropertyId::ExposureTime, attributes.minValue.intValue, attributes.maxValue.intValue, 1, exposure_value.intValue);
+    }
+    if (POAGetConfigAttributesByConfigID(impl->cameraId, POA_GAIN, &attributes) == POA_OK)
+    {
+        propertyRegistry.define(lzx::PropertyId::Gain, attributes.minValue.intValue, attributes.maxValue.intValue, 1, gain_value.intValue);
+    }
+
+    int startX = 0;
+    int startY = 0;
+    POAGetImageStartPos(impl->cameraId, &startX, &startY);
+    propertyRegistry.define(lzx::PropertyId::Width, 16, properties.maxWidth, 4, impl->width);
+    propertyRegistry.define(lzx::PropertyId::Height, 16, properties.maxHeight, 2, impl->height);
+    propertyRegistry.define(lzx::PropertyId::OffsetX, 0, properties.maxWidth - 16, 4, startX);
+    propertyRegistry.define(lzx::PropertyId::OffsetY, 0, properties.maxHeight - 16, 2, startY);
+
+    Log::info(QString("Open Camera: %1 width: %2 height: %3 exp: %4 gain: %5 bayer: %6")
                   .arg(QString::fromStdString(impl->label))
                   .arg(impl->width)
                   .arg(impl->height)
                   .arg(exposure_value.intValue)
-                  .arg(gain_value.intValue));
+                  .arg(gain_value.intValue)
+                  .arg(impl->isColor ? lzx::Demosaic::name(impl->bayerPattern) : "mono"));
     return true;
 }
 
@@ -215,6 +472,15 @@ bool PlayerOne::start()
         return false;
     }
 
+    // 停止取流期间留在队列里的参数，以及之前提交的参数都已生效
+    lzx::ParameterTransaction pending;
+    uint64_t pendingEpoch = 0;
+    if (impl->parameterQueue.take(pending, pendingEpoch))
+    {
+        impl->applyParameters(pending, pendingEpoch);
+    }
+    impl->parameterEpoch.reset();
+
     POAErrors error = POAStartExposure(impl->cameraId, POA_FALSE); // continuously exposure
 
     if (error != POA_OK)
@@ -223,6 +489,23 @@ bool PlayerOne::start()
         return false;
     }
 
+    // 按当前图像尺寸预分配帧池
+    impl->allocateBuffers();
+
+    if (impl->isColor)
+    {
+        if (!impl->demosaicPool)
+        {
+            impl->demosaicPool = std::make_unique<lzx::ThreadPool>();
+            impl->demosaic = std::make_unique<lzx::Demosaic>(impl->demosaicPool.get());
+        }
+        Log::info(QString("PlayerOne demosaic: %1 %2, %3 threads, %4")
+                      .arg(lzx::Demosaic::name(impl->bayerPattern))
+                      .arg(lzx::Demosaic::name(impl->demosaicMethod.load()))
+                      .arg(impl->demosaicPool->workerCount() + 1)
+                      .arg(lzx::Demosaic::simdName()));
+    }
+
     impl->streaming = true;
 
     impl->grabThread = std::make_unique<std::thread>(&PlayerOne::Impl::grabFunction, impl.get());
@@ -246,6 +529,40 @@ bool PlayerOne::stop()
     impl->grabThread->join();
     impl->grabThread.reset();
 
+    lzx::LatencyHistogram::Summary readyStats = impl->readyToFetch->summary();
+    lzx::LatencyHistogram::Summary transferStats = impl->transfer->summary();
+    Log::info(QString("PlayerOne wait strategy %1: period %2 ms, ready-to-fetch p50 %3 ms p99 %4 ms max %5 ms, transfer p50 %6 ms p99 %7 ms")
+                  .arg(lzx::WaitStrategy::name(impl->waitStrategy.kind()))
+                  .arg(impl->waitStrategy.measuredPeriodUs() / 1000.0, 0, 'f', 2)
+                  .arg(readyStats.p50Us / 1000.0, 0, 'f', 2)
+                  .arg(readyStats.p99Us / 1000.0, 0, 'f', 2)
+                  .arg(readyStats.maxUs / 1000.0, 0, 'f', 2)
+                  .arg(transferStats.p50Us / 1000.0, 0, 'f', 2)
+                  .arg(transferStats.p99Us / 1000.0, 0, 'f', 2));
+    impl->readyToFetch->reset();
+    impl->transfer->reset();
+
+    if (impl->framePool)
+    {
+        auto stats = impl->framePool->statistics();
+        Log::info(QString("PlayerOne frame pool: acquired %1 exhausted %2 oversized %3 high water %4/%5 huge pages %6")
+                      .arg(stats.acquired)
+                      .arg(stats.exhausted)
+                      .arg(stats.oversized)
+                      .arg(stats.highWater)
+                      .arg(stats.capacity)
+                      .arg(stats.hugePageBuffers));
+    }
+
+    for (const auto &stats : impl->frameBus->statistics())
+    {
+        Log::info(QString("PlayerOne frame bus [%1]: delivered %2 skipped %3 dropped %4")
+                      .arg(QString::fromStdString(stats.name))
+                      .arg(stats.delivered)
+                      .arg(stats.skipped)
+                      .arg(stats.dropped));
+    }
+
     // 停止曝光
     POAErrors error = POAStopExposure(impl->cameraId);
     if (error != POA_OK)
@@ -269,130 +586,167 @@ bool PlayerOne::streaming()
     return impl->streaming;
 }
 
-bool PlayerOne::getFrame(unsigned char *buffer, int &width, int &height, int &channels, int &bitDepth)
+lzx::Frame PlayerOne::acquireLatestFrame()
 {
-    if (!buffer)
+    if (!impl->streaming)
     {
-        Log::error("PlayerOne::getFrame Invalid buffer pointer");
-        return false;
+        return lzx::Frame();
     }
 
-    if (impl->streaming && true)
-    {
-        lzx::Frame *frame = impl->tripleBuffer.get()->consume();
-
-        if (frame && frame->width() > 0 && frame->height() > 0)
-        {
-
-            width = frame->width();
-            height = frame->height();
-            channels = frame->channels();
-            bitDepth = frame->bitDepth();
+    // 只有新帧才会返回，共享缓冲区不拷贝像素
+    return impl->subscription->acquire();
+}
 
-            auto sn = frame->sn();
+lzx::FrameBus *PlayerOne::frameBus()
+{
+    return impl->frameBus.get();
+}
 
-            // 只有新帧才会返回
-            if (sn > this->m_lastGotFrameCount)
-            {
-                this->m_lastGotFrameCount = sn;
+uint64_t PlayerOne::apply(const lzx::ParameterTransaction &transaction)
+{
+    if (transaction.empty())
+    {
+        return impl->parameterEpoch.current();
+    }
 
-                memcpy(buffer, frame->buffer(), frame->bufferSize());
+    // 按参数表限制范围；修改 ROI 时补全四个值，起点加宽高不超出传感器
+    lzx::ParameterTransaction target;
+    for (const auto &change : transaction.changes())
+    {
+        target.set(change.first, propertyRegistry.clamp(change.first, change.second));
+    }
+    if (transaction.changesGeometry())
+    {
+        int width = static_cast<int>(target.value(lzx::PropertyId::Width, propertyRegistry.value(lzx::PropertyId::Width)));
+        int height = static_cast<int>(target.value(lzx::PropertyId::Height, propertyRegistry.value(lzx::PropertyId::Height)));
+        double x = target.value(lzx::PropertyId::OffsetX, propertyRegistry.value(lzx::PropertyId::OffsetX));
+        double y = target.value(lzx::PropertyId::OffsetY, propertyRegistry.value(lzx::PropertyId::OffsetY));
+        x = propertyRegistry.clamp(lzx::PropertyId::OffsetX, std::min(x, propertyRegistry.info(lzx::PropertyId::Width).max - width));
+        y = propertyRegistry.clamp(lzx::PropertyId::OffsetY, std::min(y, propertyRegistry.info(lzx::PropertyId::Height).max - height));
+        target.setRoi(static_cast<int>(x), static_cast<int>(y), width, height);
+    }
 
-                impl->tripleBuffer.get()->consumeDone();
+    uint64_t epoch = impl->parameterEpoch.allocate();
+    if (impl->streaming)
+    {
+        // 不在界面线程上调用 SDK，交给采集线程在两帧之间应用
+        impl->parameterQueue.push(epoch, target);
+    }
+    else
+    {
+        lzx::ParameterTransaction pending;
+        uint64_t pendingEpoch = 0;
+        if (impl->parameterQueue.take(pending, pendingEpoch))
+        {
+            pending.merge(target);
+            target = pending;
+        }
 
-                return true;
-            }
+        if (!impl->applyParameters(target, epoch))
+        {
+            return 0;
         }
+    }
 
-        impl->tripleBuffer.get()->consumeDone();
+    if (target.has(lzx::PropertyId::ExposureTime))
+    {
+        notifyStateChanged("exposure", std::to_string(int(target.value(lzx::PropertyId::ExposureTime))));
+    }
+    if (target.has(lzx::PropertyId::Gain))
+    {
+        notifyStateChanged("gain", std::to_string(int(target.value(lzx::PropertyId::Gain))));
+    }
+    if (transaction.changesGeometry())
+    {
+        notifyStateChanged("width", std::to_string(int(target.value(lzx::PropertyId::Width))));
+        notifyStateChanged("height", std::to_string(int(target.value(lzx::PropertyId::Height))));
     }
 
-    return false;
+    return epoch;
 }
 
 bool PlayerOne::set(const std::string &name, double value)
 {
+    lzx::PropertyId id;
+    if (lzx::PropertyRegistry::parse(name, id))
+    {
+        return apply(lzx::ParameterTransaction().set(id, value)) != 0;
+    }
     return false;
 }
 
 bool PlayerOne::set(const std::string &name, int value)
 {
-    // exposure
-    if (name == "exposure")
+    // exposure / gain / ROI
+    lzx::PropertyId id;
+    if (lzx::PropertyRegistry::parse(name, id))
     {
+        return apply(lzx::ParameterTransaction().set(id, value)) != 0;
+    }
 
-        POAConfigValue exposure_value;
-        POABool isAuto = POA_FALSE;
-        exposure_value.intValue = value;
-        POAErrors error = POASetConfig(impl->cameraId, POA_EXPOSURE,
-                                       exposure_value, isAuto);
+    return false;
+}
 
-        if (error != POA_OK)
+bool PlayerOne::set(const std::string &name, bool value)
+{
+    return false;
+}
+
+bool PlayerOne::set(const std::string &name, const std::string &value)
+{
+    // 彩色相机的插值方法：bilinear / edge，取流期间也可以切换
+    if (name == "Demosaic")
+    {
+        lzx::Demosaic::Method method;
+        if (!lzx::Demosaic::parse(value, method))
         {
-            Log::error(QString("POASetConfig failed with error code %1").arg(error));
+            Log::error(QString("Unknown demosaic method: %1").arg(QString::fromStdString(value)));
             return false;
         }
 
-        notifyStateChanged("exposure", std::to_string(value));
+        impl->demosaicMethod = method;
+        notifyStateChanged("Demosaic", value);
+        return true;
     }
 
-    // gain
-    if (name == "gain")
+    // 等待图像就绪的策略：spin / spin-yield / predictive / timed，取流期间也可以切换
+    if (name == "WaitStrategy")
     {
-        POAConfigValue gain_value;
-        POABool isAuto = POA_FALSE;
-        gain_value.intValue = value;
-        POAErrors error = POASetConfig(impl->cameraId, POA_GAIN,
-                                       gain_value, isAuto);
-
-        if (error != POA_OK)
+        lzx::WaitStrategy::Kind kind;
+        if (!lzx::WaitStrategy::parse(value, kind))
         {
-            Log::error(QString("POASetConfig failed with error code %1").arg(error));
+            Log::error(QString("Unknown wait strategy: %1").arg(QString::fromStdString(value)));
             return false;
         }
 
-        notifyStateChanged("gain", std::to_string(value));
+        impl->waitStrategy.setKind(kind);
+        Log::info(QString("PlayerOne wait strategy: %1").arg(lzx::WaitStrategy::name(kind)));
+        notifyStateChanged("WaitStrategy", value);
+        return true;
     }
 
     return false;
 }
 
-bool PlayerOne::set(const std::string &name, bool value)
-{
-    return false;
-}
-
-bool PlayerOne::set(const std::string &name, const std::string &value)
-{
-    return false;
-}
-
 bool PlayerOne::get(const std::string &name, double &value)
 {
+    lzx::PropertyId id;
+    if (lzx::PropertyRegistry::parse(name, id) && propertyRegistry.available(id))
+    {
+        value = propertyRegistry.value(id);
+        return true;
+    }
 
     return false;
 }
 
 bool PlayerOne::get(const std::string &name, int &value)
 {
-
-    // 曝光时间 us
-    if (name == "ExposureTime")
+    // 曝光时间 us、增益、ROI，取参数表里最近写入的值，不调用 SDK
+    lzx::PropertyId id;
+    if (lzx::PropertyRegistry::parse(name, id) && propertyRegistry.available(id))
     {
-        POAConfigValue exposValue;
-
-        POABool boolValue;
-
-        POAErrors error = POAGetConfig(impl->cameraId, POA_EXPOSURE, &exposValue, &boolValue);
-
-        if (error != POA_OK)
-        {
-            Log::error(QString("POAGetConfig failed with error code %1").arg(error));
-            return false;
-        }
-
-        value = exposValue.intValue;
-
+        value = static_cast<int>(propertyRegistry.value(id));
         return true;
     }
 
@@ -406,5 +760,12 @@ bool PlayerOne::get(const std::string &name, bool &value)
 
 bool PlayerOne::get(const std::string &name, std::string &value)
 {
+    // Bayer 排列，黑白相机为 Mono
+    if (name == "BayerPattern")
+    {
+        value = impl->isColor ? lzx::Demosaic::name(impl->bayerPattern) : "Mono";
+        return true;
+    }
+
     return false;
 }
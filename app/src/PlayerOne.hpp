@@ -3,7 +3,7 @@
 
 #include "ICamera.hpp"
 #include "Frame.h"
-#include "TripleBuffer.h"
+#include "FrameBus.h"
 #include <string>
 #include <vector>
 #include <memory>
@@ -27,7 +27,10 @@ public:
     bool stop() override;
     bool snap() override;
     virtual bool streaming() override;
-    virtual bool getFrame(unsigned char *buffer, int &width, int &height, int &channels, int &bitDepth) override;
+    virtual lzx::Frame acquireLatestFrame() override;
+    virtual lzx::FrameBus *frameBus() override;
+
+    uint64_t apply(const lzx::ParameterTransaction &transaction) override;
 
     bool set(const std::string &name, double value) override;
     bool set(const std::string &name, int value) override;
@@ -41,8 +44,6 @@ public:
 private:
     struct Impl;
     std::unique_ptr<Impl> impl;
-
-    size_t m_lastGotFrameCount = 0;
 };
 
 #endif
@@ -0,0 +1,143 @@
+#include "RawContainer.h"
+
+#include <cstring>
+#include <fstream>
+#include <QString>
+
+#include "logwidget.hpp"
+
+namespace lzx
+{
+    using namespace raw;
+
+    static bool validHeader(const RawFileHeader &header)
+    {
+        return memcmp(header.magic, FileMagic, sizeof(FileMagic)) == 0 &&
+               header.version == Version &&
+               header.headerBytes == BlockSize &&
+               header.width > 0 && header.height > 0 &&
+               header.channels > 0 && header.bitDepth >= 8 && header.bitDepth <= 16 &&
+               header.frameBytes > 0 && header.frameSlotBytes >= header.frameBytes &&
+               (header.codec == CodecNone || header.codec == CodecDeltaPack) &&
+               header.chunkFrames > 0 &&
+               header.chunkHeaderBytes == chunkHeaderBytes(header.chunkFrames);
+    }
+
+    bool RawReader::isContainer(const std::string &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        char magic[sizeof(FileMagic)] = {};
+        return file.read(magic, sizeof(magic)) && memcmp(magic, FileMagic, sizeof(FileMagic)) == 0;
+    }
+
+    bool RawReader::open(const std::string &path)
+    {
+        close();
+
+        if (!m_file.open(path))
+        {
+            Log::error(QString("RawReader: failed to map %1").arg(QString::fromStdString(path)));
+            return false;
+        }
+
+        if (m_file.size() < BlockSize)
+        {
+            Log::error("RawReader: file too small");
+            close();
+            return false;
+        }
+
+        memcpy(&m_header, m_file.data(), sizeof(m_header));
+        if (!validHeader(m_header))
+        {
+            Log::error("RawReader: not a valid .hdrraw file");
+            close();
+            return false;
+        }
+
+        // 顺序扫描块索引，遇到不完整或损坏的块停止
+        const uint64_t fileSize = m_file.size();
+        uint64_t offset = m_header.headerBytes;
+        while (offset + m_header.chunkHeaderBytes <= fileSize)
+        {
+            const unsigned char *chunk = m_file.data() + offset;
+            RawChunkHeader chunkHeader;
+            memcpy(&chunkHeader, chunk, sizeof(chunkHeader));
+
+            if (memcmp(chunkHeader.magic, ChunkMagic, sizeof(ChunkMagic)) != 0 ||
+                chunkHeader.chunkIndex != m_chunkCount ||
+                chunkHeader.frameCount == 0 || chunkHeader.frameCount > m_header.chunkFrames)
+            {
+                break;
+            }
+
+            const bool encoded = m_header.codec != CodecNone;
+            uint64_t payloadBytes = chunkHeader.payloadBytes;
+            if (!encoded)
+            {
+                payloadBytes = chunkHeader.frameCount * m_header.frameSlotBytes;
+            }
+            else if (payloadBytes == 0)
+            {
+                break;
+            }
+
+            uint64_t chunkBytes = m_header.chunkHeaderBytes + alignUp(payloadBytes);
+            if (offset + chunkBytes > fileSize)
+            {
+                Log::warn(QString("RawReader: chunk %1 is truncated").arg(m_chunkCount));
+                break;
+            }
+
+            const unsigned char *records = chunk + sizeof(RawChunkHeader);
+            const unsigned char *payload = chunk + m_header.chunkHeaderBytes;
+            bool valid = true;
+            std::vector<Entry> entries(chunkHeader.frameCount);
+            for (uint32_t i = 0; i < chunkHeader.frameCount && valid; i++)
+            {
+                Entry &entry = entries[i];
+                memcpy(&entry.record, records + i * sizeof(RawFrameRecord), sizeof(RawFrameRecord));
+                if (encoded)
+                {
+                    valid = entry.record.storedBytes > 0 && entry.record.offset <= payloadBytes &&
+                            entry.record.storedBytes <= payloadBytes - entry.record.offset;
+                    entry.data = payload + entry.record.offset;
+                }
+                else
+                {
+                    entry.data = payload + i * m_header.frameSlotBytes;
+                }
+            }
+            if (!valid)
+            {
+                Log::warn(QString("RawReader: chunk %1 has an invalid frame index").arg(m_chunkCount));
+                break;
+            }
+            m_entries.insert(m_entries.end(), entries.begin(), entries.end());
+
+            offset += chunkBytes;
+            m_chunkCount++;
+        }
+
+        m_endOffset = offset;
+        if (offset != fileSize)
+        {
+            Log::warn(QString("RawReader: %1 bytes after the last complete chunk ignored").arg(fileSize - offset));
+        }
+        return true;
+    }
+
+    void RawReader::close()
+    {
+        m_file.close();
+        m_header = RawFileHeader{};
+        m_entries.clear();
+        m_endOffset = 0;
+        m_chunkCount = 0;
+    }
+
+    FrameView RawReader::view(size_t index) const
+    {
+        return FrameView(m_entries[index].data, m_header.width, m_header.height, m_header.channels, m_header.bitDepth);
+    }
+}
@@ -0,0 +1,134 @@
+#ifndef RAW_CONTAINER_H
+#define RAW_CONTAINER_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+#include "Frame.h"
+#include "MappedFile.h"
+
+namespace lzx
+{
+    // 原始帧录像容器（.hdrraw），小端，所有块按 4096 字节对齐，便于无缓冲写入和内存映射读取
+    //
+    //   [RawFileHeader, 4096 字节]
+    //   [块 0: RawChunkHeader + RawFrameRecord × chunkFrames，补齐到 chunkHeaderBytes][帧槽 × frameCount]
+    //   [块 1 ...]
+    //
+    // 未编码时每个帧槽 frameSlotBytes 字节（紧密排列的帧数据，补齐到 4096）；
+    // 编码后（codec != CodecNone）各帧长度不一，依次紧挨着存放，位置由帧记录的 offset 给出，
+    // 块的数据区共 payloadBytes 字节，补齐到 4096。
+    // 块一次性整块写入，文件可以随时追加新块；读取时顺序扫描，遇到不完整的块即停止，
+    // 因此录制中途崩溃只会丢失最后一个块。
+    namespace raw
+    {
+        constexpr size_t BlockSize = 4096;
+        constexpr uint32_t Version = 1;
+        constexpr char FileMagic[8] = {'H', 'D', 'R', 'R', 'A', 'W', '\0', '\1'};
+        constexpr char ChunkMagic[8] = {'H', 'D', 'R', 'C', 'H', 'U', 'N', 'K'};
+
+        // 帧数据的编码方式
+        enum Codec : uint32_t
+        {
+            CodecNone = 0,     // 原样存储
+            CodecDeltaPack = 1 // FrameCodec 无损编码
+        };
+
+        inline size_t alignUp(size_t value, size_t alignment = BlockSize)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+#pragma pack(push, 1)
+        struct RawFileHeader
+        {
+            char magic[8];
+            uint32_t version;
+            uint32_t headerBytes; // 文件头占用的字节数（BlockSize）
+            int32_t width;
+            int32_t height;
+            int32_t channels;
+            int32_t bitDepth;
+            uint64_t frameBytes;     // 一帧紧密排列的字节数
+            uint64_t frameSlotBytes; // 每个帧槽的字节数
+            uint32_t chunkFrames;    // 每块最多的帧数
+            uint32_t chunkHeaderBytes;
+            uint32_t codec;
+            uint32_t reserved0;
+            int64_t createdUnixMs;  // 创建时的系统时间
+            int64_t createdSteadyNs; // 创建时的单调时钟，和帧时间戳一起换算出绝对时间
+            char label[64];         // 相机名
+        };
+
+        struct RawChunkHeader
+        {
+            char magic[8];
+            uint32_t chunkIndex;
+            uint32_t frameCount;   // 本块实际帧数，最后一块可能不满
+            uint64_t payloadBytes; // 数据区有效字节数（不含对齐填充），旧文件为 0
+            uint64_t reserved;
+        };
+
+        struct RawFrameRecord
+        {
+            uint64_t sequence;
+            int64_t hostTimestampNs;
+            uint64_t deviceFrameCounter;
+            uint64_t droppedGap;
+            double exposureUs;
+            double gain;
+            uint64_t storedBytes; // 帧数据的字节数（编码后小于 frameBytes）
+            uint64_t offset;      // 帧数据相对块数据区起点的偏移（仅编码时使用）
+        };
+#pragma pack(pop)
+
+        static_assert(sizeof(RawFileHeader) <= BlockSize, "file header must fit one block");
+        static_assert(sizeof(RawChunkHeader) == 32, "chunk header layout");
+        static_assert(sizeof(RawFrameRecord) == 64, "frame record layout");
+
+        inline size_t chunkHeaderBytes(uint32_t chunkFrames)
+        {
+            return alignUp(sizeof(RawChunkHeader) + chunkFrames * sizeof(RawFrameRecord));
+        }
+    }
+
+    // 读取 .hdrraw：整个文件只读映射，帧数据直接指向映射区，不拷贝
+    class RawReader
+    {
+    public:
+        struct Entry
+        {
+            const unsigned char *data = nullptr; // 帧数据起始地址，长度为 record.storedBytes
+            raw::RawFrameRecord record{};
+        };
+
+        // 检查文件是否为 .hdrraw 容器（只读文件头）
+        static bool isContainer(const std::string &path);
+
+        bool open(const std::string &path);
+        void close();
+        bool isOpen() const { return m_file.isOpen(); }
+
+        const raw::RawFileHeader &header() const { return m_header; }
+        size_t frameCount() const { return m_entries.size(); }
+        const Entry &entry(size_t index) const { return m_entries[index]; }
+
+        // 未编码的帧可以直接当作视图使用
+        FrameView view(size_t index) const;
+
+        // 最后一个完整块之后的偏移，追加写入从这里开始
+        uint64_t endOffset() const { return m_endOffset; }
+        uint32_t chunkCount() const { return m_chunkCount; }
+
+    private:
+        MappedFile m_file;
+        raw::RawFileHeader m_header{};
+        std::vector<Entry> m_entries;
+        uint64_t m_endOffset = 0;
+        uint32_t m_chunkCount = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,492 @@
+#include "RawRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <QString>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "FrameCodec.h"
+#include "ThreadPool.h"
+#include "logwidget.hpp"
+
+namespace lzx
+{
+    using namespace raw;
+
+    // 顺序写文件，优先无缓冲写；写入的地址、长度和偏移都必须是 BlockSize 的整数倍
+    class RawRecorder::FileWriter
+    {
+    public:
+        ~FileWriter() { close(); }
+
+        // offset > 0 时打开已有文件，从 offset 处截断后继续写
+        bool open(const std::string &path, uint64_t offset)
+        {
+#ifdef _WIN32
+            std::wstring widePath = QString::fromStdString(path).toStdWString();
+            DWORD disposition = offset > 0 ? OPEN_EXISTING : CREATE_ALWAYS;
+            m_handle = CreateFileW(widePath.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, disposition,
+                                   FILE_FLAG_NO_BUFFERING | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            m_unbuffered = m_handle != INVALID_HANDLE_VALUE;
+            if (!m_unbuffered)
+            {
+                m_handle = CreateFileW(widePath.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, disposition,
+                                       FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            }
+            if (m_handle == INVALID_HANDLE_VALUE)
+            {
+                m_handle = nullptr;
+                return false;
+            }
+
+            LARGE_INTEGER position;
+            position.QuadPart = static_cast<LONGLONG>(offset);
+            if (!SetFilePointerEx(m_handle, position, nullptr, FILE_BEGIN) || !SetEndOfFile(m_handle))
+            {
+                close();
+                return false;
+            }
+            return true;
+#else
+            int flags = O_WRONLY | O_CREAT | (offset > 0 ? 0 : O_TRUNC);
+#ifdef O_DIRECT
+            m_fd = ::open(path.c_str(), flags | O_DIRECT, 0644);
+            m_unbuffered = m_fd >= 0;
+#endif
+            if (m_fd < 0)
+            {
+                m_fd = ::open(path.c_str(), flags, 0644);
+            }
+            if (m_fd < 0)
+            {
+                return false;
+            }
+
+            if (ftruncate(m_fd, static_cast<off_t>(offset)) != 0 ||
+                lseek(m_fd, static_cast<off_t>(offset), SEEK_SET) < 0)
+            {
+                close();
+                return false;
+            }
+            return true;
+#endif
+        }
+
+        bool write(const unsigned char *data, size_t bytes)
+        {
+#ifdef _WIN32
+            while (bytes > 0)
+            {
+                DWORD toWrite = static_cast<DWORD>(std::min<size_t>(bytes, 1u << 30));
+                DWORD written = 0;
+                if (!WriteFile(m_handle, data, toWrite, &written, nullptr) || written == 0)
+                {
+                    return false;
+                }
+                data += written;
+                bytes -= written;
+            }
+            return true;
+#else
+            while (bytes > 0)
+            {
+                ssize_t written = ::write(m_fd, data, bytes);
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+#ifdef O_DIRECT
+                    // 有的文件系统能打开 O_DIRECT 但写入时报 EINVAL，关掉后重试
+                    if (errno == EINVAL && m_unbuffered)
+                    {
+                        fcntl(m_fd, F_SETFL, fcntl(m_fd, F_GETFL) & ~O_DIRECT);
+                        m_unbuffered = false;
+                        continue;
+                    }
+#endif
+                    return false;
+                }
+                data += written;
+                bytes -= static_cast<size_t>(written);
+            }
+            return true;
+#endif
+        }
+
+        void close()
+        {
+#ifdef _WIN32
+            if (m_handle)
+            {
+                CloseHandle(m_handle);
+                m_handle = nullptr;
+            }
+#else
+            if (m_fd >= 0)
+            {
+                ::close(m_fd);
+                m_fd = -1;
+            }
+#endif
+        }
+
+        bool unbuffered() const { return m_unbuffered; }
+
+    private:
+#ifdef _WIN32
+        HANDLE m_handle = nullptr;
+#else
+        int m_fd = -1;
+#endif
+        bool m_unbuffered = false;
+    };
+
+    RawRecorder::RawRecorder(size_t queueDepth)
+        : m_queueDepth(queueDepth)
+    {
+    }
+
+    RawRecorder::~RawRecorder()
+    {
+        stop();
+    }
+
+    bool RawRecorder::start(FrameBus *bus, const std::string &path, const std::string &label, bool append)
+    {
+        if (m_running || !bus)
+            return false;
+
+        m_path = path;
+        m_label = label;
+        m_header = RawFileHeader{};
+        m_headerValid = false;
+        m_writeFailed = false;
+        m_chunk.reset();
+        m_chunkIndex = 0;
+        m_chunkFill = 0;
+        m_payloadUsed = 0;
+
+        // 追加：沿用已有文件头，从最后一个完整块之后开始写
+        uint64_t offset = 0;
+        if (append && RawReader::isContainer(path))
+        {
+            RawReader reader;
+            if (!reader.open(path))
+            {
+                return false;
+            }
+            m_header = reader.header();
+            m_headerValid = true;
+            m_chunkIndex = reader.chunkCount();
+            offset = reader.endOffset();
+        }
+
+        m_file = std::make_unique<FileWriter>();
+        if (!m_file->open(path, offset))
+        {
+            Log::error(QString("RawRecorder: failed to open %1").arg(QString::fromStdString(path)));
+            m_file.reset();
+            return false;
+        }
+        m_unbuffered = m_file->unbuffered();
+
+        m_framesWritten = 0;
+        m_framesRejected = 0;
+        m_chunksWritten = 0;
+        m_bytesWritten = 0;
+        m_rawBytes = 0;
+        m_writeNs = 0;
+
+        raw::Codec codec = m_headerValid ? static_cast<raw::Codec>(m_header.codec) : m_codecType;
+        if (codec != CodecNone && !m_codec)
+        {
+            m_codecPool = std::make_unique<ThreadPool>();
+            m_codec = std::make_unique<FrameCodec>(m_codecPool.get());
+        }
+        else if (codec == CodecNone)
+        {
+            m_codec.reset();
+            m_codecPool.reset();
+        }
+
+        // 磁盘跟不上时丢弃新帧并计数，不能反过来阻塞相机的采集线程
+        m_ring = std::make_shared<FrameRing>("raw recorder", m_queueDepth, FrameRing::OverflowPolicy::DropNewest);
+        m_running = true;
+        m_thread = std::make_unique<std::thread>(&RawRecorder::ioFunction, this);
+
+        m_bus = bus;
+        m_bus->attachRing(m_ring);
+
+        Log::info(QString("Raw recording to %1 (%2, %3)")
+                      .arg(QString::fromStdString(path))
+                      .arg(m_unbuffered ? "unbuffered" : "buffered")
+                      .arg(m_codec ? "compressed" : "uncompressed"));
+        return true;
+    }
+
+    void RawRecorder::stop()
+    {
+        if (!m_thread)
+            return;
+
+        // 先摘除队列，之后不会再有新帧进来，I/O 线程写完队列中剩余的帧后退出
+        m_bus->detachRing(m_ring);
+        m_bus = nullptr;
+
+        m_running = false;
+        m_ring->wakeConsumer();
+        m_thread->join();
+        m_thread.reset();
+        m_file.reset();
+        m_chunk.reset();
+
+        Statistics stats = statistics();
+        double mb = stats.bytesWritten / 1048576.0;
+        Log::info(QString("Raw recording stopped: %1 frames, %2 chunks, %3 MB (ratio %4), %5 MB/s while writing, dropped %6 rejected %7, queue high water %8/%9")
+                      .arg(stats.framesWritten)
+                      .arg(stats.chunksWritten)
+                      .arg(mb, 0, 'f', 1)
+                      .arg(stats.bytesWritten > 0 ? static_cast<double>(stats.rawBytes) / stats.bytesWritten : 0.0, 0, 'f', 2)
+                      .arg(stats.writeSeconds > 0 ? mb / stats.writeSeconds : 0.0, 0, 'f', 0)
+                      .arg(stats.framesDropped)
+                      .arg(stats.framesRejected)
+                      .arg(m_ring->statistics().highWater)
+                      .arg(m_ring->depth()));
+    }
+
+    RawRecorder::Statistics RawRecorder::statistics() const
+    {
+        Statistics stats;
+        stats.framesWritten = m_framesWritten.load(std::memory_order_relaxed);
+        stats.framesRejected = m_framesRejected.load(std::memory_order_relaxed);
+        stats.chunksWritten = m_chunksWritten.load(std::memory_order_relaxed);
+        stats.bytesWritten = m_bytesWritten.load(std::memory_order_relaxed);
+        stats.rawBytes = m_rawBytes.load(std::memory_order_relaxed);
+        stats.writeSeconds = m_writeNs.load(std::memory_order_relaxed) / 1e9;
+        stats.unbuffered = m_unbuffered.load(std::memory_order_relaxed);
+        if (m_ring)
+        {
+            stats.framesDropped = m_ring->statistics().droppedNewest;
+        }
+        return stats;
+    }
+
+    void RawRecorder::ioFunction()
+    {
+        Frame frame;
+        for (;;)
+        {
+            if (m_ring->waitPop(frame, std::chrono::milliseconds(50)))
+            {
+                appendFrame(frame);
+                frame.reset(); // 尽快把缓冲区还给相机的帧池
+            }
+            else if (!m_running)
+            {
+                break;
+            }
+        }
+
+        if (m_chunkFill > 0 && !m_writeFailed)
+        {
+            flushChunk();
+        }
+    }
+
+    void RawRecorder::appendFrame(const Frame &frame)
+    {
+        if (!m_chunk && !m_writeFailed && !beginFile(frame))
+        {
+            m_writeFailed = true;
+        }
+
+        if (m_writeFailed)
+        {
+            m_framesRejected.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        if (frame.width() != m_header.width || frame.height() != m_header.height ||
+            frame.channels() != m_header.channels || frame.bitDepth() != m_header.bitDepth)
+        {
+            if (m_framesRejected.fetch_add(1, std::memory_order_relaxed) == 0)
+            {
+                Log::warn(QString("RawRecorder: frame %1x%2 %3 bit does not match the file, skipped")
+                              .arg(frame.width())
+                              .arg(frame.height())
+                              .arg(frame.bitDepth()));
+            }
+            return;
+        }
+
+        unsigned char *slot = m_chunk.get() + m_header.chunkHeaderBytes + m_payloadUsed;
+        FrameView view = frame.view();
+        size_t storedBytes = m_header.frameBytes;
+        if (m_codec)
+        {
+            // 编码结果紧挨着上一帧存放
+            storedBytes = m_codec->encode(view, slot);
+            if (storedBytes == 0)
+            {
+                m_framesRejected.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+        else if (view.isContiguous())
+        {
+            memcpy(slot, view.data(), m_header.frameBytes);
+        }
+        else
+        {
+            // 去掉行填充，紧密写入帧槽
+            size_t rowBytes = view.width() * view.bytesPerPixel();
+            for (int y = 0; y < view.height(); y++)
+            {
+                memcpy(slot + y * rowBytes, view.row(y), rowBytes);
+            }
+        }
+
+        const FrameMetadata &meta = frame.metadata();
+        RawFrameRecord record{};
+        record.sequence = frame.sn();
+        record.hostTimestampNs = meta.hostTimestampNs;
+        record.deviceFrameCounter = meta.deviceFrameCounter;
+        record.droppedGap = meta.droppedGap;
+        record.exposureUs = meta.exposureUs;
+        record.gain = meta.gain;
+        record.storedBytes = storedBytes;
+        record.offset = m_payloadUsed;
+        memcpy(m_chunk.get() + sizeof(RawChunkHeader) + m_chunkFill * sizeof(RawFrameRecord), &record, sizeof(record));
+
+        m_payloadUsed += m_codec ? storedBytes : m_header.frameSlotBytes;
+        m_chunkFill++;
+
+        // 帧数到上限，或剩余空间放不下最坏情况的下一帧时写出
+        bool full = m_chunkFill == m_header.chunkFrames || m_payloadCapacity - m_payloadUsed < m_header.frameSlotBytes;
+        if (full && !flushChunk())
+        {
+            m_writeFailed = true;
+        }
+    }
+
+    bool RawRecorder::beginFile(const Frame &frame)
+    {
+        size_t frameBytes = Frame::packedStride(frame.width(), frame.channels(), frame.bitDepth()) * frame.height();
+
+        if (m_headerValid)
+        {
+            if (frame.width() != m_header.width || frame.height() != m_header.height ||
+                frame.channels() != m_header.channels || frame.bitDepth() != m_header.bitDepth)
+            {
+                Log::error("RawRecorder: frame format differs from the file being appended to");
+                return false;
+            }
+        }
+        else
+        {
+            memcpy(m_header.magic, FileMagic, sizeof(FileMagic));
+            m_header.version = Version;
+            m_header.headerBytes = BlockSize;
+            m_header.width = frame.width();
+            m_header.height = frame.height();
+            m_header.channels = frame.channels();
+            m_header.bitDepth = frame.bitDepth();
+            m_header.frameBytes = frameBytes;
+            m_header.codec = m_codec ? CodecDeltaPack : CodecNone;
+            if (m_codec)
+            {
+                // 编码后帧长不定，帧槽记为最坏情况的长度，每块帧数取上限，写满约 ChunkTargetBytes 为止
+                m_header.frameSlotBytes = alignUp(FrameCodec::maxEncodedBytes(frame.width(), frame.height(), frame.channels(), frame.bitDepth()));
+                m_header.chunkFrames = MaxChunkFrames;
+            }
+            else
+            {
+                m_header.frameSlotBytes = alignUp(frameBytes);
+                m_header.chunkFrames = static_cast<uint32_t>(std::clamp<size_t>(ChunkTargetBytes / m_header.frameSlotBytes, 1, MaxChunkFrames));
+            }
+            m_header.chunkHeaderBytes = static_cast<uint32_t>(chunkHeaderBytes(m_header.chunkFrames));
+            m_header.createdUnixMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                         std::chrono::system_clock::now().time_since_epoch())
+                                         .count();
+            m_header.createdSteadyNs = FrameMetadata::now();
+            memcpy(m_header.label, m_label.data(), std::min(m_label.size(), sizeof(m_header.label) - 1));
+        }
+
+        if (m_header.codec == CodecNone)
+        {
+            m_payloadCapacity = m_header.chunkFrames * m_header.frameSlotBytes;
+        }
+        else
+        {
+            m_payloadCapacity = std::max<size_t>(ChunkTargetBytes, m_header.frameSlotBytes) + m_header.frameSlotBytes;
+        }
+        size_t chunkBytes = m_header.chunkHeaderBytes + m_payloadCapacity;
+        m_chunk.reset(static_cast<unsigned char *>(::operator new(chunkBytes, std::align_val_t(BlockSize))));
+        memset(m_chunk.get(), 0, chunkBytes);
+
+        if (!m_headerValid)
+        {
+            // 文件头借用块缓冲区的第一个 4096 字节写出
+            memcpy(m_chunk.get(), &m_header, sizeof(m_header));
+            if (!m_file->write(m_chunk.get(), BlockSize))
+            {
+                Log::error("RawRecorder: failed to write file header");
+                return false;
+            }
+            memset(m_chunk.get(), 0, BlockSize);
+            m_headerValid = true;
+        }
+
+        return true;
+    }
+
+    bool RawRecorder::flushChunk()
+    {
+        RawChunkHeader chunkHeader{};
+        memcpy(chunkHeader.magic, ChunkMagic, sizeof(ChunkMagic));
+        chunkHeader.chunkIndex = m_chunkIndex;
+        chunkHeader.frameCount = m_chunkFill;
+        chunkHeader.payloadBytes = m_payloadUsed;
+        memcpy(m_chunk.get(), &chunkHeader, sizeof(chunkHeader));
+
+        // 最后一块可能不满，只写有效的数据，末尾补零对齐到 BlockSize
+        size_t payloadBytes = alignUp(m_payloadUsed);
+        unsigned char *payload = m_chunk.get() + m_header.chunkHeaderBytes;
+        memset(payload + m_payloadUsed, 0, payloadBytes - m_payloadUsed);
+        size_t bytes = m_header.chunkHeaderBytes + payloadBytes;
+
+        int64_t begin = FrameMetadata::now();
+        bool ok = m_file->write(m_chunk.get(), bytes);
+        m_writeNs.fetch_add(FrameMetadata::now() - begin, std::memory_order_relaxed);
+        m_unbuffered.store(m_file->unbuffered(), std::memory_order_relaxed);
+
+        if (!ok)
+        {
+            Log::error(QString("RawRecorder: write failed at chunk %1").arg(m_chunkIndex));
+            return false;
+        }
+
+        m_framesWritten.fetch_add(m_chunkFill, std::memory_order_relaxed);
+        m_chunksWritten.fetch_add(1, std::memory_order_relaxed);
+        m_bytesWritten.fetch_add(bytes, std::memory_order_relaxed);
+        m_rawBytes.fetch_add(m_chunkFill * m_header.frameBytes, std::memory_order_relaxed);
+
+        m_chunkIndex++;
+        m_chunkFill = 0;
+        m_payloadUsed = 0;
+        memset(m_chunk.get(), 0, m_header.chunkHeaderBytes);
+        return true;
+    }
+}
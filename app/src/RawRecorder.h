@@ -0,0 +1,110 @@
+#ifndef RAW_RECORDER_H
+#define RAW_RECORDER_H
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <cstdint>
+
+#include "Frame.h"
+#include "FrameBus.h"
+#include "FrameRing.h"
+#include "RawContainer.h"
+
+namespace lzx
+{
+    class FrameCodec;
+    class ThreadPool;
+
+    // 原始帧录像：在帧总线上挂一个队列（满时丢弃最新帧并计数），独立的 I/O 线程把相机原始帧（8/16位）
+    // 按块写入 .hdrraw 容器，不经过显示和 LUT，录制帧率只受磁盘带宽限制。
+    // 块缓冲区按 4096 对齐，整块写入；支持时使用无缓冲写（O_DIRECT / FILE_FLAG_NO_BUFFERING），
+    // 不支持时（如 tmpfs、网络盘）自动退回普通写入。
+    // 可选用 FrameCodec 无损编码后再写盘（图块在线程池上并行编码），磁盘带宽不够时用。
+    class RawRecorder
+    {
+    public:
+        struct Statistics
+        {
+            uint64_t framesWritten = 0;
+            uint64_t framesDropped = 0;  // 队列满被丢弃的帧（磁盘跟不上）
+            uint64_t framesRejected = 0; // 尺寸与文件不一致或写入失败后丢弃的帧
+            uint64_t chunksWritten = 0;
+            uint64_t bytesWritten = 0;
+            uint64_t rawBytes = 0;       // 已写入帧的原始字节数，与 bytesWritten 之比即压缩比
+            double writeSeconds = 0.0;   // 阻塞在写盘上的总时间
+            bool unbuffered = false;     // 是否使用了无缓冲写
+        };
+
+        // queueDepth: 队列深度，相机按总线上挂接的队列深度扩容帧池，队列里的每一帧都会占用一块帧池存储；
+        // 只需吸收一次整块写盘的停顿，块缓冲区本身已经攒下了大部分数据
+        explicit RawRecorder(size_t queueDepth = 16);
+        ~RawRecorder();
+
+        // 开始录制 bus 上的帧；append 为 true 且文件已存在时在最后一个完整块之后追加
+        bool start(FrameBus *bus, const std::string &path, const std::string &label, bool append = false);
+        void stop();
+
+        // 新建文件使用的编码方式，下一次 start 时生效；追加时沿用文件原有的编码
+        void setCodec(raw::Codec codec) { m_codecType = codec; }
+        raw::Codec codec() const { return m_codecType; }
+
+        bool recording() const { return m_running; }
+        const std::string &path() const { return m_path; }
+        Statistics statistics() const;
+
+    private:
+        RawRecorder(const RawRecorder &) = delete;
+        RawRecorder &operator=(const RawRecorder &) = delete;
+
+        class FileWriter;
+
+        static constexpr size_t ChunkTargetBytes = 32 << 20; // 每块约 32MB，大块顺序写吞吐最好
+        static constexpr uint32_t MaxChunkFrames = 256;
+
+        void ioFunction();
+        void appendFrame(const Frame &frame);
+        bool beginFile(const Frame &frame);
+        bool flushChunk();
+
+        size_t m_queueDepth;
+        raw::Codec m_codecType = raw::CodecNone;
+        std::string m_path;
+        std::string m_label;
+
+        FrameBus *m_bus = nullptr;
+        std::shared_ptr<FrameRing> m_ring;
+        std::unique_ptr<FileWriter> m_file;
+        std::atomic<bool> m_running{false};
+        std::unique_ptr<std::thread> m_thread;
+
+        // 以下仅 I/O 线程访问
+        raw::RawFileHeader m_header{};
+        bool m_headerValid = false; // 追加模式下沿用已有文件头
+        bool m_writeFailed = false;
+        struct AlignedDeleter
+        {
+            void operator()(unsigned char *p) const { ::operator delete(p, std::align_val_t(raw::BlockSize)); }
+        };
+        std::unique_ptr<unsigned char, AlignedDeleter> m_chunk; // 块缓冲区：块头 + 数据区
+        size_t m_payloadCapacity = 0; // 数据区容量
+        size_t m_payloadUsed = 0;
+        std::unique_ptr<ThreadPool> m_codecPool;
+        std::unique_ptr<FrameCodec> m_codec; // 编码时才创建
+        uint32_t m_chunkIndex = 0;
+        uint32_t m_chunkFill = 0;
+
+        // 统计
+        std::atomic<uint64_t> m_framesWritten{0};
+        std::atomic<uint64_t> m_framesRejected{0};
+        std::atomic<uint64_t> m_chunksWritten{0};
+        std::atomic<uint64_t> m_bytesWritten{0};
+        std::atomic<uint64_t> m_rawBytes{0};
+        std::atomic<int64_t> m_writeNs{0};
+        std::atomic<bool> m_unbuffered{false};
+    };
+}
+
+#endif
@@ -0,0 +1,428 @@
+#include "ReplayCamera.h"
+
+#include <chrono>
+#include <fstream>
+#include <QString>
+
+#include "FrameCodec.h"
+#include "ThreadPool.h"
+#include "logwidget.hpp"
+
+namespace lzx
+{
+    static constexpr size_t kFramePoolCapacity = 8;
+
+    ReplayCamera::ReplayCamera(const std::string &path, int width, int height, int bitDepth, FrameBus *bus)
+        : m_path(path),
+          m_width(width),
+          m_height(height),
+          m_bitDepth(bitDepth),
+          m_frameBytes(FramePool::frameBytes(width, height, 1, bitDepth)),
+          m_frameBus(bus ? nullptr : std::make_unique<FrameBus>()),
+          m_bus(bus ? bus : m_frameBus.get())
+    {
+        m_subscription = m_bus->subscribe("replay view");
+    }
+
+    ReplayCamera::~ReplayCamera()
+    {
+        stop();
+        close();
+    }
+
+    bool ReplayCamera::open()
+    {
+        if (m_opened)
+            return true;
+
+        m_container = RawReader::isContainer(m_path);
+        if (!(m_container ? openContainer() : openHeadless()))
+        {
+            return false;
+        }
+
+        m_opened = true;
+
+        Log::info(QString("Replay: %1 frames %2x%3 %4 bit, timestamps %5")
+                      .arg(m_frameCount)
+                      .arg(m_width)
+                      .arg(m_height)
+                      .arg(m_bitDepth)
+                      .arg(m_timestampsUs.empty() ? "none" : "loaded"));
+
+        notifyStateChanged("open", "true");
+        notifyStateChanged("width", std::to_string(m_width));
+        notifyStateChanged("height", std::to_string(m_height));
+        return true;
+    }
+
+    bool ReplayCamera::openHeadless()
+    {
+        if (m_frameBytes == 0)
+        {
+            Log::error("Replay: invalid frame geometry");
+            return false;
+        }
+
+        if (!m_file.open(m_path))
+        {
+            Log::error(QString("Replay: failed to map %1").arg(QString::fromStdString(m_path)));
+            return false;
+        }
+
+        m_frameCount = m_file.size() / m_frameBytes;
+        if (m_frameCount == 0)
+        {
+            Log::error("Replay: file is smaller than one frame");
+            m_file.close();
+            return false;
+        }
+
+        if (m_file.size() % m_frameBytes != 0)
+        {
+            Log::warn(QString("Replay: %1 trailing bytes ignored, check width/height/bit depth")
+                          .arg(m_file.size() % m_frameBytes));
+        }
+
+        if (!loadTimestamps())
+        {
+            m_timestampsUs.clear();
+        }
+        return true;
+    }
+
+    bool ReplayCamera::openContainer()
+    {
+        if (!m_reader.open(m_path))
+        {
+            return false;
+        }
+
+        const raw::RawFileHeader &header = m_reader.header();
+        if (header.codec == raw::CodecDeltaPack)
+        {
+            // 编码的录像在播放线程里解码，图块分给线程池
+            if (!m_codec)
+            {
+                m_codecPool = std::make_unique<ThreadPool>();
+                m_codec = std::make_unique<FrameCodec>(m_codecPool.get());
+            }
+        }
+        else if (header.codec != raw::CodecNone)
+        {
+            Log::error(QString("Replay: unsupported codec %1").arg(header.codec));
+            m_reader.close();
+            return false;
+        }
+
+        if (m_reader.frameCount() == 0)
+        {
+            Log::error("Replay: recording contains no complete chunk");
+            m_reader.close();
+            return false;
+        }
+
+        // 尺寸和位深以文件为准
+        m_width = header.width;
+        m_height = header.height;
+        m_channels = header.channels;
+        m_bitDepth = header.bitDepth;
+        m_frameBytes = header.frameBytes;
+        m_frameCount = m_reader.frameCount();
+
+        m_timestampsUs.resize(m_frameCount);
+        for (size_t i = 0; i < m_frameCount; i++)
+        {
+            m_timestampsUs[i] = m_reader.entry(i).record.hostTimestampNs / 1000;
+        }
+        return true;
+    }
+
+    const unsigned char *ReplayCamera::frameData(size_t index) const
+    {
+        return m_container ? m_reader.entry(index).data : m_file.data() + index * m_frameBytes;
+    }
+
+    bool ReplayCamera::loadTimestamps()
+    {
+        std::ifstream file(m_path + ".timestamps");
+        if (!file)
+        {
+            return false;
+        }
+
+        m_timestampsUs.clear();
+        m_timestampsUs.reserve(m_frameCount);
+
+        int64_t value = 0;
+        while (m_timestampsUs.size() < m_frameCount && file >> value)
+        {
+            m_timestampsUs.push_back(value);
+        }
+
+        if (m_timestampsUs.size() != m_frameCount)
+        {
+            Log::warn(QString("Replay: %1 timestamps for %2 frames, falling back to fixed fps")
+                          .arg(m_timestampsUs.size())
+                          .arg(m_frameCount));
+            return false;
+        }
+        return true;
+    }
+
+    bool ReplayCamera::close()
+    {
+        if (!m_opened)
+            return true;
+
+        stop();
+
+        m_file.close();
+        m_reader.close();
+        m_opened = false;
+
+        notifyStateChanged("open", "false");
+        return true;
+    }
+
+    bool ReplayCamera::start()
+    {
+        if (!m_opened || m_thread)
+            return false;
+
+        m_framePool = FramePool::create(kFramePoolCapacity, m_frameBytes);
+        m_published = 0;
+        m_late = 0;
+        m_corrupt = 0;
+
+        m_streaming = true;
+        m_thread = std::make_unique<std::thread>(&ReplayCamera::playFunction, this);
+
+        Log::info(QString("Replay start, pacing %1").arg(pacingName(m_pacing)));
+        notifyStateChanged("stream", "true");
+        return true;
+    }
+
+    bool ReplayCamera::stop()
+    {
+        if (!m_thread)
+            return true;
+
+        // 非循环播放结束时线程已经自行退出并通知过界面
+        bool wasStreaming = m_streaming.exchange(false);
+        m_thread->join();
+        m_thread.reset();
+
+        Log::info(QString("Replay stop: published %1 late %2 corrupt %3")
+                      .arg(m_published.load())
+                      .arg(m_late.load())
+                      .arg(m_corrupt.load()));
+
+        for (const auto &stats : m_bus->statistics())
+        {
+            Log::info(QString("Replay frame bus [%1]: delivered %2 skipped %3 dropped %4")
+                          .arg(QString::fromStdString(stats.name))
+                          .arg(stats.delivered)
+                          .arg(stats.skipped)
+                          .arg(stats.dropped));
+        }
+
+        if (wasStreaming)
+        {
+            notifyStateChanged("stream", "false");
+        }
+        return true;
+    }
+
+    void ReplayCamera::playFunction()
+    {
+        using Clock = std::chrono::steady_clock;
+
+        Clock::time_point start = Clock::now();
+        int64_t scheduleUs = 0; // 当前帧相对 start 的计划时刻
+        size_t index = 0;
+
+        while (m_streaming)
+        {
+            if (index == m_frameCount)
+            {
+                if (!m_loop)
+                {
+                    break;
+                }
+
+                // 循环：下一轮接在上一轮最后一帧之后一个帧间隔
+                index = 0;
+            }
+
+            Pacing pacing = m_pacing;
+            double frameRate = m_frameRate > 0 ? m_frameRate.load() : 30.0;
+            int64_t periodUs = static_cast<int64_t>(1e6 / frameRate);
+
+            if (pacing != Pacing::AsFastAsPossible)
+            {
+                Clock::time_point due = start + std::chrono::microseconds(scheduleUs);
+                Clock::time_point now = Clock::now();
+                if (now < due)
+                {
+                    std::this_thread::sleep_until(due);
+                }
+                else if (now - due > std::chrono::microseconds(periodUs))
+                {
+                    m_late.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+
+            // 下一帧的计划时刻
+            auto advance = [&]()
+            {
+                bool useTimestamps = pacing == Pacing::Original && !m_timestampsUs.empty();
+                if (useTimestamps && index + 1 < m_frameCount)
+                {
+                    scheduleUs += m_timestampsUs[index + 1] - m_timestampsUs[index];
+                }
+                else
+                {
+                    scheduleUs += periodUs;
+                }
+
+                index++;
+            };
+
+            Frame frame = m_framePool->acquire(m_width, m_height, m_channels, m_bitDepth);
+            if (m_container && m_reader.header().codec != raw::CodecNone)
+            {
+                const RawReader::Entry &entry = m_reader.entry(index);
+                if (!m_codec->decode(entry.data, entry.record.storedBytes, frame.buffer(),
+                                     m_width, m_height, m_channels, m_bitDepth, frame.stride()))
+                {
+                    // 缓冲区只写了一部分，不能当成正常帧发布，丢掉这一帧
+                    Log::warn(QString("Replay: frame %1 failed to decode, dropped").arg(index));
+                    m_corrupt.fetch_add(1, std::memory_order_relaxed);
+                    advance();
+                    continue;
+                }
+            }
+            else
+            {
+                frame.fill(frameData(index));
+            }
+            frame.setSequenceNumber(Frame::nextSequenceNumber());
+
+            FrameMetadata &meta = frame.metadata();
+            meta.hostTimestampNs = FrameMetadata::now();
+            meta.stageNs[FrameMetadata::Grab] = meta.hostTimestampNs;
+            meta.deviceFrameCounter = index;
+            if (m_container)
+            {
+                // 录制时的曝光、增益和相机帧计数原样带出
+                const raw::RawFrameRecord &record = m_reader.entry(index).record;
+                meta.exposureUs = record.exposureUs;
+                meta.gain = record.gain;
+                meta.deviceFrameCounter = record.deviceFrameCounter;
+                meta.droppedGap = record.droppedGap;
+            }
+            meta.mark(FrameMetadata::Enqueue);
+
+            m_bus->publish(std::move(frame));
+            m_published.fetch_add(1, std::memory_order_relaxed);
+
+            advance();
+        }
+
+        // 播放结束（非循环）时通知界面
+        if (m_streaming.exchange(false))
+        {
+            Log::info("Replay reached end of file");
+            notifyStateChanged("stream", "false");
+        }
+    }
+
+    Frame ReplayCamera::acquireLatestFrame()
+    {
+        return m_subscription->acquire();
+    }
+
+    bool ReplayCamera::set(const std::string &name, double value)
+    {
+        if (name == "FrameRate" && value > 0)
+        {
+            m_frameRate = value;
+            return true;
+        }
+        return false;
+    }
+
+    bool ReplayCamera::set(const std::string &name, bool value)
+    {
+        if (name == "Loop")
+        {
+            m_loop = value;
+            return true;
+        }
+        return false;
+    }
+
+    bool ReplayCamera::set(const std::string &name, const std::string &value)
+    {
+        if (name == "Pacing")
+        {
+            Pacing pacing;
+            if (!parsePacing(value, pacing))
+            {
+                Log::error(QString("Replay: unknown pacing %1").arg(QString::fromStdString(value)));
+                return false;
+            }
+            m_pacing = pacing;
+            return true;
+        }
+        return false;
+    }
+
+    bool ReplayCamera::get(const std::string &name, int &value)
+    {
+        if (name == "width")
+        {
+            value = m_width;
+            return true;
+        }
+        else if (name == "height")
+        {
+            value = m_height;
+            return true;
+        }
+        else if (name == "FrameCount")
+        {
+            value = static_cast<int>(m_frameCount);
+            return true;
+        }
+        return false;
+    }
+
+    const char *ReplayCamera::pacingName(Pacing pacing)
+    {
+        switch (pacing)
+        {
+        case Pacing::Original:
+            return "original";
+        case Pacing::FixedFps:
+            return "fixed";
+        case Pacing::AsFastAsPossible:
+            return "max";
+        }
+        return "unknown";
+    }
+
+    bool ReplayCamera::parsePacing(const std::string &text, Pacing &pacing)
+    {
+        for (Pacing candidate : {Pacing::Original, Pacing::FixedFps, Pacing::AsFastAsPossible})
+        {
+            if (text == pacingName(candidate))
+            {
+                pacing = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+}
@@ -0,0 +1,103 @@
+#ifndef REPLAY_CAMERA_H
+#define REPLAY_CAMERA_H
+
+#include "ICamera.hpp"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Frame.h"
+#include "FrameBus.h"
+#include "FramePool.h"
+#include "MappedFile.h"
+#include "RawContainer.h"
+
+namespace lzx
+{
+    class FrameCodec;
+    class ThreadPool;
+
+    // 回放相机：把内存映射的原始录像按指定节奏发布到帧总线，用于可重复的吞吐和延迟测试。
+    // 默认发布到自己的总线，只驱动所在面板（代替 PlayerOne）；构造时传入全局总线则作为参考相机（代替海康），
+    // Mask 窗口和配对也从它取帧，不需要相机硬件就能跑完整的显示/Mask流水线。
+    // 文件格式：.hdrraw 容器（尺寸、位深和时间戳取自文件，支持编码的录像），
+    // 或无文件头的单通道帧序列（8位或16位小端，尺寸由构造参数给出），可选的同名 .timestamps 文件每行一个时间戳（us）
+    class ReplayCamera : public ICamera
+    {
+    public:
+        enum class Pacing
+        {
+            Original, // 按录制时的时间戳（没有时间戳文件时退化为固定帧率）
+            FixedFps, // 固定帧率
+            AsFastAsPossible // 不等待，测吞吐
+        };
+
+        // bus 为空时使用自己的帧总线；不为空时发布到这条总线，总线必须比相机活得久
+        ReplayCamera(const std::string &path, int width, int height, int bitDepth = 16, FrameBus *bus = nullptr);
+        virtual ~ReplayCamera();
+
+        virtual std::string label() override { return "Replay"; }
+        virtual bool open() override;
+        virtual bool close() override;
+        virtual bool start() override;
+        virtual bool stop() override;
+        virtual bool snap() override { return false; }
+        virtual bool streaming() override { return m_streaming; }
+        virtual Frame acquireLatestFrame() override;
+        virtual FrameBus *frameBus() override { return m_bus; }
+
+        // FrameRate (double), Loop (bool), Pacing (string: original / fixed / max)
+        virtual bool set(const std::string &name, double value) override;
+        virtual bool set(const std::string &name, bool value) override;
+        virtual bool set(const std::string &name, const std::string &value) override;
+        virtual bool get(const std::string &name, int &value) override;
+
+        static const char *pacingName(Pacing pacing);
+        static bool parsePacing(const std::string &text, Pacing &pacing);
+
+    private:
+        void playFunction();
+        bool loadTimestamps();
+        bool openHeadless();
+        bool openContainer();
+        const unsigned char *frameData(size_t index) const;
+
+        std::string m_path;
+        int m_width;
+        int m_height;
+        int m_channels = 1;
+        int m_bitDepth;
+        size_t m_frameBytes;
+        size_t m_frameCount = 0;
+
+        MappedFile m_file;
+        RawReader m_reader; // .hdrraw 容器
+        bool m_container = false;
+        std::unique_ptr<ThreadPool> m_codecPool; // 编码的录像才创建
+        std::unique_ptr<FrameCodec> m_codec;
+        std::vector<int64_t> m_timestampsUs; // 与帧一一对应，为空表示没有时间戳文件
+
+        std::atomic<Pacing> m_pacing{Pacing::Original};
+        std::atomic<double> m_frameRate{30.0};
+        std::atomic<bool> m_loop{true};
+
+        bool m_opened = false;
+        std::atomic<bool> m_streaming{false};
+        std::unique_ptr<std::thread> m_thread;
+
+        std::shared_ptr<FramePool> m_framePool;
+        std::unique_ptr<FrameBus> m_frameBus; // 没有传入总线时才创建
+        FrameBus *m_bus;                      // 实际发布的总线
+        std::unique_ptr<FrameBus::Subscription> m_subscription;
+
+        // 统计
+        std::atomic<uint64_t> m_published{0};
+        std::atomic<uint64_t> m_late{0};    // 落后计划时间超过一帧的次数
+        std::atomic<uint64_t> m_corrupt{0}; // 解码失败丢掉的帧
+    };
+}
+
+#endif
@@ -9,6 +9,29 @@ Settings::Settings()
     , referenceFlipX(false)  // 初始化布尔成员
     , flipY(false)           // 初始化布尔成员
     , referenceFlipY(false)  // 初始化布尔成员
+    , replayWidth(1024)
+    , replayHeight(768)
+    , replayBitDepth(16)
+    , replayPacing("original")
+    , replayFrameRate(30.0)
+    , replayLoop(true)
+    , replayAsReference(false)
+    , rawCompression(false)
+    , hikPixelFormat("Mono12Packed")
+    , demosaicMethod("bilinear")
+    , framePairing(false)
+    , pairingToleranceUs(2000.0)
+    , pairingOffsetUs(0.0)
+    , pboUpload(true)
+    , histogramRefreshRate(15)
+    , autoRangeLowPercent(0.1)
+    , autoRangeHighPercent(99.9)
+    , autoRangeSmoothingMs(300.0)
+    , autoRangeHysteresisPercent(1.0)
+    , autoExposureSaturationPercent(0.5)
+    , autoExposureBlackPercent(1.0)
+    , autoExposureIntervalMs(100)
+    , autoExposureMinFrameRate(20.0)
 {
     load();
 }
@@ -70,7 +93,213 @@ void Settings::setReferenceFlipY(bool flip) {
     save(); // 自动保存
 }
 
+QString Settings::getReplayFile() const {
+    return replayFile;
+}
+
+void Settings::setReplayFile(const QString& path) {
+    replayFile = path;
+    save(); // 自动保存
+}
+
+int Settings::getReplayWidth() const {
+    return replayWidth;
+}
+
+int Settings::getReplayHeight() const {
+    return replayHeight;
+}
+
+int Settings::getReplayBitDepth() const {
+    return replayBitDepth;
+}
+
+void Settings::setReplayGeometry(int width, int height, int bitDepth) {
+    replayWidth = width;
+    replayHeight = height;
+    replayBitDepth = bitDepth;
+    save(); // 自动保存
+}
+
+QString Settings::getReplayPacing() const {
+    return replayPacing;
+}
+
+void Settings::setReplayPacing(const QString& pacing) {
+    replayPacing = pacing;
+    save(); // 自动保存
+}
+
+double Settings::getReplayFrameRate() const {
+    return replayFrameRate;
+}
+
+void Settings::setReplayFrameRate(double fps) {
+    replayFrameRate = fps;
+    save(); // 自动保存
+}
+
+bool Settings::isReplayLoop() const {
+    return replayLoop;
+}
+
+void Settings::setReplayLoop(bool value) {
+    replayLoop = value;
+    save(); // 自动保存
+}
+
+bool Settings::isReplayAsReference() const {
+    return replayAsReference;
+}
+
+void Settings::setReplayAsReference(bool value) {
+    replayAsReference = value;
+    save(); // 自动保存
+}
+
+bool Settings::isRawCompression() const {
+    return rawCompression;
+}
+
+void Settings::setRawCompression(bool value) {
+    rawCompression = value;
+    save(); // 自动保存
+}
+
+bool Settings::isPboUpload() const {
+    return pboUpload;
+}
+
+void Settings::setPboUpload(bool value) {
+    pboUpload = value;
+    save(); // 自动保存
+}
+
+int Settings::getHistogramRefreshRate() const {
+    return histogramRefreshRate;
+}
+
+void Settings::setHistogramRefreshRate(int hz) {
+    histogramRefreshRate = hz;
+    save(); // 自动保存
+}
+
+double Settings::getAutoRangeLowPercent() const {
+    return autoRangeLowPercent;
+}
+
+void Settings::setAutoRangeLowPercent(double percent) {
+    autoRangeLowPercent = percent;
+    save(); // 自动保存
+}
+
+double Settings::getAutoRangeHighPercent() const {
+    return autoRangeHighPercent;
+}
+
+void Settings::setAutoRangeHighPercent(double percent) {
+    autoRangeHighPercent = percent;
+    save(); // 自动保存
+}
+
+double Settings::getAutoRangeSmoothingMs() const {
+    return autoRangeSmoothingMs;
+}
+
+void Settings::setAutoRangeSmoothingMs(double ms) {
+    autoRangeSmoothingMs = ms;
+    save(); // 自动保存
+}
+
+double Settings::getAutoRangeHysteresisPercent() const {
+    return autoRangeHysteresisPercent;
+}
+
+void Settings::setAutoRangeHysteresisPercent(double percent) {
+    autoRangeHysteresisPercent = percent;
+    save(); // 自动保存
+}
+
+double Settings::getAutoExposureSaturationPercent() const {
+    return autoExposureSaturationPercent;
+}
+
+void Settings::setAutoExposureSaturationPercent(double percent) {
+    autoExposureSaturationPercent = percent;
+    save(); // 自动保存
+}
+
+double Settings::getAutoExposureBlackPercent() const {
+    return autoExposureBlackPercent;
+}
+
+void Settings::setAutoExposureBlackPercent(double percent) {
+    autoExposureBlackPercent = percent;
+    save(); // 自动保存
+}
+
+int Settings::getAutoExposureIntervalMs() const {
+    return autoExposureIntervalMs;
+}
+
+void Settings::setAutoExposureIntervalMs(int ms) {
+    autoExposureIntervalMs = ms;
+    save(); // 自动保存
+}
+
+double Settings::getAutoExposureMinFrameRate() const {
+    return autoExposureMinFrameRate;
+}
+
+void Settings::setAutoExposureMinFrameRate(double fps) {
+    autoExposureMinFrameRate = fps;
+    save(); // 自动保存
+}
+
+QString Settings::getHikPixelFormat() const {
+    return hikPixelFormat;
+}
+
+void Settings::setHikPixelFormat(const QString& format) {
+    hikPixelFormat = format;
+    save(); // 自动保存
+}
+
+QString Settings::getDemosaicMethod() const {
+    return demosaicMethod;
+}
+
+void Settings::setDemosaicMethod(const QString& method) {
+    demosaicMethod = method;
+    save(); // 自动保存
+}
 
+bool Settings::isFramePairing() const {
+    return framePairing;
+}
+
+void Settings::setFramePairing(bool value) {
+    framePairing = value;
+    save(); // 自动保存
+}
+
+double Settings::getPairingToleranceUs() const {
+    return pairingToleranceUs;
+}
+
+void Settings::setPairingToleranceUs(double us) {
+    pairingToleranceUs = us;
+    save(); // 自动保存
+}
+
+double Settings::getPairingOffsetUs() const {
+    return pairingOffsetUs;
+}
+
+void Settings::setPairingOffsetUs(double us) {
+    pairingOffsetUs = us;
+    save(); // 自动保存
+}
 
 void Settings::save() {
     settings->setValue("defaultSavePath", defaultSavePath);
@@ -79,6 +308,30 @@ void Settings::save() {
     settings->setValue("referenceFlipX", referenceFlipX);
     settings->setValue("flipY", flipY);
     settings->setValue("referenceFlipY", referenceFlipY);
+    settings->setValue("replayFile", replayFile);
+    settings->setValue("replayWidth", replayWidth);
+    settings->setValue("replayHeight", replayHeight);
+    settings->setValue("replayBitDepth", replayBitDepth);
+    settings->setValue("replayPacing", replayPacing);
+    settings->setValue("replayFrameRate", replayFrameRate);
+    settings->setValue("replayLoop", replayLoop);
+    settings->setValue("replayAsReference", replayAsReference);
+    settings->setValue("rawCompression", rawCompression);
+    settings->setValue("hikPixelFormat", hikPixelFormat);
+    settings->setValue("demosaicMethod", demosaicMethod);
+    settings->setValue("framePairing", framePairing);
+    settings->setValue("pairingToleranceUs", pairingToleranceUs);
+    settings->setValue("pairingOffsetUs", pairingOffsetUs);
+    settings->setValue("pboUpload", pboUpload);
+    settings->setValue("histogramRefreshRate", histogramRefreshRate);
+    settings->setValue("autoRangeLowPercent", autoRangeLowPercent);
+    settings->setValue("autoRangeHighPercent", autoRangeHighPercent);
+    settings->setValue("autoRangeSmoothingMs", autoRangeSmoothingMs);
+    settings->setValue("autoRangeHysteresisPercent", autoRangeHysteresisPercent);
+    settings->setValue("autoExposureSaturationPercent", autoExposureSaturationPercent);
+    settings->setValue("autoExposureBlackPercent", autoExposureBlackPercent);
+    settings->setValue("autoExposureIntervalMs", autoExposureIntervalMs);
+    settings->setValue("autoExposureMinFrameRate", autoExposureMinFrameRate);
     settings->sync();
 }
 
@@ -89,5 +342,29 @@ void Settings::load() {
     referenceFlipX = settings->value("referenceFlipX", false).toBool();
     flipY = settings->value("flipY", false).toBool();
     referenceFlipY = settings->value("referenceFlipY", false).toBool();
+    replayFile = settings->value("replayFile", replayFile).toString();
+    replayWidth = settings->value("replayWidth", replayWidth).toInt();
+    replayHeight = settings->value("replayHeight", replayHeight).toInt();
+    replayBitDepth = settings->value("replayBitDepth", replayBitDepth).toInt();
+    replayPacing = settings->value("replayPacing", replayPacing).toString();
+    replayFrameRate = settings->value("replayFrameRate", replayFrameRate).toDouble();
+    replayLoop = settings->value("replayLoop", replayLoop).toBool();
+    replayAsReference = settings->value("replayAsReference", replayAsReference).toBool();
+    rawCompression = settings->value("rawCompression", rawCompression).toBool();
+    hikPixelFormat = settings->value("hikPixelFormat", hikPixelFormat).toString();
+    demosaicMethod = settings->value("demosaicMethod", demosaicMethod).toString();
+    framePairing = settings->value("framePairing", framePairing).toBool();
+    pairingToleranceUs = settings->value("pairingToleranceUs", pairingToleranceUs).toDouble();
+    pairingOffsetUs = settings->value("pairingOffsetUs", pairingOffsetUs).toDouble();
+    pboUpload = settings->value("pboUpload", pboUpload).toBool();
+    histogramRefreshRate = settings->value("histogramRefreshRate", histogramRefreshRate).toInt();
+    autoRangeLowPercent = settings->value("autoRangeLowPercent", autoRangeLowPercent).toDouble();
+    autoRangeHighPercent = settings->value("autoRangeHighPercent", autoRangeHighPercent).toDouble();
+    autoRangeSmoothingMs = settings->value("autoRangeSmoothingMs", autoRangeSmoothingMs).toDouble();
+    autoRangeHysteresisPercent = settings->value("autoRangeHysteresisPercent", autoRangeHysteresisPercent).toDouble();
+    autoExposureSaturationPercent = settings->value("autoExposureSaturationPercent", autoExposureSaturationPercent).toDouble();
+    autoExposureBlackPercent = settings->value("autoExposureBlackPercent", autoExposureBlackPercent).toDouble();
+    autoExposureIntervalMs = settings->value("autoExposureIntervalMs", autoExposureIntervalMs).toInt();
+    autoExposureMinFrameRate = settings->value("autoExposureMinFrameRate", autoExposureMinFrameRate).toDouble();
     
 }
\ No newline at end of file
@@ -36,6 +36,81 @@ public:
     bool isReferenceFlipY() const;
     void setReferenceFlipY(bool value);
 
+    // 回放录像（为空时使用 PlayerOne 相机）
+    QString getReplayFile() const;
+    void setReplayFile(const QString& path);
+
+    // 回放录像的帧尺寸和位深（原始文件没有文件头）
+    int getReplayWidth() const;
+    int getReplayHeight() const;
+    int getReplayBitDepth() const;
+    void setReplayGeometry(int width, int height, int bitDepth);
+
+    // 回放节奏：original / fixed / max
+    QString getReplayPacing() const;
+    void setReplayPacing(const QString& pacing);
+
+    // 回放固定帧率
+    double getReplayFrameRate() const;
+    void setReplayFrameRate(double fps);
+
+    // 回放是否循环
+    bool isReplayLoop() const;
+    void setReplayLoop(bool value);
+
+    // 回放录像作为参考相机（代替海康，驱动 Mask 窗口），否则代替 PlayerOne
+    bool isReplayAsReference() const;
+    void setReplayAsReference(bool value);
+
+    // 海康相机的像素格式：Mono8 / Mono10 / Mono10Packed / Mono12 / Mono12Packed / Mono16
+    QString getHikPixelFormat() const;
+    void setHikPixelFormat(const QString& format);
+
+    // PlayerOne 彩色相机的 Bayer 插值方法：bilinear / edge
+    QString getDemosaicMethod() const;
+    void setDemosaicMethod(const QString& method);
+
+    // 原始帧录像是否无损压缩
+    bool isRawCompression() const;
+    void setRawCompression(bool value);
+
+    // 参考/成像相机帧配对：是否开启、曝光中点之差的容差（us）、加到成像帧上的固定补偿（us）
+    bool isFramePairing() const;
+    void setFramePairing(bool value);
+    double getPairingToleranceUs() const;
+    void setPairingToleranceUs(double us);
+    double getPairingOffsetUs() const;
+    void setPairingOffsetUs(double us);
+
+    // 显示纹理经由 PBO 异步上传，关闭时直接从内存上传（兼容有问题的驱动）
+    bool isPboUpload() const;
+    void setPboUpload(bool value);
+
+    // 直方图显示的刷新率（Hz），相机帧率更高时两次刷新之间的直方图合并成一次
+    int getHistogramRefreshRate() const;
+    void setHistogramRefreshRate(int hz);
+
+    // 自动显示范围：黑白点取直方图的百分位（%），平滑时间常数（ms），滞回阈值（满量程的 %）
+    double getAutoRangeLowPercent() const;
+    void setAutoRangeLowPercent(double percent);
+    double getAutoRangeHighPercent() const;
+    void setAutoRangeHighPercent(double percent);
+    double getAutoRangeSmoothingMs() const;
+    void setAutoRangeSmoothingMs(double ms);
+    double getAutoRangeHysteresisPercent() const;
+    void setAutoRangeHysteresisPercent(double percent);
+
+    // 自动曝光：允许饱和/死黑的像素比例（%），两次写曝光的最小间隔（ms），
+    // 最低帧率（fps，曝光不超过它对应的帧间隔，0 表示只受相机范围限制）
+    double getAutoExposureSaturationPercent() const;
+    void setAutoExposureSaturationPercent(double percent);
+    double getAutoExposureBlackPercent() const;
+    void setAutoExposureBlackPercent(double percent);
+    int getAutoExposureIntervalMs() const;
+    void setAutoExposureIntervalMs(int ms);
+    double getAutoExposureMinFrameRate() const;
+    void setAutoExposureMinFrameRate(double fps);
+
     // 保存和加载设置
     void save();
     void load();
@@ -56,6 +131,30 @@ private:
     bool referenceFlipX;
     bool flipY;
     bool referenceFlipY;
+    QString replayFile;
+    int replayWidth;
+    int replayHeight;
+    int replayBitDepth;
+    QString replayPacing;
+    double replayFrameRate;
+    bool replayLoop;
+    bool replayAsReference;
+    bool rawCompression;
+    QString hikPixelFormat;
+    QString demosaicMethod;
+    bool framePairing;
+    double pairingToleranceUs;
+    double pairingOffsetUs;
+    bool pboUpload;
+    int histogramRefreshRate;
+    double autoRangeLowPercent;
+    double autoRangeHighPercent;
+    double autoRangeSmoothingMs;
+    double autoRangeHysteresisPercent;
+    double autoExposureSaturationPercent;
+    double autoExposureBlackPercent;
+    int autoExposureIntervalMs;
+    double autoExposureMinFrameRate;
 };
 
 #endif // SETTINGS_HPP
\ No newline at end of file
@@ -7,6 +7,9 @@
 #include <QPushButton>
 #include <QFileDialog>
 #include <QDialogButtonBox>
+
+#include <algorithm>
+
 SettingsDialog::SettingsDialog(QWidget *parent)
     : QDialog(parent)
 {
@@ -41,6 +44,186 @@ SettingsDialog::SettingsDialog(QWidget *parent)
     exposureLayout->addStretch(); // 添加弹性空间
     mainLayout->addLayout(exposureLayout);
 
+    // 海康相机像素格式，重新打开相机后生效
+    auto *pixelFormatLayout = new QHBoxLayout;
+    auto *pixelFormatLabel = new QLabel("海康像素格式：");
+    pixelFormatLabel->setFixedWidth(LABEL_WIDTH);
+    hikPixelFormatCombo = new QComboBox;
+    hikPixelFormatCombo->addItems({"Mono8", "Mono10", "Mono10Packed", "Mono12", "Mono12Packed", "Mono16"});
+    hikPixelFormatCombo->setFixedWidth(150);
+    hikPixelFormatCombo->setToolTip("10/12 位保留相机的全部动态范围，打包格式占用的 USB 带宽更少；重新打开相机后生效");
+    pixelFormatLayout->addWidget(pixelFormatLabel);
+    pixelFormatLayout->addWidget(hikPixelFormatCombo);
+    pixelFormatLayout->addStretch();
+    mainLayout->addLayout(pixelFormatLayout);
+
+    // PlayerOne 彩色相机的 Bayer 插值，重新打开相机后生效
+    auto *demosaicLayout = new QHBoxLayout;
+    auto *demosaicLabel = new QLabel("彩色插值：");
+    demosaicLabel->setFixedWidth(LABEL_WIDTH);
+    demosaicMethodCombo = new QComboBox;
+    demosaicMethodCombo->addItem("双线性", "bilinear");
+    demosaicMethodCombo->addItem("边缘自适应", "edge");
+    demosaicMethodCombo->setFixedWidth(150);
+    demosaicMethodCombo->setToolTip("边缘自适应的伪彩和锯齿更少，耗时约为双线性的两倍；只对彩色相机有效");
+    demosaicLayout->addWidget(demosaicLabel);
+    demosaicLayout->addWidget(demosaicMethodCombo);
+    demosaicLayout->addStretch();
+    mainLayout->addLayout(demosaicLayout);
+
+    // 原始帧录像压缩
+    auto *compressionLayout = new QHBoxLayout;
+    auto *compressionLabel = new QLabel("原始录像：");
+    compressionLabel->setFixedWidth(LABEL_WIDTH);
+    rawCompressionCheckBox = new QCheckBox("无损压缩（省磁盘带宽，多占 CPU）");
+    compressionLayout->addWidget(compressionLabel);
+    compressionLayout->addWidget(rawCompressionCheckBox);
+    compressionLayout->addStretch();
+    mainLayout->addLayout(compressionLayout);
+
+    // 参考/成像相机帧配对，下次成像相机开始取流时生效
+    auto *pairingLayout = new QHBoxLayout;
+    auto *pairingLabel = new QLabel("帧配对：");
+    pairingLabel->setFixedWidth(LABEL_WIDTH);
+    framePairingCheckBox = new QCheckBox("按曝光时刻配对参考帧与成像帧（统计输出到日志）");
+    pairingLayout->addWidget(pairingLabel);
+    pairingLayout->addWidget(framePairingCheckBox);
+    pairingLayout->addStretch();
+    mainLayout->addLayout(pairingLayout);
+
+    auto *pairingTimingLayout = new QHBoxLayout;
+    auto *pairingTimingLabel = new QLabel("容差/补偿(μs)：");
+    pairingTimingLabel->setFixedWidth(LABEL_WIDTH);
+    pairingToleranceSpinBox = new QDoubleSpinBox;
+    pairingToleranceSpinBox->setRange(1, 1000000);
+    pairingToleranceSpinBox->setDecimals(0);
+    pairingToleranceSpinBox->setFixedWidth(100);
+    pairingToleranceSpinBox->setToolTip("两帧曝光中点之差不超过容差才配成一对");
+    pairingOffsetSpinBox = new QDoubleSpinBox;
+    pairingOffsetSpinBox->setRange(-1000000, 1000000);
+    pairingOffsetSpinBox->setDecimals(0);
+    pairingOffsetSpinBox->setFixedWidth(100);
+    pairingOffsetSpinBox->setToolTip("加到成像帧曝光时刻上的固定补偿，可填日志中配对偏差的平均值的相反数");
+    pairingTimingLayout->addWidget(pairingTimingLabel);
+    pairingTimingLayout->addWidget(pairingToleranceSpinBox);
+    pairingTimingLayout->addWidget(pairingOffsetSpinBox);
+    pairingTimingLayout->addStretch();
+    mainLayout->addLayout(pairingTimingLayout);
+
+    // 显示纹理上传方式，重新打开显示窗口后生效
+    auto *uploadLayout = new QHBoxLayout;
+    auto *uploadLabel = new QLabel("纹理上传：");
+    uploadLabel->setFixedWidth(LABEL_WIDTH);
+    pboUploadCheckBox = new QCheckBox("经由 PBO 异步上传（显示卡顿或花屏时关闭）");
+    uploadLayout->addWidget(uploadLabel);
+    uploadLayout->addWidget(pboUploadCheckBox);
+    uploadLayout->addStretch();
+    mainLayout->addLayout(uploadLayout);
+
+    // 直方图显示的刷新率，重新打开灰度映射弹窗后生效
+    auto *histogramLayout = new QHBoxLayout;
+    auto *histogramLabel = new QLabel("直方图刷新：");
+    histogramLabel->setFixedWidth(LABEL_WIDTH);
+    histogramRefreshSpinBox = new QSpinBox;
+    histogramRefreshSpinBox->setRange(1, 60);
+    histogramRefreshSpinBox->setSuffix(" Hz");
+    histogramRefreshSpinBox->setFixedWidth(100);
+    histogramRefreshSpinBox->setToolTip("灰度映射弹窗里直方图的重绘频率，相机帧率更高时多余的直方图被合并");
+    histogramLayout->addWidget(histogramLabel);
+    histogramLayout->addWidget(histogramRefreshSpinBox);
+    histogramLayout->addStretch();
+    mainLayout->addLayout(histogramLayout);
+
+    // 自动显示范围，下次打开自动范围时生效
+    auto *autoRangeLayout = new QHBoxLayout;
+    auto *autoRangeLabel = new QLabel("自动范围(%)：");
+    autoRangeLabel->setFixedWidth(LABEL_WIDTH);
+    autoRangeLowSpinBox = new QDoubleSpinBox;
+    autoRangeLowSpinBox->setRange(0, 50);
+    autoRangeLowSpinBox->setDecimals(2);
+    autoRangeLowSpinBox->setSingleStep(0.1);
+    autoRangeLowSpinBox->setFixedWidth(100);
+    autoRangeLowSpinBox->setToolTip("黑点取直方图的这个百分位");
+    autoRangeHighSpinBox = new QDoubleSpinBox;
+    autoRangeHighSpinBox->setRange(50, 100);
+    autoRangeHighSpinBox->setDecimals(2);
+    autoRangeHighSpinBox->setSingleStep(0.1);
+    autoRangeHighSpinBox->setFixedWidth(100);
+    autoRangeHighSpinBox->setToolTip("白点取直方图的这个百分位");
+    autoRangeLayout->addWidget(autoRangeLabel);
+    autoRangeLayout->addWidget(autoRangeLowSpinBox);
+    autoRangeLayout->addWidget(autoRangeHighSpinBox);
+    autoRangeLayout->addStretch();
+    mainLayout->addLayout(autoRangeLayout);
+
+    auto *autoRangeTrackingLayout = new QHBoxLayout;
+    auto *autoRangeTrackingLabel = new QLabel("平滑(ms)/滞回(%)：");
+    autoRangeTrackingLabel->setFixedWidth(LABEL_WIDTH);
+    autoRangeSmoothingSpinBox = new QDoubleSpinBox;
+    autoRangeSmoothingSpinBox->setRange(0, 10000);
+    autoRangeSmoothingSpinBox->setDecimals(0);
+    autoRangeSmoothingSpinBox->setFixedWidth(100);
+    autoRangeSmoothingSpinBox->setToolTip("黑白点跟随场景变化的时间常数，0 表示不平滑");
+    autoRangeHysteresisSpinBox = new QDoubleSpinBox;
+    autoRangeHysteresisSpinBox->setRange(0, 20);
+    autoRangeHysteresisSpinBox->setDecimals(1);
+    autoRangeHysteresisSpinBox->setSingleStep(0.5);
+    autoRangeHysteresisSpinBox->setFixedWidth(100);
+    autoRangeHysteresisSpinBox->setToolTip("黑白点移动超过满量程的这个比例才更新 LUT，避免闪烁");
+    autoRangeTrackingLayout->addWidget(autoRangeTrackingLabel);
+    autoRangeTrackingLayout->addWidget(autoRangeSmoothingSpinBox);
+    autoRangeTrackingLayout->addWidget(autoRangeHysteresisSpinBox);
+    autoRangeTrackingLayout->addStretch();
+    mainLayout->addLayout(autoRangeTrackingLayout);
+
+    auto *autoExposureLayout = new QHBoxLayout;
+    auto *autoExposureLabel = new QLabel("自动曝光(%)：");
+    autoExposureLabel->setFixedWidth(LABEL_WIDTH);
+    autoExposureSaturationSpinBox = new QDoubleSpinBox;
+    autoExposureSaturationSpinBox->setRange(0, 20);
+    autoExposureSaturationSpinBox->setDecimals(2);
+    autoExposureSaturationSpinBox->setSingleStep(0.1);
+    autoExposureSaturationSpinBox->setFixedWidth(100);
+    autoExposureSaturationSpinBox->setToolTip("允许饱和的像素比例，曝光尽量加大到这个比例为止");
+    autoExposureBlackSpinBox = new QDoubleSpinBox;
+    autoExposureBlackSpinBox->setRange(0, 50);
+    autoExposureBlackSpinBox->setDecimals(2);
+    autoExposureBlackSpinBox->setSingleStep(0.1);
+    autoExposureBlackSpinBox->setFixedWidth(100);
+    autoExposureBlackSpinBox->setToolTip("允许死黑的像素比例，与饱和同时超标时两端折中");
+    autoExposureLayout->addWidget(autoExposureLabel);
+    autoExposureLayout->addWidget(autoExposureSaturationSpinBox);
+    autoExposureLayout->addWidget(autoExposureBlackSpinBox);
+    autoExposureLayout->addStretch();
+    mainLayout->addLayout(autoExposureLayout);
+
+    auto *autoExposureIntervalLayout = new QHBoxLayout;
+    auto *autoExposureIntervalLabel = new QLabel("曝光写入间隔：");
+    autoExposureIntervalLabel->setFixedWidth(LABEL_WIDTH);
+    autoExposureIntervalSpinBox = new QSpinBox;
+    autoExposureIntervalSpinBox->setRange(0, 5000);
+    autoExposureIntervalSpinBox->setSuffix(" ms");
+    autoExposureIntervalSpinBox->setFixedWidth(100);
+    autoExposureIntervalSpinBox->setToolTip("自动曝光两次写相机的最小间隔，另外还要等上次的曝光生效");
+    autoExposureIntervalLayout->addWidget(autoExposureIntervalLabel);
+    autoExposureIntervalLayout->addWidget(autoExposureIntervalSpinBox);
+    autoExposureIntervalLayout->addStretch();
+    mainLayout->addLayout(autoExposureIntervalLayout);
+
+    auto *autoExposureFrameRateLayout = new QHBoxLayout;
+    auto *autoExposureFrameRateLabel = new QLabel("曝光最低帧率：");
+    autoExposureFrameRateLabel->setFixedWidth(LABEL_WIDTH);
+    autoExposureMinFrameRateSpinBox = new QDoubleSpinBox;
+    autoExposureMinFrameRateSpinBox->setRange(0, 1000);
+    autoExposureMinFrameRateSpinBox->setDecimals(1);
+    autoExposureMinFrameRateSpinBox->setSuffix(" fps");
+    autoExposureMinFrameRateSpinBox->setFixedWidth(100);
+    autoExposureMinFrameRateSpinBox->setToolTip("自动曝光不超过这个帧率对应的帧间隔，暗场景下不会拖慢相机和 Mask 刷新；0 表示只受相机范围限制");
+    autoExposureFrameRateLayout->addWidget(autoExposureFrameRateLabel);
+    autoExposureFrameRateLayout->addWidget(autoExposureMinFrameRateSpinBox);
+    autoExposureFrameRateLayout->addStretch();
+    mainLayout->addLayout(autoExposureFrameRateLayout);
+
     // 添加一些垂直空间
     mainLayout->addSpacing(10);
 
@@ -63,6 +246,22 @@ SettingsDialog::SettingsDialog(QWidget *parent)
     auto &settings = Settings::getInstance();
     defaultSavePathEdit->setText(settings.getDefaultSavePath());
     defaultExposureTimeSpinBox->setValue(settings.getDefaultExposureTime());
+    rawCompressionCheckBox->setChecked(settings.isRawCompression());
+    hikPixelFormatCombo->setCurrentText(settings.getHikPixelFormat());
+    demosaicMethodCombo->setCurrentIndex(std::max(0, demosaicMethodCombo->findData(settings.getDemosaicMethod())));
+    framePairingCheckBox->setChecked(settings.isFramePairing());
+    pairingToleranceSpinBox->setValue(settings.getPairingToleranceUs());
+    pairingOffsetSpinBox->setValue(settings.getPairingOffsetUs());
+    pboUploadCheckBox->setChecked(settings.isPboUpload());
+    histogramRefreshSpinBox->setValue(settings.getHistogramRefreshRate());
+    autoRangeLowSpinBox->setValue(settings.getAutoRangeLowPercent());
+    autoRangeHighSpinBox->setValue(settings.getAutoRangeHighPercent());
+    autoRangeSmoothingSpinBox->setValue(settings.getAutoRangeSmoothingMs());
+    autoRangeHysteresisSpinBox->setValue(settings.getAutoRangeHysteresisPercent());
+    autoExposureSaturationSpinBox->setValue(settings.getAutoExposureSaturationPercent());
+    autoExposureBlackSpinBox->setValue(settings.getAutoExposureBlackPercent());
+    autoExposureIntervalSpinBox->setValue(settings.getAutoExposureIntervalMs());
+    autoExposureMinFrameRateSpinBox->setValue(settings.getAutoExposureMinFrameRate());
 }
 
 void SettingsDialog::browseDefaultSavePath()
@@ -83,6 +282,22 @@ void SettingsDialog::accept()
     auto &settings = Settings::getInstance();
     settings.setDefaultSavePath(defaultSavePathEdit->text());
     settings.setDefaultExposureTime(defaultExposureTimeSpinBox->value());
+    settings.setRawCompression(rawCompressionCheckBox->isChecked());
+    settings.setHikPixelFormat(hikPixelFormatCombo->currentText());
+    settings.setDemosaicMethod(demosaicMethodCombo->currentData().toString());
+    settings.setFramePairing(framePairingCheckBox->isChecked());
+    settings.setPairingToleranceUs(pairingToleranceSpinBox->value());
+    settings.setPairingOffsetUs(pairingOffsetSpinBox->value());
+    settings.setPboUpload(pboUploadCheckBox->isChecked());
+    settings.setHistogramRefreshRate(histogramRefreshSpinBox->value());
+    settings.setAutoRangeLowPercent(autoRangeLowSpinBox->value());
+    settings.setAutoRangeHighPercent(autoRangeHighSpinBox->value());
+    settings.setAutoRangeSmoothingMs(autoRangeSmoothingSpinBox->value());
+    settings.setAutoRangeHysteresisPercent(autoRangeHysteresisSpinBox->value());
+    settings.setAutoExposureSaturationPercent(autoExposureSaturationSpinBox->value());
+    settings.setAutoExposureBlackPercent(autoExposureBlackSpinBox->value());
+    settings.setAutoExposureIntervalMs(autoExposureIntervalSpinBox->value());
+    settings.setAutoExposureMinFrameRate(autoExposureMinFrameRateSpinBox->value());
     settings.save();
     QDialog::accept();
 }
\ No newline at end of file
@@ -4,6 +4,9 @@
 #include <QDialog>
 #include <QLineEdit>
 #include <QDoubleSpinBox>
+#include <QCheckBox>
+#include <QComboBox>
+#include <QSpinBox>
 
 class SettingsDialog : public QDialog
 {
@@ -19,6 +22,22 @@ private slots:
 private:
     QLineEdit *defaultSavePathEdit;
     QDoubleSpinBox *defaultExposureTimeSpinBox;
+    QCheckBox *rawCompressionCheckBox;
+    QCheckBox *pboUploadCheckBox;
+    QSpinBox *histogramRefreshSpinBox;
+    QDoubleSpinBox *autoRangeLowSpinBox;
+    QDoubleSpinBox *autoRangeHighSpinBox;
+    QDoubleSpinBox *autoRangeSmoothingSpinBox;
+    QDoubleSpinBox *autoRangeHysteresisSpinBox;
+    QDoubleSpinBox *autoExposureSaturationSpinBox;
+    QDoubleSpinBox *autoExposureBlackSpinBox;
+    QSpinBox *autoExposureIntervalSpinBox;
+    QDoubleSpinBox *autoExposureMinFrameRateSpinBox;
+    QComboBox *hikPixelFormatCombo;
+    QComboBox *demosaicMethodCombo;
+    QCheckBox *framePairingCheckBox;
+    QDoubleSpinBox *pairingToleranceSpinBox;
+    QDoubleSpinBox *pairingOffsetSpinBox;
 
     const int LABEL_WIDTH = 120;
 };
@@ -0,0 +1,196 @@
+#include "TextureUploadRing.h"
+
+#include <cstring>
+#include <QOpenGLContext>
+#include <QString>
+
+#include "logwidget.hpp"
+
+// GL 3.3 的头文件里没有 ARB_buffer_storage 的常量
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+namespace lzx
+{
+    void TextureUploadRing::initialize(QOpenGLFunctions_3_3_Core *f)
+    {
+        m_gl = f;
+
+        QOpenGLContext *context = QOpenGLContext::currentContext();
+        if (context && (context->hasExtension("GL_ARB_buffer_storage") || context->format().version() >= qMakePair(4, 4)))
+        {
+            m_bufferStorage = reinterpret_cast<BufferStorageFunction>(context->getProcAddress("glBufferStorage"));
+        }
+        m_persistent = m_bufferStorage != nullptr;
+
+        Log::info(QString("Texture upload: %1 PBOs, %2").arg(SlotCount).arg(m_persistent ? "persistent mapping" : "map per frame"));
+    }
+
+    void TextureUploadRing::release()
+    {
+        if (!m_gl)
+            return;
+
+        destroySlots();
+
+        if (m_stats.uploads > 0)
+        {
+            Log::info(QString("Texture upload: %1 frames via PBO, %2 busy, %3 reallocations")
+                          .arg(m_stats.uploads)
+                          .arg(m_stats.busy)
+                          .arg(m_stats.reallocs));
+        }
+        m_gl = nullptr;
+    }
+
+    void TextureUploadRing::destroySlots()
+    {
+        for (Slot &slot : m_slots)
+        {
+            if (slot.fence)
+            {
+                m_gl->glDeleteSync(slot.fence);
+                slot.fence = nullptr;
+            }
+            if (slot.buffer)
+            {
+                if (slot.mapped)
+                {
+                    m_gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+                    m_gl->glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+                    slot.mapped = nullptr;
+                }
+                m_gl->glDeleteBuffers(1, &slot.buffer);
+                slot.buffer = 0;
+            }
+        }
+        m_gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        m_capacity = 0;
+        m_next = 0;
+    }
+
+    bool TextureUploadRing::allocate(size_t bytes)
+    {
+        // 删除 PBO 前等 GPU 读完，只在帧变大时发生
+        for (Slot &slot : m_slots)
+        {
+            if (slot.fence)
+            {
+                m_gl->glClientWaitSync(slot.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 100000000);
+            }
+        }
+        destroySlots();
+
+        const GLbitfield persistentFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        for (Slot &slot : m_slots)
+        {
+            m_gl->glGenBuffers(1, &slot.buffer);
+            m_gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+            if (m_persistent)
+            {
+                m_bufferStorage(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, persistentFlags);
+                slot.mapped = static_cast<unsigned char *>(m_gl->glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes), persistentFlags));
+                if (!slot.mapped)
+                {
+                    // 持久映射失败时退回每帧映射
+                    Log::warn("Persistent PBO mapping failed, falling back to map per frame");
+                    m_persistent = false;
+                    destroySlots();
+                    return allocate(bytes);
+                }
+            }
+            else
+            {
+                m_gl->glBufferData(GL_PIXEL_UNPACK_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW);
+            }
+        }
+        m_gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        if (m_gl->glGetError() != GL_NO_ERROR)
+        {
+            Log::error("Allocate texture upload PBOs failed");
+            destroySlots();
+            return false;
+        }
+
+        m_capacity = bytes;
+        ++m_stats.reallocs;
+        return true;
+    }
+
+    bool TextureUploadRing::upload(GLuint texture, const FrameView &view, GLenum format, GLenum type, int alignment)
+    {
+        if (!m_gl || view.empty())
+            return false;
+
+        // PBO 里紧密排列，行长按 alignment 对齐
+        size_t rowBytes = static_cast<size_t>(view.width()) * view.bytesPerPixel();
+        size_t pitch = (rowBytes + alignment - 1) / alignment * alignment;
+        size_t bytes = pitch * view.height();
+
+        if (bytes > m_capacity && !allocate(bytes))
+            return false;
+
+        Slot &slot = m_slots[m_next];
+        if (slot.fence)
+        {
+            // 只检查，不等待：GPU 还在读这个 PBO 时本帧走直接上传
+            GLenum state = m_gl->glClientWaitSync(slot.fence, 0, 0);
+            if (state == GL_TIMEOUT_EXPIRED || state == GL_WAIT_FAILED)
+            {
+                ++m_stats.busy;
+                return false;
+            }
+            m_gl->glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+        }
+
+        m_gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, slot.buffer);
+
+        unsigned char *target = slot.mapped;
+        if (!target)
+        {
+            // fence 已经保证 GPU 读完了，不需要驱动再同步
+            target = static_cast<unsigned char *>(m_gl->glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, static_cast<GLsizeiptr>(bytes),
+                                                                         GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT));
+            if (!target)
+            {
+                m_gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+                return false;
+            }
+        }
+
+        if (view.stride() == pitch)
+        {
+            memcpy(target, view.data(), bytes);
+        }
+        else
+        {
+            for (int y = 0; y < view.height(); y++)
+            {
+                memcpy(target + y * pitch, view.row(y), rowBytes);
+            }
+        }
+
+        if (!slot.mapped)
+        {
+            m_gl->glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        }
+
+        m_gl->glBindTexture(GL_TEXTURE_2D, texture);
+        m_gl->glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+        m_gl->glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        m_gl->glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, view.width(), view.height(), format, type, nullptr);
+        m_gl->glBindTexture(GL_TEXTURE_2D, 0);
+        m_gl->glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        slot.fence = m_gl->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        m_next = (m_next + 1) % SlotCount;
+        ++m_stats.uploads;
+        return true;
+    }
+}
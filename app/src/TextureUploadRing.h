@@ -0,0 +1,74 @@
+#ifndef TEXTURE_UPLOAD_RING_H
+#define TEXTURE_UPLOAD_RING_H
+
+#include <QOpenGLFunctions_3_3_Core>
+#include <cstddef>
+#include <cstdint>
+
+#include "FrameView.h"
+
+namespace lzx
+{
+    // 纹理的流式上传：若干个像素缓冲区（PBO）轮流使用，每帧把像素写进一个空闲的 PBO，
+    // glTexSubImage2D 从 PBO 读取，由 GPU 异步完成拷贝，渲染线程不用等驱动同步拷贝整帧。
+    // 每个 PBO 上传后插入一个 fence，下次轮到它时只检查 fence，GPU 还没读完就返回 false，
+    // 由调用方退回直接上传，不会阻塞渲染线程。
+    // 驱动支持 GL_ARB_buffer_storage 时 PBO 持久映射，只在创建时映射一次；否则每帧
+    // glMapBufferRange（不同步，由 fence 保证 GPU 已经读完）。
+    // 只能在 OpenGL 上下文中使用，析构前需要在上下文中调用 release()。
+    class TextureUploadRing
+    {
+    public:
+        static constexpr int SlotCount = 3;
+
+        struct Statistics
+        {
+            uint64_t uploads = 0;   // 经由 PBO 上传的帧数
+            uint64_t busy = 0;      // 轮到的 PBO 还在被 GPU 读取，退回直接上传的帧数
+            uint64_t reallocs = 0;  // 因帧变大重建 PBO 的次数
+        };
+
+        TextureUploadRing() = default;
+        ~TextureUploadRing() = default;
+
+        // 在当前上下文中初始化，检测是否支持持久映射
+        void initialize(QOpenGLFunctions_3_3_Core *f);
+
+        // 删除 PBO 和 fence（需要上下文）
+        void release();
+
+        // 把视图上传到已分配存储、尺寸一致的纹理；format/type/alignment 与 glTexSubImage2D 相同
+        // 返回 false 时纹理没有更新，调用方应直接上传
+        bool upload(GLuint texture, const FrameView &view, GLenum format, GLenum type, int alignment);
+
+        bool persistent() const { return m_persistent; }
+        Statistics statistics() const { return m_stats; }
+
+    private:
+        TextureUploadRing(const TextureUploadRing &) = delete;
+        TextureUploadRing &operator=(const TextureUploadRing &) = delete;
+
+        using BufferStorageFunction = void(QOPENGLF_APIENTRYP)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+
+        struct Slot
+        {
+            GLuint buffer = 0;
+            GLsync fence = nullptr;
+            unsigned char *mapped = nullptr; // 持久映射的地址
+        };
+
+        bool allocate(size_t bytes);
+        void destroySlots();
+
+        QOpenGLFunctions_3_3_Core *m_gl = nullptr;
+        BufferStorageFunction m_bufferStorage = nullptr;
+        bool m_persistent = false;
+
+        Slot m_slots[SlotCount];
+        size_t m_capacity = 0; // 每个 PBO 的字节数
+        int m_next = 0;
+        Statistics m_stats;
+    };
+}
+
+#endif
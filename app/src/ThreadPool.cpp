@@ -0,0 +1,101 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+namespace lzx
+{
+    ThreadPool::ThreadPool(size_t threads)
+    {
+        if (threads == 0)
+        {
+            unsigned hardware = std::thread::hardware_concurrency();
+            threads = hardware > 1 ? hardware - 1 : 0;
+        }
+
+        for (size_t i = 0; i < threads; i++)
+        {
+            m_workers.emplace_back(&ThreadPool::workerFunction, this);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+
+        for (auto &worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)> &task)
+    {
+        if (count == 0)
+            return;
+
+        // 没有工作线程或只有一个任务时直接在调用线程执行
+        if (m_workers.empty() || count == 1)
+        {
+            for (size_t i = 0; i < count; i++)
+                task(i);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_task = &task;
+            m_count = count;
+            m_next.store(0, std::memory_order_relaxed);
+            m_busy = m_workers.size();
+            m_generation++;
+        }
+        m_wake.notify_all();
+
+        runTasks();
+
+        // 等所有工作线程都离开本次任务，task 的引用才能失效
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this]
+                    { return m_busy == 0; });
+        m_task = nullptr;
+    }
+
+    void ThreadPool::runTasks()
+    {
+        for (;;)
+        {
+            size_t index = m_next.fetch_add(1, std::memory_order_relaxed);
+            if (index >= m_count)
+                break;
+            (*m_task)(index);
+        }
+    }
+
+    void ThreadPool::workerFunction()
+    {
+        uint64_t seen = 0;
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [&]
+                            { return m_stop || m_generation != seen; });
+                if (m_stop)
+                    return;
+                seen = m_generation;
+            }
+
+            runTasks();
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (--m_busy == 0)
+                    m_done.notify_one();
+            }
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+namespace lzx
+{
+    // 固定线程数的工作线程池，只提供 parallelFor：把 [0, count) 分给工作线程和调用线程一起处理，
+    // 全部完成后返回。用于按图块并行的编解码、直方图等逐帧任务，同一时刻只允许一个 parallelFor
+    class ThreadPool
+    {
+    public:
+        // threads 为额外的工作线程数（调用线程也参与计算），0 表示按硬件核数减一
+        explicit ThreadPool(size_t threads = 0);
+        ~ThreadPool();
+
+        size_t workerCount() const { return m_workers.size(); }
+
+        void parallelFor(size_t count, const std::function<void(size_t)> &task);
+
+    private:
+        ThreadPool(const ThreadPool &) = delete;
+        ThreadPool &operator=(const ThreadPool &) = delete;
+
+        void workerFunction();
+        void runTasks();
+
+        std::vector<std::thread> m_workers;
+
+        std::mutex m_mutex;
+        std::condition_variable m_wake; // 新任务或退出
+        std::condition_variable m_done; // 所有工作线程离开当前任务
+        bool m_stop = false;
+        uint64_t m_generation = 0; // 每次 parallelFor 加一，工作线程据此判断是否有新任务
+        size_t m_busy = 0;         // 仍在处理当前任务的工作线程数
+
+        const std::function<void(size_t)> *m_task = nullptr;
+        size_t m_count = 0;
+        std::atomic<size_t> m_next{0};
+    };
+}
+
+#endif
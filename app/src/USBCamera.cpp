@@ -3,10 +3,22 @@
 
 #include "logwidget.hpp"
 #include "Global.hpp"
+#include "CameraProperty.h"
+#include "ClockMapper.h"
+#include "FramePool.h"
+#include "PixelConvert.h"
 
+#include <algorithm>
+#include <mutex>
 #include <sstream>
 
 static MV_CC_DEVICE_INFO_LIST stDeviceList;
+static std::mutex deviceListMutex; // 枚举在设备搜索对话框和各相机的命令线程上都可能发生
+
+// 帧池容量：全局总线的4个槽位，参考窗口、Mask窗口和自动曝光的订阅者各持有1帧，采集线程正在写入1帧；
+// 挂接录像、帧配对队列后按 FrameBus::retainedFrames() 加上余量扩容，余量是采集线程正在写入的帧和刚出队尚在处理的帧
+static constexpr size_t kFramePoolCapacity = 8;
+static constexpr size_t kFramePoolHeadroom = 2;
 
 std::string mvsErrorCode(int code)
 {
@@ -39,6 +51,8 @@ std::vector<std::string> EnumUSBDevices()
     std::vector<std::string> devicesInfo;
     int nRet = MV_OK;
 
+    std::lock_guard<std::mutex> lock(deviceListMutex);
+
     // Try to enum devices for maxAttempts times
     for (int attempt = 0; attempt < maxAttempts; ++attempt)
     {
@@ -70,46 +84,345 @@ std::vector<std::string> EnumUSBDevices()
     return devicesInfo;
 }
 
+// SDK 像素类型与 lzx::PixelFormat 的对应
+static bool fromMvsPixelType(MvGvspPixelType type, lzx::PixelFormat &format)
+{
+    switch (type)
+    {
+    case PixelType_Gvsp_Mono8:
+        format = lzx::PixelFormat::Mono8;
+        return true;
+    case PixelType_Gvsp_Mono10:
+        format = lzx::PixelFormat::Mono10;
+        return true;
+    case PixelType_Gvsp_Mono10_Packed:
+        format = lzx::PixelFormat::Mono10Packed;
+        return true;
+    case PixelType_Gvsp_Mono12:
+        format = lzx::PixelFormat::Mono12;
+        return true;
+    case PixelType_Gvsp_Mono12_Packed:
+        format = lzx::PixelFormat::Mono12Packed;
+        return true;
+    case PixelType_Gvsp_Mono16:
+        format = lzx::PixelFormat::Mono16;
+        return true;
+    default:
+        return false;
+    }
+}
+
+static MvGvspPixelType toMvsPixelType(lzx::PixelFormat format)
+{
+    switch (format)
+    {
+    case lzx::PixelFormat::Mono10:
+        return PixelType_Gvsp_Mono10;
+    case lzx::PixelFormat::Mono10Packed:
+        return PixelType_Gvsp_Mono10_Packed;
+    case lzx::PixelFormat::Mono12:
+        return PixelType_Gvsp_Mono12;
+    case lzx::PixelFormat::Mono12Packed:
+        return PixelType_Gvsp_Mono12_Packed;
+    case lzx::PixelFormat::Mono16:
+        return PixelType_Gvsp_Mono16;
+    default:
+        return PixelType_Gvsp_Mono8;
+    }
+}
+
 struct USBCamera::Impl
 {
     std::string label;
     int id = 0; // Device id default to 0 to open the first device
     void *handle = nullptr;
 
-    bool streaming = false;
-    bool lowLatencyMode = false;
+    std::atomic<bool> streaming{false}; // 命令线程写，采集线程、AE 线程、渲染线程和界面线程读
+    std::atomic<bool> lowLatencyMode{false}; // GUI线程切换，采集线程读取
     std::unique_ptr<std::thread> thread;
+    std::shared_ptr<lzx::FramePool> framePool;
+    std::unique_ptr<lzx::FrameBus::Subscription> subscription; // 参考窗口在全局总线上的订阅
+    lzx::PixelFormat pixelFormat = lzx::PixelFormat::Mono8;     // 打开时设置到相机，设置失败退回 Mono8
+    lzx::ClockMapper clockMapper;                               // 设备时间戳映射到主机时钟，每次取流重新估计
+    double deviceTicksPerSecond = 1e9;                          // USB3 Vision 的时间戳单位是 ns，GigE 相机从 GevTimestampTickFrequency 读取
+    lzx::PropertyRegistry *properties = nullptr;                // 指向 ICamera::propertyRegistry
+    lzx::ParameterEpoch parameterEpoch{lzx::ParameterEpoch::Confirm::Reported};
+    lzx::ParameterQueue parameterQueue; // 取流时提交的参数，由采集线程在两帧之间应用
+
+    // 打开时查询一次参数范围；ROI 的范围按整个传感器记录，偏移的上限在提交时按新的宽高限制
+    void queryProperties()
+    {
+        properties->clear();
 
-    // 不同于其他相机，海康相机采集数据还需要共享给Mask窗口，所以这里数据要放大全局变量的三缓冲区中
+        for (lzx::PropertyId id : {lzx::PropertyId::ExposureTime, lzx::PropertyId::Gain})
+        {
+            MVCC_FLOATVALUE stParam = {0};
+            int nRet = MV_CC_GetFloatValue(handle, lzx::PropertyRegistry::name(id), &stParam);
+            if (MV_OK != nRet)
+            {
+                Log::warn(QString("Get %1 range failed").arg(lzx::PropertyRegistry::name(id)));
+                continue;
+            }
+            properties->define(id, stParam.fMin, stParam.fMax, 0.0, stParam.fCurValue);
+        }
+
+        MVCC_INTVALUE widthMax = {0};
+        MVCC_INTVALUE heightMax = {0};
+        MVCC_INTVALUE width = {0};
+        MVCC_INTVALUE height = {0};
+        MVCC_INTVALUE offsetX = {0};
+        MVCC_INTVALUE offsetY = {0};
+        if (MV_OK != MV_CC_GetIntValue(handle, "WidthMax", &widthMax) ||
+            MV_OK != MV_CC_GetIntValue(handle, "HeightMax", &heightMax) ||
+            MV_OK != MV_CC_GetIntValue(handle, "Width", &width) ||
+            MV_OK != MV_CC_GetIntValue(handle, "Height", &height) ||
+            MV_OK != MV_CC_GetIntValue(handle, "OffsetX", &offsetX) ||
+            MV_OK != MV_CC_GetIntValue(handle, "OffsetY", &offsetY))
+        {
+            Log::warn("Get ROI range failed");
+            return;
+        }
+
+        properties->define(lzx::PropertyId::Width, width.nMin, widthMax.nCurValue, width.nInc, width.nCurValue);
+        properties->define(lzx::PropertyId::Height, height.nMin, heightMax.nCurValue, height.nInc, height.nCurValue);
+        properties->define(lzx::PropertyId::OffsetX, 0, widthMax.nCurValue - width.nMin, offsetX.nInc, offsetX.nCurValue);
+        properties->define(lzx::PropertyId::OffsetY, 0, heightMax.nCurValue - height.nMin, offsetY.nInc, offsetY.nCurValue);
+    }
+
+    // 按参数表限制范围；修改 ROI 时补全四个值，偏移加宽高不超出传感器
+    lzx::ParameterTransaction clampTransaction(const lzx::ParameterTransaction &transaction) const
+    {
+        lzx::ParameterTransaction target;
+        for (const auto &change : transaction.changes())
+        {
+            target.set(change.first, properties->clamp(change.first, change.second));
+        }
+
+        if (transaction.changesGeometry())
+        {
+            int width = static_cast<int>(target.value(lzx::PropertyId::Width, properties->value(lzx::PropertyId::Width)));
+            int height = static_cast<int>(target.value(lzx::PropertyId::Height, properties->value(lzx::PropertyId::Height)));
+            double x = target.value(lzx::PropertyId::OffsetX, properties->value(lzx::PropertyId::OffsetX));
+            double y = target.value(lzx::PropertyId::OffsetY, properties->value(lzx::PropertyId::OffsetY));
+            x = properties->clamp(lzx::PropertyId::OffsetX, std::min(x, properties->info(lzx::PropertyId::Width).max - width));
+            y = properties->clamp(lzx::PropertyId::OffsetY, std::min(y, properties->info(lzx::PropertyId::Height).max - height));
+            target.setRoi(static_cast<int>(x), static_cast<int>(y), width, height);
+        }
+        return target;
+    }
+
+    bool writeFloat(lzx::PropertyId id, double value)
+    {
+        int nRet = MV_CC_SetFloatValue(handle, lzx::PropertyRegistry::name(id), static_cast<float>(value));
+        if (MV_OK != nRet)
+        {
+            Log::error(QString("Set %1 failed (%2)").arg(lzx::PropertyRegistry::name(id)).arg(QString::fromStdString(mvsErrorCode(nRet))));
+            return false;
+        }
+        properties->update(id, value);
+        return true;
+    }
+
+    bool writeInt(lzx::PropertyId id, double value)
+    {
+        int nRet = MV_CC_SetIntValue(handle, lzx::PropertyRegistry::name(id), static_cast<unsigned int>(value));
+        if (MV_OK != nRet)
+        {
+            Log::error(QString("Set %1 failed (%2)").arg(lzx::PropertyRegistry::name(id)).arg(QString::fromStdString(mvsErrorCode(nRet))));
+            return false;
+        }
+        properties->update(id, value);
+        return true;
+    }
+
+    // 一个方向上的偏移和尺寸：新偏移加旧尺寸不越界时先写偏移，否则先写尺寸（此时尺寸一定是缩小的），
+    // 保证中间状态也在传感器范围内
+    bool writeAxis(lzx::PropertyId offsetId, lzx::PropertyId sizeId, double offset, double size, double sensorSize)
+    {
+        if (offset + properties->value(sizeId) <= sensorSize)
+        {
+            return writeInt(offsetId, offset) && writeInt(sizeId, size);
+        }
+        return writeInt(sizeId, size) && writeInt(offsetId, offset);
+    }
+
+    // 写入一组已经限制过范围的参数；在采集线程（取流时）或停止取流时调用
+    // 修改 ROI 需要暂停取流，海康相机取流期间不允许改宽高
+    bool applyParameters(const lzx::ParameterTransaction &transaction, uint64_t epoch)
+    {
+        bool ok = true;
+        if (transaction.has(lzx::PropertyId::ExposureTime))
+        {
+            ok = writeFloat(lzx::PropertyId::ExposureTime, transaction.value(lzx::PropertyId::ExposureTime)) && ok;
+        }
+        if (transaction.has(lzx::PropertyId::Gain))
+        {
+            ok = writeFloat(lzx::PropertyId::Gain, transaction.value(lzx::PropertyId::Gain)) && ok;
+        }
+
+        if (transaction.changesGeometry())
+        {
+            if (streaming)
+            {
+                MV_CC_StopGrabbing(handle);
+            }
+
+            ok = writeAxis(lzx::PropertyId::OffsetX, lzx::PropertyId::Width,
+                           transaction.value(lzx::PropertyId::OffsetX), transaction.value(lzx::PropertyId::Width),
+                           properties->info(lzx::PropertyId::Width).max) &&
+                 ok;
+            ok = writeAxis(lzx::PropertyId::OffsetY, lzx::PropertyId::Height,
+                           transaction.value(lzx::PropertyId::OffsetY), transaction.value(lzx::PropertyId::Height),
+                           properties->info(lzx::PropertyId::Height).max) &&
+                 ok;
+
+            if (streaming && MV_OK != MV_CC_StartGrabbing(handle))
+            {
+                Log::error("Restart grabbing after ROI change failed");
+                ok = false;
+            }
+        }
+
+        // 写入失败时不切换编号，之后的帧仍带旧编号
+        if (ok)
+        {
+            parameterEpoch.applied(epoch, transaction, lzx::FrameMetadata::now());
+        }
+        return ok;
+    }
+
+    // 把 pixelFormat 写到相机，只能在停止取流时调用
+    bool applyPixelFormat()
+    {
+        int nRet = MV_CC_SetEnumValue(handle, "PixelFormat", toMvsPixelType(pixelFormat));
+        if (MV_OK != nRet && pixelFormat != lzx::PixelFormat::Mono8)
+        {
+            Log::warn(QString("Set pixel format to %1 failed (%2), falling back to Mono8")
+                          .arg(lzx::PixelConvert::name(pixelFormat))
+                          .arg(QString::fromStdString(mvsErrorCode(nRet))));
+            pixelFormat = lzx::PixelFormat::Mono8;
+            nRet = MV_CC_SetEnumValue(handle, "PixelFormat", PixelType_Gvsp_Mono8);
+        }
+
+        if (MV_OK != nRet)
+        {
+            Log::error("Set pixel format failed");
+            return false;
+        }
+
+        Log::info(QString("Set pixel format to %1").arg(lzx::PixelConvert::name(pixelFormat)));
+        return true;
+    }
+
+    // 不同于其他相机，海康相机采集数据还需要共享给Mask窗口，所以这里数据要发布到全局总线上
     void grabFunction()
     {
         MV_FRAME_OUT stOutFrame = {0}; // 帧数据
 
-        size_t frameCount = 0;
+        uint64_t lastDeviceFrame = 0;
+        MvGvspPixelType lastUnsupported = PixelType_Gvsp_Undefined; // 不支持的格式只报一次
 
         while (streaming)
         {
+            // 两帧之间应用界面提交的参数
+            lzx::ParameterTransaction pending;
+            uint64_t pendingEpoch = 0;
+            if (parameterQueue.take(pending, pendingEpoch))
+            {
+                applyParameters(pending, pendingEpoch);
+            }
+
             int nRet = MV_CC_GetImageBuffer(this->handle, &stOutFrame, 1000);
 
             if (MV_OK == nRet)
             {
+                int64_t grabNs = lzx::FrameMetadata::now();
+
                 int width = stOutFrame.stFrameInfo.nWidth;
                 int height = stOutFrame.stFrameInfo.nHeight;
-                int channels = stOutFrame.stFrameInfo.nFrameLen / (width * height);
+                lzx::PixelFormat format;
 
-                if (stOutFrame.stFrameInfo.enPixelType == PixelType_Gvsp_Mono8)
+                if (fromMvsPixelType(stOutFrame.stFrameInfo.enPixelType, format))
                 {
-                    qDebug() << "PixelType_Gvsp_Mono8 Got";
-                    lzx::Frame frame(width, height, channels);
-                    frame.fill(stOutFrame.pBufAddr);
-
-                    frame.setSequenceNumber(frameCount++);
-
-                    GlobalResourceManager::getInstance().tripleBuffer->produce(std::move(frame));
+                    // 单色格式，10/12 位保留原始有效位数，放在 16 位存储的低位
+                    int bitDepth = lzx::PixelConvert::bitDepth(format);
+                    size_t srcBytes = stOutFrame.stFrameInfo.nFrameLen;
+
+                    // 图像尺寸只有拿到帧后才确定，尺寸变大或总线上挂接了新队列时重建帧池
+                    // SDK 的数据总要拷贝（或解包）一次，顺便把行首对齐到缓存行
+                    size_t stride = lzx::Frame::alignedStride(width, 1, bitDepth);
+                    size_t frameBytes = lzx::FramePool::frameBytes(width, height, 1, bitDepth, stride);
+                    size_t poolCapacity = std::max(kFramePoolCapacity,
+                                                   GlobalResourceManager::getInstance().frameBus->retainedFrames() + kFramePoolHeadroom);
+                    if (!framePool || framePool->bufferSize() < frameBytes || framePool->capacity() < poolCapacity)
+                    {
+                        framePool = lzx::FramePool::create(poolCapacity, frameBytes,
+                                                           frameBytes >= lzx::FramePool::HugePageThreshold);
+                    }
+
+                    lzx::FrameMetadata grabMeta;
+                    grabMeta.hostTimestampNs = grabNs;
+                    grabMeta.stageNs[lzx::FrameMetadata::Grab] = grabNs;
+                    grabMeta.exposureUs = stOutFrame.stFrameInfo.fExposureTime;
+                    grabMeta.gain = stOutFrame.stFrameInfo.fGain;
+                    grabMeta.deviceFrameCounter = stOutFrame.stFrameInfo.nFrameNum;
+                    grabMeta.parameterEpoch = parameterEpoch.tag(grabMeta, width, height);
+
+                    // 设备时间戳在曝光开始时锁存；到达时间减去曝光时间再拟合，曝光时间变化时映射关系不跳变
+                    uint64_t ticks = (static_cast<uint64_t>(stOutFrame.stFrameInfo.nDevTimeStampHigh) << 32) | stOutFrame.stFrameInfo.nDevTimeStampLow;
+                    if (ticks != 0)
+                    {
+                        int64_t deviceNs = static_cast<int64_t>(ticks * (1e9 / deviceTicksPerSecond));
+                        clockMapper.addSample(deviceNs, grabNs - static_cast<int64_t>(grabMeta.exposureUs * 1000.0));
+                        grabMeta.deviceTimestampNs = deviceNs;
+                        grabMeta.exposureStartNs = clockMapper.toHost(deviceNs);
+                    }
+
+                    // 低延迟模式：非打包格式的 SDK 缓冲区直接写进信箱，Mask窗口不经过帧池和总线
+                    bool packed = lzx::PixelConvert::isPacked(format);
+                    if (lowLatencyMode && !packed && srcBytes >= lzx::PixelConvert::rowBytes(format, width) * height)
+                    {
+                        lzx::FrameMetadata meta = grabMeta;
+                        meta.mark(lzx::FrameMetadata::Enqueue);
+                        GlobalResourceManager::getInstance().mailbox->write(lzx::FrameView(stOutFrame.pBufAddr, width, height, 1, bitDepth), meta);
+                    }
+
+                    lzx::Frame frame = framePool->acquire(width, height, 1, bitDepth, stride);
+                    if (!lzx::PixelConvert::toFrame(stOutFrame.pBufAddr, srcBytes, format, frame))
+                    {
+                        Log::error(QString("Hikvision %1 frame %2x%3 has only %4 bytes")
+                                       .arg(lzx::PixelConvert::name(format))
+                                       .arg(width)
+                                       .arg(height)
+                                       .arg(srcBytes));
+                        MV_CC_FreeImageBuffer(this->handle, &stOutFrame);
+                        continue;
+                    }
+
+                    frame.setSequenceNumber(lzx::Frame::nextSequenceNumber());
+
+                    // 帧信息来自SDK，曝光和增益是这一帧实际生效的值
+                    lzx::FrameMetadata &meta = frame.metadata();
+                    uint64_t deviceFrame = stOutFrame.stFrameInfo.nFrameNum;
+                    meta = grabMeta;
+                    meta.droppedGap = (lastDeviceFrame > 0 && deviceFrame > lastDeviceFrame + 1) ? deviceFrame - lastDeviceFrame - 1 : 0;
+                    lastDeviceFrame = deviceFrame;
+
+                    // 打包格式解包后再写信箱
+                    if (lowLatencyMode && packed)
+                    {
+                        lzx::FrameMetadata mailboxMeta = meta;
+                        mailboxMeta.mark(lzx::FrameMetadata::Enqueue);
+                        GlobalResourceManager::getInstance().mailbox->write(frame.view(), mailboxMeta);
+                    }
+
+                    meta.mark(lzx::FrameMetadata::Enqueue);
+                    GlobalResourceManager::getInstance().frameBus->publish(std::move(frame));
                 }
-                else
+                else if (stOutFrame.stFrameInfo.enPixelType != lastUnsupported)
                 {
-                    Log::error("Hikvision Unsupported pixel format");
+                    lastUnsupported = stOutFrame.stFrameInfo.enPixelType;
+                    Log::error(QString("Hikvision Unsupported pixel format 0x%1").arg(static_cast<unsigned>(lastUnsupported), 8, 16, QChar('0')));
                 }
             }
 
@@ -122,12 +435,16 @@ USBCamera::USBCamera(const std::string &label)
     : impl(std::make_unique<Impl>())
 {
     impl->label = label;
+    impl->properties = &propertyRegistry;
+    impl->subscription = GlobalResourceManager::getInstance().frameBus->subscribe("reference view");
 }
 
 USBCamera::USBCamera(int id)
     : impl(std::make_unique<Impl>())
 {
     impl->id = id;
+    impl->properties = &propertyRegistry;
+    impl->subscription = GlobalResourceManager::getInstance().frameBus->subscribe("reference view");
     Log::info(QString("Device %1 Instance Created.").arg(id).toStdString().c_str());
 }
 
@@ -143,19 +460,37 @@ std::string USBCamera::label()
 bool USBCamera::open()
 {
     // 自动枚举一次设备
-    if (stDeviceList.nDeviceNum == 0)
+    unsigned int deviceCount = 0;
+    {
+        std::lock_guard<std::mutex> lock(deviceListMutex);
+        deviceCount = stDeviceList.nDeviceNum;
+    }
+    if (deviceCount == 0)
     {
         EnumUSBDevices();
+    }
+
+    // 拷贝设备信息，之后别的线程重新枚举也不影响这里
+    MV_CC_DEVICE_INFO deviceInfo = {0};
+    bool found = false;
+    {
+        std::lock_guard<std::mutex> lock(deviceListMutex);
         if (stDeviceList.nDeviceNum == 0)
         {
             Log::error("No device found");
             return false;
         }
+
+        if (impl->id >= 0 && impl->id < static_cast<int>(stDeviceList.nDeviceNum) && stDeviceList.pDeviceInfo[impl->id])
+        {
+            deviceInfo = *stDeviceList.pDeviceInfo[impl->id];
+            found = true;
+        }
     }
 
-    if (impl->id >= 0 && impl->id < stDeviceList.nDeviceNum)
+    if (found)
     {
-        MV_CC_DEVICE_INFO *di = stDeviceList.pDeviceInfo[impl->id];
+        MV_CC_DEVICE_INFO *di = &deviceInfo;
 
         // Check handle is not null
         if (impl->handle != nullptr)
@@ -201,17 +536,11 @@ bool USBCamera::open()
             Log::info(QString("Pixel format: %1").arg(stParam.nCurValue).toStdString().c_str());
         }
 
-        // Set Default Pixel Format to Mono8
-        nRet = MV_CC_SetEnumValue(impl->handle, "PixelFormat", PixelType_Gvsp_Mono8);
-        if (MV_OK != nRet)
+        // 设置像素格式（默认 Mono8，可通过 set("PixelFormat") 在打开前指定）
+        if (!impl->applyPixelFormat())
         {
-            Log::error("Set pixel format failed");
             return false;
         }
-        else
-        {
-            Log::info("Set pixel format to Mono8");
-        }
 
         // 设置不控制帧率
         nRet = MV_CC_SetBoolValue(impl->handle, "AcquisitionFrameRateEnable", false);
@@ -375,29 +704,10 @@ bool USBCamera::open()
                           .c_str());
         }
 
-        // 获取初始曝光
-        {
-            MVCC_FLOATVALUE stParam = {0};
-            nRet = MV_CC_GetFloatValue(impl->handle, "ExposureTime", &stParam);
-            if (MV_OK != nRet)
-            {
-                Log::warn("Get exposure time failed");
-            }
-
-            notifyStateChanged("exposure", std::to_string(int(stParam.fCurValue)));
-        }
-
-        // 获取初始gain
-        {
-            MVCC_FLOATVALUE stParam = {0};
-            nRet = MV_CC_GetFloatValue(impl->handle, "Gain", &stParam);
-            if (MV_OK != nRet)
-            {
-                Log::warn("Get gain failed");
-            }
-
-            notifyStateChanged("gain", std::to_string(int(stParam.fCurValue)));
-        }
+        // 查询参数范围和初始值，之后读参数不再调用 SDK
+        impl->queryProperties();
+        notifyStateChanged("exposure", std::to_string(int(propertyRegistry.value(lzx::PropertyId::ExposureTime))));
+        notifyStateChanged("gain", std::to_string(int(propertyRegistry.value(lzx::PropertyId::Gain))));
 
         notifyStateChanged("open", "true");
 
@@ -457,6 +767,14 @@ bool USBCamera::start()
     }
     else
     {
+        // 停止取流期间留在队列里的参数，以及之前提交的参数都已生效
+        lzx::ParameterTransaction pending;
+        uint64_t pendingEpoch = 0;
+        if (impl->parameterQueue.take(pending, pendingEpoch))
+        {
+            impl->applyParameters(pending, pendingEpoch);
+        }
+        impl->parameterEpoch.reset();
 
         // 开启取流
         int nRet = MV_CC_StartGrabbing(impl->handle);
@@ -467,6 +785,15 @@ bool USBCamera::start()
             return false;
         }
 
+        // 时间戳频率，USB 相机没有这个节点时按 ns 处理
+        MVCC_INTVALUE_EX tickFrequency = {0};
+        impl->deviceTicksPerSecond = 1e9;
+        if (MV_OK == MV_CC_GetIntValueEx(impl->handle, "GevTimestampTickFrequency", &tickFrequency) && tickFrequency.nCurValue > 0)
+        {
+            impl->deviceTicksPerSecond = static_cast<double>(tickFrequency.nCurValue);
+        }
+        impl->clockMapper.reset();
+
         // 线程
         impl->streaming = true;
         impl->thread = std::make_unique<std::thread>(&Impl::grabFunction, impl.get());
@@ -494,6 +821,48 @@ bool USBCamera::stop()
             impl->thread.reset();
         }
 
+        if (impl->framePool)
+        {
+            auto stats = impl->framePool->statistics();
+            Log::info(QString("Hikvision frame pool: acquired %1 exhausted %2 oversized %3 high water %4/%5 huge pages %6")
+                          .arg(stats.acquired)
+                          .arg(stats.exhausted)
+                          .arg(stats.oversized)
+                          .arg(stats.highWater)
+                          .arg(stats.capacity)
+                          .arg(stats.hugePageBuffers));
+        }
+
+        lzx::ClockMapper::Estimate clock = impl->clockMapper.estimate();
+        if (clock.valid)
+        {
+            Log::info(QString("Hikvision clock: drift %1 ppm, jitter %2 us over %3 s, resets %4")
+                          .arg(clock.driftPpm, 0, 'f', 1)
+                          .arg(clock.jitterUs, 0, 'f', 0)
+                          .arg(clock.spanSeconds, 0, 'f', 1)
+                          .arg(clock.resets));
+        }
+
+        lzx::FrameMailbox::Statistics mailboxStats = GlobalResourceManager::getInstance().mailbox->statistics();
+        if (mailboxStats.writes > 0)
+        {
+            Log::info(QString("Hikvision mailbox: writes %1 reads %2 retries %3 waits %4 timeouts %5")
+                          .arg(mailboxStats.writes)
+                          .arg(mailboxStats.reads)
+                          .arg(mailboxStats.retries)
+                          .arg(mailboxStats.waits)
+                          .arg(mailboxStats.timeouts));
+        }
+
+        for (const auto &stats : GlobalResourceManager::getInstance().frameBus->statistics())
+        {
+            Log::info(QString("Hikvision frame bus [%1]: delivered %2 skipped %3 dropped %4")
+                          .arg(QString::fromStdString(stats.name))
+                          .arg(stats.delivered)
+                          .arg(stats.skipped)
+                          .arg(stats.dropped));
+        }
+
         // 停止取流
         if (impl->handle != nullptr)
         {
@@ -523,71 +892,77 @@ bool USBCamera::streaming()
     return impl->streaming;
 }
 
-bool USBCamera::getFrame(unsigned char *buffer, int &width, int &height, int &channels, int &bitDepth)
+lzx::Frame USBCamera::acquireLatestFrame()
 {
-    if (!buffer)
+    if (!impl->streaming)
     {
-        Log::error("Hikvision Invalid buffer pointer");
-        return false;
+        return lzx::Frame();
     }
 
-    if (impl->streaming)
-    {
-        lzx::Frame *frame = GlobalResourceManager::getInstance().tripleBuffer->consume();
+    // 共享缓冲区，不拷贝像素
+    return impl->subscription->acquire();
+}
 
-        if (frame && frame->width() > 0 && frame->height() > 0)
-        {
-            width = frame->width();
-            height = frame->height();
-            channels = frame->channels();
-            bitDepth = frame->bitDepth();
+lzx::FrameBus *USBCamera::frameBus()
+{
+    return GlobalResourceManager::getInstance().frameBus.get();
+}
 
-            auto sn = frame->sn();
-            if (sn > m_lastGotFrameCount)
-            {
-                m_lastGotFrameCount = sn;
-                memcpy(buffer, frame->buffer(), frame->bufferSize());
-                GlobalResourceManager::getInstance().tripleBuffer->consumeDone();
-                return true;
-            }
-        }
+uint64_t USBCamera::apply(const lzx::ParameterTransaction &transaction)
+{
+    if (impl->handle == nullptr)
+    {
+        Log::error("Handle is null");
+        return 0;
+    }
 
-        GlobalResourceManager::getInstance().tripleBuffer->consumeDone();
+    if (transaction.empty())
+    {
+        return impl->parameterEpoch.current();
     }
 
-    return false;
-}
+    lzx::ParameterTransaction target = impl->clampTransaction(transaction);
+    uint64_t epoch = impl->parameterEpoch.allocate();
 
-bool USBCamera::set(const std::string &name, double value)
-{
-    if (name == "ExposureTime" || name == "exposure")
+    if (impl->streaming)
     {
-        MVCC_FLOATVALUE stParam = {0};
-        stParam.fCurValue = value;
-        int nRet = MV_CC_SetFloatValue(impl->handle, "ExposureTime", stParam.fCurValue);
-        if (MV_OK != nRet)
+        // 不在界面线程上调用 SDK，交给采集线程在两帧之间应用
+        impl->parameterQueue.push(epoch, target);
+    }
+    else
+    {
+        lzx::ParameterTransaction pending;
+        uint64_t pendingEpoch = 0;
+        if (impl->parameterQueue.take(pending, pendingEpoch))
         {
-            Log::error("Set exposure time failed");
-            return false;
+            pending.merge(target);
+            target = pending;
         }
 
-        notifyStateChanged("exposure", std::to_string(int(value)));
+        if (!impl->applyParameters(target, epoch))
+        {
+            return 0;
+        }
+    }
 
-        return true;
+    if (target.has(lzx::PropertyId::ExposureTime))
+    {
+        notifyStateChanged("exposure", std::to_string(int(target.value(lzx::PropertyId::ExposureTime))));
     }
-    else if (name == "Gain" || name == "gain")
+    if (target.has(lzx::PropertyId::Gain))
     {
-        MVCC_FLOATVALUE stParam = {0};
-        stParam.fCurValue = value;
-        int nRet = MV_CC_SetFloatValue(impl->handle, "Gain", stParam.fCurValue);
-        if (MV_OK != nRet)
-        {
-            Log::error("Set Gain failed");
-            return false;
-        }
+        notifyStateChanged("gain", std::to_string(int(target.value(lzx::PropertyId::Gain))));
+    }
 
-        notifyStateChanged("gain", std::to_string(int(value)));
-        return true;
+    return epoch;
+}
+
+bool USBCamera::set(const std::string &name, double value)
+{
+    lzx::PropertyId id;
+    if (lzx::PropertyRegistry::parse(name, id))
+    {
+        return apply(lzx::ParameterTransaction().set(id, value)) != 0;
     }
     return false;
 }
@@ -610,92 +985,11 @@ bool USBCamera::set(const std::string &name, int value)
             return true;
         }
     }
-    else if (name == "Width")
-    {
-
-        int nRet = MV_CC_SetIntValue(impl->handle, "Width", value);
-        if (MV_OK != nRet)
-        {
-            Log::error("Set Width failed");
-            return false;
-        }
-        else
-        {
-            return true;
-        }
-    }
-    else if (name == "Height")
-    {
-        MVCC_INTVALUE stParam = {0};
-        stParam.nCurValue = value;
-        int nRet = MV_CC_SetIntValue(impl->handle, "Height", stParam.nCurValue);
-        if (MV_OK != nRet)
-        {
-            Log::error("Set Height failed");
-            return false;
-        }
-        else
-        {
-            return true;
-        }
-    }
-    else if (name == "OffsetX")
-    {
-
-        int nRet = MV_CC_SetIntValue(impl->handle, "OffsetX", value);
-        if (MV_OK != nRet)
-        {
-            Log::error("Set OffsetX failed");
-            return false;
-        }
-        else
-        {
-            return true;
-        }
-    }
-    else if (name == "OffsetY")
-    {
-
-        int nRet = MV_CC_SetIntValue(impl->handle, "OffsetY", value);
-        if (MV_OK != nRet)
-        {
-            Log::error("Set OffsetY failed");
-            return false;
-        }
-        else
-        {
-            return true;
-        }
-    }
 
-    if (name == "ExposureTime" || name == "exposure")
+    lzx::PropertyId id;
+    if (lzx::PropertyRegistry::parse(name, id))
     {
-        MVCC_FLOATVALUE stParam = {0};
-        stParam.fCurValue = value;
-        int nRet = MV_CC_SetFloatValue(impl->handle, "ExposureTime", stParam.fCurValue);
-        if (MV_OK != nRet)
-        {
-            Log::error("Set exposure time failed");
-            return false;
-        }
-
-        notifyStateChanged("exposure", std::to_string(int(value)));
-
-        return true;
-    }
-    else if (name == "Gain" || name == "gain")
-    {
-        MVCC_FLOATVALUE stParam = {0};
-        stParam.fCurValue = value;
-        int nRet = MV_CC_SetFloatValue(impl->handle, "Gain", stParam.fCurValue);
-        if (MV_OK != nRet)
-        {
-            Log::error("Set Gain failed");
-            return false;
-        }
-
-        notifyStateChanged("gain", std::to_string(int(value)));
-        return true;
+        return apply(lzx::ParameterTransaction().set(id, value)) != 0;
     }
 
     Log::error(QString("Unsupported  parameter: %1").arg(QString::fromStdString(name)));
@@ -707,18 +1001,9 @@ bool USBCamera::set(const std::string &name, bool value)
 {
     if (name == "LowLatencyMode")
     {
-        impl->lowLatencyMode = value; // 影响数据的去向
-
-        if (impl->lowLatencyMode)
-        {
-            // 关闭取流线程,但是不关闭取流,数据的获取将在OpenGL Window的loop中直接更新纹理，避免任何形式的Buffer的使用以降低延迟
-            if (impl->streaming)
-            {
-                impl->streaming = false;
-                impl->thread->join();
-                impl->thread.reset();
-            }
-        }
+        // 影响数据的去向：低延迟模式下采集线程同时把最新帧写进全局信箱，Mask窗口优先从信箱取帧
+        impl->lowLatencyMode = value;
+        Log::info(QString("Hikvision low latency mode: %1").arg(value ? "on" : "off"));
         return true;
     }
 
@@ -728,51 +1013,49 @@ bool USBCamera::set(const std::string &name, bool value)
 
 bool USBCamera::set(const std::string &name, const std::string &value)
 {
-
-    return false;
-}
-
-bool USBCamera::get(const std::string &name, double &value)
-{
-
-    int nRet = 0;
-    if (name == "ExposureTime")
+    if (name == "PixelFormat")
     {
-        MVCC_FLOATVALUE stParam = {0};
-        nRet = MV_CC_GetFloatValue(impl->handle, "ExposureTime", &stParam);
-        if (MV_OK != nRet)
+        lzx::PixelFormat format;
+        if (!lzx::PixelConvert::parse(value, format))
         {
-            Log::error("Get exposure time failed");
+            Log::error(QString("Unsupported pixel format: %1").arg(QString::fromStdString(value)));
             return false;
         }
-        else
-        {
-            value = stParam.fCurValue;
-            return true;
-        }
-    }
-    else if (name == "ResultingFrameRate")
-    {
-        MVCC_FLOATVALUE stParam = {0};
-        nRet = MV_CC_GetFloatValue(impl->handle, "ResultingFrameRate", &stParam);
-        if (MV_OK != nRet)
+
+        // 取流时相机不允许修改像素格式
+        if (impl->streaming)
         {
-            Log::error("Get ResultingFrameRate failed");
+            Log::error("Stop streaming before changing the pixel format");
             return false;
         }
-        else
+
+        impl->pixelFormat = format;
+        if (impl->handle != nullptr)
         {
-            value = stParam.fCurValue;
-            return true;
+            return impl->applyPixelFormat();
         }
+        return true;
     }
-    else if (name == "Gain")
+
+    return false;
+}
+
+bool USBCamera::get(const std::string &name, double &value)
+{
+    // 曝光和增益取参数表里最近写入的值，不调用 SDK
+    lzx::PropertyId id;
+    if (lzx::PropertyRegistry::parse(name, id) && propertyRegistry.available(id))
+    {
+        value = propertyRegistry.value(id);
+        return true;
+    }
+    else if (name == "ResultingFrameRate")
     {
         MVCC_FLOATVALUE stParam = {0};
-        nRet = MV_CC_GetFloatValue(impl->handle, "Gain", &stParam);
+        int nRet = MV_CC_GetFloatValue(impl->handle, "ResultingFrameRate", &stParam);
         if (MV_OK != nRet)
         {
-            Log::error("Get Gain failed");
+            Log::error("Get ResultingFrameRate failed");
             return false;
         }
         else
@@ -787,67 +1070,16 @@ bool USBCamera::get(const std::string &name, double &value)
 
 bool USBCamera::get(const std::string &name, int &value)
 {
-    int nRet = 0;
-
-    if (name == "Width")
+    lzx::PropertyId id;
+    if (lzx::PropertyRegistry::parse(name, id) && propertyRegistry.available(id))
     {
-        MVCC_INTVALUE stParam = {0};
-        nRet = MV_CC_GetIntValue(impl->handle, "Width", &stParam);
-        if (MV_OK != nRet)
-        {
-            Log::error("Get Width failed");
-            return false;
-        }
-        else
-        {
-            value = stParam.nCurValue;
-            return true;
-        }
-    }
-    else if (name == "Height")
-    {
-        MVCC_INTVALUE stParam = {0};
-        nRet = MV_CC_GetIntValue(impl->handle, "Height", &stParam);
-        if (MV_OK != nRet)
-        {
-            Log::error("Get Height failed");
-            return false;
-        }
-        else
-        {
-            value = stParam.nCurValue;
-            return true;
-        }
-    }
-    else if (name == "OffsetX")
-    {
-        MVCC_INTVALUE stParam = {0};
-        nRet = MV_CC_GetIntValue(impl->handle, "OffsetX", &stParam);
-        if (MV_OK != nRet)
-        {
-            Log::error("Get OffsetX failed");
-            return false;
-        }
-        else
-        {
-            value = stParam.nCurValue;
-            return true;
-        }
+        value = static_cast<int>(propertyRegistry.value(id));
+        return true;
     }
-    else if (name == "OffsetY")
+    else if (name == "BitDepth")
     {
-        MVCC_INTVALUE stParam = {0};
-        nRet = MV_CC_GetIntValue(impl->handle, "OffsetY", &stParam);
-        if (MV_OK != nRet)
-        {
-            Log::error("Get OffsetY failed");
-            return false;
-        }
-        else
-        {
-            value = stParam.nCurValue;
-            return true;
-        }
+        value = lzx::PixelConvert::bitDepth(impl->pixelFormat);
+        return true;
     }
 
     return false;
@@ -860,5 +1092,11 @@ bool USBCamera::get(const std::string &name, bool &value)
 
 bool USBCamera::get(const std::string &name, std::string &value)
 {
+    if (name == "PixelFormat")
+    {
+        value = lzx::PixelConvert::name(impl->pixelFormat);
+        return true;
+    }
+
     return false;
 }
@@ -0,0 +1,33 @@
+#include "WaitStrategy.h"
+
+namespace lzx
+{
+    const char *WaitStrategy::name(Kind kind)
+    {
+        switch (kind)
+        {
+        case Kind::Spin:
+            return "spin";
+        case Kind::SpinYield:
+            return "spin-yield";
+        case Kind::PredictiveSleep:
+            return "predictive";
+        case Kind::TimedWait:
+            return "timed";
+        }
+        return "unknown";
+    }
+
+    bool WaitStrategy::parse(const std::string &text, Kind &kind)
+    {
+        for (Kind candidate : {Kind::Spin, Kind::SpinYield, Kind::PredictiveSleep, Kind::TimedWait})
+        {
+            if (text == name(candidate))
+            {
+                kind = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+}
@@ -0,0 +1,205 @@
+#ifndef WAIT_STRATEGY_H
+#define WAIT_STRATEGY_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <cstdint>
+
+#include "Frame.h"
+
+namespace lzx
+{
+    // 采集线程等待“图像就绪”的策略
+    // 相机 SDK 只提供轮询接口（如 POAImageReady），轮询间隔直接决定拿到帧的延迟和抖动
+    class WaitStrategy
+    {
+    public:
+        enum class Kind
+        {
+            Spin,            // 纯轮询，延迟最低，占满一个核
+            SpinYield,       // 先轮询一段时间，再每次让出时间片
+            PredictiveSleep, // 根据曝光时间和实测帧间隔预测就绪时刻，提前睡眠，临近时再轮询
+            TimedWait        // 固定间隔睡眠轮询（原来的做法）
+        };
+
+        struct Result
+        {
+            bool ready = false;        // false 表示等待期间被要求停止
+            int64_t readyNs = 0;       // 首次观察到就绪的时刻
+            int64_t lastNotReadyNs = 0; // 最后一次观察到未就绪的时刻（第一次轮询就就绪时为0）
+            int polls = 0;             // 本帧的轮询次数
+
+            // 估计的就绪时刻：取两次观察的中点，第一次轮询就就绪时只能取观察时刻
+            int64_t estimatedReadyNs() const
+            {
+                return lastNotReadyNs ? lastNotReadyNs + (readyNs - lastNotReadyNs) / 2 : readyNs;
+            }
+        };
+
+        explicit WaitStrategy(Kind kind = Kind::TimedWait) : m_kind(kind) {}
+
+        void setKind(Kind kind) { m_kind.store(kind, std::memory_order_relaxed); }
+        Kind kind() const { return m_kind.load(std::memory_order_relaxed); }
+
+        // 曝光时间（us）：还没有实测帧间隔时用它预测，帧间隔不会短于它；变化时重新测量帧间隔
+        void setExposureHint(double exposureUs) { m_exposureHintUs.store(exposureUs, std::memory_order_relaxed); }
+
+        // TimedWait 的睡眠间隔
+        void setPollInterval(std::chrono::microseconds interval) { m_pollIntervalUs.store(interval.count(), std::memory_order_relaxed); }
+
+        static const char *name(Kind kind);
+        static bool parse(const std::string &text, Kind &kind);
+
+        // 等待 isReady() 返回 true；running() 返回 false 时放弃等待
+        template <typename IsReady, typename Running>
+        Result wait(IsReady isReady, Running running)
+        {
+            Result result;
+            Kind kind = this->kind();
+
+            if (kind == Kind::PredictiveSleep)
+            {
+                sleepUntilPredicted(running);
+            }
+
+            int64_t pollIntervalUs = m_pollIntervalUs.load(std::memory_order_relaxed);
+            int spins = 0;
+
+            while (running())
+            {
+                int64_t before = FrameMetadata::now();
+                result.polls++;
+                if (isReady())
+                {
+                    result.ready = true;
+                    result.readyNs = FrameMetadata::now();
+                    onReady(result.readyNs);
+                    return result;
+                }
+                result.lastNotReadyNs = before;
+
+                switch (kind)
+                {
+                case Kind::Spin:
+                    break;
+
+                case Kind::SpinYield:
+                case Kind::PredictiveSleep:
+                    // 预测的时刻附近短暂轮询，超过后退化为让出时间片
+                    if (++spins > SpinLimit)
+                        std::this_thread::yield();
+                    break;
+
+                case Kind::TimedWait:
+                    std::this_thread::sleep_for(std::chrono::microseconds(pollIntervalUs));
+                    break;
+                }
+            }
+
+            return result;
+        }
+
+        // 实测的帧间隔（us），还没有测到时返回 0
+        double measuredPeriodUs() const { return m_measuredPeriodUs.load(std::memory_order_relaxed); }
+
+        // 重新开始取流时清空预测状态
+        void reset()
+        {
+            m_lastReadyNs = 0;
+            m_periodUs = 0.0;
+            m_longRun = 0;
+            m_measuredPeriodUs.store(0.0, std::memory_order_relaxed);
+        }
+
+    private:
+        static constexpr int SpinLimit = 2000;                  // SpinYield 开始让出时间片之前的轮询次数
+        static constexpr int64_t WakeMarginNs = 2000000;        // 预测睡眠提前醒来的余量，覆盖系统定时器的误差
+        static constexpr double PeriodSmoothing = 0.1;          // 帧间隔的指数平滑系数
+        static constexpr int LongRunLimit = 3;                  // 连续这么多个一致的长间隔视为帧率变了，而不是丢帧
+        static constexpr double LongRunTolerance = 0.2;         // 长间隔之间的相对差别不超过这个比例才算一致
+
+        // 曝光改变后帧间隔随之改变，旧的估计作废（只在采集线程调用）
+        void checkExposureHint()
+        {
+            double hintUs = m_exposureHintUs.load(std::memory_order_relaxed);
+            if (hintUs != m_seededHintUs)
+            {
+                m_seededHintUs = hintUs;
+                m_periodUs = 0.0;
+                m_longRun = 0;
+            }
+        }
+
+        template <typename Running>
+        void sleepUntilPredicted(Running running)
+        {
+            checkExposureHint();
+            double periodUs = std::max(m_periodUs, m_seededHintUs);
+            if (m_lastReadyNs == 0 || periodUs <= 0)
+                return;
+
+            int64_t wakeNs = m_lastReadyNs + static_cast<int64_t>(periodUs * 1000.0) - WakeMarginNs;
+
+            // 分段睡眠，便于及时响应停止
+            while (running())
+            {
+                int64_t remainNs = wakeNs - FrameMetadata::now();
+                if (remainNs <= 0)
+                    break;
+                std::this_thread::sleep_for(std::chrono::nanoseconds(std::min<int64_t>(remainNs, 50000000)));
+            }
+        }
+
+        void onReady(int64_t readyNs)
+        {
+            checkExposureHint();
+            if (m_lastReadyNs > 0)
+            {
+                double intervalUs = (readyNs - m_lastReadyNs) / 1000.0;
+
+                // 丢帧或者暂停造成的长间隔不计入；连续几个一致的长间隔说明帧率确实变慢了，以它重新开始
+                if (m_periodUs <= 0)
+                {
+                    m_periodUs = intervalUs;
+                }
+                else if (intervalUs < m_periodUs * 3)
+                {
+                    m_periodUs += (intervalUs - m_periodUs) * PeriodSmoothing;
+                    m_longRun = 0;
+                }
+                else
+                {
+                    bool consistent = m_longRun > 0 && std::abs(intervalUs - m_longIntervalUs) <= m_longIntervalUs * LongRunTolerance;
+                    m_longRun = consistent ? m_longRun + 1 : 1;
+                    m_longIntervalUs = intervalUs;
+                    if (m_longRun >= LongRunLimit)
+                    {
+                        m_periodUs = intervalUs;
+                        m_longRun = 0;
+                    }
+                }
+            }
+            m_lastReadyNs = readyNs;
+            m_measuredPeriodUs.store(m_periodUs, std::memory_order_relaxed);
+        }
+
+        std::atomic<Kind> m_kind;
+        std::atomic<double> m_exposureHintUs{0.0};
+        std::atomic<int64_t> m_pollIntervalUs{1000};
+
+        std::atomic<double> m_measuredPeriodUs{0.0};
+
+        // 仅采集线程访问
+        int64_t m_lastReadyNs = 0;
+        double m_periodUs = 0.0;
+        double m_seededHintUs = 0.0; // 当前帧间隔估计所对应的曝光
+        int m_longRun = 0;           // 连续的长间隔个数
+        double m_longIntervalUs = 0.0;
+    };
+}
+
+#endif
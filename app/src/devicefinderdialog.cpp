@@ -12,7 +12,8 @@ DeviceFinderDialog::DeviceFinderDialog(QWidget *parent)
     : QDialog(parent),
       deviceList(new QListWidget(this)),
       searchButton(new QPushButton(tr("搜索"), this)),
-      selectionButton(new QPushButton(tr("选择"), this))
+      selectionButton(new QPushButton(tr("选择"), this)),
+      discoveryQueue(std::make_unique<lzx::CameraCommandQueue>("device discovery"))
 {
     QVBoxLayout *layout = new QVBoxLayout(this);
     layout->addWidget(deviceList);
@@ -32,6 +33,9 @@ DeviceFinderDialog::DeviceFinderDialog(QWidget *parent)
 
 DeviceFinderDialog::~DeviceFinderDialog()
 {
+    // 等正在进行的搜索结束，它的回调会投递到本对象
+    discoveryQueue.reset();
+
     delete deviceList;
     delete searchButton;
     delete selectionButton;
@@ -41,13 +45,25 @@ void DeviceFinderDialog::searchDevices()
 {
     // Clear the device list
     deviceList->clear();
-
-    // Enumerate USB devices and add them to the list
-    auto devices = EnumUSBDevices();
-    for (auto &device : devices)
-    {
-        deviceList->addItem(device.c_str());
-    }
+    searchButton->setEnabled(false);
+
+    // Enumerate USB devices on the discovery thread and add them to the list when done
+    auto devices = std::make_shared<std::vector<std::string>>();
+    discoveryQueue->submit(
+        "enumerate", [devices]()
+        {
+            *devices = EnumUSBDevices();
+            return !devices->empty(); },
+        [this, devices](bool)
+        {
+            QMetaObject::invokeMethod(this, [this, devices]()
+                                      {
+                for (auto &device : *devices)
+                {
+                    deviceList->addItem(device.c_str());
+                }
+                searchButton->setEnabled(true); }, Qt::QueuedConnection);
+        });
 }
 
 void DeviceFinderDialog::selectDevice()
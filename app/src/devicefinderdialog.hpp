@@ -5,6 +5,10 @@
 #include <QListWidget>
 #include <QPushButton>
 
+#include <memory>
+
+#include "CameraCommandQueue.h"
+
 class DeviceFinderDialog : public QDialog
 {
     Q_OBJECT
@@ -24,6 +28,7 @@ private:
     QListWidget *deviceList;
     QPushButton *searchButton;
     QPushButton *selectionButton;
+    std::unique_ptr<lzx::CameraCommandQueue> discoveryQueue; // 枚举设备可能要重试近一秒，不在界面线程上执行
 };
 
 #endif // DEVICEFINDERDIALOG_HPP
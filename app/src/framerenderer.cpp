@@ -13,13 +13,19 @@
 #include <QInputDialog>
 #include <QMediaFormat>
 #include <QMediaCaptureSession>
+#include <QWindow>
+
+#include <algorithm>
 
 #include "Global.hpp"
 
 #include "Settings.hpp"
 
 #include "logwidget.hpp"
+#include "PixelConvert.h"
 #include "polygonrenderer.hpp"
+#include "TextureUploadRing.h"
+#include "FramePool.h"
 
 static const char *basicVertexShader =
     "#version 330\n"
@@ -32,6 +38,8 @@ static const char *basicVertexShader =
     "    gl_Position = vec4(position, 0.0, 1.0);\n"
     "}\n";
 
+// justUseRed：单通道纹理把 r 复制到 rgb；valueScale：10/12 位数据放大到满量程；
+// LUT 对 rgb 三个通道分别查表，彩色图像也能做灰度映射。着色器源码只用 ASCII，部分驱动不接受其他字符
 static const char *basicFragmentShader =
     "#version 330\n"
     "uniform sampler2D tex;\n"
@@ -40,6 +48,7 @@ static const char *basicFragmentShader =
     "uniform vec4 canvasBoundary; // left right bottom top    \n"
     "uniform bool justUseRed;\n"
     "uniform bool useLut;\n"
+    "uniform float valueScale;\n"
     "uniform bool flipY;\n"
     "uniform bool flipX;\n"
     "in vec2 Texcoord;\n"
@@ -57,9 +66,12 @@ static const char *basicFragmentShader =
     "       textureCoord.x = 1.0 - textureCoord.x;\n"
     "   }\n"
     "   vec4 texColor = texture(tex,textureCoord);\n"
+    "   texColor.rgb = min(texColor.rgb * valueScale, vec3(1.0));\n"
     "   if(useLut)\n"
     "   {\n"
-    "       texColor = texture(lutTex, texColor.r);\n"
+    "       texColor.r = texture(lutTex, texColor.r).r;\n"
+    "       texColor.g = texture(lutTex, texColor.g).r;\n"
+    "       texColor.b = texture(lutTex, texColor.b).r;\n"
     "   }\n"
     "   if(justUseRed)\n"
     "   {\n"
@@ -289,12 +301,25 @@ struct FrameRenderer::Impl
     QOpenGLBuffer vbo;
     QOpenGLBuffer ebo;
 
+    bool justUseRed = true; // 当前纹理是单通道，显示时复制成灰度
+
+    // onFrameChanged(QImage) 转换后上传的 RGBA 数据，尺寸不变时复用
+    std::vector<unsigned char> imageUpload;
+
+    // 相机帧经由 PBO 上传，关闭或 PBO 忙时直接上传
+    lzx::TextureUploadRing uploadRing;
+    bool pboUpload = true;
+
+    // 拍照和录像的异步读回
+    lzx::ReadbackRing readback;
+
     // LUT相关
     GLuint lutTexture = 0;
     float lutMin = 0.0f;
     float lutMax = 65535.0f;
     float lutGamma = 1.0f;
     int lutBitDepth = 16;
+    float valueScale = 1.0f; // 16位纹理按 65535 归一化，有效位数不足16位时乘上这个系数
     bool needUpdateLut = false;
 
     // 中间层 FBO 相关
@@ -355,17 +380,8 @@ struct FrameRenderer::Impl
 
         for (int i = 0; i < lutSize; ++i)
         {
-            // 归一化
-            float x = static_cast<float>(i) / (lutSize - 1);
-
-            if (lutBitDepth == 16)
-            {
-                x *= 65535.0f;
-            }
-            else if (lutBitDepth == 8)
-            {
-                x *= 255.0f;
-            }
+            // 着色器里的采样值已按有效位数归一化，这里换算回原始灰度
+            float x = static_cast<float>(i) / (lutSize - 1) * ((1 << lutBitDepth) - 1);
 
             if (x < lutMin)
             {
@@ -420,6 +436,12 @@ struct FrameRenderer::Impl
     {
         owner.makeCurrent();
 
+        if (pboUpload)
+        {
+            uploadRing.initialize(&owner);
+        }
+        readback.initialize(&owner);
+
         // 创建和初始化 LUT 纹理
         owner.glGenTextures(1, &lutTexture);
         owner.glBindTexture(GL_TEXTURE_1D, lutTexture);
@@ -437,6 +459,7 @@ struct FrameRenderer::Impl
         shaderProgram->link();
         shaderProgram->bind();
         shaderProgram->setUniformValue("justUseRed", true);
+        shaderProgram->setUniformValue("valueScale", 1.0f);
 
         // 初始化默认纹理
         QImage image;
@@ -562,9 +585,9 @@ FrameRenderer::FrameRenderer(QWidget *parent, bool isReference)
     setFormat(format);
 
     impl->lastSize = this->size();
+    impl->pboUpload = Settings::getInstance().isPboUpload();
 
-    frameData.resize(2048 * 2048 * 4); // 足够大
-    m_fpsTimer.invalidate();           // 初始化计时器
+    m_fpsTimer.invalidate(); // 初始化计时器
 
     if (isReference)
     {
@@ -579,13 +602,67 @@ FrameRenderer::FrameRenderer(QWidget *parent, bool isReference)
         m_flipX = Settings::getInstance().isFlipX();
         m_flipY = Settings::getInstance().isFlipY();
     }
+
+    // 抓取到送显的延迟：交换缓冲区后才算真正显示
+    m_displayLatency = lzx::LatencyTracker::getInstance().histogram(isReference ? "reference grab-to-display" : "grab-to-display");
+    connect(this, &QOpenGLWidget::frameSwapped, this, [this]()
+            {
+        if (!m_presentPending)
+            return;
+
+        m_presentPending = false;
+        lzx::FrameMetadata &meta = m_currentFrame.metadata();
+        meta.mark(lzx::FrameMetadata::Present);
+        m_displayLatency->record(meta.elapsed(lzx::FrameMetadata::Grab, lzx::FrameMetadata::Present)); });
+
+    // 直方图在后台线程上统计和合并，写进发布通道，不经过界面线程的事件队列
+    m_histogramWorker = std::make_unique<lzx::HistogramWorker>([this](const lzx::HistogramEngine::Result &result)
+                                                               {
+        lzx::HistogramChannel::Snapshot &slot = m_histogramChannel->writeBuffer();
+        result.rebin(m_histogramBins, slot.bins);
+        slot.maxValue = result.maxValue;
+        m_histogramChannel->publish();
+
+        // 范围切换时才重新生成 LUT，在界面线程的 paintGL 里完成；
+        // 平滑按帧的时间戳折算，不受后台线程什么时候处理到这一帧影响
+        int64_t timestampNs = result.timestampNs ? result.timestampNs : lzx::FrameMetadata::now();
+        if (m_autoRangeEnabled && m_autoRange.update(result, timestampNs))
+        {
+            m_autoRangeChanged = true;
+            QMetaObject::invokeMethod(this, qOverload<>(&QWidget::update), Qt::QueuedConnection);
+        } },
+                                                               2);
 }
 
 FrameRenderer::~FrameRenderer()
 {
+    // 先注销到达通知，之后发布线程不会再访问本对象
+    logRenderStatistics();
+    m_frameNotifier.reset();
+
     // Make the OpenGL context current before cleaning up resources
     makeCurrent();
 
+    // 先执行完后台的拍照保存和视频帧填充，它们会访问本对象
+    collectReadbacks(true);
+    m_readbackWorker.reset();
+
+    lzx::HistogramWorker::Statistics histogramStats = m_histogramWorker->statistics();
+    m_histogramWorker.reset();
+    if (histogramStats.computed > 0)
+    {
+        lzx::HistogramChannel::Statistics channelStats = m_histogramChannel->statistics();
+        Log::info(QString("Histogram: %1 frames, %2 replaced before computing, average %3 ms, %4 displayed, %5 merged")
+                      .arg(histogramStats.computed)
+                      .arg(histogramStats.replaced)
+                      .arg(histogramStats.averageMs, 0, 'f', 3)
+                      .arg(channelStats.delivered)
+                      .arg(channelStats.coalesced));
+    }
+
+    impl->uploadRing.release();
+    impl->readback.release();
+
     // Clean up intermediate FBO resources
     if (impl->intermediateFBO)
     {
@@ -604,6 +681,9 @@ FrameRenderer::~FrameRenderer()
     m_captureSession.reset();
     m_frameInput.reset();
 
+    // 归还当前帧的租约
+    m_currentFrame.reset();
+
     // Clean up the impl pointer last
     delete impl;
 
@@ -635,12 +715,28 @@ void FrameRenderer::initializeGL()
 
 void FrameRenderer::paintGL()
 {
+    // 这次重绘会取走最新帧，之后到达的帧再发通知
+    if (m_frameNotifier)
+    {
+        m_frameNotifier->acknowledge();
+    }
+
     // 首先检查必要的资源是否存在
     if (!impl->shaderProgram || !impl->cameraTexture || !impl->vao.isCreated())
     {
         return;
     }
 
+    // 自动范围切换
+    if (m_autoRangeChanged.exchange(false) && m_autoRangeEnabled)
+    {
+        lzx::AutoRange::Range range = m_autoRange.range();
+        impl->lutMin = range.low;
+        impl->lutMax = range.high;
+        impl->needUpdateLut = true;
+        emit autoRangeChanged(range.low, range.high);
+    }
+
     // 更新LUT
     if (impl->needUpdateLut)
     {
@@ -653,10 +749,16 @@ void FrameRenderer::paintGL()
 
     if (associateCamera && associateCamera->streaming())
     {
-        int width, height, channels, bitDepth;
-        if (associateCamera->getFrame(frameData.data(), width, height, channels, bitDepth))
+        lzx::Frame frame = associateCamera->acquireLatestFrame();
+        if (!frame.empty())
         {
-            onFrameChangedDirectMode(frameData.data(), width, height, channels, bitDepth);
+            // 新帧到达后才归还上一帧的租约
+            m_currentFrame = std::move(frame);
+
+            onFrameChangedDirectMode(m_currentFrame.view());
+            calculateHistogram(m_currentFrame);
+            m_currentFrame.metadata().mark(lzx::FrameMetadata::TextureUpload);
+            m_presentPending = true;
             updateSuccess = true;
 
             // FPS 计算
@@ -664,6 +766,7 @@ void FrameRenderer::paintGL()
             {
                 m_fpsTimer.start();
                 m_lastFpsUpdate = 0;
+                m_lastLatencyLog = 0;
                 m_frameCount = 0;
             }
 
@@ -679,9 +782,31 @@ void FrameRenderer::paintGL()
                 m_frameCount = 0;
                 m_lastFpsUpdate = currentTime;
             }
+
+            // 定期输出延迟分位数，输出后清零，统计的是最近一个周期
+            if (currentTime - m_lastLatencyLog >= LATENCY_LOG_INTERVAL)
+            {
+                lzx::LatencyHistogram::Summary summary = m_displayLatency->summary();
+                if (summary.count > 0)
+                {
+                    Log::info(QString("Latency %1: p50 %2 ms p99 %3 ms max %4 ms (%5 frames)")
+                                  .arg(QString::fromStdString(summary.name))
+                                  .arg(summary.p50Us / 1000.0, 0, 'f', 2)
+                                  .arg(summary.p99Us / 1000.0, 0, 'f', 2)
+                                  .arg(summary.maxUs / 1000.0, 0, 'f', 2)
+                                  .arg(summary.count));
+                }
+                m_displayLatency->reset();
+                m_lastLatencyLog = currentTime;
+            }
         }
     }
 
+    if (updateSuccess)
+        ++m_busyFrames;
+    else
+        ++m_idleFrames;
+
     // 绘制到中间层FBO, 涉及图片的LUT映射
     if (updateSuccess)
     {
@@ -722,11 +847,14 @@ void FrameRenderer::paintGL()
                                              0.f,  // bottom
                                              1.f); // top
 
-        impl->shaderProgram->setUniformValue("flipY", m_flipY);
+        // 中间层按屏幕显示的方向从上到下存放，读回的像素不用再在 CPU 上翻转，上屏时再翻回来
+        impl->shaderProgram->setUniformValue("flipY", !m_flipY);
         impl->shaderProgram->setUniformValue("flipX", m_flipX);
 
         // 使用Lut
         impl->shaderProgram->setUniformValue("useLut", true);
+        impl->shaderProgram->setUniformValue("justUseRed", impl->justUseRed);
+        impl->shaderProgram->setUniformValue("valueScale", impl->valueScale);
 
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
@@ -734,77 +862,39 @@ void FrameRenderer::paintGL()
         impl->shaderProgram->release();
         impl->cameraTexture->release();
 
-        // 拍照
-        if (m_requestCapture)
+        // 拍照和录像：读回排进 PBO，完成后由后台线程编码，不等待 GPU
+        int64_t timestampNs = m_currentFrame.metadata().hostTimestampNs;
+        if (timestampNs == 0)
         {
-            m_requestCapture = false;
-
-            std::vector<unsigned char> data(impl->intermediateFBOSize.width() * impl->intermediateFBOSize.height() * 3);
-            glReadPixels(0, 0, impl->intermediateFBOSize.width(), impl->intermediateFBOSize.height(), GL_RGB, GL_UNSIGNED_BYTE, data.data());
-            QImage img(data.data(), impl->intermediateFBOSize.width(), impl->intermediateFBOSize.height(), QImage::Format_RGB888);
-            img.save(m_captureFileName);
+            timestampNs = lzx::FrameMetadata::now();
+        }
 
-            Log::info(QString("Capture saved to %1").arg(m_captureFileName));
+        if (m_requestCapture)
+        {
+            uint64_t tag = m_captureCount + 1;
+            if (impl->readback.request(impl->intermediateFBOSize.width(), impl->intermediateFBOSize.height(), GL_RGBA, tag, timestampNs))
+            {
+                m_requestCapture = false;
+                m_captureCount = tag;
+                m_pendingCaptures[tag] = m_captureFileName;
+            }
         }
 
-        // 录像
         if (m_isRecording)
         {
             // 检查是否应该发送新帧
             qint64 currentTime = QDateTime::currentMSecsSinceEpoch();
-            if (currentTime - m_lastFrameTime >= FRAME_INTERVAL)
+            if (currentTime - m_lastFrameTime >= FRAME_INTERVAL &&
+                impl->readback.request(impl->intermediateFBOSize.width(), impl->intermediateFBOSize.height(), GL_BGRA, 0, timestampNs))
             {
-                // 分配内存并读取像素
-                std::vector<unsigned char> data(impl->intermediateFBOSize.width() *
-                                                impl->intermediateFBOSize.height() * 4);
-
-                glReadPixels(0, 0, impl->intermediateFBOSize.width(),
-                             impl->intermediateFBOSize.height(),
-                             GL_BGRA, GL_UNSIGNED_BYTE, data.data());
-
-                // 垂直翻转图像
-                std::vector<unsigned char> flipped_data(data.size());
-                int stride = impl->intermediateFBOSize.width() * 4;
-                for (int y = 0; y < impl->intermediateFBOSize.height(); ++y)
-                {
-                    memcpy(flipped_data.data() + y * stride,
-                           data.data() + (impl->intermediateFBOSize.height() - 1 - y) * stride,
-                           stride);
-                }
-
-                // 创建视频帧
-                QVideoFrame videoFrame(
-                    QVideoFrameFormat(
-                        QSize(impl->intermediateFBOSize.width(), impl->intermediateFBOSize.height()),
-                        QVideoFrameFormat::Format_BGRA8888));
-
-                if (videoFrame.map(QVideoFrame::WriteOnly))
-                {
-                    // 复制图像数据
-                    memcpy(videoFrame.bits(0), flipped_data.data(), flipped_data.size());
-
-                    // 设置准确的时间戳
-                    qint64 presentationTime = m_recordingFrameCount *  13.8; // ms ， 13是为了满足72fps的要求
-                    videoFrame.setStartTime(presentationTime * 1000); // 转换为微秒
-                    // videoFrame.setEndTime((presentationTime + FRAME_INTERVAL) * 1000);
-
-                    videoFrame.unmap();
-
-                    // 发送帧
-                    if (!m_frameInput->sendVideoFrame(videoFrame))
-                    {
-                        Log::warn(QString("Failed to send video frame at time %1ms")
-                                      .arg(presentationTime));
-                    }
-                }
-
                 m_lastFrameTime = currentTime;
-
-                m_recordingFrameCount++;
             }
         }
     }
 
+    collectReadbacks(false);
+    sendEncodedFrames();
+
     // 切换回默认FBO
     glBindFramebuffer(GL_FRAMEBUFFER, defaultFramebufferObject());
     onAutoFit();
@@ -831,7 +921,9 @@ void FrameRenderer::paintGL()
 
         // 禁用LUT
         impl->shaderProgram->setUniformValue("useLut", false);
-        impl->shaderProgram->setUniformValue("flipY", false);
+        impl->shaderProgram->setUniformValue("justUseRed", false); // 中间层已经是 RGB
+        impl->shaderProgram->setUniformValue("valueScale", 1.0f);
+        impl->shaderProgram->setUniformValue("flipY", true); // 中间层是上下翻转存放的
         impl->shaderProgram->setUniformValue("flipX", false);
 
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
@@ -861,62 +953,73 @@ void FrameRenderer::paintGL()
         Log::error(QString("OpenGL Error occured in FrameRenderer paintGL: %1").arg(error));
     }
 
-    update();
+    // 不再无条件 update()：有新帧时由到达通知触发重绘；
+    // 还有读回没完成时不论是否在取流都稍后再重绘一次，停止取流前最后几帧的拍照和录像不会停在 PBO 里
+    if (impl->readback.pending())
+    {
+        QTimer::singleShot(1, this, qOverload<>(&QWidget::update));
+    }
 }
 
-void FrameRenderer::calculateHistogram(const unsigned char *data, int width, int height,
-                                       int channels, int bitDepth)
+void FrameRenderer::setAssociateCamera(lzx::ICamera *camera)
 {
-    if (!m_histogramEnabled || !data)
-        return;
+    m_frameNotifier.reset();
+    associateCamera = camera;
 
-    // 确定最大值
-    int maxPossibleValue = (bitDepth <= 8) ? 255 : 65535;
+    lzx::FrameBus *bus = camera ? camera->frameBus() : nullptr;
+    if (bus)
+    {
+        m_frameNotifier = std::make_unique<lzx::FrameNotifier>(bus, [this]()
+                                                               { QMetaObject::invokeMethod(this, [this]()
+                                                                                           { onFrameArrived(); }, Qt::QueuedConnection); });
+    }
+}
 
-    // 初始化直方图数组
-    std::vector<int> histogram(m_histogramBins, 0);
+void FrameRenderer::onFrameArrived()
+{
+    // 隐藏、最小化或被完全遮挡时不重绘，也不确认通知：之后到达的帧不再投递事件，
+    // 重新显示时 Qt 会补一次重绘，重绘时取最新帧并确认
+    if (!isOnScreen())
+    {
+        ++m_hiddenFrames;
+        return;
+    }
 
-    // 确定采样步长
-    int samplingStep = static_cast<int>(m_histogramSamplingMode);
+    update();
+}
 
-    // 计算bin的宽度
-    float binWidth = static_cast<float>(maxPossibleValue + 1) / m_histogramBins;
+bool FrameRenderer::isOnScreen() const
+{
+    if (!isVisible() || visibleRegion().isEmpty())
+        return false;
 
-    // 遍历图像数据
-    for (int y = 0; y < height; y += samplingStep)
-    {
-        for (int x = 0; x < width; x += samplingStep)
-        {
-            // 计算像素位置
-            int pixelPos = (y * width + x) * channels;
+    QWindow *handle = window()->windowHandle();
+    return !handle || handle->isExposed();
+}
 
-            // 获取像素值(只取第一个通道,通常是灰度值)
-            int pixelValue;
-            if (bitDepth <= 8)
-            {
-                pixelValue = data[pixelPos];
-            }
-            else
-            {
-                // 16位数据
-                unsigned short *data16 = (unsigned short *)data;
-                pixelValue = data16[pixelPos];
-            }
+void FrameRenderer::logRenderStatistics()
+{
+    if (m_busyFrames == 0 && m_idleFrames == 0)
+        return;
 
-            // 计算对应的bin索引
-            int binIndex = static_cast<int>(pixelValue / binWidth);
-            if (binIndex >= m_histogramBins)
-            {
-                binIndex = m_histogramBins - 1;
-            }
+    lzx::FrameNotifier::Statistics stats = m_frameNotifier ? m_frameNotifier->statistics() : lzx::FrameNotifier::Statistics();
+    Log::info(QString("Render %1: %2 busy, %3 idle, %4 deferred while hidden, %5 frames arrived, %6 notifications")
+                  .arg(m_isReference ? "reference" : "imaging")
+                  .arg(m_busyFrames)
+                  .arg(m_idleFrames)
+                  .arg(m_hiddenFrames)
+                  .arg(stats.arrived)
+                  .arg(stats.notified));
+}
 
-            // 增加计数
-            histogram[binIndex]++;
-        }
-    }
+void FrameRenderer::calculateHistogram(const lzx::Frame &frame)
+{
+    // 灰度映射弹窗关闭时，自动范围仍然需要直方图
+    if ((!m_histogramEnabled && !m_autoRangeEnabled) || frame.empty())
+        return;
 
-    // 发送信号
-    emit histogramCalculated(histogram, maxPossibleValue);
+    // 后台线程只算最新的一帧，来不及算的旧帧被替换
+    m_histogramWorker->submit(frame, static_cast<int>(m_histogramSamplingMode));
 }
 
 void FrameRenderer::wheelEvent(QWheelEvent *event)
@@ -967,10 +1070,36 @@ void FrameRenderer::wheelEvent(QWheelEvent *event)
 
 // 更新帧 (Direct模式)
 void FrameRenderer::onFrameChangedDirectMode(const unsigned char *data, int width, int height, int channels, int bitDepth)
+{
+    onFrameChangedDirectMode(lzx::FrameView(data, width, height, channels, bitDepth));
+
+    // 数据不归本对象持有，复制一份交给直方图线程
+    if (m_histogramEnabled || m_autoRangeEnabled)
+    {
+        lzx::Frame frame(width, height, channels, bitDepth);
+        frame.fill(data);
+        calculateHistogram(frame);
+    }
+}
+
+void FrameRenderer::onFrameChangedDirectMode(const lzx::FrameView &view)
 {
     bool needAutoFit = false;
 
-    impl->lutBitDepth = bitDepth;
+    int width = view.width();
+    int height = view.height();
+    int channels = view.channels();
+    int bitDepth = view.bitDepth();
+
+    // 有效位数变化时 LUT 和归一化系数都要跟着变
+    int effectiveBits = std::min(std::max(bitDepth, 8), 16);
+    if (impl->lutBitDepth != effectiveBits)
+    {
+        impl->lutBitDepth = effectiveBits;
+        impl->needUpdateLut = true;
+    }
+    impl->valueScale = effectiveBits > 8 ? 65535.0f / ((1 << effectiveBits) - 1) : 1.0f;
+    impl->justUseRed = channels < 3;
 
     // 重建纹理
     if (!impl->cameraTexture || QSize(impl->cameraTexture->width(), impl->cameraTexture->height()) != QSize(width, height) || m_isFirstUpdate)
@@ -1027,10 +1156,7 @@ void FrameRenderer::onFrameChangedDirectMode(const unsigned char *data, int widt
     }
 
     // 更新纹理
-    updateOpenGLTexture(impl->cameraTexture->textureId(), width, height, data, channels, bitDepth);
-
-    // 计算直方图
-    calculateHistogram(data, width, height, channels, bitDepth);
+    updateOpenGLTexture(impl->cameraTexture->textureId(), view);
 
     // 自适应大小
     needAutoFit ? onAutoFit() : void();
@@ -1109,6 +1235,7 @@ void FrameRenderer::onEnableUpdate(bool enable)
     else
     {
         enableUpdate = false;
+        logRenderStatistics();
     }
 }
 
@@ -1119,6 +1246,12 @@ void FrameRenderer::startRecording(QString filename)
 
     m_recordingFile = filename;
     m_recordingFrameCount = 0;
+    m_recordingStartNs = 0;
+    m_recordingDroppedBase = m_readbackWorker->dropped();
+    {
+        std::lock_guard<std::mutex> lock(m_encodedMutex);
+        m_encodedFrames.clear();
+    }
 
     m_recordingStartTime = QDateTime::currentMSecsSinceEpoch();
     m_lastFrameTime = m_recordingStartTime;
@@ -1164,6 +1297,14 @@ void FrameRenderer::stopRecording()
     if (!m_isRecording)
         return;
 
+    // 已经读回的帧都编码完、送进录像再停止
+    m_isRecording = false;
+    makeCurrent();
+    collectReadbacks(true);
+    doneCurrent();
+    m_readbackWorker->drain();
+    sendEncodedFrames();
+
     if (m_recorder)
     {
         m_recorder->stop();
@@ -1173,37 +1314,197 @@ void FrameRenderer::stopRecording()
     m_videoSink.reset();
     m_captureSession.reset();
     m_frameInput.reset();
-    m_isRecording = false;
 
-    Log::info(QString("Video saved to: %1").arg(m_recordingFile));
+    Log::info(QString("Video saved to: %1 (%2 frames, %3 dropped by the encoder thread)")
+                  .arg(m_recordingFile)
+                  .arg(m_recordingFrameCount)
+                  .arg(m_readbackWorker->dropped() - m_recordingDroppedBase));
+}
+
+void FrameRenderer::collectReadbacks(bool wait)
+{
+    impl->readback.collect([this](const lzx::FrameView &view, uint64_t tag, int64_t timestampNs)
+                           {
+        // 映射的 PBO 只在回调期间有效，拷贝进池里的帧后交给后台线程
+        size_t frameBytes = lzx::FramePool::frameBytes(view.width(), view.height(), 4, 8);
+        if (!m_readbackPool || m_readbackPool->bufferSize() < frameBytes)
+        {
+            m_readbackPool = lzx::FramePool::create(lzx::ReadbackRing::SlotCount + 4, frameBytes);
+        }
+        lzx::Frame copy = m_readbackPool->acquire(view.width(), view.height(), 4, 8);
+        copy.fill(view.data(), view.stride());
+
+        if (tag != 0)
+        {
+            QString fileName = m_pendingCaptures[tag];
+            m_pendingCaptures.erase(tag);
+            m_readbackWorker->submit([copy, fileName]()
+                                     {
+                QImage image(copy.data(), copy.width(), copy.height(), static_cast<qsizetype>(copy.stride()), QImage::Format_RGBA8888);
+                if (image.save(fileName))
+                    Log::info(QString("Capture saved to %1").arg(fileName));
+                else
+                    Log::error(QString("Save capture to %1 failed").arg(fileName)); },
+                                     false);
+            return;
+        }
+
+        // 视频帧的时间戳取相机抓取时刻，录像的节奏与相机一致
+        if (m_recordingStartNs == 0)
+        {
+            m_recordingStartNs = timestampNs;
+        }
+        qint64 startTimeUs = (timestampNs - m_recordingStartNs) / 1000;
+
+        bool queued = m_readbackWorker->submit([this, copy, startTimeUs]()
+                                               {
+            QVideoFrame videoFrame(QVideoFrameFormat(QSize(copy.width(), copy.height()), QVideoFrameFormat::Format_BGRA8888));
+            if (!videoFrame.map(QVideoFrame::WriteOnly))
+            {
+                Log::warn("Map video frame failed");
+                return;
+            }
+
+            // 视频帧的行可能有填充
+            size_t rowBytes = static_cast<size_t>(copy.width()) * 4;
+            for (int y = 0; y < copy.height(); y++)
+            {
+                memcpy(videoFrame.bits(0) + y * videoFrame.bytesPerLine(0), copy.data() + y * copy.stride(), rowBytes);
+            }
+            videoFrame.unmap();
+            videoFrame.setStartTime(startTimeUs);
+
+            std::lock_guard<std::mutex> lock(m_encodedMutex);
+            m_encodedFrames.push_back(videoFrame); },
+                                               true);
+        if (queued)
+        {
+            m_recordingFrameCount++;
+        } },
+                           wait);
+}
+
+void FrameRenderer::sendEncodedFrames()
+{
+    std::deque<QVideoFrame> frames;
+    {
+        std::lock_guard<std::mutex> lock(m_encodedMutex);
+        frames.swap(m_encodedFrames);
+    }
+
+    // QVideoFrameInput 属于界面线程，在这里送进录像
+    for (QVideoFrame &videoFrame : frames)
+    {
+        if (m_frameInput && !m_frameInput->sendVideoFrame(videoFrame))
+        {
+            Log::warn(QString("Failed to send video frame at time %1ms").arg(videoFrame.startTime() / 1000));
+        }
+    }
 }
 
 void FrameRenderer::onLutChanged(double min, double max, double gamma)
 {
     //   Log::info(QString("LUT changed: min %1, max %2, gamma %3").arg(min).arg(max).arg(gamma));
 
+    // 自动范围打开时黑白点由直方图决定，控件只调整 gamma
+    if (m_autoRangeEnabled)
+    {
+        min = impl->lutMin;
+        max = impl->lutMax;
+    }
+
+    // 自动范围移动黑白点后控件会把同样的值发回来，不重复生成 LUT
+    if (impl->lutMin == static_cast<float>(min) && impl->lutMax == static_cast<float>(max) && impl->lutGamma == static_cast<float>(gamma))
+        return;
+
     impl->lutMin = min;
     impl->lutMax = max;
     impl->lutGamma = gamma;
     impl->needUpdateLut = true;
 }
 
+void FrameRenderer::setAutoRangeEnabled(bool enabled)
+{
+    if (enabled)
+    {
+        auto &settings = Settings::getInstance();
+        lzx::AutoRange::Config config;
+        config.lowPercentile = settings.getAutoRangeLowPercent() / 100.0;
+        config.highPercentile = settings.getAutoRangeHighPercent() / 100.0;
+        config.timeConstantMs = settings.getAutoRangeSmoothingMs();
+        config.hysteresis = settings.getAutoRangeHysteresisPercent() / 100.0;
+        m_autoRange.setConfig(config);
+    }
+    else if (m_autoRangeEnabled)
+    {
+        lzx::AutoRange::Statistics stats = m_autoRange.statistics();
+        Log::info(QString("Auto range: %1 histograms, LUT regenerated %2 times").arg(stats.updates).arg(stats.changes));
+    }
+
+    m_autoRangeEnabled = enabled;
+    Log::info(QString("Auto range enabled: %1").arg(enabled ? "true" : "false"));
+}
+
 void FrameRenderer::onFrameChanged(const QImage &frame)
 {
     bool needAutoFit = false;
 
-    // 将 QImage 转换为 OpenGL 可以使用的格式
-    QImage glImage = frame.convertToFormat(QImage::Format_RGBA8888).mirrored(false, true);
+    // 转成 RGBA8888 并上下翻转（纹理原点在左下角），常见格式逐行直接转换，不经过临时 QImage
+    const int width = frame.width();
+    const int height = frame.height();
+    const size_t rowBytes = static_cast<size_t>(width) * 4;
+    impl->imageUpload.resize(rowBytes * height);
+    unsigned char *upload = impl->imageUpload.data();
+
+    auto convertRows = [&](const QImage &image, void (*convert)(const uint8_t *, uint8_t *, size_t))
+    {
+        for (int y = 0; y < height; y++)
+        {
+            convert(image.constScanLine(y), upload + (height - 1 - y) * rowBytes, width);
+        }
+    };
+
+    switch (frame.format())
+    {
+    case QImage::Format_RGB888:
+        convertRows(frame, lzx::PixelConvert::rgbToRgba);
+        break;
+    case QImage::Format_BGR888:
+        convertRows(frame, [](const uint8_t *src, uint8_t *dst, size_t pixels)
+                    {
+                        lzx::PixelConvert::rgbToRgba(src, dst, pixels);
+                        lzx::PixelConvert::rgbaToBgra(dst, dst, pixels); });
+        break;
+    case QImage::Format_RGBA8888:
+    case QImage::Format_RGBX8888:
+        lzx::PixelConvert::flipVertical(frame.constBits(), frame.bytesPerLine(), upload, rowBytes, rowBytes, height);
+        break;
+    case QImage::Format_RGB32:
+    case QImage::Format_ARGB32:
+        // 小端机器上内存顺序是 BGRA
+        convertRows(frame, lzx::PixelConvert::rgbaToBgra);
+        break;
+    case QImage::Format_Grayscale8:
+        convertRows(frame, lzx::PixelConvert::mono8ToRgba);
+        break;
+    default:
+    {
+        // 其余格式（预乘 alpha、16 位等）交给 Qt 转换
+        QImage rgba = frame.convertToFormat(QImage::Format_RGBA8888);
+        lzx::PixelConvert::flipVertical(rgba.constBits(), rgba.bytesPerLine(), upload, rowBytes, rowBytes, height);
+        break;
+    }
+    }
 
     // 检查 QImage 的大小是否改变
-    if (!impl->cameraTexture || QSize(impl->cameraTexture->width(), impl->cameraTexture->height()) != glImage.size())
+    if (!impl->cameraTexture || QSize(impl->cameraTexture->width(), impl->cameraTexture->height()) != frame.size())
     {
         // 删除旧的纹理
         delete impl->cameraTexture;
 
         // 创建一个新的纹理
         impl->cameraTexture = new QOpenGLTexture(QOpenGLTexture::Target2D);
-        impl->cameraTexture->setSize(glImage.width(), glImage.height());
+        impl->cameraTexture->setSize(width, height);
         impl->cameraTexture->setFormat(QOpenGLTexture::RGBA8_UNorm);
         impl->cameraTexture->setWrapMode(QOpenGLTexture::ClampToBorder);
         impl->cameraTexture->setBorderColor(QColor(Qt::black));
@@ -1213,12 +1514,12 @@ void FrameRenderer::onFrameChanged(const QImage &frame)
 
         needAutoFit = true;
         // 将 QImage 上传到 GPU
-        impl->cameraTexture->setData(0, QOpenGLTexture::RGBA, QOpenGLTexture::UInt8, glImage.constBits());
+        impl->cameraTexture->setData(0, QOpenGLTexture::RGBA, QOpenGLTexture::UInt8, upload);
     }
     else
     {
         // 使用子图像方式上传到GPU
-        impl->cameraTexture->setData(0, 0, QOpenGLTexture::RGBA, QOpenGLTexture::UInt8, glImage.constBits());
+        impl->cameraTexture->setData(0, 0, QOpenGLTexture::RGBA, QOpenGLTexture::UInt8, upload);
     }
 
     // 自适应大小
@@ -1534,9 +1835,15 @@ void FrameRenderer::resizeGL(int width, int height)
 }
 
 // 更新纹理内容
-void FrameRenderer::updateOpenGLTexture(GLuint textureID, int width, int height, const GLubyte *data, int channels, int bitDepth)
+void FrameRenderer::updateOpenGLTexture(GLuint textureID, const lzx::FrameView &view)
 {
-    if (!data || width <= 0 || height <= 0)
+    int width = view.width();
+    int height = view.height();
+    int channels = view.channels();
+    int bitDepth = view.bitDepth();
+    const GLubyte *data = view.data();
+
+    if (view.empty() || !view.isRowContiguous())
     {
         Log::error("Invalid texture update parameters");
         return;
@@ -1599,10 +1906,40 @@ void FrameRenderer::updateOpenGLTexture(GLuint textureID, int width, int height,
     else if (bytesPerPixel % 2 == 0)
         alignment = 2;
 
+    // 优先经由 PBO 上传：渲染线程只拷贝进映射的缓冲区，传输由 GPU 异步完成
+    if (impl->pboUpload && impl->uploadRing.upload(textureID, view, format, type, alignment))
+    {
+        GLenum error = glGetError();
+        if (error != GL_NO_ERROR)
+        {
+            Log::error(QString("OpenGL Error in PBO texture upload: %1, disabling PBO upload").arg(error));
+            impl->uploadRing.release();
+            impl->pboUpload = false;
+        }
+        return;
+    }
+
     glBindTexture(GL_TEXTURE_2D, textureID);
 
-    // 然后更新纹理数据
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, type, data);
+    // 行间距不是像素大小的整数倍时无法用 ROW_LENGTH 描述，只能逐行上传
+    bool strideInPixels = view.stride() % bytesPerPixel == 0;
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+    if (strideInPixels)
+    {
+        // 带行填充或ROI的视图直接上传，不需要先拷贝成紧密排列
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, static_cast<GLint>(view.stride() / bytesPerPixel));
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, type, data);
+    }
+    else
+    {
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        for (int y = 0; y < height; y++)
+        {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y, width, 1, format, type, view.row(y));
+        }
+    }
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
 
     glBindTexture(GL_TEXTURE_2D, 0);
 
@@ -10,9 +10,22 @@
 #include "ICamera.hpp"
 
 #include "ICamera.hpp"
-#include "TripleBuffer.h"
+#include "FrameBus.h"
+#include "FrameNotifier.h"
 #include "Frame.h"
 #include "Common.h"
+#include "LatencyStats.h"
+#include "FrameReadback.h"
+#include "HistogramEngine.h"
+#include "HistogramChannel.h"
+#include "AutoRange.h"
+#include "FramePool.h"
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
 
 #include <QMediaRecorder>
 #include <QVideoSink>
@@ -40,7 +53,7 @@ public:
 
     explicit FrameRenderer(QWidget *parent = nullptr, bool isReference = false);
     virtual ~FrameRenderer();
-    void setAssociateCamera(lzx::ICamera *camera) { associateCamera = camera; }
+    void setAssociateCamera(lzx::ICamera *camera); // 在相机的帧总线上注册到达通知，有新帧时才重绘
     std::vector<MaskPolygon> getMaskPolygons() const;
 
 protected:
@@ -56,12 +69,13 @@ protected:
 
 signals:
 
-    void histogramCalculated(const std::vector<int> &histogram, int maxValue);
     void fpsUpdated(double fps);
+    void autoRangeChanged(double min, double max); // 自动范围切换后通知灰度映射控件移动黑白点
 
 public slots:
     void onFrameChanged(const QImage &frame);
     void onFrameChangedDirectMode(const unsigned char *data, int width, int height, int channels, int bitDepth = 8);
+    void onFrameChangedDirectMode(const lzx::FrameView &view); // 支持带行填充、ROI的视图
     void onFrameChangedFromCamera(lzx::ICamera *camera);
     void onAutoFit();
     void onModeChanged(FrameRenderer::Mode mode);
@@ -84,6 +98,12 @@ public slots:
     }
 
     void setHistogramBins(int bins) { m_histogramBins = bins; }
+
+    // 自动显示范围：黑白点跟随直方图的百分位，参数在打开时从设置读取
+    void setAutoRangeEnabled(bool enabled);
+
+    // 每帧的直方图发布到这里，显示端按自己的刷新率拉取
+    std::shared_ptr<lzx::HistogramChannel> histogramChannel() const { return m_histogramChannel; }
     void setHistogramSamplingMode(HistogramSamplingMode mode) { m_histogramSamplingMode = mode; }
 
     void onLutChanged(double min, double max, double gamma);
@@ -101,6 +121,14 @@ private:
     // 拍照
     bool m_requestCapture = false;
     QString m_captureFileName;
+    uint64_t m_captureCount = 0;
+    std::map<uint64_t, QString> m_pendingCaptures; // 读回还没完成的拍照，按读回标记索引
+
+    // 读回的像素在后台线程上保存成图片或填充成视频帧
+    std::unique_ptr<lzx::ReadbackWorker> m_readbackWorker = std::make_unique<lzx::ReadbackWorker>();
+    std::shared_ptr<lzx::FramePool> m_readbackPool;
+    std::mutex m_encodedMutex;
+    std::deque<QVideoFrame> m_encodedFrames; // 后台线程填充好、等待在界面线程送进录像的帧
 
     // 录像
     std::unique_ptr<QMediaCaptureSession> m_captureSession;
@@ -113,11 +141,20 @@ private:
     qint64 m_lastFrameTime = 0;
     const qint64 FRAME_INTERVAL = 20; // 50fps = 20ms per framebool
     qint64 m_recordingFrameCount = 0; // 记录录制的帧数
+    int64_t m_recordingStartNs = 0;   // 第一帧的抓取时刻，视频时间戳从这里算起
+    uint64_t m_recordingDroppedBase = 0;
 
 
     // 直方图
     bool m_histogramEnabled = false;
-    int m_histogramBins = 100; // 默认100个bin
+    std::atomic<int> m_histogramBins{100}; // 默认100个bin，后台线程合并时读取
+    std::shared_ptr<lzx::HistogramChannel> m_histogramChannel = std::make_shared<lzx::HistogramChannel>();
+    std::unique_ptr<lzx::HistogramWorker> m_histogramWorker; // 精确直方图在后台线程计算
+
+    // 自动显示范围，在直方图线程上更新
+    lzx::AutoRange m_autoRange{lzx::AutoRange::Config()};
+    std::atomic<bool> m_autoRangeEnabled{false};
+    std::atomic<bool> m_autoRangeChanged{false};
     HistogramSamplingMode m_histogramSamplingMode = HistogramSamplingMode::Medium;
 
     // FPS 计算相关成员
@@ -126,6 +163,12 @@ private:
     qint64 m_lastFpsUpdate = 0;
     static constexpr int FPS_UPDATE_INTERVAL = 1000; // 每秒更新一次FPS
 
+    // 延迟统计
+    lzx::LatencyHistogram *m_displayLatency = nullptr;
+    bool m_presentPending = false; // 新帧已上传，等待交换缓冲区
+    qint64 m_lastLatencyLog = 0;
+    static constexpr int LATENCY_LOG_INTERVAL = 10000; // 每10秒输出一次延迟分位数
+
     bool m_flipY = false; // 控制Y方向是否反转
     bool m_flipX = false; // 控制X方向是否反转
 
@@ -137,10 +180,22 @@ private:
 
     lzx::ICamera *associateCamera = nullptr; // 关联的相机
 
-    std::vector<unsigned char> frameData; // 临时存储图像数据，用于绘制
+    // 事件驱动的重绘：新帧到达、视图变化时才重绘，不再每次 paintGL 末尾都 update()
+    std::unique_ptr<lzx::FrameNotifier> m_frameNotifier;
+    uint64_t m_busyFrames = 0;   // 上传了新帧的重绘
+    uint64_t m_idleFrames = 0;   // 没有新帧的重绘（缩放、LUT、窗口变化等）
+    uint64_t m_hiddenFrames = 0; // 窗口隐藏或被遮挡、推迟到重新显示时的到达通知
+
+    lzx::Frame m_currentFrame; // 当前显示帧的租约，直接引用生产者的缓冲区
+
+    void updateOpenGLTexture(GLuint textureID, const lzx::FrameView &view);
+
+    void collectReadbacks(bool wait); // 取出完成的读回交给后台线程，需要 OpenGL 上下文
+    void sendEncodedFrames();
 
-    void updateOpenGLTexture(GLuint textureID, int width, int height, const GLubyte *data, int channels, int bitDepth);
+    void calculateHistogram(const lzx::Frame &frame); // 提交给后台线程，不阻塞界面
 
-    void calculateHistogram(const unsigned char *data, int width, int height,
-                            int channels, int bitDepth);
+    void onFrameArrived();    // 界面线程上处理到达通知
+    bool isOnScreen() const;  // 可见且没有被完全遮挡、窗口没有最小化
+    void logRenderStatistics();
 };
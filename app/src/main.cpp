@@ -14,6 +14,7 @@
 #include "CameraControllerBar.h"
 
 #include "NeonButton.h"
+#include "PixelConvert.h"
 
 #define USE_QLEMENTINE_STYLE
 
@@ -37,6 +38,9 @@ int main(int argc, char *argv[])
     window->setMinimumSize(1400, 800);
     window->show();
 
+    // 在取流之前选择像素转换的实现并自检，结果输出到日志窗口
+    lzx::PixelConvert::simdLevel();
+
 #ifdef TEST_MY_WIDGET
     // 创建主窗口
     MultiWindowManager multi;
@@ -3,6 +3,9 @@
 #include <QMenu>
 #include <QMenuBar>
 
+#include <atomic>
+#include <thread>
+
 #include "SettingsDialog.hpp"
 
 #include "Common.h"
@@ -10,6 +13,7 @@
 #include "CameraViewPanel.h"
 
 #include "Settings.hpp"
+#include "Benchmarks.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent),
@@ -45,6 +49,12 @@ MainWindow::MainWindow(QWidget *parent)
     menu->addAction(glslEditorAction);
     connect(glslEditorAction, &QAction::triggered, this, &MainWindow::openGLSLEditor);
 
+    // 性能测试，结果输出到日志
+    benchmarkAction = new QAction(tr("性能测试"), this);
+    benchmarkAction->setStatusTip(tr("测量编解码等处理环节的吞吐，结果输出到日志"));
+    menu->addAction(benchmarkAction);
+    connect(benchmarkAction, &QAction::triggered, this, &MainWindow::runBenchmarks);
+
     menu->addAction(settingsAction);
     connect(settingsAction, &QAction::triggered, this, &MainWindow::openSettings);
 
@@ -75,8 +85,12 @@ MainWindow::MainWindow(QWidget *parent)
     if (1)
     {
 
-        multiWindowManager->addWindow(new CameraViewPanel("MVS", rightPanel, true));
-        multiWindowManager->addWindow(new CameraViewPanel("PlayerOne", rightPanel));
+        // 设置了回放录像时用录像代替 PlayerOne，便于没有相机时复现问题和测量延迟；
+        // 设置为参考相机时代替海康，Mask 窗口也由录像驱动
+        bool replay = !Settings::getInstance().getReplayFile().isEmpty();
+        bool replayReference = replay && Settings::getInstance().isReplayAsReference();
+        multiWindowManager->addWindow(new CameraViewPanel(replayReference ? "Replay" : "MVS", rightPanel, true));
+        multiWindowManager->addWindow(new CameraViewPanel(replay && !replayReference ? "Replay" : "PlayerOne", rightPanel));
     }
     else
     {
@@ -141,6 +155,23 @@ void MainWindow::openGLSLEditor()
     glslEditor->activateWindow();
 }
 
+void MainWindow::runBenchmarks()
+{
+    // 耗时数秒，放到后台线程，同一时间只跑一次
+    static std::atomic<bool> running{false};
+    if (running.exchange(true))
+    {
+        Log::warn("Benchmarks are already running");
+        return;
+    }
+
+    std::thread([]
+                {
+        lzx::Benchmarks::runAll();
+        running = false; })
+        .detach();
+}
+
 void MainWindow::toggleDeviceFinder()
 {
     if (deviceFinderDialog->isVisible())
@@ -38,6 +38,8 @@ private slots:
 
     void openSaveFolder();
 
+    void runBenchmarks();
+
 private:
     QSplitter *splitter;
     MultiWindowManager *multiWindowManager;
@@ -54,6 +56,7 @@ private:
     UserControlArea *userControlArea;
     QAction *settingsAction;
     QAction *glslEditorAction;
+    QAction *benchmarkAction;
     GLSLEditor *glslEditor = nullptr;
 };
 